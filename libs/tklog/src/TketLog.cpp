@@ -18,57 +18,159 @@
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 
 namespace tket {
 
-Logger::Logger(LogLevel level) : level(level) {}
-void Logger::trace(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Trace) {
-    log("trace", s, os);
+const char *log_level_name(LogLevel level) {
+  switch (level) {
+    case LogLevel::Trace:
+      return "trace";
+    case LogLevel::Debug:
+      return "debug";
+    case LogLevel::Info:
+      return "info";
+    case LogLevel::Warn:
+      return "warn";
+    case LogLevel::Err:
+      return "error";
+    case LogLevel::Critical:
+      return "critical";
+    default:
+      return "off";
   }
 }
-void Logger::debug(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Debug) {
-    log("debug", s, os);
+
+std::string LogEvent::format() const {
+  std::tm *plt;
+  const std::time_t t = std::chrono::system_clock::to_time_t(time);
+#if defined(_MSC_VER)
+  std::tm lt;
+  localtime_s(&lt, &t);
+  plt = &lt;
+#else
+  std::tm lt;
+  plt = localtime_r(&t, &lt);
+#endif
+  std::ostringstream ss;
+  ss << "[" << std::put_time(plt, "%Y-%m-%d %H:%M:%S") << "]"
+     << " [tket] [" << log_level_name(level) << "] " << message;
+  for (const LogField &field : fields) {
+    ss << " " << field.key << "=" << field.value;
   }
+  return ss.str();
 }
-void Logger::info(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Info) {
-    log("info", s, os);
+
+StreamLogSink::StreamLogSink(std::ostream &os) : os(os) {}
+
+void StreamLogSink::write(const LogEvent &event) {
+  const std::string line = event.format();
+  std::lock_guard<std::mutex> lock(mutex);
+  os << line << std::endl;
+}
+
+FileLogSink::FileLogSink(const std::string &filename)
+    : ofs(filename, std::ios::app) {
+  if (!ofs) {
+    throw std::runtime_error("Cannot open log file '" + filename + "'");
   }
 }
-void Logger::warn(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Warn) {
-    log("warn", s, os);
+
+void FileLogSink::write(const LogEvent &event) {
+  const std::string line = event.format();
+  std::lock_guard<std::mutex> lock(mutex);
+  ofs << line << std::endl;
+}
+
+RingBufferLogSink::RingBufferLogSink(std::size_t capacity)
+    : capacity(capacity) {}
+
+void RingBufferLogSink::write(const LogEvent &event) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (capacity == 0) return;
+  if (events.size() == capacity) {
+    events.pop_front();
   }
+  events.push_back(event);
 }
-void Logger::error(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Err) {
-    log("error", s, os);
+
+std::vector<LogEvent> RingBufferLogSink::get_events() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return {events.cbegin(), events.cend()};
+}
+
+void RingBufferLogSink::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  events.clear();
+}
+
+Logger::Logger(LogLevel level)
+    : level(level), sinks{std::make_shared<StreamLogSink>(std::cout)} {}
+
+void Logger::log_event(
+    LogLevel lev, std::string message, std::initializer_list<LogField> fields) {
+  if (!should_log(lev)) return;
+  LogEvent event{
+      lev, std::chrono::system_clock::now(), std::move(message), fields};
+  std::vector<std::shared_ptr<LogSink>> current_sinks;
+  {
+    std::lock_guard<std::mutex> lock(sinks_mutex);
+    current_sinks = sinks;
   }
+  for (const auto &sink : current_sinks) {
+    sink->write(event);
+  }
+}
+
+void Logger::trace(const std::string &s) { log_event(LogLevel::Trace, s); }
+void Logger::debug(const std::string &s) { log_event(LogLevel::Debug, s); }
+void Logger::info(const std::string &s) { log_event(LogLevel::Info, s); }
+void Logger::warn(const std::string &s) { log_event(LogLevel::Warn, s); }
+void Logger::error(const std::string &s) { log_event(LogLevel::Err, s); }
+void Logger::critical(const std::string &s) {
+  log_event(LogLevel::Critical, s);
+}
+
+void Logger::trace(const std::string &s, std::ostream &os) {
+  log(LogLevel::Trace, s, os);
+}
+void Logger::debug(const std::string &s, std::ostream &os) {
+  log(LogLevel::Debug, s, os);
+}
+void Logger::info(const std::string &s, std::ostream &os) {
+  log(LogLevel::Info, s, os);
+}
+void Logger::warn(const std::string &s, std::ostream &os) {
+  log(LogLevel::Warn, s, os);
+}
+void Logger::error(const std::string &s, std::ostream &os) {
+  log(LogLevel::Err, s, os);
 }
 void Logger::critical(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Critical) {
-    log("critical", s, os);
-  }
+  log(LogLevel::Critical, s, os);
 }
 
-void Logger::log(const char *levstr, const std::string &s, std::ostream &os) {
-  std::tm *plt;
-  const std::time_t t = std::time(nullptr);
-#if defined(_MSC_VER)
-  std::tm lt;
-  localtime_s(&lt, &t);
-  plt = &lt;
-#else
-  plt = std::localtime(&t);
-#endif
-  os << "[" << std::put_time(plt, "%Y-%m-%d %H:%M:%S") << "]"
-     << " [tket] [" << levstr << "] " << s << std::endl;
+void Logger::log(LogLevel lev, const std::string &s, std::ostream &os) {
+  if (should_log(lev)) {
+    os << LogEvent{lev, std::chrono::system_clock::now(), s, {}}.format()
+       << std::endl;
+  }
 }
 
 void Logger::set_level(LogLevel lev) { level = lev; }
 
+LogLevel Logger::get_level() const { return level; }
+
+void Logger::add_sink(std::shared_ptr<LogSink> sink) {
+  std::lock_guard<std::mutex> lock(sinks_mutex);
+  sinks.push_back(std::move(sink));
+}
+
+void Logger::clear_sinks() {
+  std::lock_guard<std::mutex> lock(sinks_mutex);
+  sinks.clear();
+}
+
 LogPtr_t &tket_log() {
 #ifdef ALL_LOGS
   static LogPtr_t logger = std::make_shared<Logger>(LogLevel::Trace);
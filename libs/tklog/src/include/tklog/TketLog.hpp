@@ -19,9 +19,19 @@
  * @brief Logging
  */
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <initializer_list>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace tket {
 
@@ -35,20 +45,130 @@ enum class LogLevel {
   Off = 6
 };
 
+/** The lower case name of a level, as written in log lines. */
+const char *log_level_name(LogLevel level);
+
+/** A key/value pair attached to a log event. */
+struct LogField {
+  std::string key;
+  std::string value;
+
+  LogField(std::string k, std::string v)
+      : key(std::move(k)), value(std::move(v)) {}
+  LogField(std::string k, const char *v) : key(std::move(k)), value(v) {}
+
+  /** Anything which can be written to a std::ostream. */
+  template <typename T>
+  LogField(std::string k, const T &v) : key(std::move(k)) {
+    std::ostringstream ss;
+    ss << v;
+    value = ss.str();
+  }
+};
+
+/** A single log message, with any structured data. */
+struct LogEvent {
+  LogLevel level;
+  std::chrono::system_clock::time_point time;
+  std::string message;
+  std::vector<LogField> fields;
+
+  /** The usual one-line form:
+   * "[date time] [tket] [level] message key1=value1 key2=value2". */
+  std::string format() const;
+};
+
+/** Destination for log events. Implementations must be thread-safe. */
+class LogSink {
+ public:
+  virtual ~LogSink() = default;
+  virtual void write(const LogEvent &event) = 0;
+};
+
+/** Writes formatted events to a stream, e.g. std::cerr. */
+class StreamLogSink : public LogSink {
+ public:
+  /** The stream must outlive the sink. */
+  explicit StreamLogSink(std::ostream &os);
+  void write(const LogEvent &event) override;
+
+ private:
+  std::mutex mutex;
+  std::ostream &os;
+};
+
+/** Appends formatted events to a file. */
+class FileLogSink : public LogSink {
+ public:
+  /** @throws std::runtime_error if the file cannot be opened */
+  explicit FileLogSink(const std::string &filename);
+  void write(const LogEvent &event) override;
+
+ private:
+  std::mutex mutex;
+  std::ofstream ofs;
+};
+
+/** Keeps the most recent events in memory, e.g. for tests or for
+ * attaching to an error report. */
+class RingBufferLogSink : public LogSink {
+ public:
+  explicit RingBufferLogSink(std::size_t capacity);
+  void write(const LogEvent &event) override;
+
+  /** The stored events, oldest first. */
+  std::vector<LogEvent> get_events() const;
+  void clear();
+
+ private:
+  mutable std::mutex mutex;
+  std::size_t capacity;
+  std::deque<LogEvent> events;
+};
+
 class Logger {
  public:
+  /** Initially the only sink writes to std::cout. */
   Logger(LogLevel level = LogLevel::Err);
-  void trace(const std::string &s, std::ostream &os = std::cout);
-  void debug(const std::string &s, std::ostream &os = std::cout);
-  void info(const std::string &s, std::ostream &os = std::cout);
-  void warn(const std::string &s, std::ostream &os = std::cout);
-  void error(const std::string &s, std::ostream &os = std::cout);
-  void critical(const std::string &s, std::ostream &os = std::cout);
+
+  /** Whether messages at this level are currently written anywhere.
+   * Use the TKET_LOG_* macros rather than testing this by hand. */
+  bool should_log(LogLevel lev) const {
+    return lev >= level.load(std::memory_order_relaxed);
+  }
+
+  /** Send an event to every sink, if the level is enabled. */
+  void log_event(
+      LogLevel lev, std::string message,
+      std::initializer_list<LogField> fields = {});
+
+  void trace(const std::string &s);
+  void debug(const std::string &s);
+  void info(const std::string &s);
+  void warn(const std::string &s);
+  void error(const std::string &s);
+  void critical(const std::string &s);
+
+  // As above, but writing to the given stream instead of the sinks.
+  void trace(const std::string &s, std::ostream &os);
+  void debug(const std::string &s, std::ostream &os);
+  void info(const std::string &s, std::ostream &os);
+  void warn(const std::string &s, std::ostream &os);
+  void error(const std::string &s, std::ostream &os);
+  void critical(const std::string &s, std::ostream &os);
+
   void set_level(LogLevel lev);
+  LogLevel get_level() const;
+
+  void add_sink(std::shared_ptr<LogSink> sink);
+  /** Remove all sinks (including the default one). */
+  void clear_sinks();
 
  private:
-  LogLevel level;
-  void log(const char *levstr, const std::string &s, std::ostream &os);
+  std::atomic<LogLevel> level;
+  mutable std::mutex sinks_mutex;
+  std::vector<std::shared_ptr<LogSink>> sinks;
+  void log(LogLevel lev, const std::string &s, std::ostream &os);
 };
 
 typedef std::shared_ptr<Logger> LogPtr_t;
@@ -57,3 +177,25 @@ typedef std::shared_ptr<Logger> LogPtr_t;
 LogPtr_t &tket_log();
 
 }  // namespace tket
+
+/**
+ * Log through tket_log() at the given level. The arguments, a message
+ * followed optionally by a braced list of key/value fields, are only
+ * evaluated if the level is enabled, so they may be expensive to compute:
+ *
+ *   TKET_LOG_TRACE("start two_qubit_squash()", {{"depth", circ.depth()}});
+ */
+#define TKET_LOG(lev, ...)                                     \
+  do {                                                         \
+    const tket::LogPtr_t& tket_log_logger_ = tket::tket_log(); \
+    if (tket_log_logger_->should_log(lev)) {                   \
+      tket_log_logger_->log_event(lev, __VA_ARGS__);           \
+    }                                                          \
+  } while (0)
+
+#define TKET_LOG_TRACE(...) TKET_LOG(tket::LogLevel::Trace, __VA_ARGS__)
+#define TKET_LOG_DEBUG(...) TKET_LOG(tket::LogLevel::Debug, __VA_ARGS__)
+#define TKET_LOG_INFO(...) TKET_LOG(tket::LogLevel::Info, __VA_ARGS__)
+#define TKET_LOG_WARN(...) TKET_LOG(tket::LogLevel::Warn, __VA_ARGS__)
+#define TKET_LOG_ERROR(...) TKET_LOG(tket::LogLevel::Err, __VA_ARGS__)
+#define TKET_LOG_CRITICAL(...) TKET_LOG(tket::LogLevel::Critical, __VA_ARGS__)
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <tklog/TketLog.hpp>
@@ -53,4 +56,64 @@ SCENARIO("Logging") {
   CHECK(s.find("(no output)") == std::string::npos);
 }
 
+SCENARIO("Lazy logging with structured fields") {
+  auto buffer = std::make_shared<RingBufferLogSink>(2);
+  tket_log()->clear_sinks();
+  tket_log()->add_sink(buffer);
+
+  unsigned n_evaluations = 0;
+  auto expensive = [&n_evaluations]() {
+    ++n_evaluations;
+    return 42u;
+  };
+
+  tket_log()->set_level(LogLevel::Err);
+  TKET_LOG_TRACE("Not evaluated", {{"value", expensive()}});
+  TKET_LOG_WARN("Not evaluated either");
+  CHECK(n_evaluations == 0);
+  CHECK(buffer->get_events().empty());
+
+  tket_log()->set_level(LogLevel::Trace);
+  TKET_LOG_TRACE("First", {{"value", expensive()}, {"name", "x"}});
+  CHECK(n_evaluations == 1);
+  TKET_LOG_DEBUG("Second");
+  TKET_LOG_ERROR("Third", {{"pi", 3.5}});
+  tket_log()->info("Fourth");
+
+  // Only the two most recent are kept.
+  const auto events = buffer->get_events();
+  REQUIRE(events.size() == 2);
+  CHECK(events[0].level == LogLevel::Err);
+  CHECK(events[0].message == "Third");
+  REQUIRE(events[0].fields.size() == 1);
+  CHECK(events[0].fields[0].key == "pi");
+  CHECK(events[0].fields[0].value == "3.5");
+  CHECK(events[1].message == "Fourth");
+  CHECK(events[1].fields.empty());
+  const std::string line = events[0].format();
+  CHECK(line.find("[tket] [error] Third pi=3.5") != std::string::npos);
+
+  buffer->clear();
+  CHECK(buffer->get_events().empty());
+
+  const std::string filename =
+      (std::filesystem::temp_directory_path() / "test_tklog.log").string();
+  std::remove(filename.c_str());
+  tket_log()->clear_sinks();
+  tket_log()->add_sink(std::make_shared<FileLogSink>(filename));
+  TKET_LOG_INFO("To file", {{"key", std::string("value")}});
+  tket_log()->clear_sinks();
+  {
+    std::ifstream ifs(filename);
+    std::stringstream contents;
+    contents << ifs.rdbuf();
+    CHECK(
+        contents.str().find("[info] To file key=value") != std::string::npos);
+  }
+  std::remove(filename.c_str());
+
+  tket_log()->add_sink(std::make_shared<StreamLogSink>(std::cout));
+  tket_log()->set_level(LogLevel::Err);
+}
+
 }  // namespace tket
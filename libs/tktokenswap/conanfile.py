@@ -18,7 +18,7 @@ from conans.errors import ConanInvalidConfiguration
 
 class TktokenswapConan(ConanFile):
     name = "tktokenswap"
-    version = "0.1.2"
+    version = "0.2.1"
     license = "Apache 2"
     url = "https://github.com/CQCL/tket"
     description = "Token swapping algorithms library"
@@ -32,8 +32,8 @@ class TktokenswapConan(ConanFile):
     generators = "cmake"
     exports_sources = "src/*"
     requires = [
-        "tklog/0.1.2@tket/stable",
-        "tkassert/0.1.1@tket/stable",
+        "tklog/0.2.0@tket/stable",
+        "tkassert/0.1.2@tket/stable",
         "tkrng/0.1.2@tket/stable",
         "boost/1.80.0",
     ]
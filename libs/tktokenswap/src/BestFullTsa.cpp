@@ -23,6 +23,10 @@ using namespace tsa_internal;
 
 BestFullTsa::BestFullTsa() { m_name = "BestFullTsa"; }
 
+CyclesGrowthManager::Options& BestFullTsa::get_cycles_growth_options() {
+  return m_hybrid_tsa.get_cycles_growth_options();
+}
+
 void BestFullTsa::append_partial_solution(
     SwapList& swaps, VertexMapping& vertex_mapping,
     DistancesInterface& distances, NeighboursInterface& neighbours,
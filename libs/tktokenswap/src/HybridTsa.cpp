@@ -28,6 +28,10 @@ HybridTsa::HybridTsa() {
   m_trivial_tsa.set(TrivialTSA::Options::BREAK_AFTER_PROGRESS);
 }
 
+CyclesGrowthManager::Options& HybridTsa::get_cycles_growth_options() {
+  return m_cycles_tsa.get_growth_options();
+}
+
 void HybridTsa::append_partial_solution(
     SwapList& swaps, VertexMapping& vertex_mapping,
     DistancesInterface& distances, NeighboursInterface& neighbours,
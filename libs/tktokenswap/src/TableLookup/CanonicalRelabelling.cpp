@@ -23,9 +23,18 @@ using std::vector;
 namespace tket {
 namespace tsa_internal {
 
-CanonicalRelabelling::CanonicalRelabelling() {
-  // no more than 6 vertices, so no more than 6 cycles ever needed.
-  m_cycles.resize(6);
+CanonicalRelabelling::CanonicalRelabelling(unsigned max_number_of_vertices)
+    : m_max_number_of_vertices(max_number_of_vertices) {
+  // Permutation hashes are decimal digits, so cycles of length >= 10
+  // cannot be represented.
+  TKET_ASSERT(m_max_number_of_vertices >= 2);
+  TKET_ASSERT(m_max_number_of_vertices <= 9);
+  // No more than N vertices, so no more than N cycles ever needed.
+  m_cycles.resize(m_max_number_of_vertices);
+}
+
+unsigned CanonicalRelabelling::get_max_number_of_vertices() const {
+  return m_max_number_of_vertices;
 }
 
 const CanonicalRelabelling::Result& CanonicalRelabelling::operator()(
@@ -39,13 +48,12 @@ const CanonicalRelabelling::Result& CanonicalRelabelling::operator()(
     return m_result;
   }
   check_mapping(desired_mapping, m_work_mapping);
-  if (desired_mapping.size() > 6) {
+  if (desired_mapping.size() > m_max_number_of_vertices) {
     m_result.too_many_vertices = true;
     return m_result;
   }
   // If not the identity, at least 2 vertices moved.
   TKET_ASSERT(desired_mapping.size() >= 2);
-  TKET_ASSERT(desired_mapping.size() <= 6);
 
   m_desired_mapping = desired_mapping;
   unsigned next_cyc_index = 0;
@@ -97,12 +105,13 @@ const CanonicalRelabelling::Result& CanonicalRelabelling::operator()(
   for (auto ii : m_sorted_cycles_indices) {
     const auto& cyc = m_cycles[ii];
     TKET_ASSERT(!cyc.empty());
-    TKET_ASSERT(cyc.size() <= 6);
+    TKET_ASSERT(cyc.size() <= m_max_number_of_vertices);
     for (size_t old_v : cyc) {
       m_result.new_to_old_vertices.push_back(old_v);
     }
   }
-  TKET_ASSERT(m_result.new_to_old_vertices.size() <= 6);
+  TKET_ASSERT(
+      m_result.new_to_old_vertices.size() <= m_max_number_of_vertices);
   m_result.old_to_new_vertices.clear();
   for (unsigned ii = 0; ii < m_result.new_to_old_vertices.size(); ++ii) {
     m_result.old_to_new_vertices[m_result.new_to_old_vertices[ii]] = ii;
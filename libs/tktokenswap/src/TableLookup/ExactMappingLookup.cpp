@@ -26,11 +26,22 @@ using std::vector;
 namespace tket {
 namespace tsa_internal {
 
+ExactMappingLookup::ExactMappingLookup()
+    : ExactMappingLookup(SwapSequenceTableFile::get_global_table()) {}
+
+ExactMappingLookup::ExactMappingLookup(
+    std::shared_ptr<const SwapSequenceTableFile> file_table)
+    : m_relabeller(SwapSequenceTableFile::max_number_of_vertices),
+      m_file_table(std::move(file_table)),
+      m_max_number_of_vertices(
+          m_file_table ? SwapSequenceTableFile::max_number_of_vertices : 6) {}
+
 const ExactMappingLookup::Result& ExactMappingLookup::operator()(
     const VertexMapping& desired_mapping, const vector<Swap>& edges,
     unsigned max_number_of_swaps) {
   m_result.success = false;
-  m_result.too_many_vertices = desired_mapping.size() > 6;
+  m_result.too_many_vertices =
+      desired_mapping.size() > m_max_number_of_vertices;
   m_result.swaps.clear();
   if (m_result.too_many_vertices) {
     return m_result;
@@ -39,6 +50,10 @@ const ExactMappingLookup::Result& ExactMappingLookup::operator()(
       desired_mapping, edges, max_number_of_swaps);
 }
 
+unsigned ExactMappingLookup::get_max_number_of_vertices() const {
+  return m_max_number_of_vertices;
+}
+
 const ExactMappingLookup::Result&
 ExactMappingLookup::improve_upon_existing_result(
     const VertexMapping& desired_mapping, const vector<Swap>& edges,
@@ -54,7 +69,8 @@ ExactMappingLookup::improve_upon_existing_result(
     m_result.swaps.clear();
     return m_result;
   }
-  if (relabelling.too_many_vertices) {
+  if (relabelling.too_many_vertices ||
+      relabelling.new_to_old_vertices.size() > m_max_number_of_vertices) {
     // We cannot get a new result, so just return the existing one, whether or
     // not it succeeded.
     if (!m_result.success) {
@@ -70,7 +86,12 @@ ExactMappingLookup::improve_upon_existing_result(
   }
   TKET_ASSERT(relabelling.new_to_old_vertices.size() >= 2);
 
-  fill_result_from_table(relabelling, edges, max_number_of_swaps);
+  if (relabelling.new_to_old_vertices.size() <= 6) {
+    fill_result_from_table(relabelling, edges, max_number_of_swaps);
+  }
+  if (m_file_table) {
+    fill_result_from_file_table(relabelling, edges, max_number_of_swaps);
+  }
   return m_result;
 }
 
@@ -136,5 +157,55 @@ void ExactMappingLookup::fill_result_from_table(
   TKET_ASSERT(m_result.swaps.size() <= 16);
 }
 
+void ExactMappingLookup::fill_result_from_file_table(
+    const CanonicalRelabelling::Result& relabelling_result,
+    const vector<Swap>& old_edges, unsigned max_number_of_swaps) {
+  if (m_result.success) {
+    if (m_result.swaps.empty()) {
+      return;
+    }
+    max_number_of_swaps =
+        std::min<unsigned>(max_number_of_swaps, m_result.swaps.size() - 1);
+    if (max_number_of_swaps == 0) {
+      return;
+    }
+  }
+  std::uint32_t new_edges_bitset = 0;
+
+  for (auto old_edge : old_edges) {
+    const auto new_v1_opt = get_optional_value(
+        relabelling_result.old_to_new_vertices, old_edge.first);
+    if (!new_v1_opt) {
+      continue;
+    }
+    const auto new_v2_opt = get_optional_value(
+        relabelling_result.old_to_new_vertices, old_edge.second);
+    if (!new_v2_opt) {
+      continue;
+    }
+    new_edges_bitset |= SwapSequenceTableFile::get_edges_bitset(
+        SwapSequenceTableFile::get_hash_from_swap(
+            get_swap(new_v1_opt.value(), new_v2_opt.value())));
+  }
+  const auto table_result = m_file_table->get_lookup_result(
+      relabelling_result.permutation_hash, new_edges_bitset,
+      max_number_of_swaps);
+
+  if (table_result.number_of_swaps > max_number_of_swaps) {
+    // No result in the table.
+    return;
+  }
+  TKET_ASSERT(table_result.swaps_code > 0);
+
+  m_result.success = true;
+  m_result.swaps.clear();
+  for (const auto& new_swap :
+       SwapSequenceTableFile::get_swaps(table_result.swaps_code)) {
+    m_result.swaps.push_back(get_swap(
+        relabelling_result.new_to_old_vertices.at(new_swap.first),
+        relabelling_result.new_to_old_vertices.at(new_swap.second)));
+  }
+}
+
 }  // namespace tsa_internal
 }  // namespace tket
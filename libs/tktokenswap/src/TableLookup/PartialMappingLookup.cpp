@@ -89,5 +89,9 @@ PartialMappingLookup::Parameters& PartialMappingLookup::get_parameters() {
   return m_parameters;
 }
 
+unsigned PartialMappingLookup::get_max_number_of_vertices() const {
+  return m_exact_mapping_lookup.get_max_number_of_vertices();
+}
+
 }  // namespace tsa_internal
 }  // namespace tket
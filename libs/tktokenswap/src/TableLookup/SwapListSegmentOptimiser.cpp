@@ -67,7 +67,8 @@ SwapListSegmentOptimiser::optimise_segment(
     if (attempt_to_optimise) {
       // We're going to attempt to optimise.
       current_map_copy = current_map;
-      const auto& resize_result = map_resizing.resize_mapping(current_map);
+      const auto& resize_result = map_resizing.resize_mapping(
+          current_map, m_mapping_lookup.get_max_number_of_vertices());
       if (resize_result.success) {
         const auto& lookup_result = m_mapping_lookup(
             current_map, resize_result.edges, vertices_with_tokens_at_start,
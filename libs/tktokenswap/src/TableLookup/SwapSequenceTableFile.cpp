@@ -0,0 +1,382 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tktokenswap/SwapSequenceTableFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <tkassert/Assert.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TKET_TSA_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using std::vector;
+
+namespace tket {
+namespace tsa_internal {
+
+static_assert(
+    sizeof(SwapSequenceTableFile::Record) == 16,
+    "Records are read directly from the file, so must not be padded");
+
+namespace {
+
+constexpr char magic[8] = {'T', 'K', 'S', 'W', 'P', 'S', 'E', 'Q'};
+constexpr std::uint32_t byte_order_mark = 0x01020304;
+constexpr std::uint32_t current_version = 1;
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t byte_order;
+  std::uint32_t version;
+  std::uint64_t number_of_records;
+  std::uint64_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 32, "The header must be 32 bytes");
+
+bool records_less(
+    const SwapSequenceTableFile::Record& lhs,
+    const SwapSequenceTableFile::Record& rhs) {
+  return lhs.permutation_hash < rhs.permutation_hash ||
+         (lhs.permutation_hash == rhs.permutation_hash &&
+          lhs.swaps_code < rhs.swaps_code);
+}
+
+bool records_equal(
+    const SwapSequenceTableFile::Record& lhs,
+    const SwapSequenceTableFile::Record& rhs) {
+  return lhs.permutation_hash == rhs.permutation_hash &&
+         lhs.swaps_code == rhs.swaps_code;
+}
+
+// Unlike get_edges_bitset, never asserts, so can be used on untrusted data.
+// A valid code is nonzero, has every 5-bit field in the range 1-28 (with no
+// gaps), fits within max_number_of_swaps fields, and matches the bitset.
+bool is_valid_record(const SwapSequenceTableFile::Record& record) {
+  if (record.permutation_hash == 0 || record.swaps_code == 0 ||
+      (record.swaps_code >>
+       (5 * SwapSequenceTableFile::max_number_of_swaps)) != 0) {
+    return false;
+  }
+  std::uint32_t edges_bitset = 0;
+  for (auto swaps_code = record.swaps_code; swaps_code != 0;
+       swaps_code >>= 5) {
+    const auto swap_hash = swaps_code & 0x1F;
+    if (swap_hash == 0 || swap_hash > 28) {
+      return false;
+    }
+    edges_bitset |= (1u << (swap_hash - 1));
+  }
+  return edges_bitset == record.edges_bitset;
+}
+
+std::runtime_error get_file_error(
+    const std::string& filename, const std::string& message) {
+  std::stringstream ss;
+  ss << "SwapSequenceTableFile: file '" << filename << "': " << message;
+  return std::runtime_error(ss.str());
+}
+
+// Checks the header, and returns the number of records.
+std::uint64_t get_number_of_records(
+    const FileHeader& header, std::uint64_t file_size,
+    const std::string& filename) {
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+    throw get_file_error(filename, "not a swap sequence table");
+  }
+  if (header.byte_order != byte_order_mark) {
+    throw get_file_error(filename, "written with a different byte order");
+  }
+  if (header.version != current_version) {
+    throw get_file_error(filename, "unsupported version");
+  }
+  const std::uint64_t max_records =
+      (file_size - sizeof(FileHeader)) / sizeof(SwapSequenceTableFile::Record);
+  if (header.number_of_records > max_records ||
+      sizeof(FileHeader) + header.number_of_records *
+                               sizeof(SwapSequenceTableFile::Record) !=
+          file_size) {
+    throw get_file_error(filename, "size does not match the header");
+  }
+  return header.number_of_records;
+}
+
+vector<Swap> get_swaps_fixed_vector() {
+  vector<Swap> swaps;
+  for (unsigned ii = 0; ii < SwapSequenceTableFile::max_number_of_vertices;
+       ++ii) {
+    for (unsigned jj = ii + 1;
+         jj < SwapSequenceTableFile::max_number_of_vertices; ++jj) {
+      swaps.push_back(get_swap(ii, jj));
+    }
+  }
+  TKET_ASSERT(swaps.size() == 28);
+  return swaps;
+}
+
+const vector<Swap>& get_swaps_global() {
+  static const auto swaps_vect(get_swaps_fixed_vector());
+  return swaps_vect;
+}
+
+const std::map<Swap, std::uint64_t>& get_swap_to_hash_global() {
+  static const auto map = []() {
+    const auto& swaps = get_swaps_global();
+    std::map<Swap, std::uint64_t> result;
+    for (unsigned ii = 0; ii < swaps.size(); ++ii) {
+      result[swaps[ii]] = ii + 1;
+    }
+    return result;
+  }();
+  return map;
+}
+
+struct GlobalTableData {
+  std::mutex mutex;
+  std::string filename;
+  std::shared_ptr<const SwapSequenceTableFile> table;
+};
+
+GlobalTableData& get_global_table_data() {
+  static GlobalTableData data;
+  return data;
+}
+
+}  // namespace
+
+SwapSequenceTableFile::SwapSequenceTableFile()
+    : m_records_begin(nullptr),
+      m_records_end(nullptr),
+      m_mapped_data(nullptr),
+      m_mapped_size(0) {}
+
+SwapSequenceTableFile::~SwapSequenceTableFile() {
+#ifdef TKET_TSA_USE_MMAP
+  if (m_mapped_data != nullptr) {
+    munmap(m_mapped_data, m_mapped_size);
+  }
+#endif
+}
+
+std::unique_ptr<SwapSequenceTableFile> SwapSequenceTableFile::load(
+    const std::string& filename) {
+  std::unique_ptr<SwapSequenceTableFile> table(new SwapSequenceTableFile());
+
+#ifdef TKET_TSA_USE_MMAP
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw get_file_error(filename, "cannot be opened");
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      file_stat.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+    close(fd);
+    throw get_file_error(filename, "too small to be a swap sequence table");
+  }
+  const auto file_size = static_cast<std::uint64_t>(file_stat.st_size);
+  void* data = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data != MAP_FAILED) {
+    table->m_mapped_data = data;
+    table->m_mapped_size = file_size;
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const auto number_of_records =
+        get_number_of_records(header, file_size, filename);
+    table->m_records_begin = reinterpret_cast<const Record*>(
+        static_cast<const char*>(data) + sizeof(FileHeader));
+    table->m_records_end = table->m_records_begin + number_of_records;
+  }
+#endif
+
+  if (table->m_mapped_data == nullptr) {
+    std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+    if (!ifs) {
+      throw get_file_error(filename, "cannot be opened");
+    }
+    const auto file_size = static_cast<std::uint64_t>(ifs.tellg());
+    if (file_size < sizeof(FileHeader)) {
+      throw get_file_error(filename, "too small to be a swap sequence table");
+    }
+    ifs.seekg(0);
+    FileHeader header;
+    ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+    const auto number_of_records =
+        get_number_of_records(header, file_size, filename);
+    table->m_owned_records.resize(number_of_records);
+    ifs.read(
+        reinterpret_cast<char*>(table->m_owned_records.data()),
+        number_of_records * sizeof(Record));
+    if (!ifs) {
+      throw get_file_error(filename, "could not be read");
+    }
+    table->m_records_begin = table->m_owned_records.data();
+    table->m_records_end =
+        table->m_owned_records.data() + table->m_owned_records.size();
+  }
+
+  // Lookups rely on the order, so a cheap check is worthwhile.
+  if (!std::is_sorted(
+          table->m_records_begin, table->m_records_end, records_less)) {
+    throw get_file_error(filename, "records are not sorted");
+  }
+  // Lookups decode the swaps with assertions, so reject corrupt codes here.
+  if (!std::all_of(
+          table->m_records_begin, table->m_records_end, is_valid_record)) {
+    throw get_file_error(filename, "contains an invalid swap sequence");
+  }
+  return table;
+}
+
+void SwapSequenceTableFile::write_file(
+    const std::string& filename, vector<Record> records) {
+  for (const auto& record : records) {
+    TKET_ASSERT(record.permutation_hash != 0);
+    TKET_ASSERT(record.swaps_code != 0);
+    TKET_ASSERT(record.edges_bitset == get_edges_bitset(record.swaps_code));
+  }
+  std::sort(records.begin(), records.end(), records_less);
+  records.erase(
+      std::unique(records.begin(), records.end(), records_equal),
+      records.end());
+
+  FileHeader header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.byte_order = byte_order_mark;
+  header.version = current_version;
+  header.number_of_records = records.size();
+  header.reserved = 0;
+
+  std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+  if (!ofs) {
+    throw get_file_error(filename, "cannot be opened for writing");
+  }
+  ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  ofs.write(
+      reinterpret_cast<const char*>(records.data()),
+      records.size() * sizeof(Record));
+  if (!ofs) {
+    throw get_file_error(filename, "could not be written");
+  }
+}
+
+void SwapSequenceTableFile::set_global_table_filename(
+    const std::string& filename) {
+  auto& data = get_global_table_data();
+  const std::lock_guard<std::mutex> lock(data.mutex);
+  if (filename != data.filename) {
+    data.filename = filename;
+    data.table.reset();
+  }
+}
+
+std::shared_ptr<const SwapSequenceTableFile>
+SwapSequenceTableFile::get_global_table() {
+  auto& data = get_global_table_data();
+  const std::lock_guard<std::mutex> lock(data.mutex);
+  if (!data.table && !data.filename.empty()) {
+    data.table = load(data.filename);
+  }
+  return data.table;
+}
+
+SwapSequenceTableFile::LookupResult SwapSequenceTableFile::get_lookup_result(
+    unsigned permutation_hash, std::uint32_t edges_bitset,
+    unsigned max_num_swaps) const {
+  LookupResult result;
+  result.swaps_code = 0;
+  result.number_of_swaps = std::numeric_limits<unsigned>::max();
+  max_num_swaps = std::min(max_num_swaps, max_number_of_swaps);
+
+  auto citer = std::lower_bound(
+      m_records_begin, m_records_end, permutation_hash,
+      [](const Record& record, unsigned hash) {
+        return record.permutation_hash < hash;
+      });
+
+  // Within a single permutation, records are sorted by swaps_code,
+  // and hence also by length; so the first match is a shortest one.
+  for (; citer != m_records_end && citer->permutation_hash == permutation_hash;
+       ++citer) {
+    const auto number_of_swaps = get_number_of_swaps(citer->swaps_code);
+    if (number_of_swaps > max_num_swaps) {
+      break;
+    }
+    if ((citer->edges_bitset & edges_bitset) == citer->edges_bitset) {
+      result.swaps_code = citer->swaps_code;
+      result.number_of_swaps = number_of_swaps;
+      break;
+    }
+  }
+  return result;
+}
+
+size_t SwapSequenceTableFile::size() const {
+  return m_records_end - m_records_begin;
+}
+
+const Swap& SwapSequenceTableFile::get_swap_from_hash(std::uint64_t x) {
+  TKET_ASSERT(x >= 1 && x <= 28);
+  return get_swaps_global()[x - 1];
+}
+
+std::uint64_t SwapSequenceTableFile::get_hash_from_swap(const Swap& swap) {
+  return get_swap_to_hash_global().at(swap);
+}
+
+std::uint32_t SwapSequenceTableFile::get_edges_bitset(
+    std::uint64_t swaps_code) {
+  std::uint32_t edges_bitset = 0;
+  while (swaps_code != 0) {
+    const auto swap_hash = swaps_code & 0x1F;
+    TKET_ASSERT(swap_hash > 0);
+    TKET_ASSERT(swap_hash <= 28);
+    edges_bitset |= (1u << (swap_hash - 1));
+    swaps_code >>= 5;
+  }
+  return edges_bitset;
+}
+
+unsigned SwapSequenceTableFile::get_number_of_swaps(std::uint64_t swaps_code) {
+  unsigned num_swaps = 0;
+  while (swaps_code != 0) {
+    ++num_swaps;
+    swaps_code >>= 5;
+  }
+  return num_swaps;
+}
+
+vector<Swap> SwapSequenceTableFile::get_swaps(std::uint64_t swaps_code) {
+  vector<Swap> swaps;
+  while (swaps_code != 0) {
+    swaps.push_back(get_swap_from_hash(swaps_code & 0x1F));
+    swaps_code >>= 5;
+  }
+  return swaps;
+}
+
+}  // namespace tsa_internal
+}  // namespace tket
@@ -0,0 +1,163 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tktokenswap/SwapSequenceTableGenerator.hpp"
+
+#include <tkassert/Assert.hpp>
+#include <unordered_set>
+
+#include "tktokenswap/CanonicalRelabelling.hpp"
+
+using std::vector;
+
+namespace tket {
+namespace tsa_internal {
+
+namespace {
+
+// The tokens on vertices {0,1,...,7}, 3 bits per vertex;
+// the token on vertex v is stored in bits 3v, 3v+1, 3v+2.
+typedef std::uint32_t TokensCode;
+
+TokensCode get_initial_tokens() {
+  TokensCode tokens = 0;
+  for (unsigned vv = 0; vv < SwapSequenceTableFile::max_number_of_vertices;
+       ++vv) {
+    tokens |= vv << (3 * vv);
+  }
+  return tokens;
+}
+
+unsigned get_token(TokensCode tokens, size_t vertex) {
+  return (tokens >> (3 * vertex)) & 7;
+}
+
+TokensCode get_swapped_tokens(TokensCode tokens, const Swap& swap) {
+  const TokensCode t1 = get_token(tokens, swap.first);
+  const TokensCode t2 = get_token(tokens, swap.second);
+  tokens &= ~((TokensCode(7) << (3 * swap.first)) |
+              (TokensCode(7) << (3 * swap.second)));
+  return tokens | (t2 << (3 * swap.first)) | (t1 << (3 * swap.second));
+}
+
+struct SearchNode {
+  std::uint64_t swaps_code;
+  TokensCode tokens;
+  std::uint32_t edges_bitset;
+  std::uint64_t last_swap_hash;
+};
+
+// Relabels the vertices of a single swap sequence, found by the search,
+// so that it can be looked up.
+SwapSequenceTableFile::Record get_record(
+    const SearchNode& node, CanonicalRelabelling& relabeller) {
+  // Only the vertices touched by the swaps are included, as for lookups;
+  // tokens never leave them. The token which ends up at vertex v started at
+  // the vertex with the same number as the token.
+  VertexMapping mapping;
+  for (const auto& swap : SwapSequenceTableFile::get_swaps(node.swaps_code)) {
+    mapping[get_token(node.tokens, swap.first)] = swap.first;
+    mapping[get_token(node.tokens, swap.second)] = swap.second;
+  }
+  const auto& relabelling = relabeller(mapping);
+  TKET_ASSERT(!relabelling.identity);
+  TKET_ASSERT(!relabelling.too_many_vertices);
+
+  SwapSequenceTableFile::Record record;
+  record.swaps_code = 0;
+  unsigned shift = 0;
+  for (const auto& swap : SwapSequenceTableFile::get_swaps(node.swaps_code)) {
+    const auto new_swap = get_swap(
+        relabelling.old_to_new_vertices.at(swap.first),
+        relabelling.old_to_new_vertices.at(swap.second));
+    record.swaps_code |= SwapSequenceTableFile::get_hash_from_swap(new_swap)
+                         << shift;
+    shift += 5;
+  }
+  record.permutation_hash = relabelling.permutation_hash;
+  record.edges_bitset =
+      SwapSequenceTableFile::get_edges_bitset(record.swaps_code);
+  return record;
+}
+
+}  // namespace
+
+vector<SwapSequenceTableFile::Record> SwapSequenceTableGenerator::get_records(
+    const vector<Swap>& edges, unsigned max_number_of_swaps) {
+  TKET_ASSERT(
+      max_number_of_swaps <= SwapSequenceTableFile::max_number_of_swaps);
+  vector<std::uint64_t> swap_hashes;
+  swap_hashes.reserve(edges.size());
+  for (const auto& edge : edges) {
+    swap_hashes.push_back(SwapSequenceTableFile::get_hash_from_swap(edge));
+  }
+  const auto initial_tokens = get_initial_tokens();
+
+  // Key: the tokens in the low 24 bits, the edges bitset above them.
+  std::unordered_set<std::uint64_t> seen_keys;
+  seen_keys.insert(initial_tokens);
+  vector<SearchNode> current_layer(1);
+  current_layer[0].swaps_code = 0;
+  current_layer[0].tokens = initial_tokens;
+  current_layer[0].edges_bitset = 0;
+  current_layer[0].last_swap_hash = 0;
+  vector<SearchNode> next_layer;
+
+  CanonicalRelabelling relabeller(
+      SwapSequenceTableFile::max_number_of_vertices);
+  vector<SwapSequenceTableFile::Record> records;
+
+  for (unsigned depth = 0; depth < max_number_of_swaps; ++depth) {
+    next_layer.clear();
+    for (const auto& node : current_layer) {
+      for (unsigned ii = 0; ii < edges.size(); ++ii) {
+        const auto swap_hash = swap_hashes[ii];
+        if (swap_hash == node.last_swap_hash) {
+          // Repeating a swap just undoes it.
+          continue;
+        }
+        SearchNode new_node;
+        new_node.tokens = get_swapped_tokens(node.tokens, edges[ii]);
+        new_node.edges_bitset = node.edges_bitset | (1u << (swap_hash - 1));
+        const std::uint64_t key =
+            new_node.tokens | (std::uint64_t(new_node.edges_bitset) << 24);
+        if (!seen_keys.insert(key).second) {
+          continue;
+        }
+        new_node.swaps_code = node.swaps_code | (swap_hash << (5 * depth));
+        new_node.last_swap_hash = swap_hash;
+        next_layer.push_back(new_node);
+        if (new_node.tokens != initial_tokens) {
+          records.push_back(get_record(new_node, relabeller));
+        }
+      }
+    }
+    current_layer.swap(next_layer);
+  }
+  return records;
+}
+
+void SwapSequenceTableGenerator::write_file(
+    const std::string& filename, const vector<vector<Swap>>& graphs,
+    unsigned max_number_of_swaps) {
+  vector<SwapSequenceTableFile::Record> all_records;
+  for (const auto& edges : graphs) {
+    const auto records = get_records(edges, max_number_of_swaps);
+    all_records.insert(all_records.end(), records.cbegin(), records.cend());
+  }
+  SwapSequenceTableFile::write_file(filename, std::move(all_records));
+}
+
+}  // namespace tsa_internal
+}  // namespace tket
@@ -48,6 +48,12 @@ class BestFullTsa : public tsa_internal::PartialTsaInterface {
       DistancesInterface& distances, NeighboursInterface& neighbours,
       tsa_internal::RiverFlowPathFinder& path_finder) override;
 
+  /** Access the options controlling cycle growth in the underlying
+   *  cycles TSA, to change if desired. Different options give different
+   *  (possibly shorter) solutions.
+   */
+  tsa_internal::CyclesGrowthManager::Options& get_cycles_growth_options();
+
  private:
   tsa_internal::HybridTsa m_hybrid_tsa;
   tsa_internal::SwapListOptimiser m_swap_list_optimiser;
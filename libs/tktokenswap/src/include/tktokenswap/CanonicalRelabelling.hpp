@@ -45,8 +45,12 @@ namespace tsa_internal {
 // these, after suitable vertex relabelling. This follows because permutations
 // can be decomposed into disjoint cycles.
 //
+// The same scheme works unchanged for up to 9 vertices (e.g., 8 = 4+2+2 -> 422
+// on [0,1,...,7]), which is used by the larger tables in
+// SwapSequenceTableFile.
+//
 
-/** Given a permutation with arbitrary vertex labels, currently size <= 6, we
+/** Given a permutation with arbitrary vertex labels, by default size <= 6, we
  * want to relabel the vertices so that we can look up an isomorphic mapping in
  * a table. This class gives one possible way. Still some scope for research and
  * improvement here; we want to cut down the number of "isomorphic" copies as
@@ -57,8 +61,8 @@ class CanonicalRelabelling {
  public:
   /** For looking up mappings in the table. */
   struct Result {
-    /** Will be empty if there are too many vertices. (Current limit is 6,
-     * although this may be updated in future). */
+    /** Will be empty if there are too many vertices. (The limit is set in
+     * the constructor, and is 6 by default). */
     VertexMapping old_to_new_vertices;
 
     /** Element[i], for new vertex i, is the old vertex number which corresponds
@@ -66,7 +70,7 @@ class CanonicalRelabelling {
      */
     std::vector<size_t> new_to_old_vertices;
 
-    /** Set equal to zero if too many vertices. Any permutation on <= 6 vertices
+    /** Set equal to zero if too many vertices. Any permutation on <= N vertices
      * is assigned a number, to be looked up in the table. 0 is the identity
      * permutation. */
     unsigned permutation_hash;
@@ -87,10 +91,20 @@ class CanonicalRelabelling {
    */
   const Result& operator()(const VertexMapping& desired_mapping);
 
-  CanonicalRelabelling();
+  /** @param max_number_of_vertices Mappings with more vertices than this
+   * are rejected (with too_many_vertices set). Must be between 2 and 9;
+   * the default 6 matches the compiled-in SwapSequenceTable.
+   */
+  explicit CanonicalRelabelling(unsigned max_number_of_vertices = 6);
+
+  /** The limit passed to the constructor.
+   * @return The largest number of vertices which can be relabelled.
+   */
+  unsigned get_max_number_of_vertices() const;
 
  private:
   Result m_result;
+  unsigned m_max_number_of_vertices;
 
   VertexMapping m_desired_mapping;
   VertexMapping m_work_mapping;
@@ -75,6 +75,9 @@ class CyclesPartialTsa : public PartialTsaInterface {
       DistancesInterface& distances, NeighboursInterface& neighbours,
       RiverFlowPathFinder& path_finder) override;
 
+  /** Access the options controlling cycle growth, to change if desired. */
+  CyclesGrowthManager::Options& get_growth_options();
+
  private:
   /** Stores cycles, and controls the growth and discarding of cycles.
    *  We grow the cycles one vertex at a time until we reach a good cycle
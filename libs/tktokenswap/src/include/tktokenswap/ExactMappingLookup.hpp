@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include "CanonicalRelabelling.hpp"
+#include "SwapSequenceTableFile.hpp"
 
 namespace tket {
 namespace tsa_internal {
@@ -22,9 +25,25 @@ namespace tsa_internal {
 /** Given a raw vertex->vertex mapping which must be enacted exactly (no empty
  * tokens), attempt to find an optimal or near-optimal result in a table, and
  * handle all vertex back-and-forth relabelling.
+ *
+ * The compiled-in SwapSequenceTable is always used, for mappings on <= 6
+ * vertices. If a SwapSequenceTableFile is also available, it is searched as
+ * well, and mappings on up to 8 vertices can be looked up.
  */
 class ExactMappingLookup {
  public:
+  /** Uses the global SwapSequenceTableFile, if one has been set
+   * (see SwapSequenceTableFile::set_global_table_filename).
+   */
+  ExactMappingLookup();
+
+  /** Uses the given extra table rather than the global one.
+   * @param file_table An extra table to search (may be null, in which case
+   * only the compiled-in table is used).
+   */
+  explicit ExactMappingLookup(
+      std::shared_ptr<const SwapSequenceTableFile> file_table);
+
   /** If successful, "swaps" will contain a vector of swaps which performs the
    * desired mapping. */
   struct Result {
@@ -58,9 +77,18 @@ class ExactMappingLookup {
       const VertexMapping& desired_mapping, const std::vector<Swap>& edges,
       unsigned max_number_of_swaps = 16);
 
+  /** The largest mapping which can be looked up.
+   * @return 6 for the compiled-in table alone, or 8 with a table file.
+   */
+  unsigned get_max_number_of_vertices() const;
+
  private:
   Result m_result;
   CanonicalRelabelling m_relabeller;
+  std::shared_ptr<const SwapSequenceTableFile> m_file_table;
+
+  /** 6 for the compiled-in table alone, or 8 with a table file. */
+  unsigned m_max_number_of_vertices;
 
   /** Attempts to fill m_result, given the relabelling to use.
    * If m_result already has a valid solution (i.e., "success" == true),
@@ -74,6 +102,17 @@ class ExactMappingLookup {
   void fill_result_from_table(
       const CanonicalRelabelling::Result& relabelling_result,
       const std::vector<Swap>& old_edges, unsigned max_number_of_swaps);
+
+  /** As fill_result_from_table, but using the table file (which must exist).
+   * @param relabelling_result The result of relabelling, for lookup in the raw
+   * table.
+   * @param old_edges Edges which exist between the vertices before relabelling.
+   * @param max_number_of_swaps Stop looking once the swap sequences exceed this
+   * length.
+   */
+  void fill_result_from_file_table(
+      const CanonicalRelabelling::Result& relabelling_result,
+      const std::vector<Swap>& old_edges, unsigned max_number_of_swaps);
 };
 
 }  // namespace tsa_internal
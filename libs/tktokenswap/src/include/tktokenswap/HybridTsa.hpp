@@ -43,6 +43,11 @@ class HybridTsa : public PartialTsaInterface {
       DistancesInterface& distances, NeighboursInterface& neighbours,
       RiverFlowPathFinder& path_finder) override;
 
+  /** Access the options controlling cycle growth in the cycles TSA,
+   *  to change if desired.
+   */
+  CyclesGrowthManager::Options& get_cycles_growth_options();
+
  private:
   CyclesPartialTsa m_cycles_tsa;
   TrivialTSA m_trivial_tsa;
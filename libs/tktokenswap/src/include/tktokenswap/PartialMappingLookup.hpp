@@ -64,6 +64,12 @@ class PartialMappingLookup {
       const std::set<size_t>& vertices_with_tokens_at_start,
       unsigned max_number_of_swaps = 16);
 
+  /** The largest mapping which can be looked up, so that callers can resize
+   * their mappings to make full use of the available tables.
+   * @return The maximum number of vertices for the underlying exact lookup.
+   */
+  unsigned get_max_number_of_vertices() const;
+
  private:
   Parameters m_parameters;
   ExactMappingLookup m_exact_mapping_lookup;
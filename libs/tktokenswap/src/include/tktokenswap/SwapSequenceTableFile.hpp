@@ -0,0 +1,194 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tktokenswap/SwapFunctions.hpp"
+
+namespace tket {
+namespace tsa_internal {
+
+/*
+NOTE on ENCODING: the compiled-in SwapSequenceTable only knows about swaps
+on the vertices {0,1,2,3,4,5}, with 4 bits per swap. Here we allow the
+vertices {0,1,...,7}, i.e. 28 possible swaps, so 5 bits are needed per swap
+and a 64-bit code can hold a sequence of length <= 12.
+
+As before, the possible swaps (01), (02), ..., (67) are listed in order and
+given the values 1,2,...,28; 0 means "no swap". The first swap is stored in
+the least significant bits. Thus, every nonzero field of a code is nonzero,
+and so sorting codes by value sorts them by length first.
+
+The file layout is a fixed 32-byte header followed by a sorted array of
+16-byte records, so that it can be memory-mapped and searched directly:
+
+  char[8]   magic       "TKSWPSEQ"
+  uint32    byte order  0x01020304, in the byte order of the writing machine
+  uint32    version     currently 1
+  uint64    number of records
+  uint64    reserved    0
+
+  Record[]  sorted by (permutation_hash, swaps_code), with no duplicates.
+
+Files are written in native byte order; a file written on a machine with a
+different byte order is rejected when loaded, rather than converted.
+*/
+
+/** A table of swap sequences on the vertices {0,1,...,7}, in the same spirit
+ * as SwapSequenceTable (see there for the meaning of the entries), but read
+ * from a binary file at runtime rather than compiled in. This allows far
+ * larger tables, covering permutations of 7 or 8 vertices, without growing
+ * the library binary. The data is created by SwapSequenceTableGenerator.
+ *
+ * On POSIX platforms the file is memory-mapped, so that loading is cheap and
+ * the data is shared between processes; elsewhere it is read into memory.
+ */
+class SwapSequenceTableFile {
+ public:
+  /** A single swap sequence on {0,1,...,7}. */
+  struct Record {
+    /** The swaps, 5 bits per swap; see the encoding notes above. */
+    std::uint64_t swaps_code;
+
+    /** The permutation hash (see CanonicalRelabelling) of the mapping
+     * which the swaps enact. */
+    std::uint32_t permutation_hash;
+
+    /** Bit (i-1) is set if and only if swap number i is used. */
+    std::uint32_t edges_bitset;
+  };
+
+  /** The largest number of vertices which can occur in a sequence. */
+  static constexpr unsigned max_number_of_vertices = 8;
+
+  /** The largest number of swaps which can be encoded in a single record. */
+  static constexpr unsigned max_number_of_swaps = 12;
+
+  /** The result of a lookup. */
+  struct LookupResult {
+    /** An integer encoding a sequence of swaps. 0 means no swaps. */
+    std::uint64_t swaps_code;
+
+    /** The number of swaps used. Set to max() if no valid sequence was found.
+     */
+    unsigned number_of_swaps;
+  };
+
+  /** Load (or memory-map) a table previously written by write_file.
+   * Throws if the file cannot be read, or is not a valid table.
+   * @param filename The file to read.
+   * @return The loaded table.
+   */
+  static std::unique_ptr<SwapSequenceTableFile> load(
+      const std::string& filename);
+
+  /** Write the given records to a file in the format described above.
+   * The records do not need to be sorted, and duplicates are removed.
+   * Throws if the file cannot be written.
+   * @param filename The file to write.
+   * @param records The swap sequences to store; all must be valid.
+   */
+  static void write_file(
+      const std::string& filename, std::vector<Record> records);
+
+  /** Set the file used by get_global_table. Nothing is read until the global
+   * table is first requested. An empty filename means that there is no
+   * global table (the default).
+   * @param filename The file which get_global_table should load.
+   */
+  static void set_global_table_filename(const std::string& filename);
+
+  /** The table named by set_global_table_filename, loaded the first time it
+   * is requested and then shared. Throws if the file is invalid.
+   * @return The global table, or null if no filename has been set.
+   */
+  static std::shared_ptr<const SwapSequenceTableFile> get_global_table();
+
+  /** Search for the shortest stored sequence enacting the permutation with
+   * the given hash, whose swaps all lie within the given edges.
+   * @param permutation_hash The hash of the desired permutation of
+   * {0,1,...,7}, after canonical relabelling.
+   * @param edges_bitset The edges on {0,1,...,7} which exist in the graph
+   * (i.e., the swaps which are allowed).
+   * @param max_num_swaps Don't return any sequence with more swaps than
+   * this.
+   * @return The shortest suitable sequence, or a null result if there is none.
+   */
+  LookupResult get_lookup_result(
+      unsigned permutation_hash, std::uint32_t edges_bitset,
+      unsigned max_num_swaps) const;
+
+  /** The total number of stored sequences.
+   * @return The number of records in the table.
+   */
+  size_t size() const;
+
+  /** Given a valid number 1-28, return the actual swap on {0,1,...,7}
+   * which it represents.
+   * @param x A code number representing a single swap.
+   * @return A single swap on vertices {0,1,...,7}.
+   */
+  static const Swap& get_swap_from_hash(std::uint64_t x);
+
+  /** The opposite of get_swap_from_hash.
+   * @param swap A swap (i,j) with 0 <= i < j <= 7.
+   * @return A number 1-28 which encodes that swap in the table.
+   */
+  static std::uint64_t get_hash_from_swap(const Swap& swap);
+
+  /** Which swaps are used in the code?
+   * @param swaps_code An integer representing a sequence of swaps.
+   * @return The set of swaps used in the sequence, encoded as a bitset.
+   */
+  static std::uint32_t get_edges_bitset(std::uint64_t swaps_code);
+
+  /** The number of swaps in a sequence.
+   * @param swaps_code An integer representing a sequence of swaps.
+   * @return The length of the swap sequence.
+   */
+  static unsigned get_number_of_swaps(std::uint64_t swaps_code);
+
+  /** Decode a sequence of swaps.
+   * @param swaps_code An integer representing a sequence of swaps.
+   * @return The swaps on {0,1,...,7}, in order.
+   */
+  static std::vector<Swap> get_swaps(std::uint64_t swaps_code);
+
+  ~SwapSequenceTableFile();
+  SwapSequenceTableFile(const SwapSequenceTableFile&) = delete;
+  SwapSequenceTableFile& operator=(const SwapSequenceTableFile&) = delete;
+
+ private:
+  SwapSequenceTableFile();
+
+  /** The records, sorted; they point either into the memory-mapped file
+   * or into m_owned_records. */
+  const Record* m_records_begin;
+  const Record* m_records_end;
+
+  /** Used only when the file could not be memory-mapped. */
+  std::vector<Record> m_owned_records;
+
+  /** The memory-mapped region (if any), to be unmapped on destruction. */
+  void* m_mapped_data;
+  size_t m_mapped_size;
+};
+
+}  // namespace tsa_internal
+}  // namespace tket
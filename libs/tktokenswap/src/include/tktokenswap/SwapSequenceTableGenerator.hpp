@@ -0,0 +1,66 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "SwapSequenceTableFile.hpp"
+
+namespace tket {
+namespace tsa_internal {
+
+/** Creates the data for a SwapSequenceTableFile, by a breadth-first search
+ * of all swap sequences on a given graph with <= 8 vertices, up to a given
+ * length. This is the same method used (offline) to create the compiled-in
+ * SwapSequenceTable.
+ *
+ * For every (permutation, set of swaps used) pair reached, only the first
+ * (hence shortest) sequence is kept; so every stored sequence is optimal
+ * amongst sequences using the same swaps. The permutations are then
+ * canonically relabelled (see CanonicalRelabelling), exactly as lookups are.
+ *
+ * Each added depth multiplies the work by roughly the number of edges,
+ * so complete graphs can only be searched to modest depths; but sparse
+ * graphs such as cycles, grids and heavy-hex fragments, which are what
+ * real devices contain, can be searched much further. Results from several
+ * graphs can simply be concatenated before writing.
+ */
+class SwapSequenceTableGenerator {
+ public:
+  /** Search all swap sequences of length <= max_number_of_swaps on the graph.
+   * @param edges The edges of the graph, i.e. the allowed swaps. Every vertex
+   * must be in {0,1,...,7}.
+   * @param max_number_of_swaps The search depth; must be <= 12.
+   * @return Records for every permutation reached, ready to be written with
+   * SwapSequenceTableFile::write_file.
+   */
+  static std::vector<SwapSequenceTableFile::Record> get_records(
+      const std::vector<Swap>& edges, unsigned max_number_of_swaps);
+
+  /** Convenience function: search each graph in turn, and write all the
+   * records to a single file.
+   * @param filename The file to write.
+   * @param graphs Each element is the edge list of a single graph.
+   * @param max_number_of_swaps The search depth for every graph.
+   */
+  static void write_file(
+      const std::string& filename,
+      const std::vector<std::vector<Swap>>& graphs,
+      unsigned max_number_of_swaps);
+};
+
+}  // namespace tsa_internal
+}  // namespace tket
@@ -0,0 +1,247 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <tktokenswap/ExactMappingLookup.hpp>
+#include <tktokenswap/GeneralFunctions.hpp>
+#include <tktokenswap/SwapListOptimiser.hpp>
+#include <tktokenswap/SwapListTableOptimiser.hpp>
+#include <tktokenswap/SwapSequenceTableFile.hpp>
+#include <tktokenswap/SwapSequenceTableGenerator.hpp>
+#include <tktokenswap/VertexMapResizing.hpp>
+#include <tktokenswap/VertexMappingFunctions.hpp>
+#include <tktokenswap/VertexSwapResult.hpp>
+
+#include "NeighboursFromEdges.hpp"
+
+using std::vector;
+
+namespace tket {
+namespace tsa_internal {
+namespace tests {
+
+static std::string get_temporary_filename(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// The cycle 0-1-2-...-(n-1)-0.
+static vector<Swap> get_cycle_edges(unsigned number_of_vertices) {
+  vector<Swap> edges;
+  for (unsigned ii = 0; ii < number_of_vertices; ++ii) {
+    edges.push_back(get_swap(ii, (ii + 1) % number_of_vertices));
+  }
+  return edges;
+}
+
+// Every record should enact the permutation given by its hash.
+static void check_records(
+    const vector<SwapSequenceTableFile::Record>& records) {
+  CanonicalRelabelling relabeller(
+      SwapSequenceTableFile::max_number_of_vertices);
+  for (const auto& record : records) {
+    const auto swaps = SwapSequenceTableFile::get_swaps(record.swaps_code);
+    REQUIRE(swaps.size() == SwapSequenceTableFile::get_number_of_swaps(
+                                record.swaps_code));
+    REQUIRE(
+        record.edges_bitset ==
+        SwapSequenceTableFile::get_edges_bitset(record.swaps_code));
+
+    // Element i is the token at vertex i.
+    VertexMapping tokens;
+    for (const auto& swap : swaps) {
+      tokens[swap.first];
+      tokens[swap.second];
+    }
+    for (auto& entry : tokens) {
+      entry.second = entry.first;
+    }
+    for (const auto& swap : swaps) {
+      std::swap(tokens[swap.first], tokens[swap.second]);
+    }
+    // The records are already canonically labelled, so relabelling the
+    // source->target mapping should give back the same hash.
+    const auto mapping = get_reversed_map(tokens);
+    const auto& relabelling = relabeller(mapping);
+    REQUIRE(!relabelling.identity);
+    REQUIRE(relabelling.permutation_hash == record.permutation_hash);
+  }
+}
+
+SCENARIO("Generate, write and read back a swap sequence table") {
+  const auto records =
+      SwapSequenceTableGenerator::get_records(get_cycle_edges(7), 6);
+  CHECK(!records.empty());
+  check_records(records);
+
+  const auto filename = get_temporary_filename("test_swap_table_c7.bin");
+  SwapSequenceTableFile::write_file(filename, records);
+  const auto table = SwapSequenceTableFile::load(filename);
+  CHECK(table->size() > 0);
+  CHECK(table->size() <= records.size());
+
+  // The rotation (0123456) on C7 needs 6 swaps.
+  const std::uint32_t full_edges = (1u << 28) - 1;
+  const auto rotation = table->get_lookup_result(7, full_edges, 12);
+  CHECK(rotation.number_of_swaps == 6);
+  CHECK(table->get_lookup_result(7, full_edges, 5).number_of_swaps > 6);
+
+  // A hash which does not occur.
+  CHECK(table->get_lookup_result(8, full_edges, 12).number_of_swaps > 12);
+  std::remove(filename.c_str());
+}
+
+SCENARIO("Invalid table files are rejected") {
+  const auto filename = get_temporary_filename("test_swap_table_bad.bin");
+  {
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << "This is not a table, but is longer than the header length.";
+  }
+  CHECK_THROWS_AS(SwapSequenceTableFile::load(filename), std::runtime_error);
+  std::remove(filename.c_str());
+  CHECK_THROWS_AS(SwapSequenceTableFile::load(filename), std::runtime_error);
+
+  // A well-formed header, but the single record has a swap number (29)
+  // which does not exist.
+  {
+    std::ofstream ofs(filename, std::ios::binary);
+    const char magic[8] = {'T', 'K', 'S', 'W', 'P', 'S', 'E', 'Q'};
+    const std::uint32_t byte_order = 0x01020304;
+    const std::uint32_t version = 1;
+    const std::uint64_t number_of_records = 1;
+    const std::uint64_t reserved = 0;
+    ofs.write(magic, sizeof(magic));
+    ofs.write(reinterpret_cast<const char*>(&byte_order), sizeof(byte_order));
+    ofs.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    ofs.write(
+        reinterpret_cast<const char*>(&number_of_records),
+        sizeof(number_of_records));
+    ofs.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+    const SwapSequenceTableFile::Record record{29, 7, 0};
+    ofs.write(reinterpret_cast<const char*>(&record), sizeof(record));
+  }
+  CHECK_THROWS_AS(SwapSequenceTableFile::load(filename), std::runtime_error);
+  std::remove(filename.c_str());
+}
+
+SCENARIO("Exact mapping lookup with a table file on 7 vertices") {
+  const auto filename = get_temporary_filename("test_swap_table_lookup.bin");
+  SwapSequenceTableGenerator::write_file(
+      filename, {get_cycle_edges(7), get_cycle_edges(6)}, 6);
+  std::shared_ptr<const SwapSequenceTableFile> table =
+      SwapSequenceTableFile::load(filename);
+
+  // A 7-cycle with arbitrary vertex labels.
+  const vector<size_t> vertices{3, 10, 11, 25, 40, 41, 100};
+  vector<Swap> edges;
+  VertexMapping desired_mapping;
+  for (unsigned ii = 0; ii < vertices.size(); ++ii) {
+    const auto next_v = vertices[(ii + 1) % vertices.size()];
+    edges.push_back(get_swap(vertices[ii], next_v));
+    desired_mapping[vertices[ii]] = next_v;
+  }
+  ExactMappingLookup compiled_only_lookup(nullptr);
+  CHECK(compiled_only_lookup(desired_mapping, edges).too_many_vertices);
+
+  ExactMappingLookup lookup(table);
+  const auto& result = lookup(desired_mapping, edges);
+  REQUIRE(result.success);
+  CHECK(!result.too_many_vertices);
+  CHECK(result.swaps.size() == 6);
+
+  // Now perform the swaps, and check that every token reaches home.
+  // Element i is the current token at vertex i.
+  auto tokens = desired_mapping;
+  for (const auto& swap : result.swaps) {
+    REQUIRE(std::find(edges.cbegin(), edges.cend(), swap) != edges.cend());
+    std::swap(tokens[swap.first], tokens[swap.second]);
+  }
+  CHECK(all_tokens_home(tokens));
+
+  // Too many swaps are needed.
+  CHECK(!lookup(desired_mapping, edges, 5).success);
+
+  // The global table is only loaded when requested.
+  SwapSequenceTableFile::set_global_table_filename(filename);
+  CHECK(SwapSequenceTableFile::get_global_table()->size() == table->size());
+  SwapSequenceTableFile::set_global_table_filename("");
+  CHECK(!SwapSequenceTableFile::get_global_table());
+  std::remove(filename.c_str());
+}
+
+// Optimise the swaps, with all 7 vertices of the cycle holding tokens,
+// and check that the result enacts the same mapping.
+static size_t get_optimised_size(const vector<Swap>& swaps) {
+  const auto edges = get_cycle_edges(7);
+  NeighboursFromEdges neighbours(edges);
+  VertexMapResizing map_resizing(neighbours);
+  SwapListTableOptimiser table_optimiser;
+  SwapListOptimiser general_optimiser;
+  SwapList swap_list;
+  VertexMapping vertex_mapping;
+  std::set<size_t> vertices_with_tokens;
+  for (const auto& swap : swaps) {
+    swap_list.push_back(swap);
+    vertex_mapping[swap.first] = swap.first;
+    vertex_mapping[swap.second] = swap.second;
+    vertices_with_tokens.insert(swap.first);
+    vertices_with_tokens.insert(swap.second);
+  }
+  for (const auto& swap : swaps) {
+    const VertexSwapResult vswap_result(swap, vertex_mapping);
+  }
+  table_optimiser.optimise(
+      vertices_with_tokens, map_resizing, swap_list, general_optimiser);
+
+  // Undo the original mapping with the new swaps, in reverse.
+  vector<Swap> optimised_swaps;
+  for (auto id_opt = swap_list.front_id(); id_opt;
+       id_opt = swap_list.next(id_opt.value())) {
+    optimised_swaps.push_back(swap_list.at(id_opt.value()));
+  }
+  for (auto citer = optimised_swaps.crbegin(); citer != optimised_swaps.crend();
+       ++citer) {
+    const VertexSwapResult vswap_result(*citer, vertex_mapping);
+  }
+  REQUIRE(all_tokens_home(vertex_mapping));
+  return swap_list.size();
+}
+
+SCENARIO("Swap list optimisation uses the table file on 7 vertices") {
+  const auto filename = get_temporary_filename("test_swap_table_list.bin");
+  SwapSequenceTableGenerator::write_file(filename, {get_cycle_edges(7)}, 6);
+
+  // This list moves tokens on all 7 vertices, and cannot be shortened
+  // using the compiled-in table on 6 vertices alone.
+  const vector<Swap> swaps{get_swap(2, 3), get_swap(5, 6), get_swap(4, 5),
+                           get_swap(3, 4), get_swap(5, 6), get_swap(2, 3),
+                           get_swap(0, 6), get_swap(1, 2)};
+
+  // The optimiser's lookup reads the global table when it is constructed.
+  SwapSequenceTableFile::set_global_table_filename("");
+  CHECK(get_optimised_size(swaps) == 8);
+  SwapSequenceTableFile::set_global_table_filename(filename);
+  CHECK(get_optimised_size(swaps) == 6);
+  SwapSequenceTableFile::set_global_table_filename("");
+  std::remove(filename.c_str());
+}
+
+}  // namespace tests
+}  // namespace tsa_internal
+}  // namespace tket
@@ -18,7 +18,7 @@ from conans.errors import ConanInvalidConfiguration
 
 class TkwsmConan(ConanFile):
     name = "tkwsm"
-    version = "0.2.1"
+    version = "0.3.0"
     license = "Apache 2"
     url = "https://github.com/CQCL/tket"
     description = "Weighted-subgraph-monomorphism algorithms library"
@@ -32,7 +32,7 @@ class TkwsmConan(ConanFile):
     generators = "cmake"
     exports_sources = "src/*"
     requires = [
-        "tkassert/0.1.1@tket/stable",
+        "tkassert/0.1.2@tket/stable",
         "tkrng/0.1.2@tket/stable",
         "boost/1.80.0",
     ]
@@ -64,3 +64,5 @@ class TkwsmConan(ConanFile):
 
     def package_info(self):
         self.cpp_info.libs = ["tkwsm"]
+        if self.settings.os == "Linux":
+            self.cpp_info.system_libs = ["pthread"]
@@ -16,7 +16,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <exception>
 #include <numeric>
+#include <thread>
 #include <tkassert/Assert.hpp>
 
 #include "tkwsm/Common/GeneralUtils.hpp"
@@ -30,15 +32,43 @@ namespace WeightedSubgraphMonomorphism {
 
 typedef std::chrono::steady_clock Clock;
 
+/** Everything a search branch changes as it runs,
+ * so that branches can run on separate threads.
+ */
+struct MainSolver::PortfolioBranch {
+  PreSearchComponents pre_search_components;
+  SearchComponents search_components;
+  SolutionData solution_data;
+  std::unique_ptr<SearchBranch> search_branch_ptr;
+
+  PortfolioBranch(
+      const NeighboursData& pattern_ndata, const NeighboursData& target_ndata,
+      const NearNeighboursData& precomputed_target_near_ndata,
+      const SolutionData& initial_solution_data)
+      : pre_search_components(
+            pattern_ndata, target_ndata, precomputed_target_near_ndata),
+        solution_data(initial_solution_data) {}
+};
+
 MainSolver::MainSolver(
     const GraphEdgeWeights& pattern_edges, const GraphEdgeWeights& target_edges,
     const MainSolverParameters& parameters)
+    : MainSolver(
+          pattern_edges,
+          // Nothing is shared, so calculate target distance data lazily.
+          std::make_shared<const TargetGraphData>(target_edges, 0),
+          parameters) {}
+
+MainSolver::MainSolver(
+    const GraphEdgeWeights& pattern_edges,
+    std::shared_ptr<const TargetGraphData> target_data,
+    const MainSolverParameters& parameters)
     : m_pattern_vertex_relabelling(pattern_edges),
-      m_target_vertex_relabelling(target_edges),
+      m_target_data_ptr(std::move(target_data)),
+      m_target_vertex_relabelling(m_target_data_ptr->get_relabelling()),
       m_pattern_neighbours_data(
           m_pattern_vertex_relabelling.new_edges_and_weights),
-      m_target_neighbours_data(
-          m_target_vertex_relabelling.new_edges_and_weights) {
+      m_target_neighbours_data(m_target_data_ptr->get_neighbours_data()) {
   const auto num_p_vertices =
       m_pattern_neighbours_data.get_number_of_nonisolated_vertices();
   if (num_p_vertices == 0) {
@@ -49,13 +79,7 @@ MainSolver::MainSolver(
   }
   const auto num_t_vertices =
       m_target_neighbours_data.get_number_of_nonisolated_vertices();
-  {
-    const auto number_of_possible_t_edges =
-        (num_t_vertices * (num_t_vertices - 1)) / 2;
-    m_solution_data.target_is_complete =
-        number_of_possible_t_edges ==
-        m_target_neighbours_data.get_number_of_edges();
-  }
+  m_solution_data.target_is_complete = m_target_data_ptr->is_complete();
 
   // Start off assuming that it's impossible. So L = +inf, U = 0 make
   // sense mathematically (infimum over empty set is +infinity, etc. etc.)
@@ -72,11 +96,13 @@ MainSolver::MainSolver(
   const auto init_start = Clock::now();
 
   m_pre_search_components_ptr = std::make_unique<PreSearchComponents>(
-      m_pattern_neighbours_data, m_target_neighbours_data);
+      m_pattern_neighbours_data, m_target_neighbours_data,
+      m_target_data_ptr->get_near_neighbours_data());
   TKET_ASSERT(m_pre_search_components_ptr);
 
+  // Kept for any portfolio branches, created once the weights are known.
+  DomainInitialiser::InitialDomains initial_domains;
   {
-    DomainInitialiser::InitialDomains initial_domains;
     const bool initialisation_succeeded =
         DomainInitialiser::full_initialisation(
             initial_domains, m_pattern_neighbours_data,
@@ -114,9 +140,8 @@ MainSolver::MainSolver(
         m_pattern_neighbours_data.get_weights_expensive();
     std::sort(p_weights.begin(), p_weights.end());
 
-    std::vector<WeightWSM> t_weights =
-        m_target_neighbours_data.get_weights_expensive();
-    std::sort(t_weights.begin(), t_weights.end());
+    const std::vector<WeightWSM>& t_weights =
+        m_target_data_ptr->get_sorted_weights();
 
     TKET_ASSERT(
         p_weights.size() == m_pattern_neighbours_data.get_number_of_edges());
@@ -162,6 +187,27 @@ MainSolver::MainSolver(
         m_solution_data.total_p_edge_weights);
   }
 
+  for (unsigned ii = 1; ii < parameters.number_of_threads; ++ii) {
+    auto branch_ptr = std::make_unique<PortfolioBranch>(
+        m_pattern_neighbours_data, m_target_neighbours_data,
+        m_target_data_ptr->get_near_neighbours_data(), m_solution_data);
+    // Diversify the variable and value orderings.
+    branch_ptr->search_components.rng.set_seed(ii);
+    branch_ptr->search_branch_ptr = std::make_unique<SearchBranch>(
+        initial_domains, m_pattern_neighbours_data,
+        branch_ptr->pre_search_components.pattern_near_ndata,
+        m_target_neighbours_data,
+        branch_ptr->pre_search_components.target_near_ndata,
+        parameters.max_distance_for_distance_reduction_during_search,
+        branch_ptr->solution_data.extra_statistics);
+    if (m_solution_data.trivial_weight_lower_bound !=
+        m_solution_data.trivial_weight_initial_upper_bound) {
+      branch_ptr->search_branch_ptr->activate_weight_checker(
+          m_solution_data.total_p_edge_weights);
+    }
+    m_portfolio_branches.push_back(std::move(branch_ptr));
+  }
+
   if (m_solution_data.initialisation_time_ms >= parameters.timeout_ms) {
     return;
   }
@@ -244,16 +290,99 @@ static bool terminate_with_enough_full_solutions(
          parameters.for_multiple_full_solutions_the_max_number_to_obtain;
 }
 
-void MainSolver::internal_solve(
-    const MainSolverParameters& parameters, std::size_t max_iterations,
-    const std::chrono::steady_clock::time_point& desired_end_time) {
-  if (m_solution_data.finished ||
-      terminate_with_enough_full_solutions(parameters, m_solution_data)) {
-    return;
+/** Do NOT backtrack, just move down directly from the current node as far as
+ * possible, i.e. a single solve iteration. Returns TRUE if we end with a full
+ * solution, false otherwise.
+ */
+static bool move_down_from_reduced_node(
+    SearchComponents& search_components, SearchBranch& search_branch,
+    const NeighboursData& target_ndata,
+    const SearchBranch::ReductionParameters& reduction_parameters) {
+  for (;;) {
+    const VariableOrdering::Result next_var_result =
+        search_components.variable_ordering.get_variable(
+            search_branch.get_domains_accessor_nonconst(),
+            search_components.rng);
+
+    if (next_var_result.empty_domain) {
+      return false;
+    }
+    if (!next_var_result.variable_opt) {
+      // If no variable to choose, it means we've got a full solution
+      // (every PV is assigned).
+      // Before we reached here, we already checked that any new pattern edges
+      // joining any newly assigned PV to an existing assigned PV
+      // ARE indeed mapped to valid target edges,
+      // so we don't need any further validity check.
+      break;
+    }
+    // We've chosen a variable (i.e., PV) to assign:
+    const VertexWSM& next_pv = next_var_result.variable_opt.value();
+
+    // Now choose a value (i.e., some TV in Domain(PV)).
+    // Thus the new assignment will be next_pv -> next_tv.
+    const VertexWSM next_tv = search_components.value_ordering.get_target_value(
+        search_branch.get_domains_accessor().get_domain(next_pv), target_ndata,
+        search_components.rng);
+
+    search_branch.move_down(next_pv, next_tv);
+    if (!search_branch.reduce_current_node(reduction_parameters)) {
+      return false;
+    }
   }
-  TKET_ASSERT(m_pre_search_components_ptr);
-  TKET_ASSERT(m_search_branch_ptr);
+  return true;
+}
+
+static void add_solution_from_final_node(
+    const MainSolverParameters& parameters, const SearchBranch& search_branch,
+    const SearchBranch::ReductionParameters& reduction_parameters,
+    SolutionData& solution_data) {
+  const DomainsAccessor& accessor = search_branch.get_domains_accessor();
+  const WeightWSM scalar_product = accessor.get_scalar_product();
 
+  TKET_ASSERT(
+      accessor.get_total_p_edge_weights() ==
+      solution_data.total_p_edge_weights);
+
+  TKET_ASSERT(scalar_product <= reduction_parameters.max_weight);
+
+  // We'll overwrite the solution into back().
+  if (parameters.for_multiple_full_solutions_the_max_number_to_obtain > 0 ||
+      solution_data.solutions.empty()) {
+    solution_data.solutions.emplace_back();
+  }
+  std::vector<std::pair<VertexWSM, VertexWSM>>& assignments =
+      solution_data.solutions.back().assignments;
+  const auto number_of_pv = accessor.get_number_of_pattern_vertices();
+  assignments.clear();
+  assignments.reserve(number_of_pv);
+
+  for (unsigned pv = 0; pv < number_of_pv; ++pv) {
+    const BitsetInformation bitset_information(accessor.get_domain(pv));
+    TKET_ASSERT(bitset_information.single_element);
+    assignments.emplace_back(pv, bitset_information.single_element.value());
+  }
+  solution_data.solutions.back().scalar_product = scalar_product;
+
+  solution_data.solutions.back().total_p_edges_weight =
+      solution_data.total_p_edge_weights;
+}
+
+/** Run a single search branch until it finishes, has enough solutions,
+ * reaches the iteration limit or the end time.
+ * @param shared_best_weight If set, the weight of the best solution found by
+ *    any branch; only strictly better solutions are then searched for.
+ */
+static void run_search(
+    const MainSolverParameters& parameters, SearchComponents& search_components,
+    SearchBranch& search_branch, const NeighboursData& target_ndata,
+    SolutionData& solution_data, std::size_t max_iterations,
+    const std::chrono::steady_clock::time_point& desired_end_time,
+    std::optional<WeightWSM> shared_best_weight) {
+  if (solution_data.finished ||
+      terminate_with_enough_full_solutions(parameters, solution_data)) {
+    return;
+  }
   SearchBranch::ReductionParameters reduction_parameters;
   decltype(reduction_parameters.max_weight) initial_weight_upper_bound;
 
@@ -264,9 +393,9 @@ void MainSolver::internal_solve(
     set_maximum(initial_weight_upper_bound);
   }
 
-  while (m_solution_data.iterations < max_iterations) {
+  while (solution_data.iterations < max_iterations) {
     // Set the maximum weight.
-    if (m_solution_data.solutions.empty()) {
+    if (solution_data.solutions.empty()) {
       // We have no solution yet.
       reduction_parameters.max_weight = initial_weight_upper_bound;
     } else {
@@ -280,29 +409,27 @@ void MainSolver::internal_solve(
         // should only have one, but previously we've stored more. So just
         // choose the best.
         {
-          auto best_scalar_product =
-              m_solution_data.solutions[0].scalar_product;
+          auto best_scalar_product = solution_data.solutions[0].scalar_product;
           unsigned best_index = 0;
-          for (unsigned index = 1; index < m_solution_data.solutions.size();
+          for (unsigned index = 1; index < solution_data.solutions.size();
                ++index) {
-            if (m_solution_data.solutions[index].scalar_product <
+            if (solution_data.solutions[index].scalar_product <
                 best_scalar_product) {
               best_scalar_product =
-                  m_solution_data.solutions[index].scalar_product;
+                  solution_data.solutions[index].scalar_product;
               best_index = index;
             }
           }
           if (best_index > 0) {
-            m_solution_data.solutions[0] =
-                m_solution_data.solutions[best_index];
+            solution_data.solutions[0] = solution_data.solutions[best_index];
           }
         }
-        m_solution_data.solutions.resize(1);
+        solution_data.solutions.resize(1);
         reduction_parameters.max_weight =
-            m_solution_data.solutions[0].scalar_product;
+            solution_data.solutions[0].scalar_product;
         if (reduction_parameters.max_weight == 0) {
           // We can't do better than zero!
-          m_solution_data.finished = true;
+          solution_data.finished = true;
           return;
         }
         // Make it strictly better.
@@ -311,35 +438,47 @@ void MainSolver::internal_solve(
             reduction_parameters.max_weight, initial_weight_upper_bound);
       }
     }
+    if (shared_best_weight) {
+      // Some branch already has a solution this good.
+      if (shared_best_weight.value() == 0) {
+        solution_data.finished = true;
+        return;
+      }
+      reduction_parameters.max_weight = std::min(
+          reduction_parameters.max_weight, shared_best_weight.value() - 1);
+    }
 
     if (reduction_parameters.max_weight <
-        m_solution_data.trivial_weight_lower_bound) {
-      m_solution_data.finished = true;
+        solution_data.trivial_weight_lower_bound) {
+      solution_data.finished = true;
       return;
     }
 
     // Now we can search!
-    ++m_solution_data.iterations;
+    ++solution_data.iterations;
 
     // On the first move ONLY, we don't backtrack; but we also haven't reduced.
-    if (m_solution_data.iterations == 1) {
-      if (!m_search_branch_ptr->reduce_current_node(reduction_parameters)) {
-        m_solution_data.finished = true;
+    if (solution_data.iterations == 1) {
+      if (!search_branch.reduce_current_node(reduction_parameters)) {
+        solution_data.finished = true;
         return;
       }
     } else {
-      if (!m_search_branch_ptr->backtrack(reduction_parameters)) {
-        m_solution_data.finished = true;
+      if (!search_branch.backtrack(reduction_parameters)) {
+        solution_data.finished = true;
         return;
       }
     }
-    if (move_down_from_reduced_node(reduction_parameters)) {
+    if (move_down_from_reduced_node(
+            search_components, search_branch, target_ndata,
+            reduction_parameters)) {
       // We've GOT a complete solution! Note that it MUST be good enough
       // to add, since we've set the max weight already.
       // We also already checked that we haven't yet got too many,
       // if we're storing more than one.
-      add_solution_from_final_node(parameters, reduction_parameters);
-      if (terminate_with_enough_full_solutions(parameters, m_solution_data)) {
+      add_solution_from_final_node(
+          parameters, search_branch, reduction_parameters, solution_data);
+      if (terminate_with_enough_full_solutions(parameters, solution_data)) {
         return;
       }
     }
@@ -349,82 +488,126 @@ void MainSolver::internal_solve(
   }
 }
 
-void MainSolver::add_solution_from_final_node(
-    const MainSolverParameters& parameters,
-    const SearchBranch::ReductionParameters& reduction_parameters) {
+void MainSolver::internal_solve(
+    const MainSolverParameters& parameters, std::size_t max_iterations,
+    const std::chrono::steady_clock::time_point& desired_end_time) {
+  if (m_solution_data.finished ||
+      terminate_with_enough_full_solutions(parameters, m_solution_data)) {
+    return;
+  }
   TKET_ASSERT(m_pre_search_components_ptr);
+  TKET_ASSERT(m_search_components_ptr);
   TKET_ASSERT(m_search_branch_ptr);
 
-  const DomainsAccessor& accessor = m_search_branch_ptr->get_domains_accessor();
-  const WeightWSM scalar_product = accessor.get_scalar_product();
-
-  TKET_ASSERT(
-      accessor.get_total_p_edge_weights() ==
-      m_solution_data.total_p_edge_weights);
-
-  TKET_ASSERT(scalar_product <= reduction_parameters.max_weight);
-
-  // We'll overwrite the solution into back().
-  if (parameters.for_multiple_full_solutions_the_max_number_to_obtain > 0 ||
-      m_solution_data.solutions.empty()) {
-    m_solution_data.solutions.emplace_back();
-  }
-  std::vector<std::pair<VertexWSM, VertexWSM>>& assignments =
-      m_solution_data.solutions.back().assignments;
-  const auto number_of_pv = accessor.get_number_of_pattern_vertices();
-  assignments.clear();
-  assignments.reserve(number_of_pv);
-
-  for (unsigned pv = 0; pv < number_of_pv; ++pv) {
-    const BitsetInformation bitset_information(accessor.get_domain(pv));
-    TKET_ASSERT(bitset_information.single_element);
-    assignments.emplace_back(pv, bitset_information.single_element.value());
+  if (!m_portfolio_branches.empty() &&
+      !parameters.terminate_with_first_full_solution &&
+      parameters.for_multiple_full_solutions_the_max_number_to_obtain == 0) {
+    portfolio_solve(parameters, max_iterations, desired_end_time);
+    return;
   }
-  m_solution_data.solutions.back().scalar_product = scalar_product;
-
-  m_solution_data.solutions.back().total_p_edges_weight =
-      m_solution_data.total_p_edge_weights;
+  run_search(
+      parameters, *m_search_components_ptr, *m_search_branch_ptr,
+      m_target_neighbours_data, m_solution_data, max_iterations,
+      desired_end_time, std::nullopt);
 }
 
-bool MainSolver::move_down_from_reduced_node(
-    const SearchBranch::ReductionParameters& reduction_parameters) {
-  TKET_ASSERT(m_search_components_ptr);
-  TKET_ASSERT(m_search_branch_ptr);
+void MainSolver::portfolio_solve(
+    const MainSolverParameters& parameters, std::size_t max_iterations,
+    const std::chrono::steady_clock::time_point& desired_end_time) {
+  // Every branch may take as many further iterations as the main search.
+  const std::size_t extra_iterations =
+      max_iterations - std::min(max_iterations, m_solution_data.iterations);
+  const auto get_limit = [](std::size_t iterations, std::size_t extra) {
+    const auto limit_opt = get_checked_sum(iterations, extra);
+    if (limit_opt) {
+      return limit_opt.value();
+    }
+    std::size_t limit;
+    set_maximum(limit);
+    return limit;
+  };
+  std::vector<std::size_t> branch_max_iterations;
+  for (const auto& branch_ptr : m_portfolio_branches) {
+    branch_max_iterations.push_back(
+        get_limit(branch_ptr->solution_data.iterations, extra_iterations));
+  }
+  const std::size_t round_length =
+      std::max<std::size_t>(1, parameters.iterations_between_bound_sharing);
 
   for (;;) {
-    const VariableOrdering::Result next_var_result =
-        m_search_components_ptr->variable_ordering.get_variable(
-            m_search_branch_ptr->get_domains_accessor_nonconst(),
-            m_search_components_ptr->rng);
-
-    if (next_var_result.empty_domain) {
-      return false;
+    // Within a round, the branches only see the best weight as it was at the
+    // start, so the outcome does not depend on thread timing.
+    std::optional<WeightWSM> shared_best_weight;
+    if (!m_solution_data.solutions.empty()) {
+      shared_best_weight = m_solution_data.solutions[0].scalar_product;
     }
-    if (!next_var_result.variable_opt) {
-      // If no variable to choose, it means we've got a full solution
-      // (every PV is assigned).
-      // Before we reached here, we already checked that any new pattern edges
-      // joining any newly assigned PV to an existing assigned PV
-      // ARE indeed mapped to valid target edges,
-      // so we don't need any further validity check.
-      break;
+    std::vector<std::exception_ptr> errors(m_portfolio_branches.size() + 1);
+    {
+      std::vector<std::thread> threads;
+      for (unsigned ii = 0; ii < m_portfolio_branches.size(); ++ii) {
+        threads.emplace_back([&, ii]() {
+          PortfolioBranch& branch = *m_portfolio_branches[ii];
+          try {
+            run_search(
+                parameters, branch.search_components, *branch.search_branch_ptr,
+                m_target_neighbours_data, branch.solution_data,
+                std::min(
+                    branch_max_iterations[ii],
+                    get_limit(branch.solution_data.iterations, round_length)),
+                desired_end_time, shared_best_weight);
+          } catch (...) {
+            errors[ii + 1] = std::current_exception();
+          }
+        });
+      }
+      try {
+        run_search(
+            parameters, *m_search_components_ptr, *m_search_branch_ptr,
+            m_target_neighbours_data, m_solution_data,
+            std::min(
+                max_iterations,
+                get_limit(m_solution_data.iterations, round_length)),
+            desired_end_time, shared_best_weight);
+      } catch (...) {
+        errors[0] = std::current_exception();
+      }
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+    }
+    for (const std::exception_ptr& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
     }
-    // We've chosen a variable (i.e., PV) to assign:
-    const VertexWSM& next_pv = next_var_result.variable_opt.value();
-
-    // Now choose a value (i.e., some TV in Domain(PV)).
-    // Thus the new assignment will be next_pv -> next_tv.
-    const VertexWSM next_tv =
-        m_search_components_ptr->value_ordering.get_target_value(
-            m_search_branch_ptr->get_domains_accessor().get_domain(next_pv),
-            m_target_neighbours_data, m_search_components_ptr->rng);
 
-    m_search_branch_ptr->move_down(next_pv, next_tv);
-    if (!m_search_branch_ptr->reduce_current_node(reduction_parameters)) {
-      return false;
+    // Collect the best solution into the main solution data,
+    // preferring earlier branches on ties.
+    bool finished = m_solution_data.finished;
+    bool out_of_iterations = m_solution_data.iterations >= max_iterations;
+    for (unsigned ii = 0; ii < m_portfolio_branches.size(); ++ii) {
+      const SolutionData& branch_data =
+          m_portfolio_branches[ii]->solution_data;
+      // A branch which has searched its whole tree has shown that nothing
+      // beats the best solution of ANY branch, since it pruned with that.
+      finished = finished || branch_data.finished;
+      out_of_iterations = out_of_iterations &&
+                          branch_data.iterations >= branch_max_iterations[ii];
+      if (!branch_data.solutions.empty() &&
+          (m_solution_data.solutions.empty() ||
+           branch_data.solutions[0].scalar_product <
+               m_solution_data.solutions[0].scalar_product)) {
+        m_solution_data.solutions.assign(1, branch_data.solutions[0]);
+      }
+    }
+    if (finished) {
+      m_solution_data.finished = true;
+      return;
+    }
+    if (out_of_iterations || Clock::now() >= desired_end_time) {
+      return;
     }
   }
-  return true;
 }
 
 }  // namespace WeightedSubgraphMonomorphism
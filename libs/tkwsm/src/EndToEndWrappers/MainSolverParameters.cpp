@@ -36,7 +36,9 @@ MainSolverParameters::MainSolverParameters(long long timeout_millisecs)
       // the WeightNogoodDetectorManager...but that would be
       // complicated.
       max_distance_for_domain_initialisation_distance_filter(2),
-      max_distance_for_distance_reduction_during_search(6) {}
+      max_distance_for_distance_reduction_during_search(6),
+      number_of_threads(1),
+      iterations_between_bound_sharing(1000) {}
 
 }  // namespace WeightedSubgraphMonomorphism
 }  // namespace tket
@@ -24,5 +24,13 @@ PreSearchComponents::PreSearchComponents(
       pattern_near_ndata(pattern_ndata),
       target_near_ndata(target_ndata) {}
 
+PreSearchComponents::PreSearchComponents(
+    const NeighboursData& pattern_nd, const NeighboursData& target_nd,
+    const NearNeighboursData& precomputed_target_near_ndata)
+    : pattern_ndata(pattern_nd),
+      target_ndata(target_nd),
+      pattern_near_ndata(pattern_ndata),
+      target_near_ndata(target_ndata, precomputed_target_near_ndata) {}
+
 }  // namespace WeightedSubgraphMonomorphism
 }  // namespace tket
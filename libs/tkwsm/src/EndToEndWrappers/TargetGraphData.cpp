@@ -0,0 +1,57 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tkwsm/EndToEndWrappers/TargetGraphData.hpp"
+
+#include <algorithm>
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+TargetGraphData::TargetGraphData(
+    const GraphEdgeWeights& target_edges, unsigned max_distance_to_precompute)
+    : m_relabelling(target_edges),
+      m_neighbours_data(m_relabelling.new_edges_and_weights),
+      m_near_neighbours_data(m_neighbours_data),
+      m_sorted_weights(m_neighbours_data.get_weights_expensive()) {
+  std::sort(m_sorted_weights.begin(), m_sorted_weights.end());
+  const auto num_t_vertices =
+      m_neighbours_data.get_number_of_nonisolated_vertices();
+  const auto number_of_possible_t_edges =
+      (num_t_vertices * (num_t_vertices - 1)) / 2;
+  m_is_complete =
+      number_of_possible_t_edges == m_neighbours_data.get_number_of_edges();
+  m_near_neighbours_data.precompute(max_distance_to_precompute);
+}
+
+const VertexRelabelling& TargetGraphData::get_relabelling() const {
+  return m_relabelling;
+}
+
+const NeighboursData& TargetGraphData::get_neighbours_data() const {
+  return m_neighbours_data;
+}
+
+const NearNeighboursData& TargetGraphData::get_near_neighbours_data() const {
+  return m_near_neighbours_data;
+}
+
+const std::vector<WeightWSM>& TargetGraphData::get_sorted_weights() const {
+  return m_sorted_weights;
+}
+
+bool TargetGraphData::is_complete() const { return m_is_complete; }
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
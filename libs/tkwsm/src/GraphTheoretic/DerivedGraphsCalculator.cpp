@@ -26,8 +26,7 @@ namespace WeightedSubgraphMonomorphism {
 void DerivedGraphsCalculator::fill_mid_vertices_for_length_two_paths(
     const NeighboursData& ndata, VertexWSM v) {
   m_mid_vertices_for_length_two_paths.clear();
-  const std::vector<std::pair<VertexWSM, WeightWSM>>& neighbours =
-      ndata.get_neighbours_and_weights(v);
+  const auto neighbours = ndata.get_neighbours_and_weights(v);
   for (const std::pair<VertexWSM, WeightWSM>& entry : neighbours) {
     const VertexWSM& v1 = entry.first;
     for (const std::pair<VertexWSM, WeightWSM>& v2_entry :
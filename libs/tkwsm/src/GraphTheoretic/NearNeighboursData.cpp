@@ -23,11 +23,41 @@ namespace tket {
 namespace WeightedSubgraphMonomorphism {
 
 NearNeighboursData::NearNeighboursData(const NeighboursData& ndata)
-    : m_ndata(ndata) {
+    : m_ndata(ndata), m_precomputed_data_ptr(nullptr) {
   m_data.resize(ndata.get_number_of_nonisolated_vertices());
   m_degree_counts_work_vector.reserve(m_data.size());
 }
 
+NearNeighboursData::NearNeighboursData(
+    const NeighboursData& ndata, const NearNeighboursData& precomputed_data)
+    : m_ndata(ndata), m_precomputed_data_ptr(&precomputed_data) {
+  TKET_ASSERT(&ndata == &precomputed_data.m_ndata);
+  m_data.resize(m_ndata.get_number_of_nonisolated_vertices());
+  m_copied_from_precomputed_data.resize(m_data.size());
+  m_degree_counts_work_vector.reserve(m_data.size());
+}
+
+void NearNeighboursData::precompute(unsigned max_distance) {
+  for (unsigned v = 0; v < m_data.size(); ++v) {
+    for (unsigned distance = 1; distance <= max_distance; ++distance) {
+      get_vertices_up_to_distance(v, distance);
+      get_degree_counts_at_exact_distance(v, distance);
+      get_degree_counts_up_to_distance(v, distance);
+    }
+  }
+}
+
+NearNeighboursData::VertexData& NearNeighboursData::get_vertex_data(
+    VertexWSM v) {
+  VertexData& data = m_data.at(v);
+  if (m_precomputed_data_ptr != nullptr &&
+      !m_copied_from_precomputed_data[v]) {
+    m_copied_from_precomputed_data[v] = true;
+    data = m_precomputed_data_ptr->m_data[v];
+  }
+  return data;
+}
+
 std::size_t NearNeighboursData::get_number_of_vertices() const {
   return m_ndata.get_number_of_nonisolated_vertices();
 }
@@ -36,7 +66,7 @@ const boost::dynamic_bitset<>&
 NearNeighboursData::get_vertices_at_exact_distance(
     VertexWSM v, unsigned distance) {
   TKET_ASSERT(distance > 0);
-  auto& list = m_data.at(v).vertices_at_exact_distance;
+  auto& list = get_vertex_data(v).vertices_at_exact_distance;
   if (list.empty()) {
     // Initialise with element[0], i.e. neighbours.
     list.emplace_back();
@@ -124,7 +154,7 @@ const FilterUtils::DegreeCounts&
 NearNeighboursData::get_degree_counts_at_exact_distance(
     VertexWSM v, unsigned distance) {
   std::vector<FilterUtils::DegreeCounts>& list =
-      m_data.at(v).degree_counts_for_exact_distance;
+      get_vertex_data(v).degree_counts_for_exact_distance;
   TKET_ASSERT(distance > 0);
   const unsigned index = distance - 1;
   if (index < list.size()) {
@@ -157,7 +187,7 @@ NearNeighboursData::get_degree_counts_at_exact_distance(
 
 const boost::dynamic_bitset<>& NearNeighboursData::get_vertices_up_to_distance(
     VertexWSM v, unsigned distance) {
-  auto& list = m_data.at(v).vertices_up_to_distance;
+  auto& list = get_vertex_data(v).vertices_up_to_distance;
   TKET_ASSERT(distance > 0);
   if (list.empty()) {
     list.resize(1);
@@ -188,7 +218,7 @@ NearNeighboursData::get_degree_counts_up_to_distance(
     VertexWSM v, unsigned distance) {
   // It seems easier to calculate degree counts from vertices,
   // than try to combine degree counts at different distances.
-  auto& list = m_data.at(v).degree_counts_up_to_max_distance;
+  auto& list = get_vertex_data(v).degree_counts_up_to_max_distance;
   TKET_ASSERT(distance > 0);
   if (list.empty()) {
     list.emplace_back(get_degree_counts_at_exact_distance(v, 1));
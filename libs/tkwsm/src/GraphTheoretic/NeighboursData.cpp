@@ -31,8 +31,7 @@ std::size_t NeighboursData::get_number_of_edges() const {
 std::vector<VertexWSM> NeighboursData::get_neighbours_expensive(
     VertexWSM v) const {
   std::vector<VertexWSM> result;
-  const std::vector<std::pair<VertexWSM, WeightWSM>>& neighbours_and_weights =
-      get_neighbours_and_weights(v);
+  const auto neighbours_and_weights = get_neighbours_and_weights(v);
   result.reserve(neighbours_and_weights.size());
   for (const std::pair<VertexWSM, WeightWSM>& entry : neighbours_and_weights) {
     result.push_back(entry.first);
@@ -41,7 +40,7 @@ std::vector<VertexWSM> NeighboursData::get_neighbours_expensive(
 }
 
 std::size_t NeighboursData::get_number_of_nonisolated_vertices() const {
-  return m_neighbours_and_weights.size();
+  return m_offsets.size() - 1;
 }
 
 NeighboursData::NeighboursData(const GraphEdgeWeights& edges_and_weights) {
@@ -77,8 +76,27 @@ NeighboursData::NeighboursData(const GraphEdgeWeights& edges_and_weights) {
     }
   }
   m_number_of_edges = ordered_edges_seen.size();
-  m_neighbours_and_weights.resize(vertices_seen.size());
 
+  // First count the degrees, to know where each neighbour list starts.
+  m_offsets.assign(vertices_seen.size() + 1, 0);
+  for (const EdgeWSM& edge : ordered_edges_seen) {
+    ++m_offsets[edge.first + 1];
+    ++m_offsets[edge.second + 1];
+  }
+  for (unsigned ii = 1; ii < m_offsets.size(); ++ii) {
+    m_offsets[ii] += m_offsets[ii - 1];
+  }
+  TKET_ASSERT(m_offsets.back() == 2 * m_number_of_edges);
+  m_neighbours_and_weights.resize(m_offsets.back());
+
+  // The next free position for each vertex.
+  std::vector<std::size_t> next_positions(
+      m_offsets.cbegin(), m_offsets.cend() - 1);
+
+  // The edges (v1,v2) are in lexicographic order with v1<v2.
+  // Thus the neighbours of each vertex v come out sorted:
+  // first the v1<v (from edges (v1,v), in increasing v1 order),
+  // then the v2>v (from edges (v,v2), in increasing v2 order).
   for (const EdgeWSM& edge : ordered_edges_seen) {
     const VertexWSM& v1 = edge.first;
     const VertexWSM& v2 = edge.second;
@@ -92,73 +110,69 @@ NeighboursData::NeighboursData(const GraphEdgeWeights& edges_and_weights) {
     } else {
       weight = edges_and_weights.at(std::make_pair(v2, v1));
     }
-    m_neighbours_and_weights[v1].emplace_back(v2, weight);
-    m_neighbours_and_weights[v2].emplace_back(v1, weight);
+    m_neighbours_and_weights[next_positions[v1]++] =
+        std::make_pair(v2, weight);
+    m_neighbours_and_weights[next_positions[v2]++] =
+        std::make_pair(v1, weight);
   }
-  for (std::vector<std::pair<VertexWSM, WeightWSM>>& neigh_data :
-       m_neighbours_and_weights) {
-    // Automatically sort by vertex first; lexicographic.
-    std::sort(neigh_data.begin(), neigh_data.end());
-    TKET_ASSERT(is_sorted_and_unique(neigh_data));
+  for (unsigned v = 0; v < vertices_seen.size(); ++v) {
+    TKET_ASSERT(next_positions[v] == m_offsets[v + 1]);
+    const auto neigh_data = get_neighbours_and_weights(v);
+    TKET_ASSERT(std::is_sorted(neigh_data.begin(), neigh_data.end()));
   }
 }
 
 std::optional<WeightWSM> NeighboursData::get_edge_weight_opt(
     VertexWSM v1, VertexWSM v2) const {
-  if (v1 >= m_neighbours_and_weights.size()) {
-    return {};
-  }
-  const std::vector<std::pair<VertexWSM, WeightWSM>>& v1_data =
-      m_neighbours_and_weights[v1];
+  const auto v1_data = get_neighbours_and_weights(v1);
   // (x,0) = (x,min) <= (x,w) <= (x+1, y) in lexicographic order
   std::pair<VertexWSM, WeightWSM> key;
   key.first = v2;
   key.second = 0;
-  const auto v2_citer = std::lower_bound(v1_data.cbegin(), v1_data.cend(), key);
-  if (v2_citer != v1_data.cend() && v2_citer->first == v2) {
+  const auto v2_citer = std::lower_bound(v1_data.begin(), v1_data.end(), key);
+  if (v2_citer != v1_data.end() && v2_citer->first == v2) {
     return v2_citer->second;
   }
   return {};
 }
 
 std::size_t NeighboursData::get_degree(VertexWSM v) const {
-  if (v >= m_neighbours_and_weights.size()) {
+  if (v + 1 >= m_offsets.size()) {
     return 0;
   }
-  return m_neighbours_and_weights[v].size();
+  return m_offsets[v + 1] - m_offsets[v];
 }
 
 std::vector<std::size_t> NeighboursData::get_sorted_degree_sequence_expensive(
     VertexWSM v) const {
   std::vector<std::size_t> result;
-  if (v >= m_neighbours_and_weights.size()) {
-    return result;
-  }
   for (const std::pair<VertexWSM, WeightWSM>& entry :
-       m_neighbours_and_weights[v]) {
+       get_neighbours_and_weights(v)) {
     result.push_back(get_degree(entry.first));
   }
   std::sort(result.begin(), result.end());
   return result;
 }
 
-const std::vector<std::pair<VertexWSM, WeightWSM>>&
+std::span<const std::pair<VertexWSM, WeightWSM>>
 NeighboursData::get_neighbours_and_weights(VertexWSM v) const {
-  if (v >= m_neighbours_and_weights.size()) {
-    return m_empty_data;
+  if (v + 1 >= m_offsets.size()) {
+    return {};
   }
-  return m_neighbours_and_weights[v];
+  return {
+      m_neighbours_and_weights.data() + m_offsets[v],
+      m_offsets[v + 1] - m_offsets[v]};
 }
 
 std::vector<WeightWSM> NeighboursData::get_weights_expensive() const {
   std::vector<WeightWSM> weights;
   weights.reserve(m_number_of_edges);
-  for (unsigned v1 = 0; v1 < m_neighbours_and_weights.size(); ++v1) {
+  for (unsigned v1 = 0; v1 + 1 < m_offsets.size(); ++v1) {
     // Every edge is implicitly stored twice, for (v1, v2) and (v2, v1).
     // To avoid duplicates, only write the weight when v1>v2.
     // The neighbour edges are stored with increasing v, as always.
     for (const std::pair<VertexWSM, WeightWSM>& inner_entry :
-         m_neighbours_and_weights[v1]) {
+         get_neighbours_and_weights(v1)) {
       const VertexWSM& v2 = inner_entry.first;
       if (v2 > v1) {
         break;
@@ -156,15 +156,20 @@ bool DomainsAccessor::alldiff_reduce_current_node(
 DomainsAccessor::IntersectionResult DomainsAccessor::intersect_domain_with_swap(
     VertexWSM pv, boost::dynamic_bitset<>& domain_mask) {
   auto& data_for_this_pv = m_raw_data.domains_data.at(pv);
-  domain_mask &= get_domain(pv);
+  const auto& existing_domain = data_for_this_pv.entries.top().domain;
 
   IntersectionResult result;
-  result.new_domain_size = domain_mask.count();
-  result.changed = get_domain_size(pv) != result.new_domain_size;
-  if (!result.changed) {
+  // The common case: nothing changes. The subset test can stop
+  // at the first block which differs, and doesn't need any bit counts.
+  if (existing_domain.is_subset_of(domain_mask)) {
+    result.changed = false;
     result.reduction_result = ReductionResult::SUCCESS;
     return result;
   }
+  // Now we know that the new domain is strictly smaller.
+  result.changed = true;
+  domain_mask &= existing_domain;
+  result.new_domain_size = domain_mask.count();
   if (result.new_domain_size == 0) {
     result.reduction_result = ReductionResult::NOGOOD;
     return result;
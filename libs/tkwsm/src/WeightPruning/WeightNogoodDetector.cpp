@@ -31,30 +31,44 @@ WeightNogoodDetector::WeightNogoodDetector(
     std::set<VertexWSM>& invalid_target_vertices)
     : m_pattern_neighbours_data(pattern_neighbours_data),
       m_target_neighbours_data(target_neighbours_data),
-      m_valid_target_vertices(std::move(initial_used_target_vertices)),
-      m_invalid_target_vertices(invalid_target_vertices) {}
+      m_number_of_valid_target_vertices(initial_used_target_vertices.size()),
+      m_invalid_target_vertices(invalid_target_vertices) {
+  // Isolated target vertices are invisible to NeighboursData,
+  // but could still be passed in.
+  std::size_t number_of_tv =
+      target_neighbours_data.get_number_of_nonisolated_vertices();
+  if (!initial_used_target_vertices.empty()) {
+    number_of_tv = std::max<std::size_t>(
+        number_of_tv, *initial_used_target_vertices.crbegin() + 1);
+  }
+  m_valid_target_vertices.resize(number_of_tv);
+  for (VertexWSM tv : initial_used_target_vertices) {
+    m_valid_target_vertices.set(tv);
+  }
+  WeightWSM max_weight;
+  set_maximum(max_weight);
+  m_minimum_t_weights_from_tv.assign(number_of_tv, max_weight);
+}
 
 std::size_t WeightNogoodDetector::get_number_of_possible_tv() const {
-  return m_valid_target_vertices.size();
+  return m_number_of_valid_target_vertices;
 }
 
 std::optional<WeightWSM> WeightNogoodDetector::get_min_weight_for_tv(
     VertexWSM tv) const {
-  if (m_valid_target_vertices.count(tv) == 0) {
+  if (tv >= m_valid_target_vertices.size() || !m_valid_target_vertices[tv]) {
     return {};
   }
-  const auto weight_opt = get_optional_value(m_minimum_t_weights_from_tv, tv);
-  if (weight_opt) {
-    return weight_opt;
+  WeightWSM& min_weight = m_minimum_t_weights_from_tv[tv];
+  if (!is_maximum(min_weight)) {
+    return min_weight;
   }
   // We must find the minimum weight, by looking at all neighbours.
-  WeightWSM min_weight;
-  set_maximum(min_weight);
-  const std::vector<std::pair<VertexWSM, WeightWSM>>& data =
-      m_target_neighbours_data.get_neighbours_and_weights(tv);
+  const auto data = m_target_neighbours_data.get_neighbours_and_weights(tv);
   for (const std::pair<VertexWSM, WeightWSM>& entry : data) {
     const VertexWSM& neighbour_tv = entry.first;
-    if (m_valid_target_vertices.count(neighbour_tv) == 0) {
+    if (neighbour_tv >= m_valid_target_vertices.size() ||
+        !m_valid_target_vertices[neighbour_tv]) {
       continue;
     }
     min_weight = std::min(min_weight, entry.second);
@@ -67,7 +81,6 @@ std::optional<WeightWSM> WeightNogoodDetector::get_min_weight_for_tv(
     // erasing invalid target vertices and updating neighbour lists.
     return {};
   }
-  m_minimum_t_weights_from_tv[tv] = min_weight;
   return min_weight;
 }
 
@@ -101,7 +114,10 @@ bool WeightNogoodDetector::fill_t_weight_lower_bounds_for_p_edges_containing_pv(
         weight = std::min(weight, weight_opt_for_tv.value());
       } else {
         m_invalid_target_vertices.insert(tv_again);
-        m_valid_target_vertices.erase(tv_again);
+        if (tv_again < m_valid_target_vertices.size() &&
+            m_valid_target_vertices.test_set(tv_again, false)) {
+          --m_number_of_valid_target_vertices;
+        }
       }
     }
 
@@ -141,9 +157,8 @@ WeightNogoodDetector::get_extra_scalar_product_lower_bound(
     // which could possibly contain f(pv).
     const auto minimum_t_weight = get_t_weight_lower_bound(pv1);
 
-    const std::vector<std::pair<VertexWSM, WeightWSM>>&
-        p_neighbours_and_weights =
-            m_pattern_neighbours_data.get_neighbours_and_weights(pv1);
+    const auto p_neighbours_and_weights =
+        m_pattern_neighbours_data.get_neighbours_and_weights(pv1);
 
     for (const std::pair<VertexWSM, WeightWSM>& pv2_weight_pair :
          p_neighbours_and_weights) {
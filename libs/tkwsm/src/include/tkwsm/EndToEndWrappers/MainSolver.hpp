@@ -15,12 +15,14 @@
 #pragma once
 #include <chrono>
 #include <memory>
+#include <vector>
 
 #include "../GraphTheoretic/NeighboursData.hpp"
 #include "../GraphTheoretic/VertexRelabelling.hpp"
 #include "../Searching/SearchBranch.hpp"
 #include "MainSolverParameters.hpp"
 #include "SolutionData.hpp"
+#include "TargetGraphData.hpp"
 
 namespace tket {
 namespace WeightedSubgraphMonomorphism {
@@ -41,6 +43,18 @@ class MainSolver {
       const GraphEdgeWeights& target_edges,
       const MainSolverParameters& parameters);
 
+  /** Upon construction, try to solve the problem, reusing target graph data
+   * which was calculated previously (and may be shared with other solvers,
+   * possibly running on other threads).
+   * @param pattern_edges The pattern graph, with edge weights
+   * @param target_data Data for the target graph.
+   * @param parameters Parameters which configure the solving algorithm.
+   */
+  MainSolver(
+      const GraphEdgeWeights& pattern_edges,
+      std::shared_ptr<const TargetGraphData> target_data,
+      const MainSolverParameters& parameters);
+
   ~MainSolver();
 
   /** After construction, do further solving, if the original solve terminated
@@ -61,10 +75,11 @@ class MainSolver {
 
  private:
   const VertexRelabelling m_pattern_vertex_relabelling;
-  const VertexRelabelling m_target_vertex_relabelling;
+  const std::shared_ptr<const TargetGraphData> m_target_data_ptr;
+  const VertexRelabelling& m_target_vertex_relabelling;
 
   NeighboursData m_pattern_neighbours_data;
-  NeighboursData m_target_neighbours_data;
+  const NeighboursData& m_target_neighbours_data;
 
   SolutionData m_solution_data;
   mutable SolutionData m_solution_data_original_vertices;
@@ -75,12 +90,12 @@ class MainSolver {
   std::unique_ptr<SearchComponents> m_search_components_ptr;
   std::unique_ptr<SearchBranch> m_search_branch_ptr;
 
-  /** Do NOT backtrack, just move down directly from the current node as far as
-   * possible, i.e. a single solve iteration. Returns TRUE if we end with a full
-   * solution, false otherwise.
+  /** Further search branches, each with its own search components and
+   * solution data, run alongside the main search when solving with several
+   * threads.
    */
-  bool move_down_from_reduced_node(
-      const SearchBranch::ReductionParameters& reduction_parameters);
+  struct PortfolioBranch;
+  std::vector<std::unique_ptr<PortfolioBranch>> m_portfolio_branches;
 
   /** Performs the solve.
    * We should NOT time things by timing each individual iteration and summing
@@ -92,9 +107,12 @@ class MainSolver {
       const MainSolverParameters& parameters, std::size_t max_iterations,
       const std::chrono::steady_clock::time_point& desired_end_time);
 
-  void add_solution_from_final_node(
-      const MainSolverParameters& parameters,
-      const SearchBranch::ReductionParameters& reduction_parameters);
+  /** Run the main search and all portfolio branches in rounds,
+   * sharing the best solution between rounds.
+   */
+  void portfolio_solve(
+      const MainSolverParameters& parameters, std::size_t max_iterations,
+      const std::chrono::steady_clock::time_point& desired_end_time);
 };
 
 }  // namespace WeightedSubgraphMonomorphism
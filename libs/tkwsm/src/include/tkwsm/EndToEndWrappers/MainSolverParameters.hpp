@@ -73,6 +73,29 @@ struct MainSolverParameters {
    */
   unsigned max_distance_for_distance_reduction_during_search;
 
+  /** How many search branches to run, each on its own thread.
+   * The first branch is the usual single-threaded search; each other branch
+   * searches the whole tree with differently seeded variable and value
+   * orderings, and all branches prune with the best solution weight found by
+   * any of them. If any branch completes its search, the best solution is
+   * optimal.
+   *
+   * Only used when a single best solution is wanted
+   * (terminate_with_first_full_solution is false and
+   * for_multiple_full_solutions_the_max_number_to_obtain is 0).
+   * The branches are created on construction, so this has no effect in later
+   * calls to "solve". With several branches, iterations_timeout applies to
+   * each branch separately, and the statistics are for the first branch only.
+   */
+  unsigned number_of_threads;
+
+  /** With several threads, how many search iterations each branch takes
+   * between exchanging the best solution weight. The branches interact only
+   * at these points, so unless a timeout cuts a round short, the result
+   * depends only on the parameters and not on thread scheduling.
+   */
+  std::size_t iterations_between_bound_sharing;
+
   /** Just set the timeout in milliseconds; the most common parameter. */
   explicit MainSolverParameters(long long timeout_ms = 1000);
 };
@@ -38,6 +38,13 @@ struct PreSearchComponents {
 
   PreSearchComponents(
       const NeighboursData& pattern_ndata, const NeighboursData& target_ndata);
+
+  /** The target distance data starts from data already calculated,
+   * e.g. shared between many solves with the same target graph.
+   */
+  PreSearchComponents(
+      const NeighboursData& pattern_ndata, const NeighboursData& target_ndata,
+      const NearNeighboursData& precomputed_target_near_ndata);
 };
 
 }  // namespace WeightedSubgraphMonomorphism
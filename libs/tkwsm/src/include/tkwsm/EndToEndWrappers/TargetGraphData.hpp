@@ -0,0 +1,80 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <vector>
+
+#include "../GraphTheoretic/NearNeighboursData.hpp"
+#include "../GraphTheoretic/NeighboursData.hpp"
+#include "../GraphTheoretic/VertexRelabelling.hpp"
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+/** Everything which the solver needs to know about the target graph
+ * which does not depend upon the pattern graph.
+ * When many problems are solved with the same target graph
+ * (e.g., placing many circuits onto a single device),
+ * this can be constructed once and passed to each MainSolver,
+ * rather than being recalculated every time.
+ * It is never altered after construction, so can be shared between
+ * solvers running concurrently on different threads.
+ */
+class TargetGraphData {
+ public:
+  /** Calculate all the data.
+   * @param target_edges The target graph, with edge weights.
+   * @param max_distance_to_precompute Distance data for all vertices, up to
+   * this distance, is calculated now (to be copied by each solver, rather
+   * than recalculated). Use 0 if the data will be used for only one solve,
+   * so that it is calculated lazily instead, only for the vertices which
+   * are needed.
+   */
+  TargetGraphData(
+      const GraphEdgeWeights& target_edges,
+      unsigned max_distance_to_precompute);
+
+  // The stored objects refer to each other, so must not move.
+  TargetGraphData(const TargetGraphData&) = delete;
+  TargetGraphData& operator=(const TargetGraphData&) = delete;
+
+  /** The target vertices are relabelled {0,1,2,...,N} internally.
+   * @return The relabelling data.
+   */
+  const VertexRelabelling& get_relabelling() const;
+
+  /** @return Neighbours data for the relabelled target graph. */
+  const NeighboursData& get_neighbours_data() const;
+
+  /** @return Distance data for the relabelled target graph; for reading
+   * only, so should be used to construct other NearNeighboursData objects.
+   */
+  const NearNeighboursData& get_near_neighbours_data() const;
+
+  /** @return All target edge weights, in increasing order. */
+  const std::vector<WeightWSM>& get_sorted_weights() const;
+
+  /** @return True if every pair of target vertices is joined by an edge. */
+  bool is_complete() const;
+
+ private:
+  const VertexRelabelling m_relabelling;
+  const NeighboursData m_neighbours_data;
+  NearNeighboursData m_near_neighbours_data;
+  std::vector<WeightWSM> m_sorted_weights;
+  bool m_is_complete;
+};
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -29,6 +29,26 @@ class NearNeighboursData {
  public:
   explicit NearNeighboursData(const NeighboursData& ndata);
 
+  /** Start from data already calculated for the same graph; e.g. target
+   * graph data which is reused by many solves. The data for a vertex is
+   * copied from "precomputed_data" the first time it is requested here,
+   * and anything not found there is then calculated lazily as usual.
+   * "precomputed_data" is only read, never altered, so can be shared
+   * between objects on different threads; it must outlive this object.
+   * @param ndata The graph data.
+   * @param precomputed_data Data calculated for the same NeighboursData
+   * object, e.g. by calling precompute.
+   */
+  NearNeighboursData(
+      const NeighboursData& ndata, const NearNeighboursData& precomputed_data);
+
+  /** Calculate and store all the data for every vertex, up to the given
+   * distance, so that no more calculation is needed for distances up to
+   * this value.
+   * @param max_distance The maximum distance to consider.
+   */
+  void precompute(unsigned max_distance);
+
   std::size_t get_number_of_vertices() const;
 
   /** Calculated lazily, on demand; returns a sorted list of vertices
@@ -89,6 +109,15 @@ class NearNeighboursData {
   // Element[v] gives data for vertex v. Lazy initialisation.
   std::vector<VertexData> m_data;
 
+  // If not null, read-only data to be copied from.
+  const NearNeighboursData* m_precomputed_data_ptr;
+
+  // Element[v] is true if m_data[v] has been copied from the precomputed data.
+  std::vector<bool> m_copied_from_precomputed_data;
+
+  // Returns m_data[v], but first copies the precomputed data, if necessary.
+  VertexData& get_vertex_data(VertexWSM v);
+
   // Will be used to fill the degree_counts.
   // The maximum size this can reach is the number of vertices.
   // Seems crude, but actually clearing and refilling this is
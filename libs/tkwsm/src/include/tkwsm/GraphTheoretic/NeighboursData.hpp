@@ -15,6 +15,7 @@
 #pragma once
 #include <map>
 #include <optional>
+#include <span>
 #include <utility>
 
 #include "GeneralStructs.hpp"
@@ -78,12 +79,13 @@ class NeighboursData {
 
   /** Return all the neighbouring vertices of v, together with
    * the edge weights, sorted by neighbouring vertex.
-   * The data is stored within this class, so time O(log (number of V)).
+   * The data is stored within this class, so time O(1).
    * @param v A vertex.
    * @return The neighbours of v and edge weights, sorted by vertex number.
+   * Only valid for as long as this object is alive.
    */
-  const std::vector<std::pair<VertexWSM, WeightWSM>>&
-  get_neighbours_and_weights(VertexWSM v) const;
+  std::span<const std::pair<VertexWSM, WeightWSM>> get_neighbours_and_weights(
+      VertexWSM v) const;
 
   /** Get the list of vertex degrees of all neighbours of v, sorted in
    * increasing order.
@@ -112,12 +114,16 @@ class NeighboursData {
   std::vector<WeightWSM> get_weights_expensive() const;
 
  private:
-  // Element[i] gives all neighbouring vertices and edge weights
-  // for vertex i, sorted by the neighbouring vertex numerical value.
-  std::vector<std::vector<std::pair<VertexWSM, WeightWSM>>>
-      m_neighbours_and_weights;
-
-  std::vector<std::pair<VertexWSM, WeightWSM>> m_empty_data;
+  // The neighbours of all vertices, stored contiguously
+  // ("compressed sparse row" format); this is used heavily
+  // during the search, so we want as few indirections as possible.
+  // The neighbouring vertices and edge weights for vertex i
+  // are the entries with indices [m_offsets[i], m_offsets[i+1]),
+  // sorted by the neighbouring vertex numerical value.
+  std::vector<std::pair<VertexWSM, WeightWSM>> m_neighbours_and_weights;
+
+  // Has size (number of vertices) + 1.
+  std::vector<std::size_t> m_offsets;
 
   std::size_t m_number_of_edges;
 };
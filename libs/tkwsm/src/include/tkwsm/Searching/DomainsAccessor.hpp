@@ -139,7 +139,7 @@ class DomainsAccessor {
   struct IntersectionResult {
     ReductionResult reduction_result;
 
-    // Only bother filling this in if it's NOT a nogood or new assignment.
+    // Only filled in if the domain changed.
     std::size_t new_domain_size;
 
     bool changed;
@@ -80,7 +80,10 @@ class WeightNogoodDetector {
   const NeighboursData& m_pattern_neighbours_data;
   const NeighboursData& m_target_neighbours_data;
 
-  mutable std::set<VertexWSM> m_valid_target_vertices;
+  // Element[tv] is true if TV could still be mapped to.
+  // A bitset rather than a std::set, since it is queried in inner loops.
+  mutable boost::dynamic_bitset<> m_valid_target_vertices;
+  mutable std::size_t m_number_of_valid_target_vertices;
 
   // As soon as a TV is newly discovered to be invalid,
   // meaning that no p-vertex could ever be assigned to it
@@ -98,15 +101,16 @@ class WeightNogoodDetector {
   // it's not "physically" const because of lazy evaluation,
   // as well as work data to avoid memory reallocation.
 
-  // KEY: a target vertex TV.
-  // VALUE: the smallest t-edge weight which can arise
-  //    from an edge containing TV.
+  // Element[tv] is the smallest t-edge weight which can arise
+  // from an edge containing TV, or the maximum value if not yet calculated.
+  // (The true value is never the maximum, since then TV would have
+  // no valid edges, and would be invalid).
   // Excludes target edges, if any, which can never arise
   // (i.e. containing at least one vertex which no pattern vertex
   // can ever map to).
   //
   // Mutable because it's lazily initialised.
-  mutable std::map<VertexWSM, WeightWSM> m_minimum_t_weights_from_tv;
+  mutable std::vector<WeightWSM> m_minimum_t_weights_from_tv;
 
   // Calculated only on first use, and cached;
   // if non-null, the minimum edge weight of any target edge
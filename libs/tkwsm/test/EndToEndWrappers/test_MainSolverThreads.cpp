@@ -0,0 +1,83 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <tkrng/RNG.hpp>
+#include <tkwsm/EndToEndWrappers/MainSolver.hpp>
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+// A connected graph: a path through all the vertices, plus random edges.
+static GraphEdgeWeights get_random_graph(
+    unsigned number_of_vertices, unsigned number_of_extra_edges, RNG& rng) {
+  GraphEdgeWeights edges;
+  for (unsigned ii = 0; ii + 1 < number_of_vertices; ++ii) {
+    edges[get_edge(ii, ii + 1)] = rng.get_size_t(1, 10);
+  }
+  while (edges.size() + 1 < number_of_vertices + number_of_extra_edges) {
+    const unsigned v1 = rng.get_size_t(number_of_vertices - 1);
+    const unsigned v2 = rng.get_size_t(number_of_vertices - 1);
+    if (v1 != v2) {
+      edges[get_edge(v1, v2)] = rng.get_size_t(1, 10);
+    }
+  }
+  return edges;
+}
+
+SCENARIO("Portfolio search with several threads") {
+  RNG rng;
+  const GraphEdgeWeights pattern_edges = get_random_graph(14, 10, rng);
+  const GraphEdgeWeights target_edges = get_random_graph(40, 100, rng);
+
+  MainSolverParameters parameters(100000);
+  parameters.iterations_timeout = 100000000;
+  const MainSolver single_solver(pattern_edges, target_edges, parameters);
+  const SolutionData& single_data = single_solver.get_solution_data();
+  REQUIRE(single_data.finished);
+  REQUIRE(single_data.solutions.size() == 1);
+  CHECK(single_data.solutions[0].get_errors(pattern_edges, target_edges) == "");
+
+  parameters.iterations_between_bound_sharing = 50;
+  for (unsigned number_of_threads : {2, 4}) {
+    parameters.number_of_threads = number_of_threads;
+    const MainSolver solver(pattern_edges, target_edges, parameters);
+    const SolutionData& data = solver.get_solution_data();
+    REQUIRE(data.finished);
+    REQUIRE(data.solutions.size() == 1);
+    CHECK(data.solutions[0].get_errors(pattern_edges, target_edges) == "");
+    CHECK(
+        data.solutions[0].scalar_product ==
+        single_data.solutions[0].scalar_product);
+  }
+
+  // Stopping early on iterations, the result is repeatable.
+  parameters.number_of_threads = 3;
+  parameters.iterations_timeout = 200;
+  const MainSolver solver1(pattern_edges, target_edges, parameters);
+  const MainSolver solver2(pattern_edges, target_edges, parameters);
+  const SolutionData& data1 = solver1.get_solution_data();
+  const SolutionData& data2 = solver2.get_solution_data();
+  CHECK(!data1.finished);
+  REQUIRE(data1.solutions.size() == 1);
+  REQUIRE(data2.solutions.size() == 1);
+  CHECK(data1.iterations == data2.iterations);
+  CHECK(data1.solutions[0].assignments == data2.solutions[0].assignments);
+  CHECK(
+      data1.solutions[0].scalar_product >=
+      single_data.solutions[0].scalar_product);
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -0,0 +1,104 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <tkrng/RNG.hpp>
+#include <tkwsm/EndToEndWrappers/MainSolver.hpp>
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+// A connected graph: a path through all the vertices, plus random edges.
+// The vertex labels are spread out, so that they must be relabelled.
+static GraphEdgeWeights get_random_graph(
+    unsigned number_of_vertices, unsigned number_of_extra_edges, RNG& rng) {
+  GraphEdgeWeights edges;
+  for (unsigned ii = 0; ii + 1 < number_of_vertices; ++ii) {
+    edges[get_edge(3 * ii, 3 * ii + 3)] = rng.get_size_t(1, 10);
+  }
+  while (edges.size() + 1 < number_of_vertices + number_of_extra_edges) {
+    const unsigned v1 = rng.get_size_t(number_of_vertices - 1);
+    const unsigned v2 = rng.get_size_t(number_of_vertices - 1);
+    if (v1 != v2) {
+      edges[get_edge(3 * v1, 3 * v2)] = rng.get_size_t(1, 10);
+    }
+  }
+  return edges;
+}
+
+SCENARIO("Reusing target graph data for several solves") {
+  RNG rng;
+  const GraphEdgeWeights target_edges = get_random_graph(30, 60, rng);
+  std::vector<GraphEdgeWeights> all_pattern_edges;
+  for (unsigned ii = 0; ii < 5; ++ii) {
+    all_pattern_edges.push_back(get_random_graph(4 + 2 * ii, ii, rng));
+  }
+  MainSolverParameters parameters(100000);
+  parameters.iterations_timeout = 100000000;
+
+  // The results should be identical to solving each problem from scratch.
+  std::vector<SolutionData> expected_data;
+  for (const auto& pattern_edges : all_pattern_edges) {
+    const MainSolver solver(pattern_edges, target_edges, parameters);
+    expected_data.push_back(solver.get_solution_data());
+    REQUIRE(expected_data.back().finished);
+  }
+  const auto check_data = [&](unsigned index, const SolutionData& data) {
+    const SolutionData& expected = expected_data[index];
+    CHECK(data.finished);
+    CHECK(data.iterations == expected.iterations);
+    REQUIRE(data.solutions.size() == expected.solutions.size());
+    for (unsigned jj = 0; jj < data.solutions.size(); ++jj) {
+      CHECK(
+          data.solutions[jj].assignments ==
+          expected.solutions[jj].assignments);
+      CHECK(
+          data.solutions[jj].scalar_product ==
+          expected.solutions[jj].scalar_product);
+      CHECK(
+          data.solutions[jj].get_errors(
+              all_pattern_edges[index], target_edges) == "");
+    }
+  };
+  for (unsigned max_distance : {0, 2, 6}) {
+    const auto target_data =
+        std::make_shared<const TargetGraphData>(target_edges, max_distance);
+    for (unsigned ii = 0; ii < all_pattern_edges.size(); ++ii) {
+      const MainSolver solver(all_pattern_edges[ii], target_data, parameters);
+      check_data(ii, solver.get_solution_data());
+    }
+  }
+  GIVEN("Solvers on several threads sharing the data") {
+    const auto target_data =
+        std::make_shared<const TargetGraphData>(target_edges, 6);
+    std::vector<SolutionData> all_data(all_pattern_edges.size());
+    std::vector<std::thread> threads;
+    for (unsigned ii = 0; ii < all_pattern_edges.size(); ++ii) {
+      threads.emplace_back([&, ii]() {
+        const MainSolver solver(all_pattern_edges[ii], target_data, parameters);
+        all_data[ii] = solver.get_solution_data();
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (unsigned ii = 0; ii < all_data.size(); ++ii) {
+      check_data(ii, all_data[ii]);
+    }
+  }
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -158,6 +158,39 @@ PYBIND11_MODULE(partition, m) {
       py::arg("method") = GraphColourMethod::Lazy,
       py::arg("cx_config") = CXConfigType::Snake);
 
+  py::class_<MeasurementReducer>(
+      m, "MeasurementReducer",
+      "Measurement reduction for an operator whose terms change over time. "
+      "The diagonalising circuit of each partition is kept between updates, "
+      "so removing terms needs no new circuits and added terms only need "
+      "circuits for the partitions they form.")
+      .def(
+          py::init<PauliPartitionStrat, GraphColourMethod, CXConfigType>(),
+          "Construct an empty reducer."
+          "\n\n:param strat: The `PauliPartitionStrat` to use."
+          "\n:param method: The `GraphColourMethod` to use."
+          "\n:param cx_config: Whenever diagonalisation is required, use "
+          "this configuration of CX gates",
+          py::arg("strat"), py::arg("method") = GraphColourMethod::Lazy,
+          py::arg("cx_config") = CXConfigType::Snake)
+      .def(
+          "add_terms", &MeasurementReducer::add_terms,
+          "Add Pauli strings to the operator. Strings already present are "
+          "ignored.",
+          py::arg("strings"))
+      .def(
+          "remove_terms", &MeasurementReducer::remove_terms,
+          "Remove Pauli strings from the operator. Strings not present are "
+          "ignored.",
+          py::arg("strings"))
+      .def(
+          "repartition", &MeasurementReducer::repartition,
+          "Partition all current strings from scratch, reusing the circuits "
+          "of unchanged partitions.")
+      .def(
+          "get_setup", &MeasurementReducer::get_setup,
+          ":return: a :py:class:`MeasurementSetup` for the current strings");
+
   m.def(
       "term_sequence", term_sequence,
       "Takes in a list of QubitPauliString objects and partitions them "
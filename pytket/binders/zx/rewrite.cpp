@@ -109,7 +109,13 @@ void init_rewrite(py::module &m) {
           "Identifies adjacent Pauli spiders where one is adjacent to a "
           "boundary. This rule applies I/O extensions to push the match into "
           "the interior from which it can be handled by "
-          ":py:meth:`remove_interior_paulis`.");
+          ":py:meth:`remove_interior_paulis`.")
+      .def_static(
+          "graphlike_reduction", &Rewrite::graphlike_reduction,
+          "Applies :py:meth:`remove_interior_cliffords` and "
+          ":py:meth:`remove_interior_paulis` until neither matches. Only the "
+          "neighbourhoods changed by each rewrite are revisited, rather than "
+          "rescanning the whole diagram.");
 }
 
 }  // namespace zx
@@ -0,0 +1,31 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Resetting the state that tket keeps between transform applications, so
+// that repeated benchmark iterations stay independent.
+
+#include "Circuit/SynthesisCache.hpp"
+
+namespace tket {
+namespace benchmarks {
+
+// Call with the timer paused before each timed application. Every iteration
+// should then do all of its own work, as on first use, rather than reuse the
+// results of earlier iterations.
+inline void reset_caches_for_iteration() { synthesis_cache().clear(); }
+
+}  // namespace benchmarks
+}  // namespace tket
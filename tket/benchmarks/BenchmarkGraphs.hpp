@@ -0,0 +1,128 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Families of device-like graphs shared by the benchmarks. Every graph is a
+// list of edges between vertices 0,1,...,n-1, in a fixed order (so that a
+// given seed always gives the same problem).
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace tket {
+namespace benchmarks {
+
+typedef std::vector<std::pair<unsigned, unsigned>> EdgeList;
+
+// Square grid of `width` x `width` vertices
+inline EdgeList square_grid(unsigned width) {
+  EdgeList edges;
+  for (unsigned x = 0; x < width; ++x) {
+    for (unsigned y = 0; y < width; ++y) {
+      const unsigned v = x * width + y;
+      if (x + 1 < width) edges.emplace_back(v, v + width);
+      if (y + 1 < width) edges.emplace_back(v, v + 1);
+    }
+  }
+  return edges;
+}
+
+// The cycle 0-1-...-(n-1)-0
+inline EdgeList ring(unsigned n_vertices) {
+  EdgeList edges;
+  for (unsigned v = 0; v < n_vertices; ++v) {
+    edges.emplace_back(v, (v + 1) % n_vertices);
+  }
+  return edges;
+}
+
+// Heavy-hex lattice: `n_rows` rows of `width` vertices, with consecutive
+// rows joined by bridge vertices on every fourth column, the columns
+// alternating between rows (as in IBM devices)
+inline EdgeList heavy_hex(unsigned n_rows, unsigned width) {
+  EdgeList edges;
+  for (unsigned r = 0; r < n_rows; ++r) {
+    for (unsigned c = 0; c + 1 < width; ++c) {
+      const unsigned v = r * width + c;
+      edges.emplace_back(v, v + 1);
+    }
+  }
+  unsigned next_vertex = n_rows * width;
+  for (unsigned r = 0; r + 1 < n_rows; ++r) {
+    for (unsigned c = 2 * (r % 2); c < width; c += 4) {
+      edges.emplace_back(r * width + c, next_vertex);
+      edges.emplace_back(next_vertex, (r + 1) * width + c);
+      ++next_vertex;
+    }
+  }
+  return edges;
+}
+
+// A connected random `degree`-regular graph on `n_vertices` vertices
+// (`n_vertices * degree` must be even), by the pairing model, retrying
+// until the result is simple and connected
+inline EdgeList random_regular(
+    unsigned n_vertices, unsigned degree, std::mt19937& rng) {
+  std::vector<unsigned> stubs(n_vertices * degree);
+  for (unsigned ii = 0; ii < stubs.size(); ++ii) {
+    stubs[ii] = ii / degree;
+  }
+  for (;;) {
+    std::shuffle(stubs.begin(), stubs.end(), rng);
+    std::set<std::pair<unsigned, unsigned>> edge_set;
+    bool simple = true;
+    for (unsigned ii = 0; simple && ii + 1 < stubs.size(); ii += 2) {
+      const unsigned v1 = std::min(stubs[ii], stubs[ii + 1]);
+      const unsigned v2 = std::max(stubs[ii], stubs[ii + 1]);
+      simple = v1 != v2 && edge_set.emplace(v1, v2).second;
+    }
+    if (!simple) continue;
+
+    // Check connectivity by repeatedly merging components.
+    std::vector<unsigned> component(n_vertices);
+    std::iota(component.begin(), component.end(), 0);
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (const auto& [v1, v2] : edge_set) {
+        const unsigned c = std::min(component[v1], component[v2]);
+        if (component[v1] != c || component[v2] != c) {
+          component[v1] = component[v2] = c;
+          changed = true;
+        }
+      }
+    }
+    if (std::all_of(component.cbegin(), component.cend(), [](unsigned c) {
+          return c == 0;
+        })) {
+      return {edge_set.cbegin(), edge_set.cend()};
+    }
+  }
+}
+
+inline unsigned number_of_vertices(const EdgeList& edges) {
+  unsigned n_vertices = 0;
+  for (const auto& [v1, v2] : edges) {
+    n_vertices = std::max(n_vertices, std::max(v1, v2) + 1);
+  }
+  return n_vertices;
+}
+
+}  // namespace benchmarks
+}  // namespace tket
@@ -0,0 +1,151 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "BenchmarkCaches.hpp"
+
+// tket includes
+#include "Circuit/Circuit.hpp"
+#include "Gate/Gate.hpp"
+#include "Gate/OpPtrFunctions.hpp"
+#include "Transformations/OptimisationPass.hpp"
+#include "Transformations/Transform.hpp"
+
+using namespace tket;
+using namespace tket::benchmarks;
+
+// Count heap allocations, to track the allocation traffic of the transforms
+static std::atomic<std::size_t> n_allocations{0};
+
+void* operator new(std::size_t size) {
+  n_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// A random circuit of single-qubit rotations and CX gates.
+Circuit random_circuit(unsigned n_qubits, unsigned n_gates) {
+  std::mt19937 rng(n_qubits * n_gates);
+  std::uniform_int_distribution<unsigned> qubit_dist(0, n_qubits - 1);
+  std::uniform_real_distribution<double> angle_dist(0., 2.);
+  const OpType rotations[] = {OpType::Rx, OpType::Ry, OpType::Rz};
+
+  Circuit circ(n_qubits);
+  for (unsigned ii = 0; ii < n_gates; ++ii) {
+    const unsigned q0 = qubit_dist(rng);
+    if (rng() % 2 == 0) {
+      circ.add_op<unsigned>(rotations[rng() % 3], angle_dist(rng), {q0});
+    } else {
+      const unsigned q1 = (q0 + 1 + rng() % (n_qubits - 1)) % n_qubits;
+      circ.add_op<unsigned>(OpType::CX, {q0, q1});
+    }
+  }
+  return circ;
+}
+
+void report_counts(benchmark::State& state, const Circuit& circ) {
+  state.counters["gates"] = circ.n_gates();
+  state.counters["cx"] = circ.count_gates(OpType::CX);
+}
+
+}  // namespace
+
+// Args: number of gates
+static void BM_FullPeepholeOptimise(benchmark::State& state) {
+  const Circuit circ = random_circuit(8, state.range(0));
+  const Transform transform = full_peephole_optimise();
+  Circuit result;
+  std::size_t allocations = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    result = circ;
+    reset_caches_for_iteration();
+    state.ResumeTiming();
+    const std::size_t before = n_allocations.load();
+    transform.apply(result);
+    allocations += n_allocations.load() - before;
+  }
+  report_counts(state, result);
+  state.counters["allocations"] = benchmark::Counter(
+      allocations, benchmark::Counter::kAvgIterations);
+}
+
+// Args: number of gates, number of threads
+static void BM_FullPeepholeOptimise_Windows(benchmark::State& state) {
+  const Circuit circ = random_circuit(8, state.range(0));
+  const Transform transform = full_peephole_optimise_parallel(
+      true, OpType::CX, 500, true, state.range(1));
+  Circuit result;
+  for (auto _ : state) {
+    state.PauseTiming();
+    result = circ;
+    reset_caches_for_iteration();
+    state.ResumeTiming();
+    transform.apply(result);
+  }
+  report_counts(state, result);
+}
+
+// Args: 1 to create the ops with get_op_ptr, 0 to construct them directly
+// (as get_op_ptr did before common ops were interned)
+static void BM_CommonOps(benchmark::State& state) {
+  const bool use_get_op_ptr = state.range(0) != 0;
+  const std::vector<std::pair<OpType, std::vector<Expr>>> ops{
+      {OpType::CX, {}},    {OpType::H, {}},       {OpType::S, {}},
+      {OpType::Sdg, {}},   {OpType::X, {}},       {OpType::Z, {}},
+      {OpType::Rz, {0.5}}, {OpType::Rz, {0.25}},  {OpType::Rx, {1.}},
+      {OpType::Ry, {1.5}}, {OpType::Rz, {0.123}}, {OpType::Rx, {0.456}}};
+  std::size_t allocations = 0;
+  for (auto _ : state) {
+    const std::size_t before = n_allocations.load();
+    for (const auto& [type, params] : ops) {
+      Op_ptr op;
+      if (use_get_op_ptr) {
+        op = get_op_ptr(type, params);
+      } else {
+        op = std::make_shared<const Gate>(type, params, 0);
+      }
+      benchmark::DoNotOptimize(op);
+    }
+    allocations += n_allocations.load() - before;
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      allocations, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_FullPeepholeOptimise)
+    ->RangeMultiplier(4)
+    ->Range(1000, 16000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FullPeepholeOptimise_Windows)
+    ->ArgsProduct({{1000, 4000, 16000}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_CommonOps)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
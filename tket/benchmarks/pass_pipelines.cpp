@@ -0,0 +1,301 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runtime, peak memory and output quality of the standard optimisation
+// passes over a small corpus of representative circuits. Each benchmark is
+// named <pass>/<family>/<qubits>. For trend tracking, run with
+//
+//   pass_pipelines --benchmark_out=results.json --benchmark_out_format=json
+//
+// and compare the "two_qubit_gates", "depth" and "peak_rss_kb" counters
+// alongside the timings.
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchmarkCaches.hpp"
+
+// tket includes
+#include "Circuit/CircUtils.hpp"
+#include "Circuit/Circuit.hpp"
+#include "Converters/Converters.hpp"
+#include "Transformations/BasicOptimisation.hpp"
+#include "Transformations/Decomposition.hpp"
+#include "Transformations/OptimisationPass.hpp"
+#include "Transformations/PauliOptimisation.hpp"
+#include "Transformations/ThreeQubitSquash.hpp"
+#include "Transformations/Transform.hpp"
+#include "ZX/Rewrite.hpp"
+
+using namespace tket;
+using namespace tket::benchmarks;
+
+namespace {
+
+////////////
+// Corpus //
+////////////
+
+Circuit qft(unsigned n_qubits) {
+  Circuit circ(n_qubits);
+  for (unsigned i = 0; i < n_qubits; ++i) {
+    circ.add_op<unsigned>(OpType::H, {i});
+    double angle = 0.5;
+    for (unsigned j = i + 1; j < n_qubits; ++j, angle /= 2) {
+      circ.add_op<unsigned>(OpType::CU1, angle, {j, i});
+    }
+  }
+  for (unsigned i = 0; i < n_qubits / 2; ++i) {
+    circ.add_op<unsigned>(OpType::SWAP, {i, n_qubits - 1 - i});
+  }
+  return circ;
+}
+
+// Cuccaro ripple-carry adder of two registers of (n_qubits - 2) / 2 bits,
+// with carry in on qubit 0 and carry out on the last qubit. The registers
+// are interleaved: b_i on qubit 2i + 1 and a_i on qubit 2i + 2.
+Circuit ripple_adder(unsigned n_qubits) {
+  const unsigned n_bits = (n_qubits - 2) / 2;
+  Circuit circ(n_qubits);
+  auto maj = [&circ](unsigned x, unsigned y, unsigned z) {
+    circ.add_op<unsigned>(OpType::CX, {z, y});
+    circ.add_op<unsigned>(OpType::CX, {z, x});
+    circ.add_op<unsigned>(OpType::CCX, {x, y, z});
+  };
+  auto uma = [&circ](unsigned x, unsigned y, unsigned z) {
+    circ.add_op<unsigned>(OpType::CCX, {x, y, z});
+    circ.add_op<unsigned>(OpType::CX, {z, x});
+    circ.add_op<unsigned>(OpType::CX, {x, y});
+  };
+  auto a = [](unsigned i) { return 2 * i + 2; };
+  auto b = [](unsigned i) { return 2 * i + 1; };
+  maj(0, b(0), a(0));
+  for (unsigned i = 1; i < n_bits; ++i) maj(a(i - 1), b(i), a(i));
+  circ.add_op<unsigned>(OpType::CX, {a(n_bits - 1), n_qubits - 1});
+  for (unsigned i = n_bits - 1; i > 0; --i) uma(a(i - 1), b(i), a(i));
+  uma(0, b(0), a(0));
+  return circ;
+}
+
+// The single-excitation part of a UCCSD ansatz under the Jordan-Wigner
+// encoding, with random amplitudes.
+Circuit uccsd_singles(unsigned n_qubits) {
+  std::mt19937 rng(n_qubits);
+  std::uniform_real_distribution<double> angle_dist(0., 2.);
+  Circuit circ(n_qubits);
+  for (unsigned p = 0; p < n_qubits; ++p) {
+    for (unsigned q = p + 1; q < n_qubits; ++q) {
+      const double t = angle_dist(rng);
+      for (const auto& [first, last] :
+           {std::pair{Pauli::X, Pauli::Y}, std::pair{Pauli::Y, Pauli::X}}) {
+        std::vector<Pauli> paulis{first};
+        paulis.insert(paulis.end(), q - p - 1, Pauli::Z);
+        paulis.push_back(last);
+        std::vector<unsigned> qubits(q - p + 1);
+        for (unsigned i = p; i <= q; ++i) qubits[i - p] = i;
+        circ.append_qubits(pauli_gadget(paulis, t), qubits);
+      }
+    }
+  }
+  return circ;
+}
+
+Circuit random_clifford_t(unsigned n_qubits) {
+  std::mt19937 rng(n_qubits);
+  std::uniform_int_distribution<unsigned> gate_dist(0, 3);
+  std::uniform_int_distribution<unsigned> qubit_dist(0, n_qubits - 1);
+  Circuit circ(n_qubits);
+  for (unsigned l = 0; l < 10 * n_qubits; ++l) {
+    for (unsigned q = 0; q < n_qubits; ++q) {
+      switch (gate_dist(rng)) {
+        case 0:
+          circ.add_op<unsigned>(OpType::H, {q});
+          break;
+        case 1:
+          circ.add_op<unsigned>(OpType::S, {q});
+          break;
+        case 2:
+          circ.add_op<unsigned>(OpType::T, {q});
+          break;
+        default: {
+          unsigned t = qubit_dist(rng);
+          if (t != q) circ.add_op<unsigned>(OpType::CX, {q, t});
+        }
+      }
+    }
+  }
+  return circ;
+}
+
+// Three rounds of QAOA for MaxCut on a ring
+Circuit qaoa_ring(unsigned n_qubits) {
+  std::mt19937 rng(n_qubits);
+  std::uniform_real_distribution<double> angle_dist(0., 2.);
+  Circuit circ(n_qubits);
+  for (unsigned q = 0; q < n_qubits; ++q) {
+    circ.add_op<unsigned>(OpType::H, {q});
+  }
+  for (unsigned round = 0; round < 3; ++round) {
+    const double gamma = angle_dist(rng);
+    const double beta = angle_dist(rng);
+    for (unsigned q = 0; q < n_qubits; ++q) {
+      const unsigned r = (q + 1) % n_qubits;
+      circ.add_op<unsigned>(OpType::CX, {q, r});
+      circ.add_op<unsigned>(OpType::Rz, gamma, {r});
+      circ.add_op<unsigned>(OpType::CX, {q, r});
+    }
+    for (unsigned q = 0; q < n_qubits; ++q) {
+      circ.add_op<unsigned>(OpType::Rx, beta, {q});
+    }
+  }
+  return circ;
+}
+
+// Every circuit is first expressed with CX, Rz and Rx only, which all the
+// passes below accept.
+Circuit prepare(Circuit circ) {
+  Transforms::decompose_multi_qubits_CX().apply(circ);
+  Transforms::decompose_ZX().apply(circ);
+  return circ;
+}
+
+const std::vector<std::pair<std::string, std::function<Circuit(unsigned)>>>
+    families = {
+        {"qft", qft},
+        {"adder", ripple_adder},
+        {"uccsd_singles", uccsd_singles},
+        {"clifford_t", random_clifford_t},
+        {"qaoa", qaoa_ring},
+};
+
+const std::vector<unsigned> sizes = {4, 8, 16};
+
+////////////////
+// Measuring //
+////////////////
+
+// Linux only: reset the peak resident set size of the process, so that it
+// can be attributed to the benchmark which follows. Elsewhere the peak is
+// reported as 0.
+void reset_peak_rss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  if (clear_refs) clear_refs << "5";
+}
+
+double peak_rss_kb() {
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmHWM:") {
+      double kb;
+      status >> kb;
+      return kb;
+    }
+    status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+  return 0;
+}
+
+void report_quality(
+    benchmark::State& state, const Circuit& input, const Circuit& output) {
+  state.counters["input_two_qubit_gates"] = input.count_n_qubit_gates(2);
+  state.counters["input_depth"] = input.depth();
+  state.counters["two_qubit_gates"] = output.count_n_qubit_gates(2);
+  state.counters["depth"] = output.depth();
+  state.counters["gates"] = output.n_gates();
+}
+
+void run_pass(
+    benchmark::State& state, const Transform& pass, const Circuit& input) {
+  Circuit result;
+  reset_peak_rss();
+  for (auto _ : state) {
+    state.PauseTiming();
+    result = input;
+    reset_caches_for_iteration();
+    state.ResumeTiming();
+    pass.apply(result);
+  }
+  state.counters["peak_rss_kb"] = peak_rss_kb();
+  report_quality(state, input, result);
+}
+
+// Conversion to a graph-like ZX diagram followed by the interior Clifford
+// and Pauli removals. There is no extraction back to a circuit, so quality is
+// measured by the number of vertices left.
+void run_zx(benchmark::State& state, const Circuit& input) {
+  using namespace zx;
+  const Rewrite to_graphlike = Rewrite::sequence(
+      {Rewrite::decompose_boxes(), Rewrite::rebase_to_zx(),
+       Rewrite::red_to_green(), Rewrite::spider_fusion(),
+       Rewrite::parallel_h_removal(), Rewrite::io_extension(),
+       Rewrite::separate_boundaries()});
+  const Rewrite reduction = Rewrite::graphlike_reduction();
+  unsigned n_vertices = 0;
+  reset_peak_rss();
+  for (auto _ : state) {
+    ZXDiagram diag = circuit_to_zx(input).first;
+    to_graphlike.apply(diag);
+    reduction.apply(diag);
+    n_vertices = diag.n_vertices();
+  }
+  state.counters["peak_rss_kb"] = peak_rss_kb();
+  state.counters["zx_vertices"] = n_vertices;
+}
+
+void register_benchmarks() {
+  const std::vector<std::pair<std::string, Transform>> passes = {
+      {"FullPeepholeOptimise", Transforms::full_peephole_optimise()},
+      {"CliffordSimp", Transforms::clifford_simp()},
+      {"KAKDecomposition", Transforms::two_qubit_squash()},
+      {"ThreeQubitSquash", Transforms::three_qubit_squash()},
+      {"PauliSimp", Transforms::synthesise_pauli_graph()},
+  };
+  for (const auto& [family, generate] : families) {
+    for (unsigned n_qubits : sizes) {
+      const Circuit input = prepare(generate(n_qubits));
+      const std::string suffix =
+          "/" + family + "/" + std::to_string(n_qubits);
+      for (const auto& [pass_name, pass] : passes) {
+        benchmark::RegisterBenchmark(
+            (pass_name + suffix).c_str(),
+            [pass = pass, input](benchmark::State& state) {
+              run_pass(state, pass, input);
+            })
+            ->Unit(benchmark::kMillisecond);
+      }
+      benchmark::RegisterBenchmark(
+          ("ZXGraphlikeReduction" + suffix).c_str(),
+          [input](benchmark::State& state) { run_zx(state, input); })
+          ->Unit(benchmark::kMillisecond);
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  register_benchmarks();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
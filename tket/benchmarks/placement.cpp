@@ -0,0 +1,205 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "BenchmarkGraphs.hpp"
+
+// tket includes
+#include "Architecture/Architecture.hpp"
+#include "Circuit/Circuit.hpp"
+#include "Placement/Placement.hpp"
+
+using namespace tket;
+using namespace tket::benchmarks;
+
+namespace {
+
+// The two-qubit gates of a circuit, as qubit index pairs
+typedef std::vector<std::pair<unsigned, unsigned>> Interactions;
+
+enum class CircuitKind { Random = 0, Brickwork = 1 };
+
+// `n_gates` CX gates between uniformly random pairs of qubits
+Interactions random_interactions(
+    unsigned n_qubits, unsigned n_gates, std::mt19937& rng) {
+  std::uniform_int_distribution<unsigned> qubit_dist(0, n_qubits - 1);
+  Interactions interactions;
+  while (interactions.size() < n_gates) {
+    const unsigned q0 = qubit_dist(rng);
+    const unsigned q1 = qubit_dist(rng);
+    if (q0 != q1) interactions.emplace_back(q0, q1);
+  }
+  return interactions;
+}
+
+// Alternating layers of CX gates between neighbours on a line of qubits,
+// which embeds exactly into any device with a long enough path
+Interactions brickwork_interactions(unsigned n_qubits, unsigned n_gates) {
+  Interactions interactions;
+  for (unsigned layer = 0; interactions.size() < n_gates; ++layer) {
+    for (unsigned q = layer % 2;
+         q + 1 < n_qubits && interactions.size() < n_gates; q += 2) {
+      interactions.emplace_back(q, q + 1);
+    }
+  }
+  return interactions;
+}
+
+Interactions make_interactions(
+    CircuitKind kind, unsigned n_qubits, unsigned n_gates, std::mt19937& rng) {
+  if (kind == CircuitKind::Random) {
+    return random_interactions(n_qubits, n_gates, rng);
+  }
+  return brickwork_interactions(n_qubits, n_gates);
+}
+
+Circuit make_circuit(unsigned n_qubits, const Interactions& interactions) {
+  Circuit circ(n_qubits);
+  for (const auto& [q0, q1] : interactions) {
+    circ.add_op<unsigned>(OpType::CX, {q0, q1});
+  }
+  return circ;
+}
+
+// Report solution quality: the total device distance between the qubits of
+// every gate (lower is better; it equals the number of gates when no routing
+// is needed), and the number of gates and qubits the placement covered.
+void set_quality_counters(
+    benchmark::State& state, Architecture& architecture,
+    const Interactions& interactions, const std::map<Qubit, Node>& placement) {
+  double total_distance = 0;
+  unsigned n_placed_gates = 0;
+  for (const auto& [q0, q1] : interactions) {
+    const auto it0 = placement.find(Qubit(q0));
+    const auto it1 = placement.find(Qubit(q1));
+    if (it0 != placement.end() && it1 != placement.end()) {
+      total_distance += architecture.get_distance(it0->second, it1->second);
+      ++n_placed_gates;
+    }
+  }
+  state.counters["total_distance"] = total_distance;
+  state.counters["placed_gates"] = n_placed_gates;
+  state.counters["placed_qubits"] = placement.size();
+}
+
+enum class PlacementKind { Graph, Line, NoiseAware };
+
+std::unique_ptr<Placement> make_placement(
+    PlacementKind kind, const Architecture& architecture, std::mt19937& rng) {
+  switch (kind) {
+    case PlacementKind::Graph:
+      return std::make_unique<GraphPlacement>(architecture);
+    case PlacementKind::Line:
+      return std::make_unique<LinePlacement>(architecture);
+    case PlacementKind::NoiseAware: {
+      std::uniform_real_distribution<double> error_dist(0.001, 0.05);
+      avg_node_errors_t node_errors;
+      avg_readout_errors_t readout_errors;
+      for (const Node& node : architecture.get_all_nodes_vec()) {
+        node_errors[node] = error_dist(rng);
+        readout_errors[node] = error_dist(rng);
+      }
+      avg_link_errors_t link_errors;
+      for (const auto& [node0, node1] : architecture.get_all_edges_vec()) {
+        link_errors[{node0, node1}] = error_dist(rng);
+      }
+      return std::make_unique<NoiseAwarePlacement>(
+          architecture, node_errors, link_errors, readout_errors);
+    }
+  }
+  return nullptr;
+}
+
+// Args: circuit kind, number of qubits, number of gates
+void run_placement(
+    benchmark::State& state, PlacementKind placement_kind,
+    const EdgeList& edges) {
+  const CircuitKind circuit_kind = CircuitKind(state.range(0));
+  const unsigned n_qubits = state.range(1);
+  const unsigned n_gates = state.range(2);
+  std::mt19937 rng(n_qubits * n_gates + edges.size());
+  Architecture architecture(edges);
+  const Interactions interactions =
+      make_interactions(circuit_kind, n_qubits, n_gates, rng);
+  const Circuit circ = make_circuit(n_qubits, interactions);
+  // Built once, so that every iteration places with the same error tables.
+  // Later iterations reuse the placer's preprocessed target graphs, as
+  // placing a stream of circuits on one device would.
+  const auto placer = make_placement(placement_kind, architecture, rng);
+  std::map<Qubit, Node> placement;
+  for (auto _ : state) {
+    placement = placer->get_placement_map(circ);
+  }
+  set_quality_counters(state, architecture, interactions, placement);
+}
+
+// Devices of roughly 50-60 qubits from each family
+const EdgeList& grid_device() {
+  static const EdgeList edges = square_grid(8);
+  return edges;
+}
+
+const EdgeList& ring_device() {
+  static const EdgeList edges = ring(60);
+  return edges;
+}
+
+const EdgeList& heavy_hex_device() {
+  static const EdgeList edges = heavy_hex(4, 13);
+  return edges;
+}
+
+const EdgeList& random_regular_device() {
+  static const EdgeList edges = [] {
+    std::mt19937 rng(1);
+    return random_regular(56, 3, rng);
+  }();
+  return edges;
+}
+
+}  // namespace
+
+#define PLACEMENT_BENCHMARK(placement_kind, device)                    \
+  static void BM_##placement_kind##Placement_##device(                 \
+      benchmark::State& state) {                                       \
+    run_placement(                                                     \
+        state, PlacementKind::placement_kind, device##_device());      \
+  }                                                                    \
+  BENCHMARK(BM_##placement_kind##Placement_##device)                   \
+      ->Args({int(CircuitKind::Random), 20, 100})                      \
+      ->Args({int(CircuitKind::Random), 40, 200})                      \
+      ->Args({int(CircuitKind::Brickwork), 20, 100})                   \
+      ->Args({int(CircuitKind::Brickwork), 40, 200})                   \
+      ->Unit(benchmark::kMillisecond);
+
+PLACEMENT_BENCHMARK(Graph, grid)
+PLACEMENT_BENCHMARK(Graph, ring)
+PLACEMENT_BENCHMARK(Graph, heavy_hex)
+PLACEMENT_BENCHMARK(Graph, random_regular)
+PLACEMENT_BENCHMARK(Line, grid)
+PLACEMENT_BENCHMARK(Line, ring)
+PLACEMENT_BENCHMARK(Line, heavy_hex)
+PLACEMENT_BENCHMARK(Line, random_regular)
+PLACEMENT_BENCHMARK(NoiseAware, grid)
+PLACEMENT_BENCHMARK(NoiseAware, ring)
+PLACEMENT_BENCHMARK(NoiseAware, heavy_hex)
+PLACEMENT_BENCHMARK(NoiseAware, random_regular)
+
+BENCHMARK_MAIN();
@@ -0,0 +1,149 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "BenchmarkGraphs.hpp"
+
+// tket includes
+#include "Architecture/Architecture.hpp"
+#include "Architecture/BestTsaWithArch.hpp"
+
+using namespace tket;
+using namespace tket::benchmarks;
+
+namespace {
+
+enum class PermutationKind {
+  // Every vertex moves to a uniformly random place
+  Random = 0,
+  // A random permutation of a random half of the vertices;
+  // the other half may be moved, as long as they return
+  RandomHalf = 1,
+  // Vertex v goes to vertex n-1-v
+  Reversal = 2,
+  // Vertex v goes to vertex v+n/4 (mod n)
+  Shift = 3,
+};
+
+BestTsaWithArch::NodeMapping make_mapping(
+    PermutationKind kind, unsigned n_vertices, std::mt19937& rng) {
+  std::vector<unsigned> sources(n_vertices);
+  std::iota(sources.begin(), sources.end(), 0);
+  std::vector<unsigned> targets = sources;
+  switch (kind) {
+    case PermutationKind::Random:
+      std::shuffle(targets.begin(), targets.end(), rng);
+      break;
+    case PermutationKind::RandomHalf:
+      std::shuffle(sources.begin(), sources.end(), rng);
+      sources.resize(n_vertices / 2);
+      targets = sources;
+      std::shuffle(targets.begin(), targets.end(), rng);
+      break;
+    case PermutationKind::Reversal:
+      std::reverse(targets.begin(), targets.end());
+      break;
+    case PermutationKind::Shift:
+      std::rotate(targets.begin(), targets.begin() + n_vertices / 4,
+                  targets.end());
+      break;
+  }
+  BestTsaWithArch::NodeMapping mapping;
+  for (unsigned ii = 0; ii < sources.size(); ++ii) {
+    mapping[Node(sources[ii])] = Node(targets[ii]);
+  }
+  return mapping;
+}
+
+// Args: permutation kind, then `strategies` (0 for the single default
+// strategy, otherwise the number of default strategies to try)
+void run_token_swapping(benchmark::State& state, const EdgeList& edges) {
+  const PermutationKind kind = PermutationKind(state.range(0));
+  const unsigned n_strategies = state.range(1);
+  const unsigned n_vertices = number_of_vertices(edges);
+  std::mt19937 rng(n_vertices + edges.size());
+  const Architecture architecture(edges);
+  const BestTsaWithArch::NodeMapping mapping =
+      make_mapping(kind, n_vertices, rng);
+  std::vector<BestTsaWithArch::Strategy> strategies =
+      BestTsaWithArch::get_default_strategies();
+  strategies.resize(std::min<std::size_t>(
+      strategies.size(), std::max(n_strategies, 1u)));
+
+  std::vector<std::pair<Node, Node>> swaps;
+  for (auto _ : state) {
+    if (n_strategies == 0) {
+      swaps = BestTsaWithArch::get_swaps(architecture, mapping);
+    } else {
+      swaps = BestTsaWithArch::get_swaps(architecture, mapping, strategies);
+    }
+  }
+  // Solution quality. Each swap moves two tokens by one step, so half the
+  // total distance the tokens must travel is a lower bound.
+  double total_distance = 0;
+  for (const auto& [source, target] : mapping) {
+    total_distance += architecture.get_distance(source, target);
+  }
+  state.counters["swaps"] = swaps.size();
+  state.counters["swaps_lower_bound"] = std::ceil(total_distance / 2);
+}
+
+}  // namespace
+
+static void BM_TokenSwapping_Grid(benchmark::State& state) {
+  static const EdgeList edges = square_grid(10);
+  run_token_swapping(state, edges);
+}
+
+static void BM_TokenSwapping_Ring(benchmark::State& state) {
+  static const EdgeList edges = ring(60);
+  run_token_swapping(state, edges);
+}
+
+static void BM_TokenSwapping_HeavyHex(benchmark::State& state) {
+  static const EdgeList edges = heavy_hex(7, 15);
+  run_token_swapping(state, edges);
+}
+
+static void BM_TokenSwapping_RandomRegular(benchmark::State& state) {
+  static const EdgeList edges = [] {
+    std::mt19937 rng(1);
+    return random_regular(100, 3, rng);
+  }();
+  run_token_swapping(state, edges);
+}
+
+static void token_swapping_args(benchmark::internal::Benchmark* bench) {
+  for (PermutationKind kind :
+       {PermutationKind::Random, PermutationKind::RandomHalf,
+        PermutationKind::Reversal, PermutationKind::Shift}) {
+    bench->Args({int(kind), 0});
+    bench->Args({int(kind), 4});
+  }
+  bench->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_TokenSwapping_Grid)->Apply(token_swapping_args);
+BENCHMARK(BM_TokenSwapping_Ring)->Apply(token_swapping_args);
+BENCHMARK(BM_TokenSwapping_HeavyHex)->Apply(token_swapping_args);
+BENCHMARK(BM_TokenSwapping_RandomRegular)->Apply(token_swapping_args);
+
+BENCHMARK_MAIN();
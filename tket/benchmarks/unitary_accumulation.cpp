@@ -0,0 +1,113 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+// tket includes
+#include "Circuit/CircUtils.hpp"
+#include "Circuit/Circuit.hpp"
+#include "Circuit/ThreeQubitConversion.hpp"
+
+using namespace tket;
+
+namespace {
+
+// Fill `circ` with a dense random circuit on `n_qubits` qubits: each gate is
+// a random rotation on one qubit or a CX between two, with equal probability.
+// The whole circuit, apart from its boundary, is returned as a region. The
+// circuit is built in place, since copying it would invalidate the region.
+Subcircuit random_region(Circuit& circ, unsigned n_qubits, unsigned n_gates) {
+  std::mt19937 rng(n_qubits * n_gates);
+  std::uniform_int_distribution<unsigned> qubit_dist(0, n_qubits - 1);
+  std::uniform_real_distribution<double> angle_dist(0., 2.);
+  const OpType rotations[] = {OpType::Rx, OpType::Ry, OpType::Rz};
+
+  circ = Circuit(n_qubits);
+  Subcircuit sub;
+  for (unsigned q = 0; q < n_qubits; ++q) {
+    sub.q_in_hole.push_back(circ.get_nth_out_edge(circ.get_in(Qubit(q)), 0));
+  }
+  for (unsigned ii = 0; ii < n_gates; ++ii) {
+    const unsigned q0 = qubit_dist(rng);
+    if (rng() % 2 == 0) {
+      sub.verts.insert(circ.add_op<unsigned>(
+          rotations[rng() % 3], angle_dist(rng), {q0}));
+    } else {
+      const unsigned q1 = (q0 + 1 + rng() % (n_qubits - 1)) % n_qubits;
+      sub.verts.insert(circ.add_op<unsigned>(OpType::CX, {q0, q1}));
+    }
+  }
+  for (unsigned q = 0; q < n_qubits; ++q) {
+    sub.q_out_hole.push_back(circ.get_nth_in_edge(circ.get_out(Qubit(q)), 0));
+  }
+  return sub;
+}
+
+}  // namespace
+
+// Args: number of gates
+static void BM_TwoQubitUnitary_FromSubcircuit(benchmark::State& state) {
+  Circuit circ;
+  const Subcircuit sub = random_region(circ, 2, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(get_matrix_from_2qb_subcircuit(circ, sub));
+  }
+}
+
+// For comparison: first extract the region as a circuit, as the squash
+// passes used to
+static void BM_TwoQubitUnitary_ViaCircuit(benchmark::State& state) {
+  Circuit circ;
+  const Subcircuit sub = random_region(circ, 2, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(get_matrix_from_2qb_circ(circ.subcircuit(sub)));
+  }
+}
+
+static void BM_ThreeQubitUnitary_FromSubcircuit(benchmark::State& state) {
+  Circuit circ;
+  const Subcircuit sub = random_region(circ, 3, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(get_matrix_from_3qb_subcircuit(circ, sub));
+  }
+}
+
+static void BM_ThreeQubitUnitary_ViaCircuit(benchmark::State& state) {
+  Circuit circ;
+  const Subcircuit sub = random_region(circ, 3, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(get_3q_unitary(circ.subcircuit(sub)));
+  }
+}
+
+BENCHMARK(BM_TwoQubitUnitary_FromSubcircuit)
+    ->RangeMultiplier(4)
+    ->Range(4, 256)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TwoQubitUnitary_ViaCircuit)
+    ->RangeMultiplier(4)
+    ->Range(4, 256)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ThreeQubitUnitary_FromSubcircuit)
+    ->RangeMultiplier(4)
+    ->Range(4, 256)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ThreeQubitUnitary_ViaCircuit)
+    ->RangeMultiplier(4)
+    ->Range(4, 256)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,162 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <tkwsm/EndToEndWrappers/MainSolver.hpp>
+#include <vector>
+
+#include "BenchmarkGraphs.hpp"
+
+using namespace tket::WeightedSubgraphMonomorphism;
+using namespace tket::benchmarks;
+
+// Random weights for the edges
+static GraphEdgeWeights with_weights(
+    const EdgeList& edges, std::mt19937& rng) {
+  std::uniform_int_distribution<WeightWSM> weight_dist(1, 10);
+  GraphEdgeWeights weights;
+  for (const auto& [v1, v2] : edges) {
+    weights[get_edge(v1, v2)] = weight_dist(rng);
+  }
+  return weights;
+}
+
+// A connected interaction graph on `n_vertices` vertices which embeds into
+// `target`: a breadth-first region of the target, keeping the BFS tree and
+// a random half of the other edges, with fresh random weights
+static GraphEdgeWeights embeddable_pattern(
+    const GraphEdgeWeights& target, unsigned n_vertices, std::mt19937& rng) {
+  std::vector<std::vector<VertexWSM>> adjacency;
+  for (const auto& entry : target) {
+    const auto& [v1, v2] = entry.first;
+    adjacency.resize(std::max<std::size_t>(adjacency.size(), v2 + 1));
+    adjacency[v1].push_back(v2);
+    adjacency[v2].push_back(v1);
+  }
+  std::uniform_int_distribution<WeightWSM> weight_dist(1, 10);
+  std::bernoulli_distribution keep_dist(0.5);
+  const VertexWSM unseen = adjacency.size();
+  std::vector<VertexWSM> relabel(adjacency.size(), unseen);
+  std::queue<VertexWSM> queue;
+  GraphEdgeWeights pattern;
+  relabel[0] = 0;
+  queue.push(0);
+  VertexWSM n_seen = 1;
+  while (!queue.empty()) {
+    const VertexWSM tv = queue.front();
+    queue.pop();
+    for (VertexWSM other_tv : adjacency[tv]) {
+      if (relabel[other_tv] == unseen) {
+        if (n_seen == n_vertices) continue;
+        relabel[other_tv] = n_seen++;
+        queue.push(other_tv);
+        pattern[get_edge(relabel[tv], relabel[other_tv])] = weight_dist(rng);
+      } else if (keep_dist(rng)) {
+        pattern[get_edge(relabel[tv], relabel[other_tv])] = weight_dist(rng);
+      }
+    }
+  }
+  return pattern;
+}
+
+static void run_solver(
+    benchmark::State& state, const GraphEdgeWeights& pattern,
+    const GraphEdgeWeights& target) {
+  MainSolverParameters parameters(10000);
+  for (auto _ : state) {
+    MainSolver solver(pattern, target, parameters);
+    const SolutionData& solution_data = solver.get_solution_data();
+    state.counters["finished"] = solution_data.finished;
+    state.counters["iterations"] = solution_data.iterations;
+    // Solution quality: the best (lowest) scalar product found,
+    // or -1 if there is no solution.
+    double scalar_product = -1;
+    for (const SolutionWSM& solution : solution_data.solutions) {
+      if (scalar_product < 0 || solution.scalar_product < scalar_product) {
+        scalar_product = solution.scalar_product;
+      }
+    }
+    state.counters["scalar_product"] = scalar_product;
+  }
+}
+
+static void BM_WSM_SquareGrid(benchmark::State& state) {
+  // Place `range(1)` vertices onto a `range(0)`-wide square grid
+  std::mt19937 rng(state.range(0) * state.range(1));
+  const GraphEdgeWeights target =
+      with_weights(square_grid(state.range(0)), rng);
+  const GraphEdgeWeights pattern =
+      embeddable_pattern(target, state.range(1), rng);
+  run_solver(state, pattern, target);
+}
+
+static void BM_WSM_HeavyHex(benchmark::State& state) {
+  // Place `range(2)` vertices onto a heavy-hex lattice of
+  // `range(0)` rows of width `range(1)`
+  std::mt19937 rng(state.range(0) * state.range(1) * state.range(2));
+  const GraphEdgeWeights target =
+      with_weights(heavy_hex(state.range(0), state.range(1)), rng);
+  const GraphEdgeWeights pattern =
+      embeddable_pattern(target, state.range(2), rng);
+  run_solver(state, pattern, target);
+}
+
+static void BM_WSM_Ring(benchmark::State& state) {
+  // Place `range(1)` vertices onto a ring of `range(0)` vertices
+  std::mt19937 rng(state.range(0) * state.range(1));
+  const GraphEdgeWeights target = with_weights(ring(state.range(0)), rng);
+  const GraphEdgeWeights pattern =
+      embeddable_pattern(target, state.range(1), rng);
+  run_solver(state, pattern, target);
+}
+
+static void BM_WSM_RandomRegular(benchmark::State& state) {
+  // Place `range(2)` vertices onto a random `range(1)`-regular graph
+  // on `range(0)` vertices
+  std::mt19937 rng(state.range(0) * state.range(1) * state.range(2));
+  const GraphEdgeWeights target = with_weights(
+      random_regular(state.range(0), state.range(1), rng), rng);
+  const GraphEdgeWeights pattern =
+      embeddable_pattern(target, state.range(2), rng);
+  run_solver(state, pattern, target);
+}
+
+BENCHMARK(BM_WSM_SquareGrid)
+    ->Args({8, 20})
+    ->Args({10, 36})
+    ->Args({12, 49})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_WSM_HeavyHex)
+    ->Args({5, 15, 30})
+    ->Args({7, 19, 50})
+    ->Args({9, 23, 80})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_WSM_Ring)
+    ->Args({50, 20})
+    ->Args({100, 50})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_WSM_RandomRegular)
+    ->Args({40, 3, 15})
+    ->Args({60, 3, 25})
+    ->Args({60, 4, 25})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
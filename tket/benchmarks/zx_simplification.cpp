@@ -0,0 +1,108 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+// tket includes
+#include "Circuit/Circuit.hpp"
+#include "Converters/Converters.hpp"
+#include "ZX/Rewrite.hpp"
+
+using namespace tket;
+using namespace tket::zx;
+
+// Random Clifford+T circuit on `nb_qubits` qubits with `nb_layers` layers,
+// converted to graph-like ZX form ready for simplification
+class FX_ZX_Graphlike : public ::benchmark::Fixture {
+ public:
+  FX_ZX_Graphlike() {}
+  void SetUp(const ::benchmark::State& state) {
+    unsigned nb_qubits = state.range(0);
+    unsigned nb_layers = state.range(1);
+    std::mt19937 rng(nb_qubits * nb_layers);
+    std::uniform_int_distribution<unsigned> gate_dist(0, 3);
+    std::uniform_int_distribution<unsigned> qubit_dist(0, nb_qubits - 1);
+    Circuit circ(nb_qubits);
+    for (unsigned l = 0; l < nb_layers; ++l) {
+      for (unsigned q = 0; q < nb_qubits; ++q) {
+        switch (gate_dist(rng)) {
+          case 0:
+            circ.add_op<unsigned>(OpType::H, {q});
+            break;
+          case 1:
+            circ.add_op<unsigned>(OpType::S, {q});
+            break;
+          case 2:
+            circ.add_op<unsigned>(OpType::T, {q});
+            break;
+          default: {
+            unsigned t = qubit_dist(rng);
+            if (t != q) circ.add_op<unsigned>(OpType::CX, {q, t});
+          }
+        }
+      }
+    }
+    diag = circuit_to_zx(circ).first;
+    Rewrite::decompose_boxes().apply(diag);
+    Rewrite::rebase_to_zx().apply(diag);
+    Rewrite::red_to_green().apply(diag);
+    Rewrite::spider_fusion().apply(diag);
+    Rewrite::parallel_h_removal().apply(diag);
+    Rewrite::io_extension().apply(diag);
+    Rewrite::separate_boundaries().apply(diag);
+  }
+  void TearDown(const ::benchmark::State&) {}
+  ~FX_ZX_Graphlike() {}
+  ZXDiagram diag;
+};
+
+BENCHMARK_DEFINE_F(FX_ZX_Graphlike, BM_Exhaustive_Simplification)
+(benchmark::State& state) {
+  // Benchmark the full-scan rewrites repeated until neither applies
+  Rewrite simp = Rewrite::repeat(Rewrite::sequence(
+      {Rewrite::remove_interior_cliffords(),
+       Rewrite::remove_interior_paulis()}));
+  for (auto _ : state) {
+    state.PauseTiming();
+    ZXDiagram copy = diag;
+    state.ResumeTiming();
+    simp.apply(copy);
+    state.counters["vertices"] = copy.n_vertices();
+  }
+}
+
+BENCHMARK_DEFINE_F(FX_ZX_Graphlike, BM_Worklist_Simplification)
+(benchmark::State& state) {
+  // Benchmark the worklist-driven equivalent of the rewrites above
+  Rewrite simp = Rewrite::graphlike_reduction();
+  for (auto _ : state) {
+    state.PauseTiming();
+    ZXDiagram copy = diag;
+    state.ResumeTiming();
+    simp.apply(copy);
+    state.counters["vertices"] = copy.n_vertices();
+  }
+}
+
+BENCHMARK_REGISTER_F(FX_ZX_Graphlike, BM_Exhaustive_Simplification)
+    ->ArgsProduct({{10, 50}, {20, 100, 400}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(FX_ZX_Graphlike, BM_Worklist_Simplification)
+    ->ArgsProduct({{10, 50}, {20, 100, 400}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -19,6 +19,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "Architecture/CompiledArchitecture.hpp"
 #include "Graphs/ArticulationPoints.hpp"
 #include "Utils/Json.hpp"
 #include "Utils/UnitID.hpp"
@@ -92,6 +93,13 @@ std::set<Node> Architecture::get_articulation_points(
 }
 
 std::set<Node> Architecture::get_articulation_points() const {
+  // Don't compile just for this: remove_worst_nodes calls it after
+  // every removal.
+  const std::shared_ptr<const CompiledArchitecture> compiled =
+      compiled_cache_.get();
+  if (compiled) {
+    return compiled->get_articulation_points();
+  }
   std::set<Vertex> aps;
   UndirectedConnGraph undir_g = get_undirected_connectivity();
   boost::articulation_points(undir_g, std::inserter(aps, aps.begin()));
@@ -187,6 +195,45 @@ int tri_lexicographical_comparison(
   return -1;
 }
 
+std::shared_ptr<const CompiledArchitecture> Architecture::get_compiled()
+    const {
+  std::lock_guard<std::mutex> lock(compiled_cache_.mutex);
+  if (!compiled_cache_.compiled) {
+    compiled_cache_.compiled =
+        std::make_shared<const CompiledArchitecture>(*this);
+  }
+  return compiled_cache_.compiled;
+}
+
+unsigned Architecture::get_diameter() { return get_compiled()->get_diameter(); }
+
+unsigned Architecture::get_distance(
+    const Node& node1, const Node& node2) const {
+  if (node1 == node2) {
+    return 0;
+  }
+  return get_compiled()->get_distance(node1, node2);
+}
+
+node_vector_t Architecture::get_path(
+    const Node& root, const Node& target) const {
+  const auto compiled = get_compiled();
+  const std::vector<unsigned> indices = compiled->get_path(
+      compiled->get_index(target), compiled->get_index(root));
+  node_vector_t path;
+  path.reserve(indices.size());
+  for (unsigned index : indices) {
+    path.push_back(compiled->get_node(index));
+  }
+  return path;
+}
+
+void Architecture::invalidate_cache() {
+  ArchitectureBase::invalidate_cache();
+  std::lock_guard<std::mutex> lock(compiled_cache_.mutex);
+  compiled_cache_.compiled.reset();
+}
+
 MatrixXb Architecture::get_connectivity() const {
   unsigned n = n_nodes();
   MatrixXb connectivity = MatrixXb(n, n);
@@ -41,6 +41,7 @@ ArchitectureMapping::ArchitectureMapping(const Architecture& arch)
     }
     m_node_to_vertex_mapping[node] = ii;
   }
+  set_compiled_indices();
 }
 
 ArchitectureMapping::ArchitectureMapping(
@@ -89,6 +90,19 @@ ArchitectureMapping::ArchitectureMapping(
             << node.repr());
     // GCOVR_EXCL_STOP
   }
+  set_compiled_indices();
+}
+
+void ArchitectureMapping::set_compiled_indices() {
+  m_compiled = m_arch.get_compiled();
+  TKET_ASSERT(m_compiled->n_nodes() == m_vertex_to_node_mapping.size());
+  m_vertex_to_compiled_index.resize(m_vertex_to_node_mapping.size());
+  m_compiled_index_to_vertex.resize(m_vertex_to_node_mapping.size());
+  for (size_t ii = 0; ii < m_vertex_to_node_mapping.size(); ++ii) {
+    const unsigned index = m_compiled->get_index(m_vertex_to_node_mapping[ii]);
+    m_vertex_to_compiled_index[ii] = index;
+    m_compiled_index_to_vertex[index] = ii;
+  }
 }
 
 size_t ArchitectureMapping::number_of_vertices() const {
@@ -121,6 +135,22 @@ const Architecture& ArchitectureMapping::get_architecture() const {
   return m_arch;
 }
 
+const CompiledArchitecture& ArchitectureMapping::get_compiled_architecture()
+    const {
+  return *m_compiled;
+}
+
+unsigned ArchitectureMapping::get_compiled_index(size_t vertex) const {
+  TKET_ASSERT(vertex < m_vertex_to_compiled_index.size());
+  return m_vertex_to_compiled_index[vertex];
+}
+
+size_t ArchitectureMapping::get_vertex_from_compiled_index(
+    unsigned index) const {
+  TKET_ASSERT(index < m_compiled_index_to_vertex.size());
+  return m_compiled_index_to_vertex[index];
+}
+
 std::vector<Swap> ArchitectureMapping::get_edges() const {
   std::vector<Swap> edges;
   for (auto [node1, node2] : m_arch.get_all_edges_vec()) {
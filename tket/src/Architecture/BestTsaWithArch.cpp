@@ -20,38 +20,62 @@
 
 #include "DistancesFromArchitecture.hpp"
 #include "NeighboursFromArchitecture.hpp"
+#include "Utils/Parallel.hpp"
 
 namespace tket {
 
 using namespace tsa_internal;
 
+std::vector<BestTsaWithArch::Strategy>
+BestTsaWithArch::get_default_strategies() {
+  std::vector<Strategy> strategies(4);
+  strategies[1].seed = 1;
+  // Greedier cycle growth helps on sparse architectures such as rings,
+  // different seeds on denser ones.
+  strategies[2].seed = 2;
+  strategies[2].cycles_options.min_decrease_for_partial_path = 1;
+  strategies[3].seed = 3;
+  strategies[3].cycles_options.max_cycle_size = 8;
+  strategies[3].cycles_options.min_decrease_for_partial_path = 1;
+  return strategies;
+}
+
 void BestTsaWithArch::append_solution(
     SwapList& swaps, VertexMapping& vertex_mapping,
     const ArchitectureMapping& arch_mapping) {
+  append_solution(swaps, vertex_mapping, arch_mapping, Strategy());
+}
+
+void BestTsaWithArch::append_solution(
+    SwapList& swaps, VertexMapping& vertex_mapping,
+    const ArchitectureMapping& arch_mapping, const Strategy& strategy) {
   DistancesFromArchitecture distances(arch_mapping);
   NeighboursFromArchitecture neighbours(arch_mapping);
   RNG rng;
+  rng.set_seed(strategy.seed);
   RiverFlowPathFinder path_finder(distances, neighbours, rng);
-  BestFullTsa().append_partial_solution(
+  BestFullTsa tsa;
+  tsa.get_cycles_growth_options() = strategy.cycles_options;
+  tsa.append_partial_solution(
       swaps, vertex_mapping, distances, neighbours, path_finder);
 }
 
-std::vector<std::pair<Node, Node>> BestTsaWithArch::get_swaps(
-    const Architecture& architecture, const NodeMapping& node_mapping) {
-  std::vector<std::pair<Node, Node>> swaps;
-  // Before all the conversion and object construction,
-  // doesn't take long to check if it's actually trivial
-  bool trivial = true;
+// Before all the conversion and object construction,
+// doesn't take long to check if it's actually trivial
+static bool is_trivial(const BestTsaWithArch::NodeMapping& node_mapping) {
   for (const auto& entry : node_mapping) {
     if (entry.first != entry.second) {
-      trivial = false;
-      break;
+      return false;
     }
   }
-  if (trivial) {
-    return swaps;
-  }
-  // Now convert the Nodes into raw vertices for use in TSA objects.
+  return true;
+}
+
+static std::vector<std::pair<Node, Node>> get_swaps_with_strategy(
+    const Architecture& architecture,
+    const BestTsaWithArch::NodeMapping& node_mapping,
+    const BestTsaWithArch::Strategy& strategy) {
+  // Convert the Nodes into raw vertices for use in TSA objects.
   const ArchitectureMapping arch_mapping(architecture);
   VertexMapping vertex_mapping;
   for (const auto& node_entry : node_mapping) {
@@ -62,9 +86,11 @@ std::vector<std::pair<Node, Node>> BestTsaWithArch::get_swaps(
   check_mapping(vertex_mapping);
 
   SwapList raw_swap_list;
-  BestTsaWithArch::append_solution(raw_swap_list, vertex_mapping, arch_mapping);
+  BestTsaWithArch::append_solution(
+      raw_swap_list, vertex_mapping, arch_mapping, strategy);
 
   // Finally, convert the raw swaps back to nodes.
+  std::vector<std::pair<Node, Node>> swaps;
   swaps.reserve(raw_swap_list.size());
   for (auto id_opt = raw_swap_list.front_id(); id_opt;
        id_opt = raw_swap_list.next(id_opt.value())) {
@@ -76,4 +102,43 @@ std::vector<std::pair<Node, Node>> BestTsaWithArch::get_swaps(
   return swaps;
 }
 
+std::vector<std::pair<Node, Node>> BestTsaWithArch::get_swaps(
+    const Architecture& architecture, const NodeMapping& node_mapping) {
+  if (is_trivial(node_mapping)) {
+    return {};
+  }
+  return get_swaps_with_strategy(architecture, node_mapping, Strategy());
+}
+
+std::vector<std::pair<Node, Node>> BestTsaWithArch::get_swaps(
+    const Architecture& architecture, const NodeMapping& node_mapping,
+    const std::vector<Strategy>& strategies, unsigned max_threads) {
+  TKET_ASSERT(!strategies.empty());
+  if (is_trivial(node_mapping)) {
+    return {};
+  }
+  if (strategies.size() == 1) {
+    return get_swaps_with_strategy(architecture, node_mapping, strategies[0]);
+  }
+  // Distances are computed (and cached) through the Architecture,
+  // so every job needs its own copy. Copies are made here, on the
+  // calling thread.
+  std::vector<Architecture> architectures(strategies.size(), architecture);
+  std::vector<std::vector<std::pair<Node, Node>>> solutions(strategies.size());
+  parallel_for(
+      strategies.size(),
+      [&](std::size_t ii) {
+        solutions[ii] = get_swaps_with_strategy(
+            architectures[ii], node_mapping, strategies[ii]);
+      },
+      max_threads);
+  std::size_t best_index = 0;
+  for (std::size_t ii = 1; ii < solutions.size(); ++ii) {
+    if (solutions[ii].size() < solutions[best_index].size()) {
+      best_index = ii;
+    }
+  }
+  return std::move(solutions[best_index]);
+}
+
 }  // namespace tket
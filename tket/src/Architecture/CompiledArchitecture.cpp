@@ -0,0 +1,333 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Architecture/CompiledArchitecture.hpp"
+
+#include <algorithm>
+#include <boost/graph/biconnected_components.hpp>
+#include <tkassert/Assert.hpp>
+
+#include "Utils/Parallel.hpp"
+
+namespace tket {
+
+CompiledArchitecture::CompiledArchitecture(
+    const Architecture &arch, std::size_t max_table_bytes)
+    : max_finite_distance_(0), connected_(true) {
+  const Architecture::UndirectedConnGraph &undir_g =
+      arch.get_undirected_connectivity();
+  const unsigned n = boost::num_vertices(undir_g);
+
+  nodes_.reserve(n);
+  for (unsigned i = 0; i < n; ++i) {
+    nodes_.push_back(undir_g[i]);
+    node_to_index_[undir_g[i]] = i;
+  }
+
+  // Compressed adjacency lists. The out-edges are held in a std::set, so are
+  // already sorted, which is also the order boost's breadth-first search
+  // (and hence Architecture::get_path) visits them in.
+  neighbour_offsets_.reserve(n + 1);
+  neighbour_offsets_.push_back(0);
+  for (unsigned i = 0; i < n; ++i) {
+    for (auto [it, end] = boost::adjacent_vertices(i, undir_g); it != end;
+         ++it) {
+      neighbours_.push_back(*it);
+    }
+    TKET_ASSERT(std::is_sorted(
+        neighbours_.begin() + neighbour_offsets_.back(), neighbours_.end()));
+    neighbour_offsets_.push_back(neighbours_.size());
+  }
+
+  // Entries must fit in 16 bits, with no_entry to spare.
+  const std::size_t table_bytes = std::size_t(n) * n * sizeof(std::uint16_t);
+  const bool store_distances = n < no_entry && table_bytes <= max_table_bytes;
+  const bool store_next_hops =
+      store_distances && 2 * table_bytes <= max_table_bytes;
+  if (store_distances) {
+    distances_.resize(std::size_t(n) * n);
+  }
+  if (store_next_hops) {
+    next_hops_.resize(std::size_t(n) * n);
+  } else {
+    const std::size_t stored_bytes =
+        store_distances ? table_bytes : std::size_t(0);
+    search_row_cache_ = std::make_unique<SearchRowCache>();
+    search_row_cache_->max_rows = std::max<std::size_t>(
+        1, (max_table_bytes - std::min(max_table_bytes, stored_bytes)) /
+               (2 * std::max(n, 1u) * sizeof(unsigned)));
+  }
+
+  // Breadth-first search from every node; the rows are independent. Even
+  // if nothing is stored, this finds the diameter and connectivity.
+  std::vector<unsigned> reached(n);
+  std::vector<unsigned> max_distances(n);
+  const auto search_from = [&](std::size_t root) {
+    std::vector<unsigned> distances(n);
+    std::vector<unsigned> next_hops(n);
+    std::vector<unsigned> queue(n);
+    reached[root] =
+        search(root, distances.data(), next_hops.data(), queue.data());
+    // The queue holds the reached nodes in order of distance.
+    max_distances[root] = distances[queue[reached[root] - 1]];
+    if (store_distances) {
+      std::uint16_t *row = distances_.data() + root * n;
+      for (unsigned v = 0; v < n; ++v) {
+        row[v] = distances[v] == unreachable ? no_entry : distances[v];
+      }
+    }
+    if (store_next_hops) {
+      std::uint16_t *row = next_hops_.data() + root * n;
+      for (unsigned v = 0; v < n; ++v) {
+        row[v] = next_hops[v] == unreachable ? no_entry : next_hops[v];
+      }
+    }
+  };
+  // Small devices are not worth starting threads for.
+  parallel_for(n, search_from, n < 256 ? 1 : 0);
+
+  for (unsigned root = 0; root < n; ++root) {
+    if (reached[root] != n) {
+      connected_ = false;
+    }
+    max_finite_distance_ = std::max(max_finite_distance_, max_distances[root]);
+  }
+
+  std::vector<unsigned> aps;
+  boost::articulation_points(undir_g, std::back_inserter(aps));
+  is_articulation_point_.assign(n, false);
+  for (unsigned ap : aps) {
+    is_articulation_point_[ap] = true;
+    articulation_points_.insert(nodes_[ap]);
+  }
+}
+
+unsigned CompiledArchitecture::search(
+    unsigned root, unsigned *distances, unsigned *next_hops,
+    unsigned *queue) const {
+  const unsigned n = nodes_.size();
+  std::fill(distances, distances + n, unreachable);
+  std::fill(next_hops, next_hops + n, unreachable);
+  distances[root] = 0;
+  next_hops[root] = root;
+  queue[0] = root;
+  unsigned queue_begin = 0;
+  unsigned queue_end = 1;
+  while (queue_begin != queue_end) {
+    const unsigned v = queue[queue_begin++];
+    const unsigned next_distance = distances[v] + 1;
+    for (unsigned w : get_neighbours(v)) {
+      if (distances[w] == unreachable) {
+        distances[w] = next_distance;
+        next_hops[w] = v;
+        queue[queue_end++] = w;
+      }
+    }
+  }
+  return queue_end;
+}
+
+unsigned CompiledArchitecture::n_nodes() const { return nodes_.size(); }
+
+const std::vector<Node> &CompiledArchitecture::get_nodes() const {
+  return nodes_;
+}
+
+const Node &CompiledArchitecture::get_node(unsigned index) const {
+  TKET_ASSERT(index < nodes_.size());
+  return nodes_[index];
+}
+
+unsigned CompiledArchitecture::get_index(const Node &node) const {
+  const auto citer = node_to_index_.find(node);
+  if (citer == node_to_index_.cend()) {
+    throw graphs::NodeDoesNotExistError(
+        "Node " + node.repr() + " is not in the architecture");
+  }
+  return citer->second;
+}
+
+bool CompiledArchitecture::node_exists(const Node &node) const {
+  return node_to_index_.count(node) != 0;
+}
+
+std::span<const unsigned> CompiledArchitecture::get_neighbours(
+    unsigned index) const {
+  TKET_ASSERT(index < nodes_.size());
+  const unsigned begin = neighbour_offsets_[index];
+  const unsigned end = neighbour_offsets_[index + 1];
+  return {neighbours_.data() + begin, end - begin};
+}
+
+unsigned CompiledArchitecture::get_degree(unsigned index) const {
+  TKET_ASSERT(index < nodes_.size());
+  return neighbour_offsets_[index + 1] - neighbour_offsets_[index];
+}
+
+bool CompiledArchitecture::edge_exists(
+    unsigned index1, unsigned index2) const {
+  const auto neighbours = get_neighbours(index1);
+  return std::binary_search(neighbours.begin(), neighbours.end(), index2);
+}
+
+unsigned CompiledArchitecture::get_distance(
+    unsigned index1, unsigned index2) const {
+  TKET_ASSERT(index1 < nodes_.size() && index2 < nodes_.size());
+  if (!distances_.empty()) {
+    const std::uint16_t distance =
+        distances_[std::size_t(index1) * nodes_.size() + index2];
+    return distance == no_entry ? unreachable : distance;
+  }
+  return get_search_row(index2)->distances[index1];
+}
+
+unsigned CompiledArchitecture::get_distance(
+    const Node &node1, const Node &node2) const {
+  const unsigned distance = get_distance(get_index(node1), get_index(node2));
+  if (distance == unreachable) {
+    throw graphs::NodesNotConnected(node1, node2);
+  }
+  return distance;
+}
+
+std::vector<unsigned> CompiledArchitecture::get_distances(
+    unsigned index) const {
+  TKET_ASSERT(index < nodes_.size());
+  if (distances_.empty()) {
+    return get_search_row(index)->distances;
+  }
+  const std::uint16_t *row =
+      distances_.data() + std::size_t(index) * nodes_.size();
+  std::vector<unsigned> distances(nodes_.size());
+  for (unsigned v = 0; v < nodes_.size(); ++v) {
+    distances[v] = row[v] == no_entry ? unreachable : row[v];
+  }
+  return distances;
+}
+
+unsigned CompiledArchitecture::get_diameter() const {
+  if (nodes_.empty()) {
+    throw std::logic_error("Graph is empty.");
+  }
+  if (!connected_) {
+    // Report the first disconnected pair, as Architecture would.
+    for (unsigned i = 0; i < nodes_.size(); ++i) {
+      const std::vector<unsigned> distances = get_distances(i);
+      for (unsigned j = i + 1; j < nodes_.size(); ++j) {
+        if (distances[j] == unreachable) {
+          throw graphs::NodesNotConnected(nodes_[i], nodes_[j]);
+        }
+      }
+    }
+  }
+  return max_finite_distance_;
+}
+
+bool CompiledArchitecture::is_articulation_point(unsigned index) const {
+  TKET_ASSERT(index < nodes_.size());
+  return is_articulation_point_[index];
+}
+
+const node_set_t &CompiledArchitecture::get_articulation_points() const {
+  return articulation_points_;
+}
+
+bool CompiledArchitecture::has_distance_table() const {
+  return !distances_.empty();
+}
+
+bool CompiledArchitecture::has_next_hop_table() const {
+  return !next_hops_.empty();
+}
+
+std::size_t CompiledArchitecture::get_max_table_bytes() const {
+  std::size_t bytes = (distances_.size() + next_hops_.size()) *
+                      sizeof(std::uint16_t);
+  if (search_row_cache_) {
+    bytes += search_row_cache_->max_rows * 2 * nodes_.size() *
+             sizeof(unsigned);
+  }
+  return bytes;
+}
+
+std::shared_ptr<const CompiledArchitecture::SearchRow>
+CompiledArchitecture::get_search_row(unsigned target) const {
+  TKET_ASSERT(search_row_cache_);
+  SearchRowCache &cache = *search_row_cache_;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    const auto citer = cache.rows.find(target);
+    if (citer != cache.rows.end()) {
+      cache.targets.splice(
+          cache.targets.begin(), cache.targets, citer->second.second);
+      return citer->second.first;
+    }
+  }
+  // Search without holding the lock; another thread may do the same
+  // search meanwhile, which is harmless.
+  auto row = std::make_shared<SearchRow>();
+  row->distances.resize(nodes_.size());
+  row->next_hops.resize(nodes_.size());
+  std::vector<unsigned> queue(nodes_.size());
+  search(target, row->distances.data(), row->next_hops.data(), queue.data());
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.rows.count(target) == 0) {
+    if (cache.rows.size() >= cache.max_rows) {
+      cache.rows.erase(cache.targets.back());
+      cache.targets.pop_back();
+    }
+    cache.targets.push_front(target);
+    cache.rows[target] = {row, cache.targets.begin()};
+  }
+  return row;
+}
+
+unsigned CompiledArchitecture::get_next_hop(
+    unsigned index1, unsigned index2) const {
+  TKET_ASSERT(index1 < nodes_.size() && index2 < nodes_.size());
+  if (!next_hops_.empty()) {
+    const std::uint16_t next_hop =
+        next_hops_[std::size_t(index2) * nodes_.size() + index1];
+    return next_hop == no_entry ? unreachable : next_hop;
+  }
+  return get_search_row(index2)->next_hops[index1];
+}
+
+std::vector<unsigned> CompiledArchitecture::get_path(
+    unsigned index1, unsigned index2) const {
+  TKET_ASSERT(index1 < nodes_.size() && index2 < nodes_.size());
+  const unsigned distance = get_distance(index1, index2);
+  if (distance == unreachable) {
+    return {};
+  }
+  std::vector<unsigned> path;
+  path.reserve(distance + 1);
+  path.push_back(index1);
+  if (!next_hops_.empty()) {
+    const std::uint16_t *row =
+        next_hops_.data() + std::size_t(index2) * nodes_.size();
+    while (path.back() != index2) {
+      path.push_back(row[path.back()]);
+    }
+  } else {
+    const auto row = get_search_row(index2);
+    while (path.back() != index2) {
+      path.push_back(row->next_hops[path.back()]);
+    }
+  }
+  return path;
+}
+
+}  // namespace tket
@@ -65,23 +65,20 @@ size_t DistancesFromArchitecture::operator()(size_t vertex1, size_t vertex2) {
   // Automatically set to zero if it doesn't exist yet.
   auto& distance_entry = m_cached_distances[get_swap(vertex1, vertex2)];
   if (distance_entry == 0) {
-    const auto& arch = m_arch_mapping.get_architecture();
-    distance_entry = arch.get_distance(
-        m_arch_mapping.get_node(vertex1), m_arch_mapping.get_node(vertex2));
-
-    // This message should no longer be triggered for disconnected
-    // architectures, since get_distance now should throw if v1, v2 are in
-    // different connected components. However, leave the check in, in case some
-    // other bizarre error causes distance zero to be returned.
+    const auto& compiled = m_arch_mapping.get_compiled_architecture();
+    distance_entry = compiled.get_distance(
+        m_arch_mapping.get_compiled_index(vertex1),
+        m_arch_mapping.get_compiled_index(vertex2));
+    if (distance_entry == CompiledArchitecture::unreachable) {
+      throw graphs::NodesNotConnected(
+          m_arch_mapping.get_node(vertex1), m_arch_mapping.get_node(vertex2));
+    }
     // GCOVR_EXCL_START
     TKET_ASSERT(
         distance_entry > 0 ||
         AssertMessage() << "DistancesFromArchitecture: architecture has "
-                        << arch.n_nodes() << " vertices, "
-                        << arch.n_connections() << " edges; "
-                        << " and d(" << vertex1 << "," << vertex2
-                        << ")=0. "
-                           "Is the graph connected?");
+                        << compiled.n_nodes() << " vertices, and d(" << vertex1
+                        << "," << vertex2 << ")=0.");
     // GCOVR_EXCL_STOP
   }
   return distance_entry;
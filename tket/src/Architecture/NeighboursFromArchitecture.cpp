@@ -42,20 +42,21 @@ const std::vector<size_t>& NeighboursFromArchitecture::operator()(
   // OK, if a vertex is isolated (has no neighbours) then this is wasteful;
   // however this case should almost never occur in practice.
 
-  const auto& source_node = m_arch_mapping.get_node(vertex);
-  const auto neighbour_nodes =
-      m_arch_mapping.get_architecture().get_neighbour_nodes(source_node);
+  const auto neighbour_indices =
+      m_arch_mapping.get_compiled_architecture().get_neighbours(
+          m_arch_mapping.get_compiled_index(vertex));
 
-  neighbours.reserve(neighbour_nodes.size());
+  neighbours.reserve(neighbour_indices.size());
 
-  for (const Node& node : neighbour_nodes) {
-    const auto neighbour_vertex = m_arch_mapping.get_vertex(node);
+  for (unsigned index : neighbour_indices) {
+    const auto neighbour_vertex =
+        m_arch_mapping.get_vertex_from_compiled_index(index);
     // GCOVR_EXCL_START
     TKET_ASSERT(
         neighbour_vertex != vertex ||
         AssertMessage()
-            << "get_neighbours: vertex " << vertex << " for node "
-            << node.repr() << " has " << neighbour_nodes.size()
+            << "get_neighbours: vertex " << vertex << " has "
+            << neighbour_indices.size()
             << " neighbours, and lists itself as a neighbour (loops not "
                "allowed)");
     // GCOVR_EXCL_STOP
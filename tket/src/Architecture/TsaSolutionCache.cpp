@@ -0,0 +1,133 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TsaSolutionCache.hpp"
+
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <tkassert/Assert.hpp>
+
+namespace tket {
+
+TsaSolutionCache::TsaSolutionCache(
+    std::size_t capacity, std::vector<BestTsaWithArch::Strategy> strategies,
+    unsigned max_threads)
+    : m_capacity(capacity),
+      m_strategies(std::move(strategies)),
+      m_max_threads(max_threads),
+      m_hits(0) {
+  TKET_ASSERT(m_capacity > 0);
+  TKET_ASSERT(!m_strategies.empty());
+}
+
+std::size_t TsaSolutionCache::KeyHash::operator()(const Key& key) const {
+  std::size_t seed = 0;
+  boost::hash_range(seed, key.nodes.begin(), key.nodes.end());
+  boost::hash_range(seed, key.edges.begin(), key.edges.end());
+  boost::hash_range(seed, key.mapping.begin(), key.mapping.end());
+  return seed;
+}
+
+std::optional<TsaSolutionCache::Key> TsaSolutionCache::get_key(
+    const Architecture& architecture,
+    const BestTsaWithArch::NodeMapping& node_mapping) {
+  Key key;
+  key.nodes = architecture.get_all_nodes_vec();
+  std::sort(key.nodes.begin(), key.nodes.end());
+  const auto get_index = [&key](const Node& node) -> std::optional<unsigned> {
+    const auto citer =
+        std::lower_bound(key.nodes.cbegin(), key.nodes.cend(), node);
+    if (citer == key.nodes.cend() || *citer != node) {
+      return std::nullopt;
+    }
+    return citer - key.nodes.cbegin();
+  };
+  for (const auto& [node1, node2] : architecture.get_all_edges_vec()) {
+    const unsigned index1 = get_index(node1).value();
+    const unsigned index2 = get_index(node2).value();
+    key.edges.emplace_back(
+        std::min(index1, index2), std::max(index1, index2));
+  }
+  std::sort(key.edges.begin(), key.edges.end());
+  key.edges.erase(
+      std::unique(key.edges.begin(), key.edges.end()), key.edges.end());
+  // The mapping is a std::map, so is already in Node order.
+  key.mapping.reserve(node_mapping.size());
+  for (const auto& [source, target] : node_mapping) {
+    const auto source_index = get_index(source);
+    const auto target_index = get_index(target);
+    if (!source_index || !target_index) {
+      return std::nullopt;
+    }
+    key.mapping.emplace_back(source_index.value(), target_index.value());
+  }
+  return key;
+}
+
+std::vector<std::pair<Node, Node>> TsaSolutionCache::get_swaps(
+    const Architecture& architecture,
+    const BestTsaWithArch::NodeMapping& node_mapping) {
+  if (std::all_of(
+          node_mapping.cbegin(), node_mapping.cend(),
+          [](const auto& entry) { return entry.first == entry.second; })) {
+    return {};
+  }
+  std::optional<Key> key = get_key(architecture, node_mapping);
+  if (!key) {
+    // Not a valid problem on this architecture;
+    // let get_swaps report the error.
+    return BestTsaWithArch::get_swaps(architecture, node_mapping);
+  }
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    const auto iter = m_entries.find(key.value());
+    if (iter != m_entries.end()) {
+      m_recently_used.splice(
+          m_recently_used.begin(), m_recently_used, iter->second.position);
+      ++m_hits;
+      return iter->second.swaps;
+    }
+  }
+  // Solve without holding the lock, so that other problems
+  // are not held up.
+  std::vector<std::pair<Node, Node>> swaps = BestTsaWithArch::get_swaps(
+      architecture, node_mapping, m_strategies, m_max_threads);
+
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  const auto [iter, inserted] =
+      m_entries.try_emplace(std::move(key.value()), Entry{swaps, {}});
+  if (!inserted) {
+    // Another thread solved the same problem meanwhile.
+    return swaps;
+  }
+  m_recently_used.push_front(&iter->first);
+  iter->second.position = m_recently_used.begin();
+  if (m_entries.size() > m_capacity) {
+    m_entries.erase(*m_recently_used.back());
+    m_recently_used.pop_back();
+  }
+  return swaps;
+}
+
+std::size_t TsaSolutionCache::size() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+std::size_t TsaSolutionCache::get_hits() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hits;
+}
+
+}  // namespace tket
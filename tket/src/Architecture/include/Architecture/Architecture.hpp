@@ -15,6 +15,8 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <set>
 #include <string>
@@ -37,6 +39,8 @@ extern template class graphs::DirectedGraph<Node>;
 
 using dist_vec = graphs::dist_vec;
 
+class CompiledArchitecture;
+
 class ArchitectureInvalidity : public std::logic_error {
  public:
   explicit ArchitectureInvalidity(const std::string &message)
@@ -129,9 +133,62 @@ class Architecture : public ArchitectureBase<graphs::DirectedGraph<Node>> {
    */
   MatrixXb get_connectivity() const;
 
+  /**
+   * Dense, immutable form of the Architecture, with all distances.
+   *
+   * Computed on the first call, and then shared (also with copies of this
+   * Architecture) until the Architecture is modified. Safe to call from
+   * several threads at once, provided nothing modifies the Architecture.
+   */
+  std::shared_ptr<const CompiledArchitecture> get_compiled() const;
+
+  /**
+   * The largest distance between two nodes, from the compiled form.
+   */
+  unsigned get_diameter() override;
+
+  /**
+   * The distance between two nodes, from the compiled form.
+   *
+   * @throws graphs::NodesNotConnected if there is no path
+   */
+  unsigned get_distance(const Node &node1, const Node &node2) const override;
+
+  /**
+   * Returns path between two nodes, from target back to root.
+   *
+   * The same path as DirectedGraph::get_path, but read from the next-hop
+   * table of the compiled form rather than by a new search.
+   */
+  node_vector_t get_path(const Node &root, const Node &target) const;
+
  protected:
   // Returns node with least connectivity given some distance matrix.
   std::optional<Node> find_worst_node(const Architecture &orig_g);
+
+  void invalidate_cache() override;
+
+ private:
+  struct CompiledCache {
+    CompiledCache() = default;
+    // Copies share the compiled form, which is immutable, but not the lock.
+    CompiledCache(const CompiledCache &other) : compiled(other.get()) {}
+    CompiledCache &operator=(const CompiledCache &other) {
+      std::shared_ptr<const CompiledArchitecture> other_compiled = other.get();
+      std::lock_guard<std::mutex> lock(mutex);
+      compiled = std::move(other_compiled);
+      return *this;
+    }
+    std::shared_ptr<const CompiledArchitecture> get() const {
+      std::lock_guard<std::mutex> lock(mutex);
+      return compiled;
+    }
+
+    mutable std::mutex mutex;
+    std::shared_ptr<const CompiledArchitecture> compiled;
+  };
+  // Reset in place on modification.
+  mutable CompiledCache compiled_cache_;
 };
 
 JSON_DECL(Architecture::Connection)
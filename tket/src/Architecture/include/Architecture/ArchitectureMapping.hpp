@@ -17,6 +17,7 @@
 #include <tktokenswap/SwapFunctions.hpp>
 
 #include "Architecture/Architecture.hpp"
+#include "Architecture/CompiledArchitecture.hpp"
 
 namespace tket {
 
@@ -95,6 +96,25 @@ class ArchitectureMapping {
    */
   std::vector<Swap> get_edges() const;
 
+  /** The compiled form of the Architecture, taken at construction.
+   *  Its indices are NOT the same as the vertex numbers;
+   *  use get_compiled_index and get_vertex_from_compiled_index.
+   *  @return The shared compiled Architecture.
+   */
+  const CompiledArchitecture& get_compiled_architecture() const;
+
+  /** The index of the vertex within get_compiled_architecture().
+   *  @param vertex The vertex created by this ArchitectureMapping object.
+   *  @return The index of the same node in the CompiledArchitecture.
+   */
+  unsigned get_compiled_index(size_t vertex) const;
+
+  /** Reverse of get_compiled_index.
+   *  @param index An index within get_compiled_architecture().
+   *  @return The vertex created by this ArchitectureMapping object.
+   */
+  size_t get_vertex_from_compiled_index(unsigned index) const;
+
  private:
   /// Store a reference to the Architecture passed into the constructor.
   const Architecture& m_arch;
@@ -104,6 +124,19 @@ class ArchitectureMapping {
 
   /// Reverse of m_vertex_to_node_mapping; look up the index of a node.
   std::map<Node, size_t> m_node_to_vertex_mapping;
+
+  /// Shared with the Architecture object (and anything else using it).
+  std::shared_ptr<const CompiledArchitecture> m_compiled;
+
+  /// Element i is the compiled index of vertex i.
+  std::vector<unsigned> m_vertex_to_compiled_index;
+
+  /// Reverse of m_vertex_to_compiled_index.
+  std::vector<size_t> m_compiled_index_to_vertex;
+
+  /// Set up the translation to and from compiled indices,
+  /// once the vertices are known.
+  void set_compiled_indices();
 };
 
 }  // namespace tket
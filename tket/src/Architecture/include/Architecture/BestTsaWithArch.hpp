@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <tktokenswap/CyclesGrowthManager.hpp>
 #include <tktokenswap/VertexMappingFunctions.hpp>
 
 #include "ArchitectureMapping.hpp"
@@ -24,6 +25,26 @@ namespace tket {
  * using Architecture objects directly to find distances and neighbours.
  */
 struct BestTsaWithArch {
+  /** The free parameters of BestFullTsa. Different strategies may give
+   * solutions of different lengths for the same problem; the default
+   * strategy is the one used when none is specified.
+   */
+  struct Strategy {
+    /** Seed for the RNG used by RiverFlowPathFinder to choose between
+     * equally short paths (the default is the RNG default seed).
+     */
+    std::size_t seed = 5489;
+
+    /** Limits on the cycles grown by the cycles TSA. */
+    tsa_internal::CyclesGrowthManager::Options cycles_options;
+  };
+
+  /** The default strategy, followed by variations of its seed and cycle
+   * growth options, for use with the multi-strategy get_swaps.
+   * @return A list of strategies, starting with Strategy().
+   */
+  static std::vector<Strategy> get_default_strategies();
+
   /** Given the desired vertex mapping, a list
    * of swaps (which may or may not be empty), and information about
    * the architecture (the underlying graph), append extra swaps to it
@@ -38,6 +59,18 @@ struct BestTsaWithArch {
       SwapList& swaps, VertexMapping& vertex_mapping,
       const ArchitectureMapping& arch_mapping);
 
+  /** As append_solution above, but using the given strategy.
+   *  @param swaps The list of swaps to append to.
+   *  @param vertex_mapping The current desired mapping. Will be updated with
+   * the new added swaps.
+   *  @param arch_mapping An ArchitectureMapping object, which knows the graph,
+   * and how to do Node <-> vertex size_t conversions.
+   *  @param strategy The parameters to use.
+   */
+  static void append_solution(
+      SwapList& swaps, VertexMapping& vertex_mapping,
+      const ArchitectureMapping& arch_mapping, const Strategy& strategy);
+
   /** This specifies desired source->target vertex mappings.
    *  Any nodes not occurring as a key might be moved by the algorithm.
    */
@@ -60,6 +93,22 @@ struct BestTsaWithArch {
    */
   static std::vector<std::pair<Node, Node>> get_swaps(
       const Architecture& architecture, const NodeMapping& node_mapping);
+
+  /** As get_swaps above, but solving the problem once for each strategy,
+   * in parallel, and returning the shortest solution found (the earliest
+   * strategy wins ties, so the result is deterministic).
+   * Each thread works on its own copy of the architecture, so the
+   * architecture is only read.
+   *  @param architecture The raw object containing the graph.
+   *  @param node_mapping The desired source->target node mapping.
+   *  @param strategies The strategies to try; must be nonempty.
+   *  @param max_threads Upper bound on the number of threads,
+   *    or 0 to use the hardware concurrency.
+   *  @return The shortest list of node pairs to swap found.
+   */
+  static std::vector<std::pair<Node, Node>> get_swaps(
+      const Architecture& architecture, const NodeMapping& node_mapping,
+      const std::vector<Strategy>& strategies, unsigned max_threads = 0);
 };
 
 }  // namespace tket
@@ -0,0 +1,232 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Architecture/Architecture.hpp"
+
+namespace tket {
+
+/**
+ * An immutable, densely indexed snapshot of an Architecture, for the
+ * components (token swapping, routing, placement) which otherwise each
+ * build their own index, distance and neighbour structures.
+ *
+ * The nodes are numbered 0,1,...,n-1 in the internal order of the
+ * Architecture, i.e. the order of the vertices in get_directed_connectivity()
+ * (which is also the order of the vectors returned by get_distances).
+ * Connectivity is undirected throughout.
+ *
+ * Distances and shortest paths are stored as n x n tables of 16-bit
+ * entries; shortest paths as next-hop tables, i.e. for every target node,
+ * the next node along a chosen shortest path from every other node. These
+ * are compact but still quadratic, so a memory budget limits them: the
+ * distance table is stored if it fits, then the next-hop table if both fit.
+ * Anything not stored is computed one row (one breadth-first search) at a
+ * time, and only a bounded number of rows are kept. The results are the
+ * same either way.
+ *
+ * Obtain one with Architecture::get_compiled(), which computes it once and
+ * shares it until the Architecture is next modified.
+ */
+class CompiledArchitecture {
+ public:
+  /** Returned by get_distance for nodes in different connected components. */
+  static constexpr unsigned unreachable = std::numeric_limits<unsigned>::max();
+
+  /** Default upper bound on the memory used for distance and next-hop data.
+   */
+  static constexpr std::size_t default_max_table_bytes = std::size_t(64)
+                                                         << 20;
+
+  /**
+   * Compute all the data for the given Architecture.
+   *
+   * @param arch The Architecture, which may be modified or destroyed
+   *    afterwards without affecting this object.
+   * @param max_table_bytes Bound on the memory used for distance and
+   *    next-hop data. Tables which do not fit are not stored; their rows are
+   *    instead computed on demand, and only as many kept as fit in what
+   *    remains (but always at least one).
+   */
+  explicit CompiledArchitecture(
+      const Architecture &arch,
+      std::size_t max_table_bytes = default_max_table_bytes);
+
+  /** The number of nodes. */
+  unsigned n_nodes() const;
+
+  /** All the nodes, element i having index i. */
+  const std::vector<Node> &get_nodes() const;
+
+  /** The node with the given index. */
+  const Node &get_node(unsigned index) const;
+
+  /**
+   * The index of a node.
+   *
+   * @throws graphs::NodeDoesNotExistError if the node is not in the
+   *    Architecture.
+   */
+  unsigned get_index(const Node &node) const;
+
+  /** Whether the node is in the Architecture. */
+  bool node_exists(const Node &node) const;
+
+  /** The indices of all neighbours of a node, in increasing order. */
+  std::span<const unsigned> get_neighbours(unsigned index) const;
+
+  /** The number of neighbours of a node. */
+  unsigned get_degree(unsigned index) const;
+
+  /** Whether the nodes are joined by an edge, in either direction. */
+  bool edge_exists(unsigned index1, unsigned index2) const;
+
+  /**
+   * The length of a shortest path between two nodes.
+   *
+   * @return the distance, or @ref unreachable if there is no path
+   */
+  unsigned get_distance(unsigned index1, unsigned index2) const;
+
+  /**
+   * The length of a shortest path between two nodes.
+   *
+   * @throws graphs::NodesNotConnected if there is no path
+   */
+  unsigned get_distance(const Node &node1, const Node &node2) const;
+
+  /**
+   * The distances from a node to every node, element i being the distance
+   * to the node with index i (@ref unreachable if there is no path).
+   */
+  std::vector<unsigned> get_distances(unsigned index) const;
+
+  /**
+   * The largest distance between two nodes.
+   *
+   * @throws std::logic_error if there are no nodes
+   * @throws graphs::NodesNotConnected if the Architecture is disconnected
+   */
+  unsigned get_diameter() const;
+
+  /** Whether removing the node would disconnect its connected component. */
+  bool is_articulation_point(unsigned index) const;
+
+  /** Nodes that cannot be removed without breaking connectivity. */
+  const node_set_t &get_articulation_points() const;
+
+  /** Whether the complete distance table is stored. */
+  bool has_distance_table() const;
+
+  /** Whether the complete next-hop table is stored. */
+  bool has_next_hop_table() const;
+
+  /**
+   * The most memory which the distance and next-hop data can use, in bytes:
+   * the stored tables, plus the largest possible cache of rows.
+   */
+  std::size_t get_max_table_bytes() const;
+
+  /**
+   * The node following index1 on the chosen shortest path to index2.
+   *
+   * @return the next node (index2 itself if index1 == index2), or
+   *    @ref unreachable if there is no path
+   */
+  unsigned get_next_hop(unsigned index1, unsigned index2) const;
+
+  /**
+   * The chosen shortest path between two nodes, in O(path length) time
+   * (given a stored row).
+   *
+   * This is the same path, in the same order, as
+   * Architecture::get_path(node2, node1).
+   *
+   * @return indices of the nodes on the path, from index1 to index2
+   *    inclusive, or an empty vector if there is no path
+   */
+  std::vector<unsigned> get_path(unsigned index1, unsigned index2) const;
+
+ private:
+  /** The result of one breadth-first search, towards a single target. */
+  struct SearchRow {
+    std::vector<unsigned> distances;
+    std::vector<unsigned> next_hops;
+  };
+
+  /** Used when a table is too large to store in full. */
+  struct SearchRowCache {
+    std::mutex mutex;
+    std::size_t max_rows;
+    /** Targets, most recently used first. */
+    std::list<unsigned> targets;
+    std::unordered_map<
+        unsigned,
+        std::pair<
+            std::shared_ptr<const SearchRow>, std::list<unsigned>::iterator>>
+        rows;
+  };
+
+  /** Stands for "no path" in distances_ and next_hops_. */
+  static constexpr std::uint16_t no_entry =
+      std::numeric_limits<std::uint16_t>::max();
+
+  std::vector<Node> nodes_;
+  std::map<Node, unsigned> node_to_index_;
+
+  /** Neighbours of node i are neighbours_[neighbour_offsets_[i]] up to
+   *  neighbours_[neighbour_offsets_[i+1]] (exclusive), sorted. */
+  std::vector<unsigned> neighbour_offsets_;
+  std::vector<unsigned> neighbours_;
+
+  /** If not empty, the row-major n x n distance matrix. */
+  std::vector<std::uint16_t> distances_;
+
+  std::vector<bool> is_articulation_point_;
+  node_set_t articulation_points_;
+
+  /** If not empty, entry (i,j) (row-major) is the next node after j on
+   *  the chosen shortest path to i. */
+  std::vector<std::uint16_t> next_hops_;
+
+  /** Only used if distances_ or next_hops_ is empty. */
+  std::unique_ptr<SearchRowCache> search_row_cache_;
+
+  /** The largest finite distance. */
+  unsigned max_finite_distance_;
+  bool connected_;
+
+  /** Breadth-first search from the root. Element v of "next_hops" becomes
+   *  the node after v on the chosen path from v to the root (or unreachable);
+   *  "queue" is workspace. Returns the number of nodes reached. */
+  unsigned search(
+      unsigned root, unsigned *distances, unsigned *next_hops,
+      unsigned *queue) const;
+
+  /** The search row for the target, from the cache or computed. */
+  std::shared_ptr<const SearchRow> get_search_row(unsigned target) const;
+};
+
+}  // namespace tket
@@ -0,0 +1,106 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "BestTsaWithArch.hpp"
+
+namespace tket {
+
+/** A thread-safe, least recently used cache of BestTsaWithArch solutions.
+ *
+ * Problems are keyed by the Architecture, in the canonical form of its
+ * sorted Nodes and sorted undirected edges, together with the node mapping.
+ * Equal problems on equal (but separately constructed) architectures
+ * therefore share an entry. Solutions are computed with the strategies
+ * given on construction; with a single strategy the token swapping is
+ * deterministic, so a cached solution is exactly what would be recomputed
+ * (up to the vertex numbering of the first architecture it was computed on).
+ */
+class TsaSolutionCache {
+ public:
+  /** @param capacity The maximum number of solutions to keep; must be
+   *    positive.
+   *  @param strategies The strategies to run for each new problem.
+   *  @param max_threads Upper bound on the number of threads used to run
+   *    several strategies, or 0 to use the hardware concurrency.
+   */
+  explicit TsaSolutionCache(
+      std::size_t capacity = 1000,
+      std::vector<BestTsaWithArch::Strategy> strategies = {
+          BestTsaWithArch::Strategy()},
+      unsigned max_threads = 0);
+
+  /** As BestTsaWithArch::get_swaps, but answering repeated problems
+   *  from the cache.
+   *  @param architecture The raw object containing the graph.
+   *  @param node_mapping The desired source->target node mapping.
+   *  @return The required list of node pairs to swap.
+   */
+  std::vector<std::pair<Node, Node>> get_swaps(
+      const Architecture& architecture,
+      const BestTsaWithArch::NodeMapping& node_mapping);
+
+  /** The number of solutions currently stored. */
+  std::size_t size() const;
+
+  /** The number of calls to get_swaps answered from the cache. */
+  std::size_t get_hits() const;
+
+ private:
+  /** A problem, with every Node replaced by its index in the sorted
+   *  list of all Nodes of the architecture.
+   */
+  struct Key {
+    std::vector<Node> nodes;
+    std::vector<std::pair<unsigned, unsigned>> edges;
+    std::vector<std::pair<unsigned, unsigned>> mapping;
+
+    bool operator==(const Key& other) const = default;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    std::vector<std::pair<Node, Node>> swaps;
+    /** Position in m_recently_used. */
+    std::list<const Key*>::iterator position;
+  };
+
+  const std::size_t m_capacity;
+  const std::vector<BestTsaWithArch::Strategy> m_strategies;
+  const unsigned m_max_threads;
+
+  mutable std::mutex m_mutex;
+  std::unordered_map<Key, Entry, KeyHash> m_entries;
+  /** Keys of m_entries, most recently used first. */
+  std::list<const Key*> m_recently_used;
+  std::size_t m_hits;
+
+  static std::optional<Key> get_key(
+      const Architecture& architecture,
+      const BestTsaWithArch::NodeMapping& node_mapping);
+};
+
+}  // namespace tket
@@ -15,16 +15,16 @@
 #include "Characterisation/DeviceCharacterisation.hpp"
 
 #include <optional>
+#include <stdexcept>
 
 namespace tket {
 
-// simple get key wrapped in std::optional
+// simple get key, nullptr if absent
 template <typename T>
-static std::optional<typename T::mapped_type> maybe_get(
+static const typename T::mapped_type* maybe_get(
     const T& error_map, const typename T::key_type& key) {
   const auto& it = error_map.find(key);
-  return (it != error_map.end()) ? std::make_optional(it->second)
-                                 : std::nullopt;
+  return (it != error_map.end()) ? &it->second : nullptr;
 }
 
 DeviceCharacterisation::DeviceCharacterisation(
@@ -47,14 +47,14 @@ DeviceCharacterisation::DeviceCharacterisation(
 
 // single-qubit case
 gate_error_t DeviceCharacterisation::get_error(const Node& n) const {
-  std::optional<gate_error_t> maybe_err = maybe_get(default_node_errors_, n);
+  const gate_error_t* maybe_err = maybe_get(default_node_errors_, n);
   return maybe_err ? *maybe_err : 0.;
 }
 gate_error_t DeviceCharacterisation::get_error(
     const Node& n, const OpType& op) const {
-  std::optional<op_errors_t> maybe_dict = maybe_get(op_node_errors_, n);
+  const op_errors_t* maybe_dict = maybe_get(op_node_errors_, n);
   if (maybe_dict) {
-    std::optional<gate_error_t> maybe_err = maybe_get(*maybe_dict, op);
+    const gate_error_t* maybe_err = maybe_get(*maybe_dict, op);
     if (maybe_err) {
       return *maybe_err;
     }
@@ -65,14 +65,14 @@ gate_error_t DeviceCharacterisation::get_error(
 // two-qubit case
 gate_error_t DeviceCharacterisation::get_error(
     const Architecture::Connection& link) const {
-  std::optional<gate_error_t> maybe_err = maybe_get(default_link_errors_, link);
+  const gate_error_t* maybe_err = maybe_get(default_link_errors_, link);
   return maybe_err ? *maybe_err : 0.;
 }
 gate_error_t DeviceCharacterisation::get_error(
     const Architecture::Connection& link, const OpType& op) const {
-  std::optional<op_errors_t> maybe_dict = maybe_get(op_link_errors_, link);
+  const op_errors_t* maybe_dict = maybe_get(op_link_errors_, link);
   if (maybe_dict) {
-    std::optional<gate_error_t> maybe_err = maybe_get(*maybe_dict, op);
+    const gate_error_t* maybe_err = maybe_get(*maybe_dict, op);
     if (maybe_err) {
       return *maybe_err;
     }
@@ -81,7 +81,7 @@ gate_error_t DeviceCharacterisation::get_error(
 }
 
 readout_error_t DeviceCharacterisation::get_readout_error(const Node& n) const {
-  std::optional<gate_error_t> maybe_err = maybe_get(default_readout_errors_, n);
+  const gate_error_t* maybe_err = maybe_get(default_readout_errors_, n);
   return maybe_err ? *maybe_err : 0.;
 }
 
@@ -110,4 +110,92 @@ void from_json(const nlohmann::json& j, DeviceCharacterisation& dc) {
   dc.op_link_errors_ = j.at("op_link_errors").get<op_link_errors_t>();
 }
 
+DenseDeviceCharacterisation::DenseDeviceCharacterisation(
+    const DeviceCharacterisation& characterisation,
+    const std::vector<Node>& nodes)
+    : nodes_(nodes),
+      node_errors_(nodes.size(), 0.),
+      readout_errors_(nodes.size(), 0.) {
+  const unsigned n = nodes_.size();
+  for (unsigned i = 0; i < n; i++) {
+    if (!node_indices_.insert({nodes_[i], i}).second) {
+      throw std::invalid_argument(
+          "DenseDeviceCharacterisation requires distinct Nodes");
+    }
+  }
+  for (const auto& [node, error] : characterisation.default_node_errors_) {
+    if (std::optional<unsigned> i = get_index(node)) {
+      node_errors_[*i] = error;
+    }
+  }
+  for (const auto& [node, error] : characterisation.default_readout_errors_) {
+    if (std::optional<unsigned> i = get_index(node)) {
+      readout_errors_[*i] = error;
+    }
+  }
+  // the n x n link matrix is only needed if some link has an error
+  if (!characterisation.default_link_errors_.empty() ||
+      !characterisation.op_link_errors_.empty()) {
+    link_errors_.assign(n * n, 0.);
+  }
+  for (const auto& [link, error] : characterisation.default_link_errors_) {
+    std::optional<unsigned> i0 = get_index(link.first);
+    std::optional<unsigned> i1 = get_index(link.second);
+    if (i0 && i1) {
+      link_errors_[*i0 * n + *i1] = error;
+    }
+  }
+
+  // OpType-specific tables start as copies of the defaults they fall back to
+  for (const auto& [node, op_errors] : characterisation.op_node_errors_) {
+    std::optional<unsigned> i = get_index(node);
+    if (!i) continue;
+    for (const auto& [op, error] : op_errors) {
+      auto [it, inserted] =
+          node_op_indices_.insert({op, node_op_indices_.size()});
+      if (inserted) {
+        op_node_errors_.insert(
+            op_node_errors_.end(), node_errors_.begin(), node_errors_.end());
+      }
+      op_node_errors_[it->second * n + *i] = error;
+    }
+  }
+  for (const auto& [link, op_errors] : characterisation.op_link_errors_) {
+    std::optional<unsigned> i0 = get_index(link.first);
+    std::optional<unsigned> i1 = get_index(link.second);
+    if (!i0 || !i1) continue;
+    for (const auto& [op, error] : op_errors) {
+      auto [it, inserted] =
+          link_op_indices_.insert({op, link_op_indices_.size()});
+      if (inserted) {
+        op_link_errors_.insert(
+            op_link_errors_.end(), link_errors_.begin(), link_errors_.end());
+      }
+      op_link_errors_[(it->second * n + *i0) * n + *i1] = error;
+    }
+  }
+}
+
+std::optional<unsigned> DenseDeviceCharacterisation::get_index(
+    const Node& n) const {
+  auto it = node_indices_.find(n);
+  if (it == node_indices_.end()) return std::nullopt;
+  return it->second;
+}
+
+gate_error_t DenseDeviceCharacterisation::get_error(
+    unsigned n, OpType op) const {
+  auto it = node_op_indices_.find(op);
+  if (it == node_op_indices_.end()) return get_error(n);
+  return op_node_errors_[it->second * nodes_.size() + n];
+}
+
+gate_error_t DenseDeviceCharacterisation::get_error(
+    unsigned n0, unsigned n1, OpType op) const {
+  auto it = link_op_indices_.find(op);
+  if (it == link_op_indices_.end()) return get_error(n0, n1);
+  const unsigned n = nodes_.size();
+  return op_link_errors_[(it->second * n + n0) * n + n1];
+}
+
 }  // namespace tket
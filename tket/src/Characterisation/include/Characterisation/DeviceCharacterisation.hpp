@@ -16,6 +16,8 @@
 
 #include <map>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <vector>
 
 #include "Architecture/Architecture.hpp"
 #include "ErrorTypes.hpp"
@@ -63,6 +65,8 @@ class DeviceCharacterisation {
   friend void to_json(nlohmann::json& j, const DeviceCharacterisation& dc);
   friend void from_json(const nlohmann::json& j, DeviceCharacterisation& dc);
 
+  friend class DenseDeviceCharacterisation;
+
  private:
   // default errors per Node
   avg_node_errors_t default_node_errors_;
@@ -76,4 +80,63 @@ class DeviceCharacterisation {
 
 JSON_DECL(DeviceCharacterisation)
 
+/**
+ * Compiled form of a DeviceCharacterisation for a fixed list of Nodes, for
+ * use in inner loops.
+ *
+ * Each Node is identified with its position in the list, and errors are
+ * stored in flat arrays indexed by position (n x n matrices for links), so
+ * that once a Node has been indexed every lookup is O(1). OpType-specific
+ * tables are only stored for the OpTypes the characterisation mentions.
+ * Lookups fall back in the same way as for DeviceCharacterisation, and errors
+ * for Nodes outside the list are dropped.
+ */
+class DenseDeviceCharacterisation {
+ public:
+  DenseDeviceCharacterisation(
+      const DeviceCharacterisation& characterisation,
+      const std::vector<Node>& nodes);
+
+  unsigned n_nodes() const { return nodes_.size(); }
+  const std::vector<Node>& get_nodes() const { return nodes_; }
+
+  /**
+   * @param n Node to look up
+   * @return Position of n in the list of Nodes, if present
+   */
+  std::optional<unsigned> get_index(const Node& n) const;
+
+  // get device gate errors by Node index, preferring OpType-specific over
+  // default values over 0. error
+  // single-qubit case
+  gate_error_t get_error(unsigned n) const { return node_errors_[n]; }
+  gate_error_t get_error(unsigned n, OpType op) const;
+  // two-qubit case
+  gate_error_t get_error(unsigned n0, unsigned n1) const {
+    return link_errors_.empty() ? 0. : link_errors_[n0 * nodes_.size() + n1];
+  }
+  gate_error_t get_error(unsigned n0, unsigned n1, OpType op) const;
+  // readout errors
+  readout_error_t get_readout_error(unsigned n) const {
+    return readout_errors_[n];
+  }
+
+ private:
+  std::vector<Node> nodes_;
+  std::map<Node, unsigned> node_indices_;
+
+  std::vector<gate_error_t> node_errors_;
+  std::vector<readout_error_t> readout_errors_;
+  // error of link (n0, n1) at n0 * n_nodes() + n1, empty if there are no
+  // link errors
+  std::vector<gate_error_t> link_errors_;
+
+  // the k-th OpType with specific errors has its table at k * n_nodes() in
+  // op_node_errors_, or k * n_nodes() * n_nodes() in op_link_errors_
+  std::map<OpType, unsigned> node_op_indices_;
+  std::vector<gate_error_t> op_node_errors_;
+  std::map<OpType, unsigned> link_op_indices_;
+  std::vector<gate_error_t> op_link_errors_;
+};
+
 }  // namespace tket
@@ -14,6 +14,8 @@
 
 #include "CircUtils.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <complex>
 #include <sstream>
@@ -25,6 +27,7 @@
 #include "Gate/GateUnitaryMatrixImplementations.hpp"
 #include "Gate/Rotation.hpp"
 #include "OpType/OpType.hpp"
+#include "OpType/OpTypeFunctions.hpp"
 #include "Ops/Op.hpp"
 #include "Utils/EigenConfig.hpp"
 #include "Utils/Expression.hpp"
@@ -60,86 +63,181 @@ Eigen::Matrix2cd get_matrix_from_circ(const Circuit &circ) {
   return factor * m;
 }
 
-Eigen::Matrix4cd get_matrix_from_2qb_circ(const Circuit &circ) {
-  std::vector<QPathDetailed> all_paths = circ.all_qubit_paths();
-  std::map<Vertex, Eigen::Matrix4cd> v_to_op;
-  Eigen::Matrix4cd cnot, tonc, swap;
-  // clang-format off
-    cnot << 1, 0, 0, 0,
-            0, 1, 0, 0,
-            0, 0, 0, 1,
-            0, 0, 1, 0;
-    tonc << 1, 0, 0, 0,
-            0, 0, 0, 1,
-            0, 0, 1, 0,
-            0, 1, 0, 0;
-    swap << 1, 0, 0, 0,
-            0, 0, 1, 0,
-            0, 1, 0, 0,
-            0, 0, 0, 1;
-  // clang-format on
-
-  for (unsigned uqb = 0; uqb < 2; uqb++) {
-    for (QPathDetailed::iterator it = all_paths[uqb].begin();
-         it != all_paths[uqb].end(); ++it) {
-      const Op_ptr o = circ.get_Op_ptr_from_Vertex(it->first);
-      switch (o->get_type()) {
-        case OpType::Input:
-        case OpType::Create:
-        case OpType::Output:
-        case OpType::Discard: {
-          v_to_op[it->first] = Eigen::Matrix4cd::Identity();
-          break;
-        }
-        case OpType::SWAP: {
-          if (uqb == 0) v_to_op[it->first] = swap;
-          break;
-        }
-        case OpType::CX: {
-          if (uqb == 0) {
-            if (it->second == 0) {
-              v_to_op[it->first] = cnot;
-            } else {
-              v_to_op[it->first] = tonc;
-            }
-          }
-          break;
-        }
-        case OpType::TK2: {
-          auto params = o->get_params();
-          TKET_ASSERT(params.size() == 3);
-          v_to_op[it->first] =
-              get_matrix_from_2qb_circ(CircPool::normalised_TK2_using_CX(
-                  params[0], params[1], params[2]));
-          break;
-        }
-        default: {
-          if (o->get_desc().is_gate() && circ.n_in_edges(it->first) == 1 &&
-              circ.n_out_edges(it->first) == 1) {
-            const Op_ptr g = o;
-            std::vector<Expr> ps = as_gate_ptr(g)->get_tk1_angles();
-            Eigen::Matrix2cd mat = get_matrix_from_tk1_angles(ps);
-            if (uqb == 0) {
-              v_to_op[it->first] =
-                  Eigen::kroneckerProduct(mat, Eigen::Matrix2cd::Identity());
-            } else {
-              v_to_op[it->first] =
-                  Eigen::kroneckerProduct(Eigen::Matrix2cd::Identity(), mat);
-            }
-          } else
-            throw BadOpType("Cannot obtain matrix from op", o->get_type());
-        }
+namespace {
+
+// Accumulates a product of one- and two-qubit gates on N wires into a
+// fixed-size matrix, in ILO-BE order (wire 0 is the most significant bit).
+// Each gate updates the rows it touches in place, rather than forming its
+// full 2^N x 2^N matrix.
+template <unsigned N>
+class UnitaryAccumulator {
+ public:
+  static constexpr unsigned dim = 1u << N;
+  typedef Eigen::Matrix<Complex, dim, dim> Matrix;
+  typedef Eigen::Matrix<Complex, 1, dim> Row;
+
+  UnitaryAccumulator() : U_(Matrix::Identity()) {}
+
+  const Matrix &get() const { return U_; }
+
+  // Left-multiply by the gate at vertex v, whose quantum ports 0, 1 are on
+  // the given wires.
+  void apply(const Circuit &circ, const Vertex &v, const unsigned *wires) {
+    const Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
+    const OpType type = op->get_type();
+    if (!op->get_desc().is_gate()) {
+      throw BadOpType("Cannot obtain matrix from op", type);
+    }
+    const unsigned n_qubits = circ.n_in_edges(v);
+    if (n_qubits == 1) {
+      const std::vector<Expr> angles = as_gate_ptr(op)->get_tk1_angles();
+      apply_1q(get_matrix_from_tk1_angles(angles), wires[0]);
+      return;
+    }
+    if (n_qubits != 2) {
+      throw CircuitInvalidity(
+          "Cannot obtain matrix of a region containing gates on more than "
+          "2 qubits");
+    }
+    const unsigned bit0 = bit(wires[0]);
+    const unsigned bit1 = bit(wires[1]);
+    // Permutations and signs need no arithmetic.
+    switch (type) {
+      case OpType::CX:
+        for_each_block(bit0, bit1, [&](unsigned r) {
+          U_.row(r | bit0).swap(U_.row(r | bit0 | bit1));
+        });
+        return;
+      case OpType::CZ:
+        for_each_block(bit0, bit1, [&](unsigned r) {
+          U_.row(r | bit0 | bit1) *= -1.;
+        });
+        return;
+      case OpType::SWAP:
+        for_each_block(bit0, bit1, [&](unsigned r) {
+          U_.row(r | bit0).swap(U_.row(r | bit1));
+        });
+        return;
+      default: {
+        const Eigen::Matrix4cd m = op->get_unitary();
+        for_each_block(bit0, bit1, [&](unsigned r) {
+          const unsigned rows[4] = {r, r | bit1, r | bit0, r | bit0 | bit1};
+          Eigen::Matrix<Complex, 4, dim> block;
+          for (unsigned k = 0; k < 4; ++k) block.row(k) = U_.row(rows[k]);
+          block = (m * block).eval();
+          for (unsigned k = 0; k < 4; ++k) U_.row(rows[k]) = block.row(k);
+        });
       }
     }
   }
-  Eigen::Matrix4cd m = Eigen::Matrix4cd::Identity();
-  SliceVec slices = circ.get_slices();
-  for (const Slice &s : slices) {
-    for (const Vertex &v : s) {
-      m = v_to_op[v] * m;
+
+ private:
+  Matrix U_;
+
+  static unsigned bit(unsigned wire) { return 1u << (N - 1 - wire); }
+
+  // Call f(r) for every row index r with both bits clear.
+  template <typename F>
+  static void for_each_block(unsigned bit0, unsigned bit1, F &&f) {
+    for (unsigned r = 0; r < dim; ++r) {
+      if ((r & (bit0 | bit1)) == 0) f(r);
     }
   }
-  return std::exp(i_ * PI * eval_expr(circ.get_phase()).value()) * m;
+
+  void apply_1q(const Eigen::Matrix2cd &u, unsigned wire) {
+    const unsigned b = bit(wire);
+    for (unsigned r = 0; r < dim; ++r) {
+      if (r & b) continue;
+      const Row row0 = U_.row(r);
+      const Row row1 = U_.row(r | b);
+      U_.row(r) = u(0, 0) * row0 + u(0, 1) * row1;
+      U_.row(r | b) = u(1, 0) * row0 + u(1, 1) * row1;
+    }
+  }
+};
+
+// Multiply together the gates of a region on N wires, stepping along the
+// wires from the in-edges and applying each vertex once all of its in-edges
+// have been reached.
+template <unsigned N>
+typename UnitaryAccumulator<N>::Matrix get_matrix_from_subcircuit(
+    const Circuit &circ, const Subcircuit &sub) {
+  if (sub.q_in_hole.size() != N) {
+    throw CircuitInvalidity(
+        "Getting Matrix: expected " + std::to_string(N) +
+        " qubit region, found " + std::to_string(sub.q_in_hole.size()));
+  }
+  UnitaryAccumulator<N> acc;
+  std::array<Edge, N> frontier;
+  std::copy(sub.q_in_hole.begin(), sub.q_in_hole.end(), frontier.begin());
+  std::size_t n_applied = 0;
+  while (n_applied < sub.verts.size()) {
+    bool progress = false;
+    for (unsigned w = 0; w < N; ++w) {
+      const Vertex v = circ.target(frontier[w]);
+      if (!sub.verts.contains(v)) continue;
+      const EdgeVec ins = circ.get_in_edges(v);
+      if (ins.size() > N) {
+        throw CircuitInvalidity(
+            "Cannot obtain matrix of a region containing gates on more than "
+            "2 qubits");
+      }
+      unsigned wires[N];
+      bool ready = true;
+      for (unsigned p = 0; p < ins.size() && ready; ++p) {
+        const auto it = std::find(frontier.begin(), frontier.end(), ins[p]);
+        ready = it != frontier.end();
+        wires[p] = it - frontier.begin();
+      }
+      if (!ready) continue;
+      acc.apply(circ, v, wires);
+      for (unsigned p = 0; p < ins.size(); ++p) {
+        frontier[wires[p]] = circ.get_next_edge(v, ins[p]);
+      }
+      ++n_applied;
+      progress = true;
+    }
+    if (!progress) {
+      throw CircuitInvalidity(
+          "Getting Matrix: region is not closed under its in-edges");
+    }
+  }
+  return acc.get();
+}
+
+}  // namespace
+
+Subcircuit whole_circuit(const Circuit &circ) {
+  Subcircuit sub;
+  for (const Qubit &q : circ.all_qubits()) {
+    sub.q_in_hole.push_back(circ.get_nth_out_edge(circ.get_in(q), 0));
+  }
+  BGL_FORALL_VERTICES(v, circ.dag, DAG) {
+    if (!is_boundary_q_type(circ.get_OpType_from_Vertex(v)) &&
+        circ.n_in_edges_of_type(v, EdgeType::Quantum) != 0) {
+      sub.verts.insert(v);
+    }
+  }
+  return sub;
+}
+
+Eigen::Matrix4cd get_matrix_from_2qb_circ(const Circuit &circ) {
+  if (circ.n_qubits() != 2)
+    throw CircuitInvalidity(
+        "Getting Matrix: expected 2 qubit circuit, found " +
+        std::to_string(circ.n_qubits()));
+  return std::exp(i_ * PI * eval_expr(circ.get_phase()).value()) *
+         get_matrix_from_2qb_subcircuit(circ, whole_circuit(circ));
+}
+
+Eigen::Matrix4cd get_matrix_from_2qb_subcircuit(
+    const Circuit &circ, const Subcircuit &sub) {
+  return get_matrix_from_subcircuit<2>(circ, sub);
+}
+
+Matrix8cd get_matrix_from_3qb_subcircuit(
+    const Circuit &circ, const Subcircuit &sub) {
+  return get_matrix_from_subcircuit<3>(circ, sub);
 }
 
 Circuit two_qubit_canonical(const Eigen::Matrix4cd &U, OpType target_2qb_gate) {
@@ -237,10 +335,10 @@ static void replace_TK2_2CX(Circuit &circ) {
     TKET_ASSERT(params.size() == 3);
     // Rounding errors can accumulate here; warn if so:
     if (!equiv_0(params[2], 4, 1e-6)) {
-      std::stringstream ss;
-      ss << "Rounding errors in CX decomposition: ZZPhase parameter = "
-         << params[2] << " when it should be 0 (mod 4). Ignoring.";
-      tket_log()->warn(ss.str());
+      TKET_LOG_WARN(
+          "Rounding errors in CX decomposition: ZZPhase parameter should be 0 "
+          "(mod 4). Ignoring.",
+          {{"parameter", params[2]}});
     }
     Circuit sub = CircPool::approx_TK2_using_2xCX(params[0], params[1]);
     bin.push_back(v);
@@ -276,9 +276,7 @@ bool Circuit::in_causal_order(
     unsigned deptha = v_to_depth.at(a);
     unsigned depthb = v_to_depth.at(b);
     if (deptha == depthb) {
-      unit_set_t unitsa = v_to_units.at(a);
-      unit_set_t unitsb = v_to_units.at(b);
-      return unitsa < unitsb;
+      return v_to_units.at(a) < v_to_units.at(b);
     }
     return deptha < depthb;
   };
@@ -294,12 +292,12 @@ bool Circuit::in_causal_order(
     VertexVec preds = get_predecessors(from);
     to_search.insert(preds.begin(), preds.end());
   }
-  unit_set_t lookup_units = v_to_units.at(target);
+  const unit_set_t &lookup_units = v_to_units.at(target);
   while (!to_search.empty()) {
     Vertex v = *to_search.begin();
     to_search.erase(to_search.begin());
     if (v_to_depth.at(v) > target_depth) continue;
-    unit_set_t v_units = v_to_units.at(v);
+    const unit_set_t &v_units = v_to_units.at(v);
     for (const UnitID &u : lookup_units) {
       if (v_units.find(u) != v_units.end()) {
         return true;
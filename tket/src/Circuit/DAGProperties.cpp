@@ -25,12 +25,12 @@ namespace tket {
 #ifdef CHECK
 #error "Macro already defined!"
 #endif
-#define CHECK(p)                                               \
-  do {                                                         \
-    if (!(p)) {                                                \
-      tket_log()->warn("Invalid DAG: check (" #p ") failed."); \
-      return false;                                            \
-    }                                                          \
+#define CHECK(p)                                            \
+  do {                                                      \
+    if (!(p)) {                                             \
+      TKET_LOG_WARN("Invalid DAG: check (" #p ") failed."); \
+      return false;                                         \
+    }                                                       \
   } while (0)
 
 enum class VertexType { Quantum, Classical, Measure };
@@ -0,0 +1,143 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SynthesisCache.hpp"
+
+#include <boost/functional/hash.hpp>
+#include <cmath>
+#include <tkassert/Assert.hpp>
+#include <utility>
+
+#include "Utils/Constants.hpp"
+
+namespace tket {
+
+SynthesisCache::SynthesisCache(std::size_t capacity, double tolerance)
+    : m_tolerance(tolerance), m_capacity(capacity), m_hits(0), m_misses(0) {
+  TKET_ASSERT(m_tolerance > 0);
+}
+
+std::size_t SynthesisCache::KeyHash::operator()(const Key &key) const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, key.tag);
+  boost::hash_combine(seed, key.dim);
+  boost::hash_range(seed, key.entries.begin(), key.entries.end());
+  return seed;
+}
+
+Circuit SynthesisCache::get_circuit(
+    const std::string &tag, const Eigen::MatrixXcd &U,
+    const Synthesiser &synthesise) {
+  TKET_ASSERT(U.rows() == U.cols() && U.rows() > 0);
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_capacity == 0) {
+      ++m_misses;
+      return synthesise(U);
+    }
+  }
+
+  // Remove the phase of the first sufficiently large entry of the first
+  // column. Some entry has modulus at least 1/sqrt(dim); the threshold is
+  // well below that, so that rounding errors rarely change the choice.
+  const unsigned dim = U.rows();
+  const double threshold = 0.5 / std::sqrt(double(dim));
+  unsigned pivot = 0;
+  while (pivot + 1 < dim && std::abs(U(pivot, 0)) < threshold) ++pivot;
+  const double phase = std::arg(U(pivot, 0));
+  const Eigen::MatrixXcd U0 = std::exp(-i_ * phase) * U;
+
+  Key key{tag, dim, {}};
+  key.entries.reserve(2 * dim * dim);
+  for (unsigned c = 0; c < dim; ++c) {
+    for (unsigned r = 0; r < dim; ++r) {
+      key.entries.push_back(std::llround(U0(r, c).real() / m_tolerance));
+      key.entries.push_back(std::llround(U0(r, c).imag() / m_tolerance));
+    }
+  }
+
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    const auto iter = m_entries.find(key);
+    if (iter != m_entries.end()) {
+      m_recently_used.splice(
+          m_recently_used.begin(), m_recently_used, iter->second.position);
+      ++m_hits;
+      Circuit circ = iter->second.circ;
+      circ.add_phase((phase - iter->second.phase) / PI);
+      return circ;
+    }
+  }
+  // Synthesise without holding the lock, so that other unitaries are not
+  // held up. The circuit is synthesised from U itself, so that the result
+  // of a miss is exactly what the synthesis would give.
+  Circuit circ = synthesise(U);
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_misses;
+  if (m_capacity > 0) {
+    const auto [iter, inserted] =
+        m_entries.try_emplace(std::move(key), Entry{circ, phase, {}});
+    // If not inserted, another thread synthesised the same unitary
+    // meanwhile.
+    if (inserted) {
+      m_recently_used.push_front(&iter->first);
+      iter->second.position = m_recently_used.begin();
+      evict_to_capacity();
+    }
+  }
+  return circ;
+}
+
+void SynthesisCache::evict_to_capacity() {
+  while (m_entries.size() > m_capacity) {
+    m_entries.erase(*m_recently_used.back());
+    m_recently_used.pop_back();
+  }
+}
+
+void SynthesisCache::set_capacity(std::size_t capacity) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_capacity = capacity;
+  evict_to_capacity();
+}
+
+void SynthesisCache::clear() {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_recently_used.clear();
+  m_hits = 0;
+  m_misses = 0;
+}
+
+std::size_t SynthesisCache::size() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+std::size_t SynthesisCache::get_hits() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hits;
+}
+
+std::size_t SynthesisCache::get_misses() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_misses;
+}
+
+SynthesisCache &synthesis_cache() {
+  static SynthesisCache cache(0);
+  return cache;
+}
+
+}  // namespace tket
@@ -16,10 +16,12 @@
 // ALL METHODS TO PERFORM BASIC CIRCUIT MANIPULATION//
 /////////////////////////////////////////////////////
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Boxes.hpp"
@@ -238,6 +240,7 @@ Vertex Circuit::add_vertex(
     const Op_ptr op_ptr, std::optional<std::string> opgroup) {
   Vertex new_V = boost::add_vertex(this->dag);
   this->dag[new_V] = {op_ptr, opgroup};
+  journal_change(new_V);
   return new_V;
 }
 
@@ -262,6 +265,8 @@ Edge Circuit::add_edge(
   dag[new_E].ports.first = source.second;
   dag[new_E].ports.second = target.second;
   dag[new_E].type = type;
+  journal_change(source.first);
+  journal_change(target.first);
 
   return new_E;
 }
@@ -302,11 +307,22 @@ void Circuit::remove_vertex(
     }
   }
 
+  if (change_journal_active()) {
+    for (const Vertex &pred : get_predecessors(deadvert)) {
+      journal_change(pred);
+    }
+    for (const Vertex &succ : get_successors(deadvert)) {
+      journal_change(succ);
+    }
+  }
   boost::clear_vertex(deadvert, this->dag);
   if (vertex_deletion == VertexDeletion::Yes) {
     if (detect_boundary_Op(deadvert))
       throw CircuitInvalidity("Cannot remove a boundary vertex");
     boost::remove_vertex(deadvert, this->dag);
+    journal_deletion(deadvert);
+  } else {
+    journal_change(deadvert);
   }
 }
 
@@ -328,9 +344,67 @@ void Circuit::remove_vertices(
 }
 
 void Circuit::remove_edge(const Edge& edge) {
+  journal_change(source(edge));
+  journal_change(target(edge));
   boost::remove_edge(edge, this->dag);
 }
 
+// Sessions are numbered across all circuits, so that a checkpoint taken on
+// one circuit is never valid for another.
+static std::atomic<unsigned long> next_journal_session = 1;
+
+void Circuit::begin_change_journal() {
+  if (change_journal.depth++ == 0) {
+    change_journal.session = next_journal_session++;
+    change_journal.entries.clear();
+  }
+}
+
+void Circuit::end_change_journal() {
+  TKET_ASSERT(change_journal.depth > 0);
+  if (--change_journal.depth == 0) {
+    change_journal.entries = {};
+  }
+}
+
+void Circuit::restart_change_journal() {
+  if (change_journal_active()) {
+    change_journal.session = next_journal_session++;
+    change_journal.entries.clear();
+  }
+}
+
+Circuit::JournalCheckpoint Circuit::change_checkpoint() const {
+  TKET_ASSERT(change_journal_active());
+  return {change_journal.session, change_journal.entries.size()};
+}
+
+std::optional<VertexVec> Circuit::changed_vertices_since(
+    const JournalCheckpoint& checkpoint) const {
+  if (!change_journal_active() ||
+      checkpoint.session != change_journal.session ||
+      checkpoint.position > change_journal.entries.size()) {
+    return std::nullopt;
+  }
+  auto begin = change_journal.entries.begin() + checkpoint.position;
+  auto end = change_journal.entries.end();
+  // Whether each vertex is absent from the result: deleted by its last entry,
+  // or already listed.
+  std::unordered_map<Vertex, bool> skip;
+  for (auto it = begin; it != end; ++it) {
+    skip[it->first] = it->second;
+  }
+  VertexVec changed;
+  for (auto it = begin; it != end; ++it) {
+    bool& skip_vertex = skip[it->first];
+    if (!skip_vertex) {
+      changed.push_back(it->first);
+      skip_vertex = true;
+    }
+  }
+  return changed;
+}
+
 unit_map_t Circuit::flatten_registers() {
   unsigned q_index = 0;
   unsigned c_index = 0;
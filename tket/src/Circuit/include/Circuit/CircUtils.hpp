@@ -18,6 +18,7 @@
 #include "DAGDefs.hpp"
 #include "Gate/GatePtr.hpp"
 #include "Utils/EigenConfig.hpp"
+#include "Utils/MatrixAnalysis.hpp"
 #include "Utils/PauliStrings.hpp"
 
 namespace tket {
@@ -60,6 +61,45 @@ Eigen::Matrix2cd get_matrix_from_circ(const Circuit& circ);
  */
 Eigen::Matrix4cd get_matrix_from_2qb_circ(const Circuit& circ);
 
+/**
+ * The quantum part of a circuit as a region, for the region kernels below
+ *
+ * The in-edges are those of the qubits in \ref Circuit::all_qubits order,
+ * and the vertices are all the non-boundary vertices with quantum inputs.
+ */
+Subcircuit whole_circuit(const Circuit& circ);
+
+/**
+ * @brief Compute the unitary of a two-qubit region of a circuit
+ *
+ * The gates are multiplied in place into a fixed-size matrix, in topological
+ * order, so this is equivalent to (but much cheaper than)
+ * `get_matrix_from_2qb_circ(circ.subcircuit(sub))`.
+ *
+ * @param circ circuit containing the region
+ * @param sub region; only \p sub.q_in_hole and \p sub.verts are used, the
+ *    i-th in-edge being qubit i of the result
+ *
+ * @pre \p sub.verts are one- and two-qubit gates with only quantum edges
+ * @pre circuit has no symbolic parameters in \p sub.verts
+ * @post matrix is in \ref BasisOrder::ilo
+ * @post global phase of \p circ is not included
+ *
+ * @return unitary of the region
+ */
+Eigen::Matrix4cd get_matrix_from_2qb_subcircuit(
+    const Circuit& circ, const Subcircuit& sub);
+
+/**
+ * @brief Compute the unitary of a three-qubit region of a circuit
+ *
+ * As \ref get_matrix_from_2qb_subcircuit, for regions of three qubits.
+ *
+ * @return unitary of the region, in \ref BasisOrder::ilo
+ */
+Matrix8cd get_matrix_from_3qb_subcircuit(
+    const Circuit& circ, const Subcircuit& sub);
+
 /**
  * Convert a 4x4 unitary matrix optimally to a corresponding circuit
  *
@@ -217,9 +217,7 @@ class MissingEdge : public std::logic_error {
  public:
   explicit MissingEdge(const tket::Edge &edge)
       : std::logic_error("Edge missing") {
-    std::stringstream s;
-    s << edge;
-    tket_log()->info(s.str());
+    TKET_LOG_INFO("Edge missing", {{"edge", edge}});
   }
   MissingEdge() : std::logic_error("unknown edge missing") {}
 };
@@ -1078,6 +1076,58 @@ class Circuit {
       const Vertex &new_vert, const EdgeVec &preds,
       const op_signature_t &types);
 
+  /**
+   * A position in the change journal of a circuit.
+   */
+  struct JournalCheckpoint {
+    /** Identifies one period during which the journal was active. */
+    unsigned long session;
+    /** Number of changes recorded before the checkpoint. */
+    std::size_t position;
+  };
+
+  /**
+   * Start recording changes to the graph.
+   *
+   * While the journal is active, the circuit records every vertex which is
+   * added or removed, whose op is set with \ref set_vertex_Op_ptr, or which
+   * gains or loses an edge through the methods of this class. Changes made
+   * by writing to \ref dag directly are not recorded.
+   *
+   * Calls nest: the journal stays active until \ref end_change_journal has
+   * been called as many times as this method.
+   */
+  void begin_change_journal();
+
+  /**
+   * Stop recording changes, discarding the journal once the outermost
+   * recording ends.
+   */
+  void end_change_journal();
+
+  /** Whether changes to the graph are currently recorded. */
+  bool change_journal_active() const { return change_journal.depth > 0; }
+
+  /**
+   * The current position in the change journal.
+   *
+   * @pre \ref change_journal_active
+   */
+  JournalCheckpoint change_checkpoint() const;
+
+  /**
+   * Vertices changed since a checkpoint and still in the circuit, in the
+   * order they were first changed.
+   *
+   * @param checkpoint position in the journal
+   *
+   * @return the changed vertices, or std::nullopt if the journal cannot
+   *    tell, because it is not active or the checkpoint belongs to an earlier
+   *    session (for example, before the whole circuit was reassigned)
+   */
+  std::optional<VertexVec> changed_vertices_since(
+      const JournalCheckpoint &checkpoint) const;
+
   //_________________________________________________
 
   ////////////////////
@@ -1627,6 +1677,45 @@ class Circuit {
 
   /** Signature associated with each named operation group */
   std::map<std::string, op_signature_t> opgroupsigs;
+
+  /** Changes to the graph recorded while the journal is active */
+  struct ChangeJournal {
+    /** Number of outstanding calls to begin_change_journal */
+    unsigned depth = 0;
+    unsigned long session = 0;
+    /** Changed vertices, each with whether it was deleted */
+    std::vector<std::pair<Vertex, bool>> entries;
+  };
+  ChangeJournal change_journal;
+
+  void journal_change(const Vertex &vert) {
+    if (change_journal_active()) {
+      change_journal.entries.push_back({vert, false});
+    }
+  }
+  void journal_deletion(const Vertex &vert) {
+    if (change_journal_active()) {
+      change_journal.entries.push_back({vert, true});
+    }
+  }
+  /** Start a new session, invalidating all checkpoints. */
+  void restart_change_journal();
+};
+
+/**
+ * Keeps the change journal of a circuit active for its lifetime.
+ */
+class ChangeJournalScope {
+ public:
+  explicit ChangeJournalScope(Circuit &circ) : circ_(circ) {
+    circ_.begin_change_journal();
+  }
+  ~ChangeJournalScope() { circ_.end_change_journal(); }
+  ChangeJournalScope(const ChangeJournalScope &) = delete;
+  ChangeJournalScope &operator=(const ChangeJournalScope &) = delete;
+
+ private:
+  Circuit &circ_;
 };
 
 JSON_DECL(Circuit)
@@ -1648,9 +1737,7 @@ bool Circuit::rename_units(const std::map<UnitA, UnitB> &qm) {
   for (const std::pair<const UnitA, UnitB> &pair : qm) {
     boundary_t::iterator found = boundary.get<TagID>().find(pair.first);
     if (found == boundary.get<TagID>().end()) {
-      std::stringstream ss;
-      ss << "unit " << pair.first.repr() << " not found in circuit";
-      tket_log()->warn(ss.str());
+      TKET_LOG_WARN("unit " + pair.first.repr() + " not found in circuit");
       continue;
     }
 
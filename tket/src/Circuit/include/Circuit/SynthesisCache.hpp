@@ -0,0 +1,137 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Circuit.hpp"
+#include "Utils/EigenConfig.hpp"
+
+namespace tket {
+
+/** A capacity suited to circuits of a few qubits, see synthesis_cache(). */
+constexpr std::size_t default_synthesis_cache_capacity = 4096;
+
+/**
+ * A thread-safe, least recently used cache of circuits synthesised from
+ * small unitaries.
+ *
+ * Unitaries are keyed by their entries rounded to a fixed tolerance, after
+ * removing the global phase, together with a tag naming the synthesis
+ * method (and any options it depends on). A unitary differing from a cached
+ * one only by a global phase therefore reuses the cached circuit, with its
+ * phase adjusted.
+ *
+ * The synthesis method must be exact, in the sense that the circuit for
+ * \f$ e^{i\theta} U \f$ is the circuit for \f$ U \f$ with its phase
+ * increased by \f$ \theta / \pi \f$. Qubit permutations are deliberately not
+ * identified: the synthesis methods are not symmetric in the qubits, and a
+ * permuted circuit may be longer than a freshly synthesised one.
+ */
+class SynthesisCache {
+ public:
+  typedef std::function<Circuit(const Eigen::MatrixXcd &)> Synthesiser;
+
+  /**
+   * @param capacity maximum number of circuits to keep; 0 disables caching
+   * @param tolerance grid spacing to which matrix entries are rounded; two
+   *    unitaries share an entry only if every pair of entries (after phase
+   *    normalisation) is within this distance
+   */
+  explicit SynthesisCache(
+      std::size_t capacity = default_synthesis_cache_capacity,
+      double tolerance = 1e-13);
+
+  /**
+   * Synthesise a circuit for a unitary, or return the cached result.
+   *
+   * @param tag name of the synthesis method and its options
+   * @param U square unitary matrix
+   * @param synthesise synthesis method, called on a miss
+   *
+   * @return circuit implementing \p U
+   */
+  Circuit get_circuit(
+      const std::string &tag, const Eigen::MatrixXcd &U,
+      const Synthesiser &synthesise);
+
+  /** Change the capacity, discarding least recently used entries. */
+  void set_capacity(std::size_t capacity);
+
+  /** Remove all entries and reset the counters. */
+  void clear();
+
+  /** The number of circuits currently stored. */
+  std::size_t size() const;
+
+  /** The number of calls to get_circuit answered from the cache. */
+  std::size_t get_hits() const;
+
+  /** The number of calls to get_circuit which ran the synthesis. */
+  std::size_t get_misses() const;
+
+ private:
+  struct Key {
+    std::string tag;
+    unsigned dim;
+    std::vector<std::int64_t> entries;
+
+    bool operator==(const Key &other) const = default;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key &key) const;
+  };
+
+  struct Entry {
+    Circuit circ;
+    /** The phase removed from the unitary \p circ was synthesised from. */
+    double phase;
+    /** Position in m_recently_used. */
+    std::list<const Key *>::iterator position;
+  };
+
+  const double m_tolerance;
+
+  mutable std::mutex m_mutex;
+  std::size_t m_capacity;
+  std::unordered_map<Key, Entry, KeyHash> m_entries;
+  /** Keys of m_entries, most recently used first. */
+  std::list<const Key *> m_recently_used;
+  std::size_t m_hits;
+  std::size_t m_misses;
+
+  void evict_to_capacity();
+};
+
+/**
+ * The cache shared by two_qubit_squash and three_qubit_squash.
+ *
+ * It lives for the whole process, so it is disabled (capacity 0) until
+ * enabled with SynthesisCache::set_capacity, for example to
+ * default_synthesis_cache_capacity. Each entry holds one small circuit.
+ * Entries are only released when they are evicted as least recently used,
+ * or by SynthesisCache::clear or a capacity of 0.
+ */
+SynthesisCache &synthesis_cache();
+
+}  // namespace tket
@@ -80,6 +80,7 @@ vertex_map_t Circuit::copy_graph(
         opgroup_transfer == OpGroupTransfer::Merge) {
       this->dag[v0].opgroup = c2.get_opgroup_from_Vertex(v);
     }
+    journal_change(v0);
     isomap.insert({v, v0});
   }
   BGL_FORALL_VERTICES(v, c2.dag, DAG) {
@@ -437,7 +438,7 @@ void Circuit::_handle_boundaries(Circuit& circ, vertex_map_t& vmap) const {
     Vertex new_in;
     Vertex new_out;
     if (el.id_.type() == UnitType::Bit) {
-      tket_log()->warn(
+      TKET_LOG_WARN(
           "The circuit contains classical data for which the dagger/transpose "
           "might not be defined.");
       new_in = circ.add_vertex(OpType::ClInput);
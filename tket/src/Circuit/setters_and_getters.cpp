@@ -54,6 +54,8 @@ Circuit::Circuit(const Circuit &circ) : Circuit() {
 // copy assignment. Moves boundary pointers.
 Circuit &Circuit::operator=(const Circuit &other)  // (1)
 {
+  // Every vertex is replaced, so no checkpoint remains meaningful.
+  restart_change_journal();
   dag = DAG();
   boundary = boundary_t();
   copy_graph(other);
@@ -618,6 +620,7 @@ const std::unordered_set<std::string> Circuit::get_opgroups() const {
 
 void Circuit::set_vertex_Op_ptr(const Vertex &vert, const Op_ptr &op) {
   this->dag[vert].op = op;
+  journal_change(vert);
 }
 
 OpDesc Circuit::get_OpDesc_from_Vertex(const Vertex &vert) const {
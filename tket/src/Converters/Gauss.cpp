@@ -14,6 +14,8 @@
 
 #include "Gauss.hpp"
 
+#include "Utils/BinaryMatrix.hpp"
+
 namespace tket {
 
 void CXMaker::row_add(unsigned r0, unsigned r1) {
@@ -36,12 +38,13 @@ void DiagMatrix::col_add(unsigned c0, unsigned c1) {
 }
 
 void DiagMatrix::gauss(CXMaker& cxmaker, unsigned blocksize) {
+  BinaryMatrix m(_matrix);
   std::vector<std::pair<unsigned, unsigned>> row_ops =
-      gaussian_elimination_row_ops(_matrix, blocksize);
+      m.gaussian_elimination_row_ops(std::nullopt, blocksize);
   for (std::pair<unsigned, unsigned> op : row_ops) {
-    row_add(op.first, op.second);
     cxmaker.row_add(op.first, op.second);
   }
+  _matrix = m.to_MatrixXb();
 }
 
 bool DiagMatrix::is_id() const { return _matrix.isIdentity(); }
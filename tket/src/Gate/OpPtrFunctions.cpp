@@ -14,18 +14,108 @@
 
 #include "OpPtrFunctions.hpp"
 
+#include <cmath>
+#include <unordered_map>
+
 #include "Gate.hpp"
+#include "OpType/OpTypeInfo.hpp"
 #include "Ops/MetaOp.hpp"
 #include "SymTable.hpp"
 
 namespace tket {
 
+// Ops are immutable, so equal ones can share an object. The operations
+// transforms create most often -- parameter-free gates, and rotations by
+// multiples of a quarter turn -- are interned in tables built once, so that
+// get_op_ptr for them does not allocate. The tables are only read after
+// construction, so are safe to share between threads.
+
+// Rotations by k / 4 half-turns, for 0 <= k < 16
+static constexpr unsigned n_interned_angles = 16;
+
+namespace {
+struct InternedOps {
+  std::unordered_map<OpType, Op_ptr> parameter_free;
+  // Angles given as doubles, and as exact Integers or Rationals, are kept
+  // apart, so that an interned op has exactly the parameter asked for.
+  std::unordered_map<OpType, std::vector<Op_ptr>> quarter_turns;
+  std::unordered_map<OpType, std::vector<Op_ptr>> exact_quarter_turns;
+  std::vector<Expr> exact_angles;
+
+  InternedOps() {
+    for (unsigned k = 0; k < n_interned_angles; ++k) {
+      exact_angles.push_back(
+          SymEngine::div(SymEngine::integer(k), SymEngine::integer(4)));
+    }
+    for (const auto& [type, info] : optypeinfo()) {
+      if (is_gate_type(type)) {
+        if (info.n_params() == 0) {
+          parameter_free[type] = std::make_shared<const Gate>(
+              type, std::vector<Expr>{}, 0);
+        } else if (info.n_params() == 1) {
+          std::vector<Op_ptr>& ops = quarter_turns[type];
+          std::vector<Op_ptr>& exact_ops = exact_quarter_turns[type];
+          for (unsigned k = 0; k < n_interned_angles; ++k) {
+            ops.push_back(std::make_shared<const Gate>(
+                type, std::vector<Expr>{Expr(0.25 * k)}, 0));
+            exact_ops.push_back(std::make_shared<const Gate>(
+                type, std::vector<Expr>{exact_angles[k]}, 0));
+          }
+        }
+      } else if (is_metaop_type(type)) {
+        parameter_free[type] = std::make_shared<const MetaOp>(type);
+      }
+    }
+  }
+
+  // The interned parameter-free op, or null if there is none
+  Op_ptr get_parameter_free(OpType type) const {
+    const auto it = parameter_free.find(type);
+    return it == parameter_free.end() ? nullptr : it->second;
+  }
+
+  // The interned rotation by param, or null if there is none
+  Op_ptr get_quarter_turn(OpType type, const Expr& param) const {
+    const ExprPtr e = param.get_basic();
+    const bool exact = SymEngine::is_a<SymEngine::Integer>(*e) ||
+                       SymEngine::is_a<SymEngine::Rational>(*e);
+    if (!exact && !SymEngine::is_a<SymEngine::RealDouble>(*e)) {
+      return nullptr;
+    }
+    const double x = 4 * SymEngine::eval_double(*e);
+    if (std::signbit(x) || x >= n_interned_angles || x != std::floor(x)) {
+      return nullptr;
+    }
+    const unsigned k = unsigned(x);
+    // a Rational close to k / 4 can round to it as a double
+    if (exact && !SymEngine::eq(*e, *exact_angles[k].get_basic())) {
+      return nullptr;
+    }
+    const auto& ops = exact ? exact_quarter_turns : quarter_turns;
+    const auto it = ops.find(type);
+    return it == ops.end() ? nullptr : it->second[k];
+  }
+};
+}  // namespace
+
+static const InternedOps& interned_ops() {
+  static const InternedOps ops;
+  return ops;
+}
+
 Op_ptr get_op_ptr(OpType chosen_type, const Expr& param, unsigned n_qubits) {
   return get_op_ptr(chosen_type, std::vector<Expr>{param}, n_qubits);
 }
 
 Op_ptr get_op_ptr(
     OpType chosen_type, const std::vector<Expr>& params, unsigned n_qubits) {
+  if (n_qubits == 0 && params.size() <= 1) {
+    const InternedOps& interned = interned_ops();
+    const Op_ptr op = params.empty()
+                          ? interned.get_parameter_free(chosen_type)
+                          : interned.get_quarter_turn(chosen_type, params[0]);
+    if (op) return op;
+  }
   if (is_gate_type(chosen_type)) {
     SymTable::register_symbols(expr_free_symbols(params));
     return std::make_shared<const Gate>(chosen_type, params, n_qubits);
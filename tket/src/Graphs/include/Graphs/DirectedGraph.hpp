@@ -529,11 +529,15 @@ class DirectedGraph : public DirectedGraphBase<T> {
     Base::remove_connection(node1, node2);
   }
 
- private:
-  inline void invalidate_cache() {
+ protected:
+  /** Called before every modification; subclasses which cache more data
+   * should override this (and call the base version). */
+  virtual void invalidate_cache() {
     distance_cache.clear();
     undir_graph = std::nullopt;
   }
+
+ private:
   mutable std::map<T, std::vector<std::size_t>> distance_cache;
   mutable std::optional<UndirectedConnGraph> undir_graph;
 };
@@ -14,12 +14,11 @@
 
 #include "Mapping/MappingManager.hpp"
 
-#include "Architecture/BestTsaWithArch.hpp"
-
 namespace tket {
 
 MappingManager::MappingManager(const ArchitecturePtr& _architecture)
-    : architecture_(_architecture) {}
+    : architecture_(_architecture),
+      tsa_cache_(std::make_shared<TsaSolutionCache>()) {}
 
 bool MappingManager::route_circuit(
     Circuit& circuit,
@@ -170,7 +169,7 @@ bool MappingManager::route_circuit_with_maps(
             node_map.insert({Node(x.first), Node(x.second)});
           }
           for (const std::pair<Node, Node>& swap :
-               BestTsaWithArch::get_swaps(*this->architecture_, node_map)) {
+               this->tsa_cache_->get_swaps(*this->architecture_, node_map)) {
             mapping_frontier->add_swap(swap.first, swap.second);
           }
         }
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "Architecture/Architecture.hpp"
+#include "Architecture/TsaSolutionCache.hpp"
 #include "Circuit/Circuit.hpp"
 #include "Mapping/RoutingMethod.hpp"
 #include "Utils/UnitID.hpp"
@@ -71,5 +72,7 @@ class MappingManager {
 
  private:
   ArchitecturePtr architecture_;
+  // routing methods often ask for the same permutation repeatedly
+  std::shared_ptr<TsaSolutionCache> tsa_cache_;
 };
 }  // namespace tket
\ No newline at end of file
@@ -14,62 +14,216 @@
 
 #include "MeasurementReduction.hpp"
 
+#include <symengine/symengine_config.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include "Utils/Parallel.hpp"
+
 namespace tket {
 
-MeasurementSetup measurement_reduction(
-    const std::list<QubitPauliString>& strings, PauliPartitionStrat strat,
-    GraphColourMethod method, CXConfigType cx_config) {
-  std::set<Qubit> qubits;
-  for (const QubitPauliString& qpt : strings) {
-    for (const std::pair<const Qubit, Pauli>& qb_p : qpt.map)
-      qubits.insert(qb_p.first);
+static MeasurementReducer::Partition diagonalise_partition(
+    const std::list<QubitPauliString>& terms, const std::set<Qubit>& qubits,
+    CXConfigType cx_config) {
+  std::list<std::pair<QubitPauliTensor, Expr>> gadgets;
+  for (const QubitPauliString& string : terms) {
+    QubitPauliTensor qps(string);
+    gadgets.push_back({qps, 1.});
+  }
+
+  MeasurementReducer::Partition part;
+  std::set<Qubit> mutable_qb_set(qubits);
+  part.circ = mutual_diagonalise(gadgets, mutable_qb_set, cx_config);
+
+  std::list<std::pair<QubitPauliTensor, Expr>>::const_iterator gadgets_iter =
+      gadgets.begin();
+  for (const QubitPauliString& string : terms) {
+    const std::pair<QubitPauliTensor, Expr>& new_gadget = *gadgets_iter;
+    std::vector<Qubit> z_qubits;
+    for (const std::pair<const Qubit, Pauli>& qp_pair :
+         new_gadget.first.string.map) {
+      if (qp_pair.second == Pauli::Z) z_qubits.push_back(qp_pair.first);
+    }
+    bool invert = (std::abs(new_gadget.first.coeff + Complex(1)) < EPS);
+    part.terms.push_back({string, {z_qubits, invert}});
+    ++gadgets_iter;
   }
+  return part;
+}
+
+/**
+ * Diagonalise each partition independently.
+ *
+ * Partitions are shared between threads when SymEngine is built with
+ * thread-safe reference counting, since every partition allocates its own
+ * expressions; otherwise they are processed in order on the calling thread.
+ */
+static std::vector<MeasurementReducer::Partition> diagonalise_partitions(
+    const std::list<std::list<QubitPauliString>>& all_terms,
+    const std::set<Qubit>& qubits, CXConfigType cx_config) {
+  std::vector<const std::list<QubitPauliString>*> jobs;
+  for (const std::list<QubitPauliString>& terms : all_terms) {
+    jobs.push_back(&terms);
+  }
+  std::vector<MeasurementReducer::Partition> parts(jobs.size());
+#ifdef WITH_SYMENGINE_THREAD_SAFE
+  // Below this many partitions per thread, thread start-up dominates.
+  constexpr std::size_t min_jobs_per_thread = 8;
+  unsigned max_threads =
+      std::max<std::size_t>(1, jobs.size() / min_jobs_per_thread);
+#else
+  unsigned max_threads = 1;
+#endif
+  parallel_for(
+      jobs.size(),
+      [&](std::size_t i) {
+        parts[i] = diagonalise_partition(*jobs[i], qubits, cx_config);
+      },
+      max_threads);
+  return parts;
+}
+
+/**
+ * Add the circuit and term results of a partition to a setup, measuring every
+ * qubit of `qb_location_map` into the bit of its index.
+ */
+static void add_to_setup(
+    MeasurementSetup& ms, const MeasurementReducer::Partition& part,
+    const std::map<Qubit, unsigned>& qb_location_map) {
+  Circuit circ = part.circ;
+  for (const std::pair<const Qubit, unsigned>& qb_loc : qb_location_map) {
+    if (!circ.contains_unit(qb_loc.first)) circ.add_qubit(qb_loc.first);
+    circ.add_bit(Bit(qb_loc.second));
+    circ.add_measure(qb_loc.first, Bit(qb_loc.second));
+  }
+  unsigned i = ms.get_circs().size();
+  ms.add_measurement_circuit(circ);
+  for (const MeasurementReducer::Partition::TermResult& term : part.terms) {
+    std::vector<unsigned> bits;
+    for (const Qubit& qb : term.second.first) {
+      bits.push_back(qb_location_map.at(qb));
+    }
+    ms.add_result_for_term(term.first, {i, bits, term.second.second});
+  }
+}
 
+static std::map<Qubit, unsigned> qubit_locations(
+    const std::set<Qubit>& qubits) {
   std::map<Qubit, unsigned> qb_location_map;
   unsigned u = 0;
   for (const Qubit& qb : qubits) {
     qb_location_map[qb] = u;
     ++u;
   }
+  return qb_location_map;
+}
+
+MeasurementSetup measurement_reduction(
+    const std::list<QubitPauliString>& strings, PauliPartitionStrat strat,
+    GraphColourMethod method, CXConfigType cx_config) {
+  std::set<Qubit> qubits;
+  for (const QubitPauliString& qpt : strings) {
+    for (const std::pair<const Qubit, Pauli>& qb_p : qpt.map)
+      qubits.insert(qb_p.first);
+  }
+  std::map<Qubit, unsigned> qb_location_map = qubit_locations(qubits);
 
   std::list<std::list<QubitPauliString>> all_terms =
       term_sequence(strings, strat, method);
   MeasurementSetup ms;
-  unsigned i = 0;
-  for (const std::list<QubitPauliString>& terms : all_terms) {
-    std::list<std::pair<QubitPauliTensor, Expr>> gadgets;
-    for (const QubitPauliString& string : terms) {
-      QubitPauliTensor qps(string);
-      gadgets.push_back({qps, 1.});
+  for (const MeasurementReducer::Partition& part :
+       diagonalise_partitions(all_terms, qubits, cx_config)) {
+    add_to_setup(ms, part, qb_location_map);
+  }
+  return ms;
+}
+
+MeasurementReducer::MeasurementReducer(
+    PauliPartitionStrat strat, GraphColourMethod method,
+    CXConfigType cx_config)
+    : strat_(strat), method_(method), cx_config_(cx_config) {}
+
+void MeasurementReducer::add_partitions(
+    const std::list<std::list<QubitPauliString>>& all_terms) {
+  for (Partition& part :
+       diagonalise_partitions(all_terms, qubits_, cx_config_)) {
+    partitions_.push_back(std::move(part));
+    std::list<Partition>::iterator it = std::prev(partitions_.end());
+    for (const Partition::TermResult& term : it->terms) {
+      term_partition_[term.first] = it;
     }
+  }
+}
 
-    std::set<Qubit> mutable_qb_set(qubits);
-    Circuit cliff_circ = mutual_diagonalise(gadgets, mutable_qb_set, cx_config);
-    unsigned bit_count = 0;
-    for (const Qubit& qb : cliff_circ.all_qubits()) {
-      cliff_circ.add_bit(Bit(bit_count));
-      cliff_circ.add_measure(qb, Bit(bit_count));
-      ++bit_count;
+void MeasurementReducer::add_terms(
+    const std::list<QubitPauliString>& strings) {
+  std::list<QubitPauliString> new_terms;
+  std::set<QubitPauliString> seen;
+  for (const QubitPauliString& qps : strings) {
+    if (term_partition_.find(qps) != term_partition_.end()) continue;
+    if (!seen.insert(qps).second) continue;
+    new_terms.push_back(qps);
+    for (const std::pair<const Qubit, Pauli>& qb_p : qps.map)
+      qubits_.insert(qb_p.first);
+  }
+  if (new_terms.empty()) return;
+  add_partitions(term_sequence(new_terms, strat_, method_));
+}
+
+void MeasurementReducer::remove_terms(
+    const std::list<QubitPauliString>& strings) {
+  for (const QubitPauliString& qps : strings) {
+    auto found = term_partition_.find(qps);
+    if (found == term_partition_.end()) continue;
+    std::list<Partition>::iterator it = found->second;
+    term_partition_.erase(found);
+    it->terms.remove_if(
+        [&](const Partition::TermResult& term) { return term.first == qps; });
+    if (it->terms.empty()) partitions_.erase(it);
+  }
+}
+
+void MeasurementReducer::repartition() {
+  std::list<QubitPauliString> strings;
+  for (const Partition& part : partitions_) {
+    for (const Partition::TermResult& term : part.terms) {
+      strings.push_back(term.first);
     }
-    ms.add_measurement_circuit(cliff_circ);
-
-    std::list<std::pair<QubitPauliTensor, Expr>>::const_iterator gadgets_iter =
-        gadgets.begin();
-    for (const QubitPauliString& string : terms) {
-      const std::pair<QubitPauliTensor, Expr>& new_gadget = *gadgets_iter;
-      std::vector<unsigned> bits;
-      for (const std::pair<const Qubit, Pauli>& qp_pair :
-           new_gadget.first.string.map) {
-        if (qp_pair.second == Pauli::Z)
-          bits.push_back(qb_location_map.at(qp_pair.first));
-      }
-      bool invert = (std::abs(new_gadget.first.coeff + Complex(1)) < EPS);
-      ms.add_result_for_term(string, {i, bits, invert});
-      ++gadgets_iter;
+  }
+  std::map<std::set<QubitPauliString>, Partition> existing;
+  for (Partition& part : partitions_) {
+    std::set<QubitPauliString> key;
+    for (const Partition::TermResult& term : part.terms) {
+      key.insert(term.first);
     }
-    ++i;
+    existing.emplace(std::move(key), std::move(part));
   }
+  partitions_.clear();
+  term_partition_.clear();
 
+  std::list<std::list<QubitPauliString>> to_diagonalise;
+  for (const std::list<QubitPauliString>& terms :
+       term_sequence(strings, strat_, method_)) {
+    auto found = existing.find(
+        std::set<QubitPauliString>(terms.begin(), terms.end()));
+    if (found == existing.end()) {
+      to_diagonalise.push_back(terms);
+      continue;
+    }
+    partitions_.push_back(std::move(found->second));
+    std::list<Partition>::iterator it = std::prev(partitions_.end());
+    for (const QubitPauliString& qps : terms) term_partition_[qps] = it;
+  }
+  add_partitions(to_diagonalise);
+}
+
+MeasurementSetup MeasurementReducer::get_setup() const {
+  std::map<Qubit, unsigned> qb_location_map = qubit_locations(qubits_);
+  MeasurementSetup ms;
+  for (const Partition& part : partitions_) {
+    add_to_setup(ms, part, qb_location_map);
+  }
   return ms;
 }
 
@@ -78,10 +78,9 @@ bool MeasurementSetup::verify() const {
       if (bits.invert) total.coeff *= -1.;
       QubitPauliTensor term_tensor(term.first);
       if (total != term_tensor) {
-        std::stringstream out;
-        out << "Invalid MeasurementSetup: expecting to measure "
-            << term_tensor.to_str() << "; actually measured " << total.to_str();
-        tket_log()->error(out.str());
+        TKET_LOG_ERROR(
+            "Invalid MeasurementSetup: expecting to measure " +
+            term_tensor.to_str() + "; actually measured " + total.to_str());
         return false;
       }
     }
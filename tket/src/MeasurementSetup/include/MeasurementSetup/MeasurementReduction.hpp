@@ -14,6 +14,11 @@
 
 #pragma once
 
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
 #include "Diagonalisation/Diagonalisation.hpp"
 #include "Diagonalisation/PauliPartition.hpp"
 #include "MeasurementSetup.hpp"
@@ -33,4 +38,76 @@ MeasurementSetup measurement_reduction(
     GraphColourMethod method = GraphColourMethod::Lazy,
     CXConfigType cx_config = CXConfigType::Snake);
 
+/**
+ * Measurement reduction for an operator whose terms change over time.
+ *
+ * The diagonalising circuit built for each partition is kept between updates.
+ * Removing terms never requires new circuits, since any subset of a
+ * diagonalised set is diagonalised by the same circuit. Added terms are
+ * partitioned among themselves, so only the partitions they form are
+ * diagonalised. Over many updates this can leave more partitions than a fresh
+ * reduction would; `repartition` partitions the whole operator again, reusing
+ * the circuit of every partition whose terms are unchanged.
+ */
+class MeasurementReducer {
+ public:
+  explicit MeasurementReducer(
+      PauliPartitionStrat strat,
+      GraphColourMethod method = GraphColourMethod::Lazy,
+      CXConfigType cx_config = CXConfigType::Snake);
+
+  /**
+   * Add terms to the operator. Terms already present are ignored.
+   */
+  void add_terms(const std::list<QubitPauliString> &strings);
+
+  /**
+   * Remove terms from the operator. Terms not present are ignored.
+   */
+  void remove_terms(const std::list<QubitPauliString> &strings);
+
+  /**
+   * Partition all current terms from scratch.
+   */
+  void repartition();
+
+  unsigned n_terms() const { return term_partition_.size(); }
+  unsigned n_partitions() const { return partitions_.size(); }
+
+  /**
+   * Assemble the measurement setup for the current terms.
+   *
+   * Each circuit acts on every qubit seen so far, with qubits introduced
+   * after a partition was diagonalised left idle in its circuit.
+   */
+  MeasurementSetup get_setup() const;
+
+  /** A diagonalised partition of terms. */
+  struct Partition {
+    /**
+     * A term with the qubits whose Z measurements give its parity after
+     * `circ`, and whether that parity is inverted
+     */
+    typedef std::pair<QubitPauliString, std::pair<std::vector<Qubit>, bool>>
+        TermResult;
+
+    /** Clifford circuit, without measurements */
+    Circuit circ;
+    std::list<TermResult> terms;
+  };
+
+ private:
+  void add_partitions(const std::list<std::list<QubitPauliString>> &all_terms);
+
+  PauliPartitionStrat strat_;
+  GraphColourMethod method_;
+  CXConfigType cx_config_;
+  std::set<Qubit> qubits_;
+  std::list<Partition> partitions_;
+  std::unordered_map<
+      QubitPauliString, std::list<Partition>::iterator,
+      MeasurementSetup::QPSHasher>
+      term_partition_;
+};
+
 }  // namespace tket
@@ -14,6 +14,7 @@
 
 #include <chrono>
 
+#include "Architecture/CompiledArchitecture.hpp"
 #include "Placement/Placement.hpp"
 #include "Utils/HelperFunctions.hpp"
 
@@ -32,9 +33,7 @@ GraphPlacement::GraphPlacement(
       maximum_pattern_depth_(_maximum_pattern_depth) {
   architecture_ = _architecture;
   this->weighted_target_edges = this->default_target_weighting(architecture_);
-  this->extended_target_graphs = {
-      this->construct_target_graph(weighted_target_edges, 0)
-          .get_undirected_connectivity()};
+  this->extended_target_graphs = std::make_shared<ExtendedTargetGraphs>();
 }
 
 const std::vector<GraphPlacement::WeightedEdge>
@@ -101,18 +100,23 @@ GraphPlacement::default_target_weighting(
     Architecture& passed_architecture) const {
   std::vector<Node> all_nodes = passed_architecture.get_all_nodes_vec();
   std::vector<GraphPlacement::WeightedEdge> weights;
-  unsigned diameter = passed_architecture.get_diameter();
-  auto it = all_nodes.begin();
-  while (it != all_nodes.end()) {
-    auto jt = it;
-    ++jt;
-    while (jt != all_nodes.end()) {
-      unsigned distance = passed_architecture.get_distance(*it, *jt);
-      weights.push_back(
-          {*it, *jt, unsigned(diameter + 1 - distance), distance});
-      ++jt;
+  const std::shared_ptr<const CompiledArchitecture> compiled =
+      passed_architecture.get_compiled();
+  unsigned diameter = compiled->get_diameter();
+  std::vector<unsigned> indices;
+  indices.reserve(all_nodes.size());
+  for (const Node& node : all_nodes) {
+    indices.push_back(compiled->get_index(node));
+  }
+  weights.reserve(all_nodes.size() * (all_nodes.size() - 1) / 2);
+  for (unsigned i = 0; i < all_nodes.size(); i++) {
+    const std::vector<unsigned> distances =
+        compiled->get_distances(indices[i]);
+    for (unsigned j = i + 1; j < all_nodes.size(); j++) {
+      unsigned distance = distances[indices[j]];
+      weights.push_back({all_nodes[i], all_nodes[j],
+                         unsigned(diameter + 1 - distance), distance});
     }
-    ++it;
   }
   return weights;
 }
@@ -170,6 +174,20 @@ Architecture GraphPlacement::construct_target_graph(
   return architecture;
 }
 
+std::shared_ptr<const TargetGraphContext>
+GraphPlacement::get_extended_target_graph(unsigned distance) const {
+  std::lock_guard<std::mutex> lock(this->extended_target_graphs->mutex);
+  std::vector<std::shared_ptr<const TargetGraphContext>>& graphs =
+      this->extended_target_graphs->graphs;
+  while (graphs.size() <= distance) {
+    const Architecture target_graph = this->construct_target_graph(
+        this->weighted_target_edges, graphs.size());
+    graphs.push_back(
+        make_target_graph_context(target_graph.get_undirected_connectivity()));
+  }
+  return graphs[distance];
+}
+
 std::vector<boost::bimap<Qubit, Node>>
 GraphPlacement::get_all_weighted_subgraph_monomorphisms(
     const Circuit& circ_,
@@ -205,7 +223,8 @@ GraphPlacement::get_all_weighted_subgraph_monomorphisms(
    * that are valid.
    *
    * As finding the distance between all pairs of Nodes in an Architecture is
-   * expensive, we cache the constructed target graphs.
+   * expensive, we cache the constructed target graphs, together with the
+   * solver's preprocessing of them, for reuse by later calls.
    *
    *
    *
@@ -245,13 +264,8 @@ GraphPlacement::get_all_weighted_subgraph_monomorphisms(
      * As eventually an edge will be added between every Node on the
      * Architecture, meaning a solution will be found.
      */
-    if (extended_target_graphs.size() <= incrementer) {
-      extended_target_graphs.push_back(
-          this->construct_target_graph(this->weighted_target_edges, incrementer)
-              .get_undirected_connectivity());
-      TKET_ASSERT(extended_target_graphs.size() - 1 == incrementer);
-    }
-    TKET_ASSERT(extended_target_graphs.size() > incrementer);
+    const std::shared_ptr<const TargetGraphContext> target_graph =
+        this->get_extended_target_graph(incrementer);
 
     // For each increment we construct a smaller pattern graph
     QubitGraph::UndirectedConnGraph pattern_graph =
@@ -271,7 +285,7 @@ GraphPlacement::get_all_weighted_subgraph_monomorphisms(
     auto it = all_pattern_graphs.begin();
     while (it != all_pattern_graphs.end() && all_bimaps.empty()) {
       all_bimaps = get_weighted_subgraph_monomorphisms(
-          *it, extended_target_graphs[incrementer], this->maximum_matches_,
+          *it, *target_graph, this->maximum_matches_,
           this->timeout_ -
               std::chrono::duration_cast<std::chrono::milliseconds>(
                   Clock::now() - init_start)
@@ -27,6 +27,26 @@ using RelabelledTargetGraph =
     RelabelledGraphWSM<Node, Architecture::UndirectedConnGraph>;
 using BimapValue = boost::bimap<Qubit, Node>::value_type;
 
+struct TargetGraphContext {
+  const RelabelledTargetGraph relabelled_target_graph;
+
+  // Null if the target graph has no edges.
+  std::shared_ptr<const TargetGraphData> target_data;
+
+  // Distance data up to the given distance is calculated now;
+  // use 0 for a single solve.
+  TargetGraphContext(
+      const Architecture::UndirectedConnGraph& target_graph,
+      unsigned max_distance_to_precompute)
+      : relabelled_target_graph(target_graph) {
+    if (!relabelled_target_graph.get_relabelled_edges_and_weights().empty()) {
+      target_data = std::make_shared<const TargetGraphData>(
+          relabelled_target_graph.get_relabelled_edges_and_weights(),
+          max_distance_to_precompute);
+    }
+  }
+};
+
 // Where should isolated pattern vertices be assigned?
 // They might NOT have been isolated originally; it may be
 // that we deliberately erased some pattern edges.
@@ -156,10 +176,32 @@ std::vector<boost::bimap<Qubit, Node>> get_weighted_subgraph_monomorphisms(
     QubitGraph::UndirectedConnGraph& pattern_graph,
     Architecture::UndirectedConnGraph& target_graph, unsigned max_matches,
     unsigned timeout_ms, bool return_best) {
+  const TargetGraphContext target_context(target_graph, 0);
+  return get_weighted_subgraph_monomorphisms(
+      pattern_graph, target_context, max_matches, timeout_ms, return_best);
+}
+
+std::shared_ptr<const TargetGraphContext> make_target_graph_context(
+    const Architecture::UndirectedConnGraph& target_graph) {
+  // The target will be reused, so calculate all the distance data
+  // the solver could need now, rather than separately in every solve.
+  const MainSolverParameters parameters;
+  return std::make_shared<const TargetGraphContext>(
+      target_graph,
+      std::max(
+          parameters.max_distance_for_domain_initialisation_distance_filter,
+          parameters.max_distance_for_distance_reduction_during_search));
+}
+
+std::vector<boost::bimap<Qubit, Node>> get_weighted_subgraph_monomorphisms(
+    const QubitGraph::UndirectedConnGraph& pattern_graph,
+    const TargetGraphContext& target_context, unsigned max_matches,
+    unsigned timeout_ms, bool return_best) {
   std::vector<boost::bimap<Qubit, Node>> all_maps;
 
   const RelabelledPatternGraph relabelled_pattern_graph(pattern_graph);
-  const RelabelledTargetGraph relabelled_target_graph(target_graph);
+  const RelabelledTargetGraph& relabelled_target_graph =
+      target_context.relabelled_target_graph;
 
   if (relabelled_pattern_graph.get_relabelled_edges_and_weights().size() >
           relabelled_target_graph.get_relabelled_edges_and_weights().size() ||
@@ -190,10 +232,10 @@ std::vector<boost::bimap<Qubit, Node>> get_weighted_subgraph_monomorphisms(
   solver_parameters.for_multiple_full_solutions_the_max_number_to_obtain =
       max_matches;
   solver_parameters.timeout_ms = timeout_ms;
+  TKET_ASSERT(target_context.target_data);
   const MainSolver main_solver(
       relabelled_pattern_graph.get_relabelled_edges_and_weights(),
-      relabelled_target_graph.get_relabelled_edges_and_weights(),
-      solver_parameters);
+      target_context.target_data, solver_parameters);
   const auto& solution_data = main_solver.get_solution_data();
   write_solver_solutions(
       all_maps, solution_data.solutions, relabelled_pattern_graph,
@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <limits>
+#include <set>
+#include <tuple>
+
 #include "Placement/Placement.hpp"
 #include "Utils/HelperFunctions.hpp"
 
@@ -26,74 +30,396 @@ NoiseAwarePlacement::NoiseAwarePlacement(
     unsigned _maximum_pattern_gates, unsigned _maximum_pattern_depth)
     : GraphPlacement(
           _architecture, _maximum_matches, _timeout, _maximum_pattern_gates,
-          _maximum_pattern_depth) {
+          _maximum_pattern_depth),
+      characterisation_(
+          _node_errors ? *_node_errors : avg_node_errors_t(),
+          _link_errors ? *_link_errors : avg_link_errors_t(),
+          _readout_errors ? *_readout_errors : avg_readout_errors_t()),
+      dense_characterisation_(
+          characterisation_, _architecture.get_all_nodes_vec()),
+      local_search_(false) {
   architecture_ = _architecture;
   this->weighted_target_edges = this->default_target_weighting(architecture_);
-  this->extended_target_graphs = {
-      this->construct_target_graph(weighted_target_edges, 0)
-          .get_undirected_connectivity()};
-  characterisation_ = {
-      _node_errors ? *_node_errors : avg_node_errors_t(),
-      _link_errors ? *_link_errors : avg_link_errors_t(),
-      _readout_errors ? *_readout_errors : avg_readout_errors_t()};
-}
-
-double NoiseAwarePlacement::cost_placement(
-    const boost::bimap<Qubit, Node>& map, const Circuit& circ_,
-    const QubitGraph& q_graph) const {
+  this->extended_target_graphs = std::make_shared<ExtendedTargetGraphs>();
+}
+
+namespace {
+
+// constants for scaling single qubit error
+constexpr double c1 = 0.5;
+constexpr double d1 = 1 - 1 / c1;
+// cost reductions smaller than this are treated as noise by local search
+constexpr double min_improvement = 1e-12;
+constexpr unsigned unassigned = std::numeric_limits<unsigned>::max();
+
+/**
+ * Dense copy of the Architecture, DeviceCharacterisation and pattern
+ * QubitGraph data used to cost placement maps. Nodes are indexed as in the
+ * DenseDeviceCharacterisation and Qubits as in the Circuit, so that costing
+ * a map, or the change made by a local move, reads flat arrays rather than
+ * querying graphs, bimaps and error maps.
+ */
+class PlacementCostTable {
+ public:
+  PlacementCostTable(
+      const Architecture& architecture,
+      const DenseDeviceCharacterisation& characterisation,
+      const Circuit& circ, const QubitGraph& q_graph,
+      unsigned maximum_pattern_depth);
+
+  /**
+   * Sum over assigned Nodes of an edge term rewarding low error links to
+   * other assigned Nodes (more so if the link is used by an interaction),
+   * plus single qubit and readout error terms.
+   */
+  double cost(const boost::bimap<Qubit, Node>& map) const;
+
+  /**
+   * Hill climb from map over swaps of adjacent assignments, see
+   * NoiseAwarePlacement::set_local_search.
+   */
+  boost::bimap<Qubit, Node> refine(const boost::bimap<Qubit, Node>& map) const;
+
+ private:
+  struct NeighbourEntry {
+    unsigned node;
+    // 1 - error of the link from the owning Node to node, and back
+    double fwd_fidelity;
+    double bck_fidelity;
+    // position in neighbours_ of the entry for the opposite direction
+    unsigned reverse;
+  };
+
+  struct State {
+    std::vector<unsigned> qubit_of_node;
+    std::vector<unsigned> node_of_qubit;
+    std::vector<double> edge_sums;
+  };
+
+  bool trivial_;
+  unsigned maximum_pattern_depth_;
+  const DenseDeviceCharacterisation& characterisation_;
+  std::vector<Qubit> qubits_;
+  std::map<Qubit, unsigned> qubit_index_;
+  // Architecture neighbours of node i are
+  // neighbours_[neighbour_offsets_[i]..neighbour_offsets_[i + 1]), in Node
+  // order
+  std::vector<unsigned> neighbour_offsets_;
+  std::vector<NeighbourEntry> neighbours_;
+  std::vector<double> single_terms_;
+  std::vector<double> readout_terms_;
+  // interaction weight of qubit i to qubit j at i * qubits_.size() + j
+  std::vector<unsigned> interactions_;
+  // Qubits interacting with each Qubit, in either direction
+  std::vector<std::vector<unsigned>> pattern_neighbours_;
+
+  unsigned interaction(unsigned qubit0, unsigned qubit1) const {
+    return interactions_[qubit0 * qubits_.size() + qubit1];
+  }
+
+  // adds the link term for a Node assigned qubit and its neighbour entry
+  // assigned neighbour_qubit to edge_sum
+  double add_link(
+      double edge_sum, const NeighbourEntry& entry, unsigned qubit,
+      unsigned neighbour_qubit) const;
+
+  double edge_sum(
+      unsigned node, const std::vector<unsigned>& qubit_of_node) const;
+
+  bool adjacent(unsigned node0, unsigned node1) const;
+
+  // whether exchanging the assignments of node0 and node1 keeps every
+  // interaction placed on an Architecture edge on one
+  bool keeps_placed_interactions(
+      const State& state, unsigned node0, unsigned node1) const;
+
+  // change in cost from exchanging the assignments of node0 and node1,
+  // using and restoring scratch, which must hold a zero for every Node
+  double move_delta(
+      State& state, unsigned node0, unsigned node1,
+      std::vector<double>& scratch) const;
+
+  void apply_move(State& state, unsigned node0, unsigned node1) const;
+};
+
+PlacementCostTable::PlacementCostTable(
+    const Architecture& architecture,
+    const DenseDeviceCharacterisation& characterisation, const Circuit& circ,
+    const QubitGraph& q_graph, unsigned maximum_pattern_depth)
+    : trivial_(circ.n_gates() == 0 || circ.n_qubits() == 0),
+      maximum_pattern_depth_(maximum_pattern_depth),
+      characterisation_(characterisation),
+      qubits_(circ.all_qubits()) {
+  for (unsigned i = 0; i < qubits_.size(); i++) {
+    qubit_index_.insert({qubits_[i], i});
+  }
+  if (trivial_) return;
+
+  const int approx_depth = circ.n_gates() / circ.n_qubits() + 1;
+  const unsigned n_nodes = characterisation.n_nodes();
+  neighbour_offsets_.reserve(n_nodes + 1);
+  neighbour_offsets_.push_back(0);
+  single_terms_.reserve(n_nodes);
+  readout_terms_.reserve(n_nodes);
+  for (unsigned node = 0; node < n_nodes; node++) {
+    for (const Node& neighbour : architecture.get_neighbour_nodes(
+             characterisation.get_nodes()[node])) {
+      const unsigned nei = characterisation.get_index(neighbour).value();
+      neighbours_.push_back(
+          {nei, 1.0 - characterisation.get_error(node, nei),
+           1.0 - characterisation.get_error(nei, node), 0});
+    }
+    neighbour_offsets_.push_back(neighbours_.size());
+    gate_error_t single_error = characterisation.get_error(node);
+    single_terms_.push_back(d1 + 1.0 / ((1.0 - single_error) + c1));
+    readout_error_t readout_error = characterisation.get_readout_error(node);
+    readout_terms_.push_back(
+        readout_error
+            ? (d1 + 1.0 / ((1.0 - readout_error) + c1)) / (approx_depth * 20)
+            : 0.);
+  }
+  for (unsigned node = 0; node < n_nodes; node++) {
+    for (unsigned i = neighbour_offsets_[node];
+         i < neighbour_offsets_[node + 1]; i++) {
+      const unsigned neighbour = neighbours_[i].node;
+      for (unsigned j = neighbour_offsets_[neighbour];
+           j < neighbour_offsets_[neighbour + 1]; j++) {
+        if (neighbours_[j].node == node) {
+          neighbours_[i].reverse = j;
+          break;
+        }
+      }
+    }
+  }
+
+  interactions_.assign(qubits_.size() * qubits_.size(), 0);
+  pattern_neighbours_.resize(qubits_.size());
+  for (const auto& [node0, node1] : q_graph.get_all_edges_vec()) {
+    auto it0 = qubit_index_.find(node0);
+    auto it1 = qubit_index_.find(node1);
+    if (it0 == qubit_index_.end() || it1 == qubit_index_.end()) continue;
+    interactions_[it0->second * qubits_.size() + it1->second] =
+        q_graph.get_connection_weight(node0, node1);
+    pattern_neighbours_[it0->second].push_back(it1->second);
+    pattern_neighbours_[it1->second].push_back(it0->second);
+  }
+}
+
+double PlacementCostTable::add_link(
+    double edge_sum, const NeighbourEntry& entry, unsigned qubit,
+    unsigned neighbour_qubit) const {
+  double fwd_edge_weighting = 1.0, bck_edge_weighting = 1.0;
+  auto place_interactions_boost = [&](unsigned edge_v) {
+    return this->maximum_pattern_depth_ - edge_v + 1;
+  };
+  // if edge is used by interaction in mapping, weight edge higher
+  unsigned edge_val = this->interaction(qubit, neighbour_qubit);
+  if (edge_val) {
+    fwd_edge_weighting += place_interactions_boost(edge_val);
+  } else {
+    edge_val = this->interaction(neighbour_qubit, qubit);
+    if (edge_val) {
+      bck_edge_weighting += place_interactions_boost(edge_val);
+    }
+  }
+  edge_sum += fwd_edge_weighting * entry.fwd_fidelity;
+  edge_sum += bck_edge_weighting * entry.bck_fidelity;
+  return edge_sum;
+}
+
+double PlacementCostTable::edge_sum(
+    unsigned node, const std::vector<unsigned>& qubit_of_node) const {
+  double sum = 1.0;
+  for (unsigned i = neighbour_offsets_[node]; i < neighbour_offsets_[node + 1];
+       i++) {
+    const unsigned neighbour_qubit = qubit_of_node[neighbours_[i].node];
+    if (neighbour_qubit == unassigned) continue;
+    sum = this->add_link(
+        sum, neighbours_[i], qubit_of_node[node], neighbour_qubit);
+  }
+  return sum;
+}
+
+double PlacementCostTable::cost(const boost::bimap<Qubit, Node>& map) const {
   double cost = 0.0;
-  if (circ_.n_gates() == 0 || circ_.n_qubits() == 0) {
-    return cost;
+  if (trivial_) return cost;
+  std::vector<unsigned> qubit_of_node(characterisation_.n_nodes(), unassigned);
+  for (auto [qb, node] : map) {
+    const unsigned n = characterisation_.get_index(node).value();
+    qubit_of_node[n] = qubit_index_.at(qb);
+  }
+  // summed in the same order as the map, so equally costed maps compare equal
+  for (auto [qb, node] : map) {
+    const unsigned n = characterisation_.get_index(node).value();
+    // bigger edge sum -> smaller cost
+    cost += 1.0 / this->edge_sum(n, qubit_of_node);
+    cost += single_terms_[n];
+    cost += readout_terms_[n];
+  }
+  return cost;
+}
+
+bool PlacementCostTable::adjacent(unsigned node0, unsigned node1) const {
+  for (unsigned i = neighbour_offsets_[node0];
+       i < neighbour_offsets_[node0 + 1]; i++) {
+    if (neighbours_[i].node == node1) return true;
+  }
+  return false;
+}
+
+bool PlacementCostTable::keeps_placed_interactions(
+    const State& state, unsigned node0, unsigned node1) const {
+  for (auto [from, to] : {std::pair{node0, node1}, std::pair{node1, node0}}) {
+    const unsigned qubit = state.qubit_of_node[from];
+    if (qubit == unassigned) continue;
+    for (unsigned other : pattern_neighbours_[qubit]) {
+      const unsigned other_node = state.node_of_qubit[other];
+      // from and to are adjacent, so an interaction between the two moved
+      // Qubits stays placed
+      if (other_node == unassigned || other_node == to) continue;
+      if (this->adjacent(from, other_node) &&
+          !this->adjacent(to, other_node)) {
+        return false;
+      }
+    }
   }
-  const int approx_depth = circ_.n_gates() / circ_.n_qubits() + 1;
-  // constants for scaling single qubit error
-  constexpr double c1 = 0.5;
-  constexpr double d1 = 1 - 1 / c1;
+  return true;
+}
+
+double PlacementCostTable::move_delta(
+    State& state, unsigned node0, unsigned node1,
+    std::vector<double>& scratch) const {
+  std::vector<unsigned>& qubit_of_node = state.qubit_of_node;
+  const unsigned qubit0 = qubit_of_node[node0];
+  const unsigned qubit1 = qubit_of_node[node1];
+  // neighbours keep their Qubit, so only the link terms to node0 and node1
+  // in their edge sums change
+  std::vector<unsigned> touched;
+  for (auto [moved, old_qubit, new_qubit] :
+       {std::tuple{node0, qubit0, qubit1}, std::tuple{node1, qubit1, qubit0}}) {
+    for (unsigned i = neighbour_offsets_[moved];
+         i < neighbour_offsets_[moved + 1]; i++) {
+      const unsigned neighbour = neighbours_[i].node;
+      const unsigned neighbour_qubit = qubit_of_node[neighbour];
+      if (neighbour == node0 || neighbour == node1 ||
+          neighbour_qubit == unassigned) {
+        continue;
+      }
+      const NeighbourEntry& entry = neighbours_[neighbours_[i].reverse];
+      double change = 0.;
+      if (new_qubit != unassigned) {
+        change += this->add_link(0., entry, neighbour_qubit, new_qubit);
+      }
+      if (old_qubit != unassigned) {
+        change -= this->add_link(0., entry, neighbour_qubit, old_qubit);
+      }
+      // a repeated entry adds nothing, as scratch is cleared on first use
+      if (scratch[neighbour] == 0.) touched.push_back(neighbour);
+      scratch[neighbour] += change;
+    }
+  }
+  double delta = 0.;
+  for (unsigned neighbour : touched) {
+    delta += 1.0 / (state.edge_sums[neighbour] + scratch[neighbour]) -
+             1.0 / state.edge_sums[neighbour];
+    scratch[neighbour] = 0.;
+  }
+  for (unsigned node : {node0, node1}) {
+    if (qubit_of_node[node] != unassigned) {
+      delta -= 1.0 / state.edge_sums[node] + single_terms_[node] +
+               readout_terms_[node];
+    }
+  }
+  std::swap(qubit_of_node[node0], qubit_of_node[node1]);
+  for (unsigned node : {node0, node1}) {
+    if (qubit_of_node[node] != unassigned) {
+      delta += 1.0 / this->edge_sum(node, qubit_of_node) +
+               single_terms_[node] + readout_terms_[node];
+    }
+  }
+  std::swap(qubit_of_node[node0], qubit_of_node[node1]);
+  return delta;
+}
+
+void PlacementCostTable::apply_move(
+    State& state, unsigned node0, unsigned node1) const {
+  std::swap(state.qubit_of_node[node0], state.qubit_of_node[node1]);
+  for (unsigned node : {node0, node1}) {
+    const unsigned qubit = state.qubit_of_node[node];
+    if (qubit == unassigned) continue;
+    state.node_of_qubit[qubit] = node;
+  }
+  // recomputed rather than updated, so rounding errors do not accumulate
+  for (unsigned node : {node0, node1}) {
+    for (unsigned i = neighbour_offsets_[node];
+         i < neighbour_offsets_[node + 1]; i++) {
+      const unsigned neighbour = neighbours_[i].node;
+      if (state.qubit_of_node[neighbour] != unassigned) {
+        state.edge_sums[neighbour] =
+            this->edge_sum(neighbour, state.qubit_of_node);
+      }
+    }
+    if (state.qubit_of_node[node] != unassigned) {
+      state.edge_sums[node] = this->edge_sum(node, state.qubit_of_node);
+    }
+  }
+}
+
+boost::bimap<Qubit, Node> PlacementCostTable::refine(
+    const boost::bimap<Qubit, Node>& map) const {
+  if (trivial_) return map;
+  State state{
+      std::vector<unsigned>(characterisation_.n_nodes(), unassigned),
+      std::vector<unsigned>(qubits_.size(), unassigned),
+      std::vector<double>(characterisation_.n_nodes(), 0.)};
   for (auto [qb, node] : map) {
-    node_set_t neighbours = this->architecture_.get_neighbour_nodes(node);
-    double edge_sum = 1.0;
-    for (const Node& neighbour : neighbours) {
-      double fwd_edge_weighting = 1.0, bck_edge_weighting = 1.0;
-      // check if neighbour node is mapped
-      auto nei_qb_it = map.right.find(neighbour);
-      if (nei_qb_it == map.right.end()) continue;
-
-      auto place_interactions_boost = [&](unsigned edge_v) {
-        return this->maximum_pattern_depth_ - edge_v + 1;
-      };
-
-      // check if either directed interaction exists
-      // if edge is used by interaction in mapping, weight edge higher
-      unsigned edge_val = q_graph.get_connection_weight(qb, nei_qb_it->second);
-      if (edge_val) {
-        fwd_edge_weighting += place_interactions_boost(edge_val);
-      } else {
-        edge_val = q_graph.get_connection_weight(nei_qb_it->second, qb);
-        if (edge_val) {
-          bck_edge_weighting += place_interactions_boost(edge_val);
+    const unsigned n = characterisation_.get_index(node).value();
+    const unsigned q = qubit_index_.at(qb);
+    state.qubit_of_node[n] = q;
+    state.node_of_qubit[q] = n;
+  }
+  for (unsigned n = 0; n < characterisation_.n_nodes(); n++) {
+    if (state.qubit_of_node[n] != unassigned) {
+      state.edge_sums[n] = this->edge_sum(n, state.qubit_of_node);
+    }
+  }
+  std::vector<double> scratch(characterisation_.n_nodes(), 0.);
+  // first improvement hill climbing, every accepted move reduces the cost by
+  // at least min_improvement so this terminates
+  bool improved = true;
+  while (improved) {
+    improved = false;
+    for (unsigned node0 = 0; node0 < characterisation_.n_nodes(); node0++) {
+      for (unsigned i = neighbour_offsets_[node0];
+           i < neighbour_offsets_[node0 + 1]; i++) {
+        if (state.qubit_of_node[node0] == unassigned) break;
+        const unsigned node1 = neighbours_[i].node;
+        // swaps of two assigned Nodes are tried from the lower index
+        if (state.qubit_of_node[node1] != unassigned && node1 < node0) {
+          continue;
+        }
+        if (!this->keeps_placed_interactions(state, node0, node1)) continue;
+        if (this->move_delta(state, node0, node1, scratch) <
+            -min_improvement) {
+          this->apply_move(state, node0, node1);
+          improved = true;
         }
       }
-      gate_error_t fwd_error =
-          this->characterisation_.get_error({node, neighbour});
-      gate_error_t bck_error =
-          this->characterisation_.get_error({neighbour, node});
-      edge_sum += fwd_edge_weighting * (1.0 - fwd_error);
-      edge_sum += bck_edge_weighting * (1.0 - bck_error);
     }
-    // bigger edge sum -> smaller cost
-    cost += 1.0 / (edge_sum);
-    // add error rate of node
-    gate_error_t single_error = this->characterisation_.get_error(node);
-    cost += d1 + 1.0 / ((1.0 - single_error) + c1);
-    readout_error_t readout_error =
-        this->characterisation_.get_readout_error(node);
-    if (readout_error) {
-      cost += (d1 + 1.0 / ((1.0 - readout_error) + c1)) / (approx_depth * 20);
+  }
+  boost::bimap<Qubit, Node> refined;
+  for (unsigned q = 0; q < qubits_.size(); q++) {
+    if (state.node_of_qubit[q] != unassigned) {
+      refined.insert(
+          {qubits_[q],
+           characterisation_.get_nodes()[state.node_of_qubit[q]]});
     }
   }
-  return cost;
+  return refined;
 }
 
+}  // namespace
+
 std::vector<boost::bimap<Qubit, Node>> NoiseAwarePlacement::rank_maps(
     const std::vector<boost::bimap<Qubit, Node>>& placement_maps,
     const Circuit& circ_,
@@ -104,8 +430,11 @@ std::vector<boost::bimap<Qubit, Node>> NoiseAwarePlacement::rank_maps(
   double best_cost = 0;
   QubitGraph q_graph =
       this->construct_pattern_graph(pattern_edges, circ_.n_qubits());
+  const PlacementCostTable cost_table(
+      this->architecture_, this->dense_characterisation_, circ_, q_graph,
+      this->maximum_pattern_depth_);
   for (const boost::bimap<Qubit, Node>& map : placement_maps) {
-    double cost = this->cost_placement(map, circ_, q_graph);
+    double cost = cost_table.cost(map);
     if (return_placement_maps.empty() || cost < best_cost) {
       best_cost = cost;
       return_placement_maps = {map};
@@ -113,7 +442,28 @@ std::vector<boost::bimap<Qubit, Node>> NoiseAwarePlacement::rank_maps(
       return_placement_maps.push_back(map);
     }
   }
-  return return_placement_maps;
+  if (!this->local_search_) {
+    return return_placement_maps;
+  }
+  // distinct best maps can climb to the same local optimum
+  std::vector<boost::bimap<Qubit, Node>> refined_placement_maps;
+  std::set<std::map<Qubit, Node>> seen_maps;
+  for (const boost::bimap<Qubit, Node>& map : return_placement_maps) {
+    boost::bimap<Qubit, Node> refined = cost_table.refine(map);
+    std::map<Qubit, Node> refined_map;
+    for (auto [qb, node] : refined) {
+      refined_map.insert({qb, node});
+    }
+    if (!seen_maps.insert(refined_map).second) continue;
+    double cost = cost_table.cost(refined);
+    if (refined_placement_maps.empty() || cost < best_cost) {
+      best_cost = cost;
+      refined_placement_maps = {refined};
+    } else if (cost == best_cost) {
+      refined_placement_maps.push_back(refined);
+    }
+  }
+  return refined_placement_maps;
 }
 
 std::vector<std::map<Qubit, Node>> NoiseAwarePlacement::get_all_placement_maps(
@@ -142,6 +492,16 @@ DeviceCharacterisation NoiseAwarePlacement::get_characterisation() const {
 void NoiseAwarePlacement::set_characterisation(
     const DeviceCharacterisation& characterisation) {
   this->characterisation_ = characterisation;
+  this->dense_characterisation_ = DenseDeviceCharacterisation(
+      characterisation, this->architecture_.get_all_nodes_vec());
+}
+
+bool NoiseAwarePlacement::get_local_search() const {
+  return this->local_search_;
+}
+
+void NoiseAwarePlacement::set_local_search(bool local_search) {
+  this->local_search_ = local_search;
 }
 
 }  // namespace tket
\ No newline at end of file
@@ -42,7 +42,7 @@ void fill_partial_mapping(
                        current_qubits.begin(), current_qubits.end(), x.first) ==
                    current_qubits.end();
           })) {
-    tket_log()->warn(
+    TKET_LOG_WARN(
         "Placement map has some Qubit not present in the Circuit.");
   }
 }
@@ -141,6 +141,7 @@ void to_json(nlohmann::json& j, const Placement::Ptr& placement_ptr) {
     j["maximum_pattern_gates"] = cast_placer->get_maximum_pattern_gates();
     j["maximum_pattern_depth"] = cast_placer->get_maximum_pattern_depth();
     j["characterisation"] = cast_placer->get_characterisation();
+    j["local_search"] = cast_placer->get_local_search();
   } else if (
       std::shared_ptr<GraphPlacement> cast_placer =
           std::dynamic_pointer_cast<GraphPlacement>(placement_ptr)) {
@@ -185,6 +186,10 @@ void from_json(const nlohmann::json& j, Placement::Ptr& placement_ptr) {
             arc, empty_node_errors, empty_link_errors, empty_readout_errors,
             matches, timeout, max_pattern_gates, max_pattern_depth);
     nap->set_characterisation(characterisation);
+    // optional for compatibility with placements serialised before it existed
+    if (j.contains("local_search")) {
+      nap->set_local_search(j.at("local_search").get<bool>());
+    }
     placement_ptr = nap;
   } else {
     placement_ptr = std::make_shared<Placement>(arc);
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "Architecture/Architecture.hpp"
 #include "Characterisation/DeviceCharacterisation.hpp"
 #include "Circuit/Circuit.hpp"
@@ -100,6 +102,13 @@ class Placement {
 
 JSON_DECL(Placement::Ptr);
 
+/**
+ * A target graph, preprocessed for the weighted subgraph monomorphism solver.
+ * Constructed once, it can be reused for any number of pattern graphs,
+ * including by calls running concurrently.
+ */
+struct TargetGraphContext;
+
 class GraphPlacement : public Placement {
  public:
   /**
@@ -191,8 +200,24 @@ class GraphPlacement : public Placement {
 
   mutable std::vector<WeightedEdge> weighted_target_edges;
 
-  //   we can use a vector as we index by incrementing size
-  mutable std::vector<Architecture::UndirectedConnGraph> extended_target_graphs;
+  /**
+   * Target graphs with edges between Node up to some distance apart, each
+   * with its solver context, built on first use. They are shared between
+   * copies of this object and by concurrent placement calls.
+   */
+  struct ExtendedTargetGraphs {
+    std::mutex mutex;
+    //   we can use a vector as we index by incrementing distance
+    std::vector<std::shared_ptr<const TargetGraphContext>> graphs;
+  };
+  std::shared_ptr<ExtendedTargetGraphs> extended_target_graphs;
+
+  /**
+   * @param distance Extra distance allowed between Node joined by an edge
+   * @return The target graph built from weighted_target_edges
+   */
+  std::shared_ptr<const TargetGraphContext> get_extended_target_graph(
+      unsigned distance) const;
 
   const std::vector<WeightedEdge> default_pattern_weighting(
       const Circuit& circuit) const;
@@ -225,6 +250,20 @@ std::vector<boost::bimap<Qubit, Node>> get_weighted_subgraph_monomorphisms(
     Architecture::UndirectedConnGraph& target_graph, unsigned max_matches,
     unsigned timeout_ms, bool return_best);
 
+/** Preprocess a target graph, for repeated calls to
+ * get_weighted_subgraph_monomorphisms with the same target graph.
+ */
+std::shared_ptr<const TargetGraphContext> make_target_graph_context(
+    const Architecture::UndirectedConnGraph& target_graph);
+
+/** As above, but with a target graph which has already been preprocessed.
+ * The context is only read, so can be shared between concurrent calls.
+ */
+std::vector<boost::bimap<Qubit, Node>> get_weighted_subgraph_monomorphisms(
+    const QubitGraph::UndirectedConnGraph& pattern_graph,
+    const TargetGraphContext& target_context, unsigned max_matches,
+    unsigned timeout_ms, bool return_best);
+
 class LinePlacement : public GraphPlacement {
  public:
   explicit LinePlacement(
@@ -288,16 +327,31 @@ class NoiseAwarePlacement : public GraphPlacement {
    */
   void set_characterisation(const DeviceCharacterisation& characterisation);
 
+  /**
+   * @return Whether the best ranked maps are refined by local search
+   */
+  bool get_local_search() const;
+
+  /**
+   * If set, the best ranked maps are improved by hill climbing over moves
+   * that swap the Nodes of two adjacent assigned Qubits or move a Qubit to
+   * an adjacent unassigned Node. Moves are costed incrementally and only
+   * accepted if they reduce the cost and keep every interaction that was
+   * placed on an Architecture edge on an Architecture edge.
+   *
+   * @param local_search Whether to refine maps after ranking
+   */
+  void set_local_search(bool local_search);
+
  private:
   DeviceCharacterisation characterisation_;
+  DenseDeviceCharacterisation dense_characterisation_;
+  bool local_search_;
 
   std::vector<boost::bimap<Qubit, Node>> rank_maps(
       const std::vector<boost::bimap<Qubit, Node>>& placement_maps,
       const Circuit& circ_,
       const std::vector<WeightedEdge>& pattern_edges) const;
-  double cost_placement(
-      const boost::bimap<Qubit, Node>& map, const Circuit& circ_,
-      const QubitGraph& q_graph) const;
 };
 
 void to_json(nlohmann::json& j, const Placement::Ptr& placement_ptr);
@@ -259,6 +259,19 @@ RepeatPass::RepeatPass(const PassPtr& pass) : pass_(pass) {
   std::tie(precons_, postcons_) = BasePass::match_passes(pass, pass);
 }
 
+bool RepeatPass::apply(
+    CompilationUnit& c_unit, SafetyMode safe_mode,
+    const PassCallback& before_apply, const PassCallback& after_apply) const {
+  before_apply(c_unit, this->get_config());
+  // Lets the transforms revisit only what changed since their last pass.
+  ChangeJournalScope journal(c_unit.circ_);
+  bool success = false;
+  while (pass_->apply(c_unit, safe_mode, before_apply, after_apply))
+    success = true;
+  after_apply(c_unit, this->get_config());
+  return success;
+}
+
 std::string RepeatPass::to_string() const {
   std::string str = "***PassType: RepeatPass***\n";
   str += BasePass::to_string();
@@ -185,10 +185,9 @@ PassPtr gen_placement_pass(const Placement::Ptr& placement_ptr) {
     try {
       changed = placement_ptr->place(circ, maps);
     } catch (const std::runtime_error& e) {
-      std::stringstream ss;
-      ss << "PlacementPass failed with message: " << e.what()
-         << " Fall back to LinePlacement.";
-      tket_log()->warn(ss.str());
+      TKET_LOG_WARN(
+          std::string("PlacementPass failed with message: ") + e.what() +
+          " Fall back to LinePlacement.");
       Placement::Ptr line_placement_ptr = std::make_shared<LinePlacement>(
           placement_ptr->get_architecture_ref());
       changed = line_placement_ptr->place(circ, maps);
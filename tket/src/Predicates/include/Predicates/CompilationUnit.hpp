@@ -51,6 +51,7 @@ class CompilationUnit {
   friend class Circuit;
   friend class BasePass;
   friend class StandardPass;
+  friend class RepeatPass;
 
   static TypePredicatePair make_type_pair(const PredicatePtr& ptr);
 
@@ -221,14 +221,7 @@ class RepeatPass : public BasePass {
   bool apply(
       CompilationUnit& c_unit, SafetyMode safe_mode = SafetyMode::Default,
       const PassCallback& before_apply = trivial_callback,
-      const PassCallback& after_apply = trivial_callback) const override {
-    before_apply(c_unit, this->get_config());
-    bool success = false;
-    while (pass_->apply(c_unit, safe_mode, before_apply, after_apply))
-      success = true;
-    after_apply(c_unit, this->get_config());
-    return success;
-  }
+      const PassCallback& after_apply = trivial_callback) const override;
   std::string to_string() const override;
   nlohmann::json get_config() const override;
   PassPtr get_pass() const { return pass_; }
@@ -14,15 +14,20 @@
 
 #include "BasicOptimisation.hpp"
 
+#include <iomanip>
+#include <memory>
 #include <optional>
+#include <sstream>
 #include <tkassert/Assert.hpp>
 
+#include "ChangeTracker.hpp"
 #include "Characterisation/DeviceCharacterisation.hpp"
 #include "Characterisation/ErrorTypes.hpp"
 #include "Circuit/CircPool.hpp"
 #include "Circuit/CircUtils.hpp"
 #include "Circuit/Command.hpp"
 #include "Circuit/DAGDefs.hpp"
+#include "Circuit/SynthesisCache.hpp"
 #include "Decomposition.hpp"
 #include "Gate/Gate.hpp"
 #include "Gate/GatePtr.hpp"
@@ -37,26 +42,52 @@ namespace tket {
 
 namespace Transforms {
 
-static bool redundancy_removal(Circuit &circ);
+static bool redundancy_removal(
+    Circuit &circ, const std::optional<VertexVec> &changed);
 static bool remove_redundancy(
     Circuit &circ, const Vertex &vert, VertexSet &bin,
     std::set<IVertex> &new_affected_verts, IndexMap &im);
-static bool commute_singles_to_front(Circuit &circ);
+static bool commute_singles_to_front(
+    Circuit &circ, const std::optional<VertexVec> &changed);
 
-Transform remove_redundancies() { return Transform(redundancy_removal); }
+Transform remove_redundancies() {
+  auto tracker = std::make_shared<ChangeTracker>();
+  return Transform([tracker](Circuit &circ) {
+    return redundancy_removal(circ, tracker->advance(circ));
+  });
+}
+
+// The vertex with its index in `im`, giving it the next index if it has none.
+static IVertex indexed(IndexMap &im, const Vertex &v) {
+  return {im.try_emplace(v, im.size()).first->second, v};
+}
 
 // this method annihilates all primitives next to each other (accounting for
 // previous annihilations)
 // also removes redundant non-classically controlled Z basis gates before a z
 // basis measurement so that eg. -H-X-X-H- always annihilates to -----
-static bool redundancy_removal(Circuit &circ) {
+// If `changed` is given, only the neighbourhood of those vertices is searched.
+static bool redundancy_removal(
+    Circuit &circ, const std::optional<VertexVec> &changed) {
   bool success = false;
-  tket_log()->trace("start redundancy_removal(): depth: " + std::to_string(circ.depth()));
+  TKET_LOG_TRACE("start redundancy_removal()", {{"depth", circ.depth()}});
   bool found_redundancy = true;
-  IndexMap im = circ.index_map();
+  IndexMap im;
   std::set<IVertex> old_affected_verts;
-  BGL_FORALL_VERTICES(v, circ.dag, DAG) {
-    old_affected_verts.insert({im.at(v), v});
+  if (changed) {
+    // A redundancy involves a vertex and its successors, so it can only have
+    // appeared at a changed vertex or a predecessor of one.
+    for (const Vertex &v : *changed) {
+      old_affected_verts.insert(indexed(im, v));
+      for (const Vertex &pred : circ.get_predecessors(v)) {
+        old_affected_verts.insert(indexed(im, pred));
+      }
+    }
+  } else {
+    im = circ.index_map();
+    BGL_FORALL_VERTICES(v, circ.dag, DAG) {
+      old_affected_verts.insert({im.at(v), v});
+    }
   }
   VertexSet bin;
   while (found_redundancy) {
@@ -71,7 +102,7 @@ static bool redundancy_removal(Circuit &circ) {
   }
   circ.remove_vertices(
       bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
-  tket_log()->trace("end redundancy_removal(): depth: " + std::to_string(circ.depth()));
+  TKET_LOG_TRACE("end redundancy_removal()", {{"depth", circ.depth()}});
   return success;
 }
 
@@ -92,7 +123,7 @@ static bool remove_redundancy(
                                &im](const Vertex &v_remove) {
     bin.insert(v_remove);
     for (const Vertex &l : circ.get_predecessors(v_remove)) {
-      new_affected_verts.insert({im.at(l), l});
+      new_affected_verts.insert(indexed(im, l));
     }
     circ.remove_vertex(
         v_remove, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::No);
@@ -151,7 +182,7 @@ static bool remove_redundancy(
         bin.insert(b);
         VertexVec last_verts = circ.get_predecessors(vert);
         for (const Vertex &l : last_verts) {
-          new_affected_verts.insert({im.at(l), l});
+          new_affected_verts.insert(indexed(im, l));
         }
         VertexList to_detach{vert, b};
         // detached from circuit but not removed from graph
@@ -167,7 +198,7 @@ static bool remove_redundancy(
           Expr expr2 = b_op->get_params()[0];
           VertexVec last_verts = circ.get_predecessors(vert);
           for (const Vertex &l : last_verts) {
-            new_affected_verts.insert({im.at(l), l});
+            new_affected_verts.insert(indexed(im, l));
           }
           circ.remove_vertex(
               b, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::No);
@@ -181,8 +212,8 @@ static bool remove_redundancy(
                 vert, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::No);
             circ.add_phase(a.value());
           } else {
-            new_affected_verts.insert({im[vert], vert});
-            circ.dag[vert].op = op_new;
+            new_affected_verts.insert(indexed(im, vert));
+            circ.set_vertex_Op_ptr(vert, op_new);
           }
           return true;
         }
@@ -193,7 +224,10 @@ static bool remove_redundancy(
 }
 
 Transform commute_through_multis() {
-  return Transform(commute_singles_to_front);
+  auto tracker = std::make_shared<ChangeTracker>();
+  return Transform([tracker](Circuit &circ) {
+    return commute_singles_to_front(circ, tracker->advance(circ));
+  });
 }
 
 // whether source and target commute
@@ -214,47 +248,98 @@ static bool ends_commute(const Circuit &circ, const Edge &e) {
       source, colour, PortType::Source, ports.first);
 }
 
+// moves the single qubit operations following the multiqubit operation
+// `current_v` along its out-edge `current_e` in front of it, for as long as
+// they commute with it. `current_e` is updated to the out-edge on the same
+// port. Returns the operations moved.
+static VertexVec commute_singles_before(
+    Circuit &circ, const Vertex &current_v, Edge &current_e) {
+  VertexVec moved;
+  Vertex prev_v = circ.target(current_e);
+  while (circ.n_in_edges_of_type(prev_v, EdgeType::Quantum) == 1 &&
+         ends_commute(circ, current_e)) {
+    // subsequent op on qubit path is a single qubit gate
+    // and commutes with current multi qubit gate
+    EdgeVec rewire_edges;
+    op_signature_t edge_types;
+    for (const Edge &e : circ.get_in_edges(prev_v)) {
+      EdgeType type = circ.get_edgetype(e);
+      Edge boundary_edge;
+      // Currently, only purely-quantum operations can be commuted
+      // through. This is guaranteed by `ends_commute`. It follows that
+      // any wire out of `prev_v` must be EdgeType::Quantum.
+      TKET_ASSERT(type == EdgeType::Quantum);
+      boundary_edge = circ.get_last_edge(current_v, current_e);
+      rewire_edges.push_back(boundary_edge);
+      edge_types.push_back(type);
+    }
+    const port_t backup_port = circ.get_source_port(current_e);
+    circ.remove_vertex(
+        prev_v, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::No);
+    circ.rewire(prev_v, rewire_edges, edge_types);
+    moved.push_back(prev_v);
+    current_e = circ.get_nth_out_edge(current_v, backup_port);
+    prev_v = circ.target(current_e);
+  }
+  return moved;
+}
+
+static bool is_multiqubit(const Circuit &circ, const Vertex &v) {
+  return circ.n_in_edges_of_type(v, EdgeType::Quantum) > 1;
+}
+
 // moves single qubit operations past multiqubit operations they commute with,
 // towards front of circuit (hardcoded)
-static bool commute_singles_to_front(Circuit &circ) {
+// If `changed` is given, only the multiqubit operations among or just before
+// those vertices are considered, together with any which the moved
+// operations reach.
+static bool commute_singles_to_front(
+    Circuit &circ, const std::optional<VertexVec> &changed) {
   bool success = false;
+  if (changed) {
+    VertexVec to_visit;
+    VertexSet queued;
+    auto visit = [&](const Vertex &v) {
+      if (is_multiqubit(circ, v) && queued.insert(v).second) {
+        to_visit.push_back(v);
+      }
+    };
+    for (const Vertex &v : *changed) {
+      visit(v);
+      for (const Vertex &pred :
+           circ.get_predecessors_of_type(v, EdgeType::Quantum)) {
+        visit(pred);
+      }
+    }
+    for (std::size_t i = 0; i < to_visit.size(); ++i) {
+      const Vertex current_v = to_visit[i];
+      for (Edge current_e :
+           circ.get_out_edges_of_type(current_v, EdgeType::Quantum)) {
+        const VertexVec moved =
+            commute_singles_before(circ, current_v, current_e);
+        for (const Vertex &v : moved) {
+          success = true;
+          // the moved operation may commute further back
+          for (const Vertex &pred :
+               circ.get_predecessors_of_type(v, EdgeType::Quantum)) {
+            visit(pred);
+          }
+        }
+      }
+    }
+    return success;
+  }
   // follow each qubit path from output to input
   for (const Qubit &q : circ.all_qubits()) {
     Vertex prev_v = circ.get_out(q);
     Edge current_e = circ.get_nth_in_edge(prev_v, 0);
     Vertex current_v = circ.source(current_e);
     while (!is_initial_q_type(circ.get_OpType_from_Vertex(current_v))) {
-      const Op_ptr curr_op = circ.get_Op_ptr_from_Vertex(current_v);
       // if current vertex is a multiqubit gate
-      if (circ.n_in_edges_of_type(current_v, EdgeType::Quantum) > 1) {
-        while (circ.n_in_edges_of_type(prev_v, EdgeType::Quantum) == 1 &&
-               ends_commute(circ, current_e)) {
-          // subsequent op on qubit path is a single qubit gate
-          // and commutes with current multi qubit gate
-          success = true;
-          EdgeVec rewire_edges;
-          op_signature_t edge_types;
-          for (const Edge &e : circ.get_in_edges(prev_v)) {
-            EdgeType type = circ.get_edgetype(e);
-            Edge boundary_edge;
-            // Currently, only purely-quantum operations can be commuted
-            // through. This is guaranteed by `ends_commute`. It follows that
-            // any wire out of `prev_v` must be EdgeType::Quantum.
-            TKET_ASSERT(type == EdgeType::Quantum);
-            boundary_edge = circ.get_last_edge(current_v, current_e);
-            rewire_edges.push_back(boundary_edge);
-            edge_types.push_back(type);
-          }
-          const port_t backup_port = circ.get_source_port(current_e);
-          circ.remove_vertex(
-              prev_v, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::No);
-          circ.rewire(prev_v, rewire_edges, edge_types);
-          current_e = circ.get_nth_out_edge(current_v, backup_port);
-          prev_v = circ.target(current_e);
-        }
+      if (is_multiqubit(circ, current_v)) {
+        success |= !commute_singles_before(circ, current_v, current_e).empty();
       }
       // move to next vertex (towards input)
-      prev_v = current_v;
       std::tie(current_v, current_e) = circ.get_prev_pair(current_v, current_e);
     }
   }
@@ -293,41 +378,46 @@ static bool replace_two_qubit_interaction(
   }
   // Circuit to (potentially) substitute
   Subcircuit sub = {in_edges, out_edges, i.vertices};
-  Circuit subc = circ.subcircuit(sub);
-
-  // Try to simplify using KAK
-  Circuit replacement = subc;
-  decompose_multi_qubits_TK2().apply(replacement);
-  Eigen::Matrix4cd mat = get_matrix_from_2qb_circ(replacement);
-  replacement = two_qubit_canonical(mat);
-  TwoQbFidelities fid;
-  fid.CX_fidelity = cx_fidelity;
-  if (target != OpType::TK2) {
-    decompose_TK2(fid, allow_swaps).apply(replacement);
-  }
+
+  // Try to simplify using KAK. Interactions often recur, so the synthesised
+  // circuits may be cached, see synthesis_cache().
+  Eigen::Matrix4cd mat = get_matrix_from_2qb_subcircuit(circ, sub);
+  std::stringstream tag;
+  tag << "two_qubit_squash/" << (target == OpType::TK2 ? "TK2" : "CX") << "/"
+      << std::setprecision(17) << cx_fidelity << "/" << allow_swaps;
+  Circuit replacement = synthesis_cache().get_circuit(
+      tag.str(), mat,
+      [target, cx_fidelity, allow_swaps](const Eigen::MatrixXcd &U) {
+        Circuit repl = two_qubit_canonical(U);
+        TwoQbFidelities fid;
+        fid.CX_fidelity = cx_fidelity;
+        if (target != OpType::TK2) {
+          decompose_TK2(fid, allow_swaps).apply(repl);
+        }
+        return repl;
+      });
 
   // Whether to substitute old circuit with new
   bool substitute = false;
-  for (Vertex v : subc.vertices_in_order()) {
-    unsigned n_ins = subc.n_in_edges_of_type(v, EdgeType::Quantum);
-    if (n_ins == 2 && subc.get_OpType_from_Vertex(v) != target) {
-      // Old circuit has non-target gates => we need to substitute
-      substitute = true;
-      break;
+  unsigned nb_2qb_old = 0;
+  unsigned nb_target_old = 0;
+  for (const Vertex &v : sub.verts) {
+    if (circ.n_in_edges_of_type(v, EdgeType::Quantum) == 2) {
+      ++nb_2qb_old;
+      if (circ.get_OpType_from_Vertex(v) == target) {
+        ++nb_target_old;
+      } else {
+        // Old circuit has non-target gates => we need to substitute
+        substitute = true;
+      }
     }
   }
   if (!substitute) {
     if (target == OpType::CX) {
-      unsigned nb_2qb_old = subc.count_gates(target);
       unsigned nb_2qb_new = replacement.count_gates(target);
-      substitute |= nb_2qb_new < nb_2qb_old;
+      substitute |= nb_2qb_new < nb_target_old;
     } else if (target == OpType::TK2) {
-      unsigned cnt_2qb = 0;
-      for (Vertex v : subc.vertices_in_order()) {
-        unsigned n_ins = subc.n_in_edges_of_type(v, EdgeType::Quantum);
-        cnt_2qb += n_ins == 2;
-      }
-      substitute |= cnt_2qb >= 2;
+      substitute |= nb_2qb_old >= 2;
     }
   }
 
@@ -415,7 +505,7 @@ Transform two_qubit_squash(
   return Transform([target_2qb_gate, cx_fidelity, allow_swaps](Circuit &circ) {
     bool success = false;
 
-    tket_log()->trace("start two_qubit_squash(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("start two_qubit_squash()", {{"depth", circ.depth()}});
 
     VertexList bin;
     // Get map from vertex/port to qubit number
@@ -546,7 +636,7 @@ Transform two_qubit_squash(
       squash_1qb_to_tk1().apply(circ);
     }
 
-    tket_log()->trace("end two_qubit_squash(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("end two_qubit_squash()", {{"depth", circ.depth()}});
 
     return success;
   });
@@ -581,9 +671,9 @@ static bool find_edge_rewire_vertex(
 static void extend_SWAP_chain(
     std::list<std::pair<std::vector<std::pair<Edge, double>>, Vertex>>
         &swap_chains,
-    Edge entry_edge, Node entry_node, const Edge &match, const Circuit &circ,
-    const DeviceCharacterisation &characterisation) {
-  tket_log()->trace("start extend_SWAP_chain(): depth: " + std::to_string(circ.depth()));
+    Edge entry_edge, unsigned entry_node, const Edge &match,
+    const Circuit &circ, const DenseDeviceCharacterisation &characterisation) {
+  TKET_LOG_TRACE("start extend_SWAP_chain()", {{"depth", circ.depth()}});
 
   for (auto it = swap_chains.begin(); it != swap_chains.end(); ++it) {
     if ((*it).first.back().first == match) {
@@ -592,7 +682,7 @@ static void extend_SWAP_chain(
           {entry_edge,
            1.0 - characterisation.get_error(
                      entry_node, circ.get_OpType_from_Vertex((*it).second))});
-      tket_log()->trace("end extend_SWAP_chain(): depth: " + std::to_string(circ.depth()));
+      TKET_LOG_TRACE("end extend_SWAP_chain()", {{"depth", circ.depth()}});
       return;
     }
   }
@@ -604,9 +694,9 @@ static void extend_SWAP_chain(
 // found throughout the whole circuit, predecessor Single Qubit Vertices are
 // rewired into the edge with best error rate
 static bool find_rewire_sq(
-    Circuit &circ, const DeviceCharacterisation &characterisation) {
+    Circuit &circ, const DenseDeviceCharacterisation &characterisation) {
 
-  tket_log()->trace("start find_rewire_sq(): depth: " + std::to_string(circ.depth()));
+  TKET_LOG_TRACE("start find_rewire_sq()", {{"depth", circ.depth()}});
 
   std::list<std::pair<std::vector<std::pair<Edge, double>>, Vertex>>
       swap_chains;
@@ -615,8 +705,11 @@ static bool find_rewire_sq(
       // find SWAP, if either predecessor is a single qubit unitary
       // find resulting swap chain...
       Vertex swap_vert = it.get_vertex();
-      unit_vector_t qubits = it->get_args();
-      node_vector_t nodes = {qubits.begin(), qubits.end()};
+      // Node indices into characterisation
+      std::vector<unsigned> nodes;
+      for (const UnitID &qb : it->get_args()) {
+        nodes.push_back(characterisation.get_index(Node(qb)).value());
+      }
       VertexVec pred_verts = circ.get_predecessors(swap_vert);
       EdgeVec pred_edges = circ.get_in_edges(swap_vert);
       EdgeVec post_edges = circ.get_all_out_edges(swap_vert);
@@ -650,19 +743,27 @@ static bool find_rewire_sq(
     }
     swap_chains.erase(swap_chains.begin());
   }
-  tket_log()->trace("end find_rewire_sq(): depth: " + std::to_string(circ.depth()));
+  TKET_LOG_TRACE("end find_rewire_sq()", {{"depth", circ.depth()}});
   return success;
 }
 
 static Transform commute_SQ_gates_through_SWAPS_helper(
     const DeviceCharacterisation &characterisation) {
   return Transform([characterisation](Circuit &circ) {
-    tket_log()->trace("start commute_SQ_gates_through_SWAPS_helper(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE(
+        "start commute_SQ_gates_through_SWAPS_helper()",
+        {{"depth", circ.depth()}});
+    // indexed once, as find_rewire_sq looks up errors for every SWAP
+    const qubit_vector_t qubits = circ.all_qubits();
+    const DenseDeviceCharacterisation dense_characterisation(
+        characterisation, node_vector_t(qubits.begin(), qubits.end()));
     bool success = false;
-    while (find_rewire_sq(circ, characterisation)) {
+    while (find_rewire_sq(circ, dense_characterisation)) {
       success = true;
     }
-    tket_log()->trace("end commute_SQ_gates_through_SWAPS_helper(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE(
+        "end commute_SQ_gates_through_SWAPS_helper()",
+        {{"depth", circ.depth()}});
     return success;
   });
 }
@@ -679,7 +780,7 @@ Transform commute_SQ_gates_through_SWAPS(const op_node_errors_t &node_errors) {
 Transform absorb_Rz_NPhasedX() {
   return Transform([](Circuit &circ) {
     bool success = false;
-    tket_log()->trace("start absorb_Rz_NPhasedX(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("start absorb_Rz_NPhasedX()", {{"depth", circ.depth()}});
     VertexSet all_bins;
 
     // Start by squashing Rz gates
@@ -743,7 +844,8 @@ Transform absorb_Rz_NPhasedX() {
           std::vector<Expr> new_params = op->get_params();
           TKET_ASSERT(new_params.size() == 2);
           new_params[1] += absorb_rz;
-          circ.dag[v] = get_op_ptr(OpType::NPhasedX, new_params, arity);
+          circ.set_vertex_Op_ptr(
+              v, get_op_ptr(OpType::NPhasedX, new_params, arity));
 
           // Finally, adjust +-absorb_rz in Rz everywhere around
           for (unsigned i = 0; i < arity; ++i) {
@@ -799,7 +901,7 @@ Transform absorb_Rz_NPhasedX() {
     circ.remove_vertices(
         all_bins, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
 
-    tket_log()->trace("end absorb_Rz_NPhasedX(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("end absorb_Rz_NPhasedX()", {{"depth", circ.depth()}});
     return success;
   });
 }
@@ -808,7 +910,7 @@ Transform ZZPhase_to_Rz() {
   // basic optimisation, replace ZZPhase with two Rz(1)
   return Transform([](Circuit &circ) {
     bool success = false;
-    tket_log()->trace("start ZZPhase_to_Rz(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("start ZZPhase_to_Rz()", {{"depth", circ.depth()}});
     VertexSet bin;
 
     BGL_FORALL_VERTICES(v, circ.dag, DAG) {
@@ -831,7 +933,7 @@ Transform ZZPhase_to_Rz() {
     }
     circ.remove_vertices(
         bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
-    tket_log()->trace("end ZZPhase_to_Rz(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("end ZZPhase_to_Rz()", {{"depth", circ.depth()}});
     return success;
   });
 }
@@ -839,7 +941,7 @@ Transform ZZPhase_to_Rz() {
 Transform normalise_TK2() {
   return Transform([](Circuit &circ) {
     bool success = false;
-    tket_log()->trace("start normalise_TK2(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("start normalise_TK2()", {{"depth", circ.depth()}});
     VertexSet bin;
 
     BGL_FORALL_VERTICES(v, circ.dag, DAG) {
@@ -873,7 +975,7 @@ Transform normalise_TK2() {
     circ.remove_vertices(
         bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
 
-    tket_log()->trace("end normalise_TK2(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("end normalise_TK2()", {{"depth", circ.depth()}});
 
     return success;
   });
@@ -0,0 +1,34 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ChangeTracker.hpp"
+
+namespace tket {
+
+namespace Transforms {
+
+std::optional<VertexVec> ChangeTracker::advance(const Circuit &circ) {
+  if (!circ.change_journal_active()) return std::nullopt;
+  const std::lock_guard<std::mutex> lock(mutex_);
+  std::optional<VertexVec> changed = std::nullopt;
+  if (checkpoint_) {
+    changed = circ.changed_vertices_since(*checkpoint_);
+  }
+  checkpoint_ = circ.change_checkpoint();
+  return changed;
+}
+
+}  // namespace Transforms
+
+}  // namespace tket
@@ -175,9 +175,12 @@ static bool multiq_clifford_match(Circuit &circ, bool allow_swaps) {
             /* --C--  ...  --C--      --C--  ...  --C--  */
             /*   |           |    =>    |           |    */
             /* --X--S--V--S--X--      --X--V--S--V--X--  */
-            circ.dag[path1[front1_index].first] = {get_op_ptr(OpType::V)};
-            circ.dag[path1[front1_index + 1].first] = {get_op_ptr(OpType::S)};
-            circ.dag[path1[front1_index + 2].first] = {get_op_ptr(OpType::V)};
+            circ.set_vertex_Op_ptr(
+                path1[front1_index].first, get_op_ptr(OpType::V));
+            circ.set_vertex_Op_ptr(
+                path1[front1_index + 1].first, get_op_ptr(OpType::S));
+            circ.set_vertex_Op_ptr(
+                path1[front1_index + 2].first, get_op_ptr(OpType::V));
             circ.add_phase(0.25);
             front1_index++;
             back1_index--;
@@ -14,6 +14,8 @@
 
 #include "CliffordReductionPass.hpp"
 
+#include <algorithm>
+
 #include "Circuit/DAGDefs.hpp"
 #include "PauliGraph/ConjugatePauliFunctions.hpp"
 
@@ -234,7 +236,6 @@ std::optional<InteractionMatch> CliffordReductionPass::search_back_for_match(
   point[0] = rip0;
   point[1] = rip1;
   std::map<Edge, RevInteractionPoint> point_lookup;
-  IndexMap im = circ.index_map();
 
   // interactions met when commuting back; point lists are in causal order of
   // circuit:
@@ -248,7 +249,7 @@ std::optional<InteractionMatch> CliffordReductionPass::search_back_for_match(
       auto r = itable.get<TagEdge>().equal_range(point[i].e);
       for (auto it = r.first; it != r.second; ++it) {
         Vertex v = it->source;
-        candidates[i][{im.at(v), v}].push_front(*it);
+        candidates[i][{v_to_index.at(v), v}].push_front(*it);
       }
       Vertex pred = circ.source(point[i].e);
       port_t pred_port = circ.get_source_port(point[i].e);
@@ -458,11 +459,16 @@ Subcircuit CliffordReductionPass::substitute(
     // Depth of to_replace is at most 1, so there are no other edges
   }
 
+  // The depths of the replaced vertices' future cone may change, so forget
+  // what is known about its past.
+  forget_ancestor_depths(to_replace.verts);
+
   // Remove replaced vertices from depth and units maps and erase all points
   // from the itable that have a replaced vertex as source.
   for (const Vertex &v : to_replace.verts) {
     v_to_depth.erase(v);
     v_to_units.erase(v);
+    v_to_index.erase(v);
     auto r = itable.get<TagSource>().equal_range(v);
     for (auto next = r.first; next != r.second; r.first = next) {
       ++next;
@@ -500,6 +506,20 @@ Subcircuit CliffordReductionPass::substitute(
     e_to_unit.insert({in, units[qi]});
   }
 
+  // The new vertices are the last ones in the vertex list, so numbering them
+  // in order after all the others keeps the order of v_to_index the same as
+  // that of Circuit::index_map().
+  std::vector<Vertex> added;
+  added.reserve(inserted.verts.size());
+  auto last = boost::vertices(circ.dag).second;
+  while (added.size() < inserted.verts.size()) {
+    added.push_back(*--last);
+  }
+  for (auto it = added.rbegin(); it != added.rend(); ++it) {
+    TKET_ASSERT(inserted.verts.contains(*it));
+    v_to_index[*it] = next_index++;
+  }
+
   // Now `v_to_depth` is 0 at all `inserted.verts`. Fix this and propagate
   // updates to the depth map into the future cone, ensuring that the depths
   // are strictly increasing along wires. Stop when we reach a vertex that
@@ -518,9 +538,7 @@ Subcircuit CliffordReductionPass::substitute(
             unsigned deptha = v_to_depth.at(a);
             unsigned depthb = v_to_depth.at(b);
             if (deptha == depthb) {
-              unit_set_t unitsa = v_to_units.at(a);
-              unit_set_t unitsb = v_to_units.at(b);
-              return unitsa < unitsb;
+              return v_to_units.at(a) < v_to_units.at(b);
             }
             return deptha < depthb;
           };
@@ -558,6 +576,83 @@ Subcircuit CliffordReductionPass::substitute(
   return inserted;
 }
 
+const std::vector<unsigned> &CliffordReductionPass::get_ancestor_depths(
+    const Vertex &v) const {
+  if (ancestor_depths.size() < next_index) {
+    ancestor_depths.resize(next_index);
+  }
+  // Depth-first, computing each entry once those of its predecessors are
+  // known. Only vertices in v_to_depth are considered, as in
+  // Circuit::in_causal_order.
+  std::vector<Vertex> to_visit{v};
+  while (!to_visit.empty()) {
+    const Vertex w = to_visit.back();
+    std::vector<unsigned> &depths = ancestor_depths[v_to_index.at(w)];
+    if (!depths.empty()) {
+      to_visit.pop_back();
+      continue;
+    }
+    const VertexVec preds = circ.get_predecessors(w);
+    bool ready = true;
+    for (const Vertex &pred : preds) {
+      if (v_to_depth.find(pred) != v_to_depth.end() &&
+          ancestor_depths[v_to_index.at(pred)].empty()) {
+        to_visit.push_back(pred);
+        ready = false;
+      }
+    }
+    if (!ready) continue;
+    depths.assign(unit_to_index.size(), 0);
+    for (const Vertex &pred : preds) {
+      if (v_to_depth.find(pred) == v_to_depth.end()) continue;
+      const std::vector<unsigned> &pred_depths =
+          ancestor_depths[v_to_index.at(pred)];
+      for (unsigned i = 0; i < depths.size(); ++i) {
+        depths[i] = std::max(depths[i], pred_depths[i]);
+      }
+    }
+    const unsigned w_depth = v_to_depth.at(w);
+    for (const UnitID &u : v_to_units.at(w)) {
+      depths[unit_to_index.at(u)] = w_depth + 1;
+    }
+    to_visit.pop_back();
+  }
+  return ancestor_depths[v_to_index.at(v)];
+}
+
+bool CliffordReductionPass::in_causal_order(
+    const Vertex &from, const Vertex &to) const {
+  if (from == to) return true;
+  const unsigned from_depth = v_to_depth.at(from);
+  if (from_depth >= v_to_depth.at(to)) return false;
+  // Depths strictly increase along wires, so `to` is in the future of `from`
+  // if and only if, on one of the units of `from`, it has an ancestor later
+  // than `from`.
+  const std::vector<unsigned> &depths = get_ancestor_depths(to);
+  for (const UnitID &u : v_to_units.at(from)) {
+    if (depths[unit_to_index.at(u)] > from_depth + 1) return true;
+  }
+  return false;
+}
+
+void CliffordReductionPass::forget_ancestor_depths(const VertexSet &verts) {
+  // Entries exist for the ancestors of any vertex with an entry, so the
+  // search can stop at vertices without one.
+  std::vector<Vertex> to_visit(verts.begin(), verts.end());
+  while (!to_visit.empty()) {
+    const Vertex v = to_visit.back();
+    to_visit.pop_back();
+    const unsigned index = v_to_index.at(v);
+    if (index >= ancestor_depths.size() || ancestor_depths[index].empty()) {
+      continue;
+    }
+    ancestor_depths[index].clear();
+    for (const Vertex &succ : circ.get_successors(v)) {
+      to_visit.push_back(succ);
+    }
+  }
+}
+
 std::optional<Edge> CliffordReductionPass::find_earliest_successor(
     const Edge &source, const EdgeSet &candidates) const {
   typedef std::function<bool(Vertex, Vertex)> Comp;
@@ -565,17 +660,24 @@ std::optional<Edge> CliffordReductionPass::find_earliest_successor(
     unsigned deptha = v_to_depth.at(a);
     unsigned depthb = v_to_depth.at(b);
     if (deptha == depthb) {
-      unit_set_t unitsa = v_to_units.at(a);
-      unit_set_t unitsb = v_to_units.at(b);
-      return unitsa < unitsb;
+      return v_to_units.at(a) < v_to_units.at(b);
     }
     return deptha < depthb;
   };
+  // Vertices are visited in order of depth, so the search can stop once it
+  // is past the deepest source of a candidate.
+  unsigned max_depth = 0;
+  for (const Edge &e : candidates) {
+    const auto it = v_to_depth.find(circ.source(e));
+    if (it != v_to_depth.end()) max_depth = std::max(max_depth, it->second);
+  }
   std::set<Vertex, Comp> to_search(c);
   to_search.insert(circ.target(source));
   while (!to_search.empty()) {
     Vertex v = *to_search.begin();
     to_search.erase(to_search.begin());
+    const auto v_depth = v_to_depth.find(v);
+    if (v_depth != v_to_depth.end() && v_depth->second > max_depth) break;
     EdgeVec outs = circ.get_all_out_edges(v);
     for (const Edge &e : outs) {
       if (candidates.find(e) != candidates.end()) return e;
@@ -594,9 +696,7 @@ CliffordReductionPass::valid_insertion_point(
   // likewise seq1 for the other qubit
   InteractionPoint seq0max = seq0.back();
   InteractionPoint seq1max = seq1.back();
-  if (circ.in_causal_order(
-          circ.source(seq1max.e), circ.target(seq0max.e), true, v_to_depth,
-          v_to_units, false)) {
+  if (in_causal_order(circ.target(seq0max.e), circ.source(seq1max.e))) {
     // Search for any points in seq1 from future of seq0max
     EdgeSet candidates;
     std::map<Edge, InteractionPoint> lookup;
@@ -611,9 +711,8 @@ CliffordReductionPass::valid_insertion_point(
     port_t p = circ.get_source_port(*successor);
     if (circ.get_OpType_from_Vertex(v) == OpType::SWAP) p = 1 - p;
     return {{seq0max, lookup.at(circ.get_nth_in_edge(v, p))}};
-  } else if (circ.in_causal_order(
-                 circ.source(seq0max.e), circ.target(seq1max.e), true,
-                 v_to_depth, v_to_units, false)) {
+  } else if (in_causal_order(
+                 circ.target(seq1max.e), circ.source(seq0max.e))) {
     // Search for any points in seq0 from future of seq1max
     EdgeSet candidates;
     std::map<Edge, InteractionPoint> lookup;
@@ -638,11 +737,16 @@ CliffordReductionPass::CliffordReductionPass(Circuit &c, bool swaps)
     : circ(c),
       itable(),
       v_to_depth(),
+      v_to_index(c.index_map()),
+      next_index(v_to_index.size()),
       success(false),
       current_depth(1),
       allow_swaps(swaps) {
   v_to_units = circ.vertex_unit_map();
   e_to_unit = circ.edge_unit_map();
+  for (const UnitID &u : circ.all_units()) {
+    unit_to_index.insert({u, unit_to_index.size()});
+  }
 }
 
 bool CliffordReductionPass::reduce_circuit(Circuit &circ, bool allow_swaps) {
@@ -757,11 +861,13 @@ CliffordReductionPassTester::CliffordReductionPassTester(Circuit &circ)
     context.v_to_depth.insert({in, 0});
   }
 
+  // As in reduce_circuit, each slice is one deeper than the last.
   SliceVec slices = circ.get_slices();
   for (const Slice &sl : slices) {
     for (const Vertex &v : sl) {
       context.v_to_depth.insert({v, context.current_depth});
     }
+    ++context.current_depth;
   }
 }
 
@@ -772,4 +878,9 @@ CliffordReductionPassTester::valid_insertion_point(
   return context.valid_insertion_point(seq0, seq1);
 }
 
+bool CliffordReductionPassTester::in_causal_order(
+    const Vertex &from, const Vertex &to) const {
+  return context.in_causal_order(from, to);
+}
+
 }  // namespace tket
@@ -16,6 +16,7 @@
 
 #include <memory>
 
+#include "Circuit/Circuit.hpp"
 #include "Transform.hpp"
 
 namespace tket {
@@ -40,6 +41,8 @@ Transform sequence(std::vector<Transform> &tvec) {
 
 Transform repeat(const Transform &trans) {
   return Transform([=](Circuit &circ, std::shared_ptr<unit_bimaps_t> maps) {
+    // Lets the transforms revisit only what changed since their last pass.
+    ChangeJournalScope journal(circ);
     bool success = false;
     while (trans.apply_fn(circ, maps)) success = true;
     return success;
@@ -69,6 +72,7 @@ Transform repeat_with_metric(
 
 Transform repeat_while(const Transform &cond, const Transform &body) {
   return Transform([=](Circuit &circ, std::shared_ptr<unit_bimaps_t> maps) {
+    ChangeJournalScope journal(circ);
     bool success = false;
     while (cond.apply_fn(circ, maps)) {
       success = true;
@@ -83,15 +83,13 @@ static std::optional<Eigen::MatrixXcd> op_unitary(Op_ptr op) {
   try {
     return op->get_unitary();
   } catch (BadOpType &) {
-    std::stringstream ss;
-    ss << "Attempting to compute unitary for invalid type: " << op->get_name();
-    tket_log()->warn(ss.str());
+    TKET_LOG_WARN(
+        "Attempting to compute unitary for invalid type: " + op->get_name());
     return std::nullopt;
   } catch (SymbolsNotSupported &) {
-    std::stringstream ss;
-    ss << "Attempting to compute unitary for symbolic operation: "
-       << op->get_name();
-    tket_log()->warn(ss.str());
+    TKET_LOG_WARN(
+        "Attempting to compute unitary for symbolic operation: " +
+        op->get_name());
     return std::nullopt;
   }
   // Any other exception is unexpected.
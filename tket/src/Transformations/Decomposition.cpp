@@ -233,9 +233,10 @@ Transform decompose_ZYZ_to_TK1() {
             }
             std::vector<Expr> new_params = {
                 angle_3 + half, angle_2, angle_1 - half};
-            circ.dag[v] = {get_op_ptr(OpType::TK1, new_params)};
+            circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::TK1, new_params));
           } else {
-            circ.dag[v] = {get_op_ptr(OpType::TK1, {zero, zero, angle_1})};
+            circ.set_vertex_Op_ptr(
+                v, get_op_ptr(OpType::TK1, {zero, zero, angle_1}));
           }
         } else if (circ.get_OpType_from_Vertex(v) == OpType::Ry) {
           const Op_ptr v_g = circ.get_Op_ptr_from_Vertex(v);
@@ -251,7 +252,7 @@ Transform decompose_ZYZ_to_TK1() {
             bin.push_back(v2);
           }
           std::vector<Expr> new_params = {angle_3 + half, angle_2, -half};
-          circ.dag[v] = {get_op_ptr(OpType::TK1, new_params)};
+          circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::TK1, new_params));
         }
         e = circ.get_next_edge(v, e);
         v = circ.target(e);
@@ -474,18 +475,18 @@ Transform decompose_ZX_to_HQS1() {
           const Op_ptr next_g = circ.get_Op_ptr_from_Vertex(next_vert);
           Expr phi = next_g->get_params()[0];
           std::vector<Expr> params{theta, phi};
-          circ.dag[v].op = get_op_ptr(OpType::PhasedX, params);
+          circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::PhasedX, params));
           circ.remove_vertex(
               next_vert, Circuit::GraphRewiring::Yes,
               Circuit::VertexDeletion::No);
           to_bin.push_back(next_vert);
           Expr new_param = prev_g->get_params()[0] + phi;
-          circ.dag[prev_vert].op = get_op_ptr(OpType::Rz, new_param);
+          circ.set_vertex_Op_ptr(prev_vert, get_op_ptr(OpType::Rz, new_param));
         } else {
           // if no Rz, initialise a PhasedX op with theta=Rx.params[0],phi=0
           Expr phi(0);
           std::vector<Expr> params{theta, phi};
-          circ.dag[v].op = get_op_ptr(OpType::PhasedX, params);
+          circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::PhasedX, params));
         }
       }
     }
@@ -525,7 +526,7 @@ Transform decompose_MolmerSorensen() {
                 circ.get_nth_in_edge(last, 1) == outs[1]) {
               // Recognise exp(-i XX * angle * pi/2)
               const Op_ptr op_ptr = get_op_ptr(OpType::XXPhase, angle);
-              circ.dag[v] = {op_ptr};
+              circ.set_vertex_Op_ptr(v, op_ptr);
               bin.push_back(next);
               circ.remove_vertex(
                   next, Circuit::GraphRewiring::Yes,
@@ -914,7 +915,8 @@ Transform decompose_ZZPhase() {
           success = true;
           const Op_ptr g = circ.get_Op_ptr_from_Vertex(v);
           TKET_ASSERT(g->get_params().size() == 1);
-          circ.dag[v] = {get_op_ptr(OpType::ZZPhase, g->get_params()[0])};
+          circ.set_vertex_Op_ptr(
+              v, get_op_ptr(OpType::ZZPhase, g->get_params()[0]));
           break;
         }
         case OpType::XXPhase: {
@@ -1188,28 +1190,28 @@ Transform decompose_ZX_to_cliffords() {
             }
             case 1: {
               if (is_rz) {
-                circ.dag[v] = {get_op_ptr(OpType::S)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::S));
                 circ.add_phase(-0.25);
               } else {
-                circ.dag[v] = {get_op_ptr(OpType::V)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::V));
               }
               break;
             }
             case 2: {
               if (is_rz) {
-                circ.dag[v] = {get_op_ptr(OpType::Z)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::Z));
               } else {
-                circ.dag[v] = {get_op_ptr(OpType::X)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::X));
               }
               circ.add_phase(-0.5);
               break;
             }
             case 3: {
               if (is_rz) {
-                circ.dag[v] = {get_op_ptr(OpType::Sdg)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::Sdg));
                 circ.add_phase(-0.75);
               } else {
-                circ.dag[v] = {get_op_ptr(OpType::Vdg)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::Vdg));
                 circ.add_phase(1);
               }
               break;
@@ -1253,7 +1255,8 @@ Transform decompose_PhaseGadgets() {
             if (type == OpType::TK1) {
               t += g->get_params()[2];
             }
-            circ.dag[*it] = {get_op_ptr(OpType::PhaseGadget, {t}, 2)};
+            circ.set_vertex_Op_ptr(
+                *it, get_op_ptr(OpType::PhaseGadget, {t}, 2));
             if (type == OpType::U1) {
               circ.add_phase(t / 2);
             } else if (
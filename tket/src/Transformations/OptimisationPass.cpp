@@ -14,11 +14,16 @@
 
 #include "OptimisationPass.hpp"
 
+#include <algorithm>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "BasicOptimisation.hpp"
 #include "Circuit/CircPool.hpp"
 #include "Circuit/CircUtils.hpp"
+#include "Circuit/Command.hpp"
 #include "CliffordOptimisation.hpp"
 #include "CliffordReductionPass.hpp"
 #include "Combinator.hpp"
@@ -29,6 +34,7 @@
 #include "Rebase.hpp"
 #include "ThreeQubitSquash.hpp"
 #include "Transform.hpp"
+#include "Utils/Parallel.hpp"
 
 #include <tklog/TketLog.hpp>
 
@@ -37,14 +43,14 @@ namespace tket {
 namespace Transforms {
 
 Transform peephole_optimise_2q() {
-  tket_log()->trace("peephole_optimise_2q()");
+  TKET_LOG_TRACE("peephole_optimise_2q()");
   return (
       synthesise_tket() >> two_qubit_squash() >> hyper_clifford_squash() >>
       synthesise_tket());
 }
 
 Transform full_peephole_optimise(bool allow_swaps, OpType target_2qb_gate) {
-  tket_log()->trace("full_peephole_optimise()");
+  TKET_LOG_TRACE("full_peephole_optimise()");
   switch (target_2qb_gate) {
     case OpType::CX:
       return (
@@ -64,26 +70,122 @@ Transform full_peephole_optimise(bool allow_swaps, OpType target_2qb_gate) {
   }
 }
 
+// Cut a circuit into consecutive windows of at most `max_size` commands
+// each, except the first which has at most `first_size`. Every window has
+// all the qubits and bits of the circuit.
+static std::vector<Circuit> split_into_windows(
+    const Circuit &circ, unsigned first_size, unsigned max_size) {
+  const qubit_vector_t qubits = circ.all_qubits();
+  const bit_vector_t bits = circ.all_bits();
+  std::vector<Circuit> windows;
+  unsigned size = 0;
+  unsigned limit = first_size;
+  for (const Command &cmd : circ) {
+    if (windows.empty() || size >= limit) {
+      windows.emplace_back(qubits, bits);
+      size = 0;
+      limit = windows.size() == 1 ? first_size : max_size;
+    }
+    windows.back().add_op<UnitID>(
+        cmd.get_op_ptr(), cmd.get_args(), cmd.get_opgroup());
+    ++size;
+  }
+  return windows;
+}
+
+// Join windows cut from `source` back together, restoring the phase,
+// implicit permutation, and created and discarded qubits of the source.
+static Circuit join_windows(
+    const std::vector<Circuit> &windows, const Circuit &source) {
+  Circuit circ(source.all_qubits(), source.all_bits());
+  for (const Circuit &window : windows) {
+    circ.append(window);
+  }
+  circ.add_phase(source.get_phase());
+  if (source.has_implicit_wireswaps()) {
+    circ.permute_boundary_output(source.implicit_qubit_permutation());
+  }
+  for (const Qubit &q : source.created_qubits()) {
+    circ.qubit_create(q);
+  }
+  for (const Qubit &q : source.discarded_qubits()) {
+    circ.qubit_discard(q);
+  }
+  std::optional<std::string> name = source.get_name();
+  if (name) {
+    circ.set_name(*name);
+  }
+  return circ;
+}
+
+// Optimise each window of `circ` independently, replacing `circ` only if some
+// window changed.
+static bool optimise_windows(
+    Circuit &circ, const Transform &transform, unsigned first_size,
+    unsigned max_size, unsigned max_threads) {
+  std::vector<Circuit> windows = split_into_windows(circ, first_size, max_size);
+  // Not std::vector<bool>, which packs its elements into shared words.
+  std::vector<char> changed(windows.size(), false);
+  parallel_for(
+      windows.size(),
+      [&](std::size_t i) { changed[i] = transform.apply(windows[i]); },
+      max_threads);
+  if (std::none_of(changed.begin(), changed.end(), [](char c) { return c; })) {
+    return false;
+  }
+  circ = join_windows(windows, circ);
+  return true;
+}
+
+Transform full_peephole_optimise_parallel(
+    bool allow_swaps, OpType target_2qb_gate, unsigned max_window_size,
+    bool reoptimise_boundaries, unsigned max_threads) {
+  TKET_LOG_TRACE("full_peephole_optimise_parallel()");
+  if (max_window_size == 0) {
+    throw std::invalid_argument("The window size must be positive.");
+  }
+  // Validates the target gate.
+  const Transform transform =
+      full_peephole_optimise(allow_swaps, target_2qb_gate);
+#ifndef WITH_SYMENGINE_THREAD_SAFE
+  // Windows share the expressions of the original circuit.
+  max_threads = 1;
+#endif
+  return Transform([=](Circuit &circ) {
+    if (circ.n_gates() <= max_window_size) {
+      return transform.apply(circ);
+    }
+    bool success = optimise_windows(
+        circ, transform, max_window_size, max_window_size, max_threads);
+    if (reoptimise_boundaries) {
+      success |= optimise_windows(
+          circ, transform, std::max(1u, max_window_size / 2), max_window_size,
+          max_threads);
+    }
+    return success;
+  });
+}
+
 Transform canonical_hyper_clifford_squash() {
-  tket_log()->trace("canonical_hyper_clifford_squash()");
+  TKET_LOG_TRACE("canonical_hyper_clifford_squash()");
   return optimise_via_PhaseGadget() >> two_qubit_squash() >>
          hyper_clifford_squash();
 }
 
 Transform hyper_clifford_squash() {
-  tket_log()->trace("hyper_clifford_squash()");
+  TKET_LOG_TRACE("hyper_clifford_squash()");
   return decompose_multi_qubits_CX() >> clifford_simp();
 }
 
 Transform clifford_simp(bool allow_swaps) {
-  tket_log()->trace("clifford_simp()");
+  TKET_LOG_TRACE("clifford_simp()");
   return decompose_cliffords_std() >> clifford_reduction(allow_swaps) >>
          decompose_multi_qubits_CX() >> singleq_clifford_sweep() >>
          squash_1qb_to_tk1();
 }
 
 Transform synthesise_tk() {
-  tket_log()->trace("synthesise_tk()");
+  TKET_LOG_TRACE("synthesise_tk()");
   Transform seq = commute_through_multis() >> remove_redundancies();
   Transform rep = repeat(seq);
   Transform synth = decompose_multi_qubits_TK2() >> remove_redundancies() >>
@@ -95,7 +197,7 @@ Transform synthesise_tk() {
 }
 
 Transform synthesise_tket() {
-  tket_log()->trace("synthesise_tket()");
+  TKET_LOG_TRACE("synthesise_tket()");
 
   Transform seq = commute_through_multis() >> remove_redundancies();
   Transform rep = repeat(seq);
@@ -110,7 +212,7 @@ Transform synthesise_tket() {
 static Transform CXs_from_phase_gadgets(CXConfigType cx_config) {
   return Transform([=](Circuit &circ) {
     bool success = false;
-    tket_log()->trace("CXs_from_phase_gadgets()");
+    TKET_LOG_TRACE("CXs_from_phase_gadgets()");
     VertexList bin;
     auto [i, end] = boost::vertices(circ.dag);
     for (auto next = i; i != end; i = next) {
@@ -132,14 +234,14 @@ static Transform CXs_from_phase_gadgets(CXConfigType cx_config) {
 }
 
 Transform optimise_via_PhaseGadget(CXConfigType cx_config) {
-  tket_log()->trace("optimise_via_PhaseGadget()");
+  TKET_LOG_TRACE("optimise_via_PhaseGadget()");
   return rebase_tket() >> decompose_PhaseGadgets() >> smash_CX_PhaseGadgets() >>
          align_PhaseGadgets() >> CXs_from_phase_gadgets(cx_config) >>
          synthesise_tket();
 }
 
 Transform synthesise_OQC() {
-  tket_log()->trace("synthesise_OQC()");
+  TKET_LOG_TRACE("synthesise_OQC()");
   return Transform([](Circuit &circ) {
     Transform rep_zx = squash_1qb_to_pqp(OpType::Rx, OpType::Rz) >>
                        commute_through_multis() >> remove_redundancies();
@@ -152,7 +254,7 @@ Transform synthesise_OQC() {
 
 /* Returns a Circuit with only HQS allowed Ops (Rz, PhasedX, ZZMax) */
 Transform synthesise_HQS() {
-  tket_log()->trace("synthesise_HQS()");
+  TKET_LOG_TRACE("synthesise_HQS()");
   return Transform([](Circuit &circ) {
     Transform single_loop =
         remove_redundancies() >> commute_through_multis() >> reduce_XZ_chains();
@@ -168,7 +270,7 @@ Transform synthesise_HQS() {
 
 // TODO: Make the XXPhase gates combine
 Transform synthesise_UMD() {
-  tket_log()->trace("synthesise_UMD()");
+  TKET_LOG_TRACE("synthesise_UMD()");
   return Transform([](Circuit &circ) {
            bool success = (synthesise_tket() >> decompose_ZX() >>
                            decompose_MolmerSorensen() >> squash_1qb_to_tk1())
@@ -15,8 +15,10 @@
 #include "PQPSquash.hpp"
 
 #include <memory>
+#include <optional>
 
 #include "BasicOptimisation.hpp"
+#include "ChangeTracker.hpp"
 #include "Circuit/DAGDefs.hpp"
 #include "Decomposition.hpp"
 #include "Gate/Rotation.hpp"
@@ -184,21 +186,23 @@ static Rotation merge_rotations(
 }
 
 static bool squash_to_pqp(
-    Circuit &circ, OpType q, OpType p, bool strict = false) {
+    Circuit &circ, OpType q, OpType p, bool strict,
+    const std::optional<VertexVec> &changed) {
   bool reverse = true;
   auto squasher = std::make_unique<PQPSquasher>(p, q, !strict, reverse);
-  return SingleQubitSquash(std::move(squasher), circ, reverse).squash();
+  SingleQubitSquash squash(std::move(squasher), circ, reverse);
+  return changed ? squash.squash_around(*changed) : squash.squash();
 }
 
 Transform reduce_XZ_chains() {
-  return Transform([](Circuit &circ) {
-    return squash_to_pqp(circ, OpType::Rx, OpType::Rz);
-  });
+  return squash_1qb_to_pqp(OpType::Rx, OpType::Rz);
 }
 
 Transform squash_1qb_to_pqp(const OpType &q, const OpType &p, bool strict) {
-  return Transform(
-      [=](Circuit &circ) { return squash_to_pqp(circ, q, p, strict); });
+  auto tracker = std::make_shared<ChangeTracker>();
+  return Transform([=](Circuit &circ) {
+    return squash_to_pqp(circ, q, p, strict, tracker->advance(circ));
+  });
 }
 
 // To squash to TK1:
@@ -376,7 +380,7 @@ static bool remove_redundancy(
             circ.add_phase(a.value());
           } else {
             new_affected_verts.insert({im[vert], vert});
-            circ.dag[vert].op = op_new;
+            circ.set_vertex_Op_ptr(vert, op_new);
           }
           return true;
         }
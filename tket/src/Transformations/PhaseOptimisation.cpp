@@ -69,8 +69,9 @@ static void recursive_smash_CX_PhaseGadgets(
     // Fix up the qubit count for the phase gadget we inserted.
     std::vector<Expr> v_params =
         circ.get_Op_ptr_from_Vertex(vert)->get_params();
-    circ.dag[vert].op =
-        get_op_ptr(OpType::PhaseGadget, v_params, circ.n_in_edges(vert));
+    circ.set_vertex_Op_ptr(
+        vert,
+        get_op_ptr(OpType::PhaseGadget, v_params, circ.n_in_edges(vert)));
   }
 }
 
@@ -14,13 +14,18 @@
 
 #include "Rebase.hpp"
 
+#include <boost/functional/hash.hpp>
+#include <memory>
+#include <optional>
 #include <tkassert/Assert.hpp>
 #include <tklog/TketLog.hpp>
+#include <unordered_map>
 
 #include "BasicOptimisation.hpp"
 #include "Circuit/CircPool.hpp"
 #include "Circuit/CircUtils.hpp"
 #include "Circuit/Circuit.hpp"
+#include "Circuit/Command.hpp"
 #include "Gate/GatePtr.hpp"
 #include "OpType/OpType.hpp"
 #include "OpType/OpTypeFunctions.hpp"
@@ -52,156 +57,213 @@ static Circuit rebase_op(
   }
 }
 
-static bool standard_rebase(
-    Circuit& circ, const OpTypeSet& allowed_gates,
-    const Circuit& cx_replacement,
-    const std::function<Circuit(const Expr&, const Expr&, const Expr&)>&
-        tk1_replacement) {
+// A circuit to replace a gate with, prepared for splicing.
+struct GateReplacement {
+  Circuit circ;
+  /** The only gate of circ, if it acts on all the qubits in order; such a
+   * replacement can be made by changing the op of the vertex in place. */
+  Op_ptr single_op;
+};
+
+// Gates with numerical parameters, identified by type, arity and parameter
+// values, so that repeated gates are only rebased once.
+struct GateKey {
+  OpType type;
+  unsigned n_qubits;
+  std::vector<double> params;
+
+  bool operator==(const GateKey& other) const = default;
+};
+
+struct GateKeyHash {
+  std::size_t operator()(const GateKey& key) const {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, key.type);
+    boost::hash_combine(seed, key.n_qubits);
+    boost::hash_range(seed, key.params.begin(), key.params.end());
+    return seed;
+  }
+};
+
+// Replacements made during one application of a rebase. Each stage of the
+// rebase replaces a disjoint set of gates, and the replacement of a gate is
+// always its fully rebased circuit, so one cache serves all the stages.
+typedef std::unordered_map<
+    GateKey, std::shared_ptr<const GateReplacement>, GateKeyHash>
+    ReplacementCache;
+
+// Which vertices to replace, given the op (unwrapped from any Conditional)
+// and the number of quantum wires
+typedef std::function<bool(const Op_ptr&, unsigned)> ReplacementFilter;
+typedef std::function<Circuit(const Op_ptr&, unsigned)> ReplacementBuilder;
+
+static std::shared_ptr<const GateReplacement> make_replacement(Circuit circ) {
+  Op_ptr single_op;
+  if (circ.n_gates() == 1 && !circ.has_implicit_wireswaps()) {
+    const Command cmd = *circ.begin();
+    const unit_vector_t args = cmd.get_args();
+    bool in_order = args.size() == circ.n_units();
+    for (unsigned i = 0; in_order && i < args.size(); ++i) {
+      in_order = args[i] == Qubit(i);
+    }
+    if (in_order) single_op = cmd.get_op_ptr();
+  }
+  return std::make_shared<const GateReplacement>(
+      GateReplacement{std::move(circ), single_op});
+}
+
+static std::shared_ptr<const GateReplacement> get_replacement(
+    ReplacementCache& cache, const Op_ptr& op, unsigned n_qubits,
+    const ReplacementBuilder& build) {
+  const OpType type = op->get_type();
+  if (!is_gate_type(type)) return make_replacement(build(op, n_qubits));
+  GateKey key{type, n_qubits, {}};
+  for (const Expr& param : op->get_params()) {
+    const std::optional<double> x = eval_expr(param);
+    if (!x) return make_replacement(build(op, n_qubits));
+    key.params.push_back(*x);
+  }
+  const auto it = cache.find(key);
+  if (it != cache.end()) return it->second;
+  std::shared_ptr<const GateReplacement> replacement =
+      make_replacement(build(op, n_qubits));
+  cache.emplace(std::move(key), replacement);
+  return replacement;
+}
+
+// Replace the selected vertices in a single sweep. Replacements which are a
+// single gate are made in place; the others are substituted and the old
+// vertices removed at the end.
+static bool replace_gates(
+    Circuit& circ, ReplacementCache& cache, const ReplacementFilter& filter,
+    const ReplacementBuilder& build) {
   bool success = false;
   VertexSet bin;
   for (const Vertex& v : circ.all_vertices()) {
     Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
-    unsigned n_qubits = circ.n_in_edges_of_type(v, EdgeType::Quantum);
-    if (n_qubits <= 1) continue;
+    const unsigned n_qubits = circ.n_in_edges_of_type(v, EdgeType::Quantum);
     bool conditional = op->get_type() == OpType::Conditional;
     if (conditional) {
       const Conditional& cond = static_cast<const Conditional&>(*op);
       op = cond.get_op();
     }
-    OpType type = op->get_type();
-    if (allowed_gates.find(type) != allowed_gates.end() || type == OpType::CX ||
-        type == OpType::Barrier)
-      continue;
-    // need to convert
-    Circuit replacement = CX_circ_from_multiq(op);
-    if (conditional) {
-      circ.substitute_conditional(replacement, v, Circuit::VertexDeletion::No);
-    } else {
-      circ.substitute(replacement, v, Circuit::VertexDeletion::No);
-    }
-    bin.insert(v);
+    if (!filter(op, n_qubits)) continue;
+    const std::shared_ptr<const GateReplacement> replacement =
+        get_replacement(cache, op, n_qubits, build);
     success = true;
-  }
-  if (allowed_gates.find(OpType::CX) == allowed_gates.end()) {
-    const Op_ptr cx_op = get_op_ptr(OpType::CX);
-    success = circ.substitute_all(cx_replacement, cx_op) | success;
-  }
-  for (const Vertex& v : circ.all_vertices()) {
-    if (bin.contains(v)) continue;
-    if (circ.n_in_edges_of_type(v, EdgeType::Quantum) > 1) continue;
-    Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
-    bool conditional = op->get_type() == OpType::Conditional;
     if (conditional) {
-      const Conditional& cond = static_cast<const Conditional&>(*op);
-      op = cond.get_op();
-    }
-    OpType type = op->get_type();
-    if (!is_gate_type(type) || is_projective_type(type) ||
-        allowed_gates.find(type) != allowed_gates.end())
+      circ.substitute_conditional(
+          replacement->circ, v, Circuit::VertexDeletion::No);
+    } else if (replacement->single_op) {
+      // Substitution does not keep the opgroup, so neither does this.
+      circ.dag[v].opgroup.reset();
+      circ.set_vertex_Op_ptr(v, replacement->single_op);
+      circ.add_phase(replacement->circ.get_phase());
       continue;
-    // need to convert
-    Circuit replacement = rebase_op(as_gate_ptr(op), tk1_replacement);
-    if (conditional) {
-      circ.substitute_conditional(replacement, v, Circuit::VertexDeletion::No);
     } else {
-      circ.substitute(replacement, v, Circuit::VertexDeletion::No);
+      circ.substitute(replacement->circ, v, Circuit::VertexDeletion::No);
     }
     bin.insert(v);
-    success = true;
   }
   circ.remove_vertices(
       bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
   return success;
 }
 
+// Filter for the 0- and 1-qubit gates outside the target gateset
+static ReplacementFilter singleq_filter(const OpTypeSet& allowed_gates) {
+  return [&allowed_gates](const Op_ptr& op, unsigned n_qubits) {
+    OpType type = op->get_type();
+    return n_qubits <= 1 && is_gate_type(type) && !is_projective_type(type) &&
+           !allowed_gates.contains(type);
+  };
+}
+
+// Every gate is replaced by its final form in one sweep: multi-qubit gates
+// are decomposed into CX and single-qubit gates, the single-qubit gates
+// rebased and the CXs replaced by cx_replacement (with its single-qubit gates
+// rebased), before being spliced into the circuit.
+static bool standard_rebase(
+    Circuit& circ, const OpTypeSet& allowed_gates,
+    const Circuit& cx_replacement,
+    const std::function<Circuit(const Expr&, const Expr&, const Expr&)>&
+        tk1_replacement) {
+  ReplacementCache cache;
+  const ReplacementFilter is_singleq = singleq_filter(allowed_gates);
+  const ReplacementBuilder rebase_singleq = [&](const Op_ptr& op, unsigned) {
+    return rebase_op(as_gate_ptr(op), tk1_replacement);
+  };
+  auto rebase_singleqs = [&](Circuit& c) {
+    replace_gates(c, cache, is_singleq, rebase_singleq);
+  };
+  const bool replace_cx = !allowed_gates.contains(OpType::CX);
+  Circuit cx_rebased = cx_replacement;
+  if (replace_cx) rebase_singleqs(cx_rebased);
+
+  const ReplacementFilter filter = [&](const Op_ptr& op, unsigned n_qubits) {
+    if (n_qubits <= 1) return is_singleq(op, n_qubits);
+    OpType type = op->get_type();
+    if (type == OpType::CX) return replace_cx;
+    return !allowed_gates.contains(type) && type != OpType::Barrier;
+  };
+  const ReplacementBuilder build = [&](const Op_ptr& op, unsigned n_qubits) {
+    if (n_qubits <= 1) return rebase_singleq(op, n_qubits);
+    if (op->get_type() == OpType::CX) return cx_rebased;
+    Circuit replacement = CX_circ_from_multiq(op);
+    rebase_singleqs(replacement);
+    if (replace_cx) {
+      replacement.substitute_all(cx_rebased, get_op_ptr(OpType::CX));
+    }
+    return replacement;
+  };
+  return replace_gates(circ, cache, filter, build);
+}
+
+// As standard_rebase, going through TK2 rather than CX.
 static bool standard_rebase_via_tk2(
     Circuit& circ, const OpTypeSet& allowed_gates,
     const std::function<Circuit(const Expr&, const Expr&, const Expr&)>&
         tk1_replacement,
     const std::function<Circuit(const Expr&, const Expr&, const Expr&)>&
         tk2_replacement) {
-  bool success = false;
-  VertexSet bin;
+  ReplacementCache cache;
+  const ReplacementFilter is_singleq = singleq_filter(allowed_gates);
+  const ReplacementBuilder rebase_singleq = [&](const Op_ptr& op, unsigned) {
+    return rebase_op(as_gate_ptr(op), tk1_replacement);
+  };
+  auto rebase_singleqs = [&](Circuit& c) {
+    replace_gates(c, cache, is_singleq, rebase_singleq);
+  };
+  const bool replace_tk2 = !allowed_gates.contains(OpType::TK2);
+  const ReplacementFilter is_tk2 = [](const Op_ptr& op, unsigned) {
+    return op->get_type() == OpType::TK2;
+  };
+  const ReplacementBuilder rebase_tk2 = [&](const Op_ptr& op, unsigned) {
+    std::vector<Expr> params = op->get_params();
+    TKET_ASSERT(params.size() == 3);
+    Circuit replacement = tk2_replacement(params[0], params[1], params[2]);
+    remove_redundancies().apply(replacement);
+    rebase_singleqs(replacement);
+    return replacement;
+  };
 
-  // 1. Replace all multi-qubit gates outside the target gateset to TK2.
-  for (const Vertex& v : circ.all_vertices()) {
-    Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
-    unsigned n_qubits = circ.n_in_edges_of_type(v, EdgeType::Quantum);
-    if (n_qubits <= 1) continue;
-    bool conditional = op->get_type() == OpType::Conditional;
-    if (conditional) {
-      const Conditional& cond = static_cast<const Conditional&>(*op);
-      op = cond.get_op();
-    }
+  const ReplacementFilter filter = [&](const Op_ptr& op, unsigned n_qubits) {
+    if (n_qubits <= 1) return is_singleq(op, n_qubits);
     OpType type = op->get_type();
-    if (allowed_gates.contains(type) || type == OpType::TK2 ||
-        type == OpType::Barrier)
-      continue;
-    // need to convert
+    if (type == OpType::TK2) return replace_tk2;
+    return !allowed_gates.contains(type) && type != OpType::Barrier;
+  };
+  const ReplacementBuilder build = [&](const Op_ptr& op, unsigned n_qubits) {
+    if (n_qubits <= 1) return rebase_singleq(op, n_qubits);
+    if (op->get_type() == OpType::TK2) return rebase_tk2(op, n_qubits);
+    // The TK2 replacements are rebased already, so rebase the single-qubit
+    // gates first.
     Circuit replacement = TK2_circ_from_multiq(op);
-    if (conditional) {
-      circ.substitute_conditional(replacement, v, Circuit::VertexDeletion::No);
-    } else {
-      circ.substitute(replacement, v, Circuit::VertexDeletion::No);
-    }
-    bin.insert(v);
-    success = true;
-  }
-
-  // 2. If TK2 is not in the target gateset, decompose TK2 gates.
-  if (!allowed_gates.contains(OpType::TK2)) {
-    for (const Vertex& v : circ.all_vertices()) {
-      Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
-      bool conditional = op->get_type() == OpType::Conditional;
-      if (conditional) {
-        const Conditional& cond = static_cast<const Conditional&>(*op);
-        op = cond.get_op();
-      }
-      if (op->get_type() == OpType::TK2) {
-        std::vector<Expr> params = op->get_params();
-        TKET_ASSERT(params.size() == 3);
-        Circuit replacement = tk2_replacement(params[0], params[1], params[2]);
-        remove_redundancies().apply(replacement);
-        if (conditional) {
-          circ.substitute_conditional(
-              replacement, v, Circuit::VertexDeletion::No);
-        } else {
-          circ.substitute(replacement, v, Circuit::VertexDeletion::No);
-        }
-        bin.insert(v);
-        success = true;
-      }
-    }
-  }
-
-  // 3. Replace 0- and 1-qubit gates by converting to TK1 and replacing.
-  for (const Vertex& v : circ.all_vertices()) {
-    if (bin.contains(v)) continue;
-    if (circ.n_in_edges_of_type(v, EdgeType::Quantum) > 1) continue;
-    Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
-    bool conditional = op->get_type() == OpType::Conditional;
-    if (conditional) {
-      const Conditional& cond = static_cast<const Conditional&>(*op);
-      op = cond.get_op();
-    }
-    OpType type = op->get_type();
-    if (!is_gate_type(type) || is_projective_type(type) ||
-        allowed_gates.contains(type))
-      continue;
-    // need to convert
-    Circuit replacement = rebase_op(as_gate_ptr(op), tk1_replacement);
-    if (conditional) {
-      circ.substitute_conditional(replacement, v, Circuit::VertexDeletion::No);
-    } else {
-      circ.substitute(replacement, v, Circuit::VertexDeletion::No);
-    }
-    bin.insert(v);
-    success = true;
-  }
-
-  circ.remove_vertices(
-      bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
-  return success;
+    rebase_singleqs(replacement);
+    if (replace_tk2) replace_gates(replacement, cache, is_tk2, rebase_tk2);
+    return replacement;
+  };
+  return replace_gates(circ, cache, filter, build);
 }
 
 Transform rebase_factory(
@@ -0,0 +1,363 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "RewriteRules.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <tkassert/Assert.hpp>
+#include <unordered_map>
+
+#include "Circuit/Command.hpp"
+#include "OpType/OpDesc.hpp"
+
+namespace tket {
+
+namespace Transforms {
+
+// The symbol, if the expression is a single free symbol.
+static std::optional<Sym> as_symbol(const Expr &e) {
+  const ExprPtr b = e.get_basic();
+  if (!SymEngine::is_a<SymEngine::Symbol>(*b)) return std::nullopt;
+  return SymEngine::rcp_static_cast<const SymEngine::Symbol>(b);
+}
+
+static SymEngine::map_basic_basic to_sub_map(const symbol_map_t &bindings) {
+  SymEngine::map_basic_basic sub_map;
+  for (const std::pair<const Sym, Expr> &p : bindings) {
+    sub_map[p.first] = p.second;
+  }
+  return sub_map;
+}
+
+static bool includes(const SymSet &super, const SymSet &sub) {
+  return std::includes(
+      super.begin(), super.end(), sub.begin(), sub.end(), SymCompareLess());
+}
+
+RewriteRuleSet::RewriteRuleSet(const std::vector<RewriteRule> &rules) {
+  for (const RewriteRule &rule : rules) {
+    rules_.push_back(compile(rule));
+    index_[rules_.back().nodes.front().type].push_back(rules_.size() - 1);
+  }
+}
+
+RewriteRuleSet::CompiledRule RewriteRuleSet::compile(const RewriteRule &rule) {
+  const Circuit &pattern = rule.pattern;
+  const Circuit &replacement = rule.replacement;
+  if (!pattern.is_simple() || !replacement.is_simple() ||
+      pattern.n_bits() != 0 || replacement.n_bits() != 0) {
+    throw std::invalid_argument(
+        "Rewrite rules must be simple circuits without bits.");
+  }
+  const unsigned n_qubits = pattern.n_qubits();
+  if (n_qubits == 0 || replacement.n_qubits() != n_qubits) {
+    throw std::invalid_argument(
+        "The pattern and replacement of a rewrite rule must have the same, "
+        "non-zero, number of qubits.");
+  }
+  if (pattern.has_implicit_wireswaps() ||
+      replacement.has_implicit_wireswaps()) {
+    throw std::invalid_argument(
+        "Rewrite rules must not have implicit wire swaps.");
+  }
+
+  // Number the gates of the pattern in topological order.
+  VertexVec verts;
+  std::unordered_map<Vertex, unsigned> node_of;
+  for (const Command &cmd : pattern) {
+    node_of[cmd.get_vertex()] = verts.size();
+    verts.push_back(cmd.get_vertex());
+  }
+  std::unordered_map<Vertex, unsigned> qubit_of;
+  for (unsigned q = 0; q < n_qubits; ++q) {
+    const Vertex in = pattern.get_in(Qubit(q));
+    const Vertex out = pattern.get_out(Qubit(q));
+    if (pattern.target(pattern.get_nth_out_edge(in, 0)) == out) {
+      throw std::invalid_argument(
+          "A rewrite pattern must act on each of its qubits.");
+    }
+    qubit_of[in] = q;
+    qubit_of[out] = q;
+  }
+
+  CompiledRule compiled{{}, {}, replacement, pattern.get_phase()};
+  SymSet wildcards;
+  SymSet other_symbols = expr_free_symbols(compiled.phase);
+  for (const Vertex &v : verts) {
+    const Op_ptr op = pattern.get_Op_ptr_from_Vertex(v);
+    const OpDesc desc = op->get_desc();
+    if (!desc.is_gate()) {
+      throw std::invalid_argument("Rewrite patterns may only contain gates.");
+    }
+    Node node{desc.type(), op->n_qubits(), {}, {}, {}};
+    const std::vector<Expr> params = op->get_params();
+    for (unsigned i = 0; i < params.size(); ++i) {
+      const std::optional<Sym> wildcard = as_symbol(params[i]);
+      const SymSet symbols = expr_free_symbols(params[i]);
+      if (wildcard) {
+        wildcards.insert(*wildcard);
+      } else {
+        other_symbols.insert(symbols.begin(), symbols.end());
+      }
+      node.params.push_back(
+          {params[i], wildcard, !wildcard && !symbols.empty(),
+           desc.param_mod(i)});
+    }
+    for (const Edge &e : pattern.get_in_edges(v)) {
+      const Vertex source = pattern.source(e);
+      const auto it = node_of.find(source);
+      node.ins.push_back(
+          it == node_of.end() ? Link{std::nullopt, qubit_of.at(source)}
+                              : Link{it->second, pattern.get_source_port(e)});
+    }
+    for (const Edge &e : pattern.get_out_edges(v)) {
+      const Vertex target = pattern.target(e);
+      const auto it = node_of.find(target);
+      node.outs.push_back(
+          it == node_of.end() ? Link{std::nullopt, qubit_of.at(target)}
+                              : Link{it->second, pattern.get_target_port(e)});
+    }
+    compiled.nodes.push_back(std::move(node));
+  }
+  if (!includes(wildcards, other_symbols) ||
+      !includes(wildcards, replacement.free_symbols())) {
+    throw std::invalid_argument(
+        "Every symbol in a rewrite rule must appear alone as a parameter of "
+        "the pattern.");
+  }
+
+  // The pattern must be closed: every node reading an input wire reaches
+  // every node writing an output wire. Nodes are in topological order, so
+  // reachability can be computed backwards.
+  const unsigned n_nodes = compiled.nodes.size();
+  std::vector<std::vector<bool>> reaches(
+      n_nodes, std::vector<bool>(n_nodes, false));
+  for (unsigned i = n_nodes; i-- > 0;) {
+    reaches[i][i] = true;
+    for (const Link &out : compiled.nodes[i].outs) {
+      if (!out.node) continue;
+      for (unsigned j = 0; j < n_nodes; ++j) {
+        if (reaches[*out.node][j]) reaches[i][j] = true;
+      }
+    }
+  }
+  auto touches_boundary = [](const std::vector<Link> &links) {
+    return std::any_of(links.begin(), links.end(), [](const Link &link) {
+      return !link.node;
+    });
+  };
+  for (unsigned entry = 0; entry < n_nodes; ++entry) {
+    if (!touches_boundary(compiled.nodes[entry].ins)) continue;
+    for (unsigned exit = 0; exit < n_nodes; ++exit) {
+      if (touches_boundary(compiled.nodes[exit].outs) &&
+          !reaches[entry][exit]) {
+        throw std::invalid_argument(
+            "Rewrite patterns must be closed: every gate on an input wire "
+            "must precede every gate on an output wire.");
+      }
+    }
+  }
+
+  // Plan a search outwards from the first node. Closed patterns are
+  // connected, so this reaches every node.
+  std::vector<bool> planned(n_nodes, false);
+  planned[0] = true;
+  std::vector<unsigned> frontier = {0};
+  for (unsigned i = 0; i < frontier.size(); ++i) {
+    const unsigned from = frontier[i];
+    const Node &node = compiled.nodes[from];
+    for (port_t p = 0; p < node.ins.size(); ++p) {
+      const Link &link = node.ins[p];
+      if (link.node && !planned[*link.node]) {
+        planned[*link.node] = true;
+        frontier.push_back(*link.node);
+        compiled.plan.push_back({*link.node, from, false, p, link.port});
+      }
+    }
+    for (port_t p = 0; p < node.outs.size(); ++p) {
+      const Link &link = node.outs[p];
+      if (link.node && !planned[*link.node]) {
+        planned[*link.node] = true;
+        frontier.push_back(*link.node);
+        compiled.plan.push_back({*link.node, from, true, p, link.port});
+      }
+    }
+  }
+  TKET_ASSERT(frontier.size() == n_nodes);
+  return compiled;
+}
+
+bool RewriteRuleSet::node_matches(
+    const Circuit &circ, const Node &node, const Vertex &v,
+    symbol_map_t &bindings) {
+  const Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
+  if (op->get_type() != node.type || op->n_qubits() != node.n_qubits) {
+    return false;
+  }
+  const std::vector<Expr> params = op->get_params();
+  for (unsigned i = 0; i < node.params.size(); ++i) {
+    const ParamTest &test = node.params[i];
+    if (test.wildcard) {
+      const auto [it, inserted] =
+          bindings.try_emplace(*test.wildcard, params[i]);
+      if (!inserted && !equiv_expr(it->second, params[i], test.mod)) {
+        return false;
+      }
+    } else if (!test.deferred && !equiv_expr(test.value, params[i], test.mod)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<RewriteRuleSet::Match> RewriteRuleSet::match_at(
+    const Circuit &circ, unsigned rule, const Vertex &v) const {
+  const CompiledRule &compiled = rules_[rule];
+  Match match{rule, VertexVec(compiled.nodes.size()), {}};
+  if (!node_matches(circ, compiled.nodes[0], v, match.bindings)) {
+    return std::nullopt;
+  }
+  match.verts[0] = v;
+  for (const Step &step : compiled.plan) {
+    const Vertex from = match.verts[step.from];
+    Vertex next;
+    port_t port;
+    if (step.forward) {
+      const Edge e = circ.get_nth_out_edge(from, step.from_port);
+      next = circ.target(e);
+      port = circ.get_target_port(e);
+    } else {
+      const Edge e = circ.get_nth_in_edge(from, step.from_port);
+      next = circ.source(e);
+      port = circ.get_source_port(e);
+    }
+    if (port != step.node_port ||
+        !node_matches(circ, compiled.nodes[step.node], next, match.bindings)) {
+      return std::nullopt;
+    }
+    match.verts[step.node] = next;
+  }
+
+  // The search only followed a spanning tree of the pattern; check that the
+  // other wires agree too, and that no two nodes matched the same vertex.
+  const VertexSet matched(match.verts.begin(), match.verts.end());
+  if (matched.size() != match.verts.size()) return std::nullopt;
+  for (unsigned j = 0; j < compiled.nodes.size(); ++j) {
+    const Node &node = compiled.nodes[j];
+    for (port_t p = 0; p < node.ins.size(); ++p) {
+      const Edge e = circ.get_nth_in_edge(match.verts[j], p);
+      const Vertex source = circ.source(e);
+      if (node.ins[p].node ? source != match.verts[*node.ins[p].node] ||
+                                 circ.get_source_port(e) != node.ins[p].port
+                           : matched.contains(source)) {
+        return std::nullopt;
+      }
+    }
+    for (port_t p = 0; p < node.outs.size(); ++p) {
+      const Edge e = circ.get_nth_out_edge(match.verts[j], p);
+      if (!node.outs[p].node && matched.contains(circ.target(e))) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  // Parameters which depend on the wildcards
+  const SymEngine::map_basic_basic sub_map = to_sub_map(match.bindings);
+  for (unsigned j = 0; j < compiled.nodes.size(); ++j) {
+    const std::vector<Expr> params =
+        circ.get_Op_ptr_from_Vertex(match.verts[j])->get_params();
+    for (unsigned i = 0; i < params.size(); ++i) {
+      const ParamTest &test = compiled.nodes[j].params[i];
+      if (test.deferred &&
+          !equiv_expr(test.value.subs(sub_map), params[i], test.mod)) {
+        return std::nullopt;
+      }
+    }
+  }
+  return match;
+}
+
+void RewriteRuleSet::replace(Circuit &circ, const Match &match) const {
+  const CompiledRule &compiled = rules_[match.rule];
+  const unsigned n_qubits = compiled.replacement.n_qubits();
+  Subcircuit sub;
+  sub.q_in_hole.resize(n_qubits);
+  sub.q_out_hole.resize(n_qubits);
+  for (unsigned j = 0; j < compiled.nodes.size(); ++j) {
+    const Node &node = compiled.nodes[j];
+    for (port_t p = 0; p < node.ins.size(); ++p) {
+      if (!node.ins[p].node) {
+        sub.q_in_hole[node.ins[p].port] =
+            circ.get_nth_in_edge(match.verts[j], p);
+      }
+    }
+    for (port_t p = 0; p < node.outs.size(); ++p) {
+      if (!node.outs[p].node) {
+        sub.q_out_hole[node.outs[p].port] =
+            circ.get_nth_out_edge(match.verts[j], p);
+      }
+    }
+  }
+  sub.verts = VertexSet(match.verts.begin(), match.verts.end());
+
+  Circuit replacement = compiled.replacement;
+  Expr phase = compiled.phase;
+  if (!match.bindings.empty()) {
+    replacement.symbol_substitution(match.bindings);
+    phase = phase.subs(to_sub_map(match.bindings));
+  }
+  replacement.add_phase(-phase);
+  circ.substitute(replacement, sub, Circuit::VertexDeletion::Yes);
+}
+
+bool RewriteRuleSet::apply(Circuit &circ) const {
+  // Matches are only recorded during the sweep, so that the vertices and
+  // their topological order stay valid. Replacing a match of a closed pattern
+  // adds no paths between its boundary wires, so the matches can then be
+  // replaced in any order.
+  std::vector<Match> matches;
+  VertexSet claimed;
+  for (const Vertex &v : circ.vertices_in_order()) {
+    if (claimed.contains(v)) continue;
+    const auto it = index_.find(circ.get_OpType_from_Vertex(v));
+    if (it == index_.end()) continue;
+    for (unsigned rule : it->second) {
+      std::optional<Match> match = match_at(circ, rule, v);
+      if (match && std::none_of(
+                       match->verts.begin(), match->verts.end(),
+                       [&claimed](const Vertex &u) {
+                         return claimed.contains(u);
+                       })) {
+        claimed.insert(match->verts.begin(), match->verts.end());
+        matches.push_back(std::move(*match));
+        break;
+      }
+    }
+  }
+  for (const Match &match : matches) {
+    replace(circ, match);
+  }
+  return !matches.empty();
+}
+
+Transform apply_rewrite_rules(const RewriteRuleSet &rules) {
+  auto shared = std::make_shared<const RewriteRuleSet>(rules);
+  return Transform([shared](Circuit &circ) { return shared->apply(circ); });
+}
+
+}  // namespace Transforms
+
+}  // namespace tket
@@ -15,8 +15,10 @@
 #include "RzPhasedXSquash.hpp"
 
 #include <memory>
+#include <optional>
 
 #include "BasicOptimisation.hpp"
+#include "ChangeTracker.hpp"
 #include "Decomposition.hpp"
 #include "PQPSquash.hpp"
 #include "Transform.hpp"
@@ -94,11 +96,15 @@ std::pair<Circuit, Gate_ptr> RzPhasedXSquasher::flush(
 }
 
 Transform squash_1qb_to_Rz_PhasedX() {
-  return Transform([](Circuit &circ) {
+  auto tracker = std::make_shared<ChangeTracker>();
+  return Transform([tracker](Circuit &circ) {
     bool reverse = false;
     bool success = decompose_ZX().apply(circ);
+    // Includes the gates just decomposed.
+    const std::optional<VertexVec> changed = tracker->advance(circ);
     auto squasher = std::make_unique<RzPhasedXSquasher>(reverse);
-    return SingleQubitSquash(std::move(squasher), circ, reverse).squash() ||
+    SingleQubitSquash squash(std::move(squasher), circ, reverse);
+    return (changed ? squash.squash_around(*changed) : squash.squash()) ||
            success;
   });
 }
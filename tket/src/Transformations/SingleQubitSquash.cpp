@@ -63,6 +63,55 @@ bool SingleQubitSquash::squash() {
   return success;
 }
 
+bool SingleQubitSquash::squash_around(const VertexVec &vertices) {
+  bool success = false;
+  // Vertices of chains already squashed, which may no longer exist.
+  VertexSet covered;
+  for (const Vertex &v : vertices) {
+    if (covered.contains(v)) continue;
+    if (in_chain(v)) {
+      success |= squash_chain(
+          circ_.get_in_edges_of_type(v, EdgeType::Quantum).front(), covered);
+      continue;
+    }
+    // Squashing one chain may insert a gate on another wire of `v`, so edges
+    // are looked up by port each time.
+    std::vector<port_t> in_ports, out_ports;
+    for (const Edge &e : circ_.get_in_edges_of_type(v, EdgeType::Quantum)) {
+      in_ports.push_back(circ_.get_target_port(e));
+    }
+    for (const Edge &e : circ_.get_out_edges_of_type(v, EdgeType::Quantum)) {
+      out_ports.push_back(circ_.get_source_port(e));
+    }
+    for (port_t p : in_ports) {
+      success |= squash_chain(circ_.get_nth_in_edge(v, p), covered);
+    }
+    for (port_t p : out_ports) {
+      success |= squash_chain(circ_.get_nth_out_edge(v, p), covered);
+    }
+  }
+  return success;
+}
+
+bool SingleQubitSquash::in_chain(const Vertex &v) const {
+  return circ_.n_in_edges_of_type(v, EdgeType::Quantum) == 1 &&
+         !is_final_q_type(circ_.get_OpType_from_Vertex(v));
+}
+
+bool SingleQubitSquash::squash_chain(const Edge &e, VertexSet &covered) {
+  Edge first = e;
+  while (in_chain(circ_.source(first))) {
+    first = circ_.get_last_edge(circ_.source(first), first);
+  }
+  Edge last = first;
+  while (in_chain(circ_.target(last))) {
+    covered.insert(circ_.target(last));
+    last = circ_.get_next_edge(circ_.target(last), last);
+  }
+  if (first == last) return false;
+  return reversed_ ? squash_between(last, first) : squash_between(first, last);
+}
+
 bool SingleQubitSquash::squash_between(const Edge &in, const Edge &out) {
   squasher_->clear();
   Edge e = in;
@@ -15,8 +15,10 @@
 #include "StandardSquash.hpp"
 
 #include <memory>
+#include <optional>
 
 #include "BasicOptimisation.hpp"
+#include "ChangeTracker.hpp"
 #include "Circuit/DAGDefs.hpp"
 #include "Gate/Rotation.hpp"
 #include "OpType/OpTypeInfo.hpp"
@@ -83,17 +85,21 @@ std::unique_ptr<AbstractSquasher> StandardSquasher::clone() const {
 static bool standard_squash(
     Circuit &circ, const OpTypeSet &singleqs,
     const std::function<Circuit(const Expr &, const Expr &, const Expr &)>
-        &tk1_replacement) {
+        &tk1_replacement,
+    const std::optional<VertexVec> &changed) {
   auto squasher = std::make_unique<StandardSquasher>(singleqs, tk1_replacement);
-  return SingleQubitSquash(std::move(squasher), circ, false).squash();
+  SingleQubitSquash squash(std::move(squasher), circ, false);
+  return changed ? squash.squash_around(*changed) : squash.squash();
 }
 
 Transform squash_factory(
     const OpTypeSet &singleqs,
     const std::function<Circuit(const Expr &, const Expr &, const Expr &)>
         &tk1_replacement) {
+  auto tracker = std::make_shared<ChangeTracker>();
   return Transform([=](Circuit &circ) {
-    return standard_squash(circ, singleqs, tk1_replacement);
+    return standard_squash(
+        circ, singleqs, tk1_replacement, tracker->advance(circ));
   });
 }
 
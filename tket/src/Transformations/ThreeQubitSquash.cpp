@@ -28,6 +28,7 @@
 #include "Circuit/CircUtils.hpp"
 #include "Circuit/Circuit.hpp"
 #include "Circuit/DAGDefs.hpp"
+#include "Circuit/SynthesisCache.hpp"
 #include "Circuit/ThreeQubitConversion.hpp"
 #include "Decomposition.hpp"
 #include "OpType/EdgeType.hpp"
@@ -72,6 +73,14 @@ class QInteraction {
 
   unsigned n_vertices() const { return vertices_.size(); }
 
+  // Number of vertices of the given type.
+  unsigned count_gates(OpType optype) const {
+    return std::count_if(
+        vertices_.begin(), vertices_.end(), [this, optype](const Vertex &v) {
+          return circ_.get_OpType_from_Vertex(v) == optype;
+        });
+  }
+
   Subcircuit subcircuit() const { return {in_edges_, out_edges_, vertices_}; }
 
   // Append a vertex following the subcircuit. It is assumed that every input
@@ -109,33 +118,56 @@ class QInteraction {
 
 typedef std::unique_ptr<QInteraction> iptr;
 
-// Candidate substitution for a 2- or 3-qubit circuit.
-static Circuit candidate_sub(const Circuit &circ, OpType target_2qb_gate) {
-  unsigned n_qb = circ.n_qubits();
-  if (n_qb == 2) {
-    Circuit repl = two_qubit_canonical(get_matrix_from_2qb_circ(circ));
-    // TODO Remove this once `clifford_simp` supports TK2.
-    if (target_2qb_gate == OpType::CX) {
-      clifford_simp(false).apply(repl);
-    }
+// Candidate substitution for a 2-qubit unitary.
+static Circuit synthesise_2q(
+    const Eigen::MatrixXcd &U, OpType target_2qb_gate) {
+  Circuit repl = two_qubit_canonical(U);
+  // TODO Remove this once `clifford_simp` supports TK2.
+  if (target_2qb_gate == OpType::CX) {
+    clifford_simp(false).apply(repl);
+  }
+  return repl;
+}
+
+// Candidate substitution for a 3-qubit unitary.
+static Circuit synthesise_3q(
+    const Eigen::MatrixXcd &U, OpType target_2qb_gate) {
+  if (target_2qb_gate == OpType::CX) {
+    Circuit repl = three_qubit_synthesis(U);
+    normalise_TK2().apply(repl);
+    decompose_TK2().apply(repl);
+    clifford_simp(false).apply(repl);
+    squash_1qb_to_tk1().apply(repl);
     return repl;
+  } else {
+    TKET_ASSERT(target_2qb_gate == OpType::TK2);
+    Circuit repl = three_qubit_tk_synthesis(U);
+    squash_1qb_to_tk1().apply(repl);
+    return repl;
+  }
+}
+
+// Candidate substitution for a 2- or 3-qubit region of a circuit. Blocks
+// often recur, so the synthesised circuits may be cached, see
+// synthesis_cache().
+static Circuit candidate_sub(
+    const Circuit &circ, const Subcircuit &sub, OpType target_2qb_gate) {
+  const std::string target_name =
+      target_2qb_gate == OpType::CX ? "CX" : "TK2";
+  const auto synthesise = [target_2qb_gate](const Eigen::MatrixXcd &U) {
+    return U.rows() == 4 ? synthesise_2q(U, target_2qb_gate)
+                         : synthesise_3q(U, target_2qb_gate);
+  };
+  Eigen::MatrixXcd U;
+  unsigned n_qb = sub.q_in_hole.size();
+  if (n_qb == 2) {
+    U = get_matrix_from_2qb_subcircuit(circ, sub);
   } else {
     TKET_ASSERT(n_qb == 3);
-    Eigen::MatrixXcd U = get_3q_unitary(circ);
-    if (target_2qb_gate == OpType::CX) {
-      Circuit repl = three_qubit_synthesis(U);
-      normalise_TK2().apply(repl);
-      decompose_TK2().apply(repl);
-      clifford_simp(false).apply(repl);
-      squash_1qb_to_tk1().apply(repl);
-      return repl;
-    } else {
-      TKET_ASSERT(target_2qb_gate == OpType::TK2);
-      Circuit repl = three_qubit_tk_synthesis(U);
-      squash_1qb_to_tk1().apply(repl);
-      return repl;
-    }
+    U = get_matrix_from_3qb_subcircuit(circ, sub);
   }
+  return synthesis_cache().get_circuit(
+      "three_qubit_squash/" + target_name, U, synthesise);
 }
 
 // Helper class representing a system of disjoint interactions, each with at
@@ -221,10 +253,9 @@ class QISystem {
       case 2:
       case 3: {
         Subcircuit sub = I->subcircuit();
-        Circuit subc = circ_.subcircuit(sub);
-        Circuit replacement = candidate_sub(subc, target_2qb_gate_);
+        Circuit replacement = candidate_sub(circ_, sub, target_2qb_gate_);
         if (replacement.count_gates(target_2qb_gate_) <
-            subc.count_gates(target_2qb_gate_)) {
+            I->count_gates(target_2qb_gate_)) {
           // 1. Collect data needed later to reconstruct the list of out-edges:
           std::vector<std::pair<Vertex, port_t>> out_vertex_ports;
           for (const Edge &e : outs) {
@@ -319,7 +350,7 @@ Transform three_qubit_squash(OpType target_2qb_gate) {
   return Transform([target_2qb_gate](Circuit &circ) {
     bool changed = false;
 
-    tket_log()->trace("start three_qubit_squash(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("start three_qubit_squash()", {{"depth", circ.depth()}});
 
     // Step through the vertices in topological order.
     QISystem Is(circ, target_2qb_gate);  // set of "live" interactions
@@ -389,7 +420,7 @@ Transform three_qubit_squash(OpType target_2qb_gate) {
     // Delete removed vertices.
     Is.destroy_bin();
 
-    tket_log()->trace("end three_qubit_squash(): depth: " + std::to_string(circ.depth()));
+    TKET_LOG_TRACE("end three_qubit_squash()", {{"depth", circ.depth()}});
 
     return changed;
   });
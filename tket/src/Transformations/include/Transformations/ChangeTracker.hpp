@@ -0,0 +1,58 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+
+#include "Circuit/Circuit.hpp"
+
+namespace tket {
+
+namespace Transforms {
+
+/**
+ * Remembers how far through the change journal of a circuit a transform has
+ * got, so that when it is applied repeatedly (as inside Transforms::repeat
+ * or RepeatPass, which keep the journal active) it only needs to revisit the
+ * vertices changed since its previous application.
+ *
+ * A transform holds one tracker, shared by its copies. The tracker is safe to
+ * use from several threads; if the transform is applied to several circuits
+ * in turn, each application after a switch simply scans the whole circuit.
+ */
+class ChangeTracker {
+ public:
+  /**
+   * Move the tracker to the current position in the journal of a circuit.
+   *
+   * Call this as the transform starts looking at the circuit, so that its own
+   * changes are revisited on the next application.
+   *
+   * @param circ circuit about to be transformed
+   *
+   * @return the vertices changed since the previous call for \p circ, or
+   *    std::nullopt if the whole circuit must be scanned
+   */
+  std::optional<VertexVec> advance(const Circuit &circ);
+
+ private:
+  std::mutex mutex_;
+  std::optional<Circuit::JournalCheckpoint> checkpoint_;
+};
+
+}  // namespace Transforms
+
+}  // namespace tket
@@ -118,6 +118,29 @@ class CliffordReductionPass {
   /** Map from vertex to depth in circuit */
   std::map<Vertex, unsigned> v_to_depth;
 
+  /**
+   * Map from vertex to its position in the vertex list of the DAG (as in
+   * Circuit::index_map(), but maintained through substitutions rather than
+   * recomputed), used to order candidate matches deterministically.
+   */
+  IndexMap v_to_index;
+
+  /** Index to give the next vertex added to the circuit */
+  unsigned next_index;
+
+  /** Map from unit to its position in Circuit::all_units() */
+  std::map<UnitID, unsigned> unit_to_index;
+
+  /**
+   * Reachability index, keyed by v_to_index. If not empty, entry i of
+   * ancestor_depths[v_to_index[v]] is one more than the depth of the latest
+   * vertex on unit i in the causal past of v (including v itself), or 0 if
+   * there is none. Entries are computed on demand, for a vertex and all its
+   * ancestors at once, and erased along with their descendants whenever
+   * substitution changes the depths.
+   */
+  mutable std::vector<std::vector<unsigned>> ancestor_depths;
+
   /** Map from vertex to sets of units that it acts on */
   std::map<Vertex, unit_set_t> v_to_units;
 
@@ -165,6 +188,26 @@ class CliffordReductionPass {
    */
   Subcircuit substitute(const Circuit &to_insert, const Subcircuit &to_replace);
 
+  /**
+   * The entry of ancestor_depths for the vertex, computing it (and the
+   * entries of any ancestors) if necessary.
+   */
+  const std::vector<unsigned> &get_ancestor_depths(const Vertex &v) const;
+
+  /**
+   * Whether `to` is in the causal future of `from`, or equal to it. Answers
+   * the same question as Circuit::in_causal_order(to, from, true, v_to_depth,
+   * v_to_units, false), but in time proportional to the number of units of
+   * `from` once the index is built.
+   */
+  bool in_causal_order(const Vertex &from, const Vertex &to) const;
+
+  /**
+   * Erases the ancestor_depths entries of the vertices and all their
+   * descendants.
+   */
+  void forget_ancestor_depths(const VertexSet &verts);
+
   /**
    * Given a set of candidate edges, finds the earliest one that is in the
    * strict causal future of source. Returns nullopt if none are in the future
@@ -202,6 +245,8 @@ class CliffordReductionPassTester {
       const std::list<InteractionPoint> &seq0,
       const std::list<InteractionPoint> &seq1) const;
 
+  bool in_causal_order(const Vertex &from, const Vertex &to) const;
+
  private:
   CliffordReductionPass context;
 };
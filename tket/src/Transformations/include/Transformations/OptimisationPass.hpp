@@ -45,6 +45,33 @@ Transform peephole_optimise_2q();
 Transform full_peephole_optimise(
     bool allow_swaps = true, OpType target_2qb_gate = OpType::CX);
 
+/**
+ * Peephole optimisation as \ref full_peephole_optimise, over windows of the
+ * circuit in parallel.
+ *
+ * The circuit is cut into consecutive time windows of at most
+ * \p max_window_size gates each, across all qubits. The windows are
+ * optimised concurrently and joined back together. Gates on either side of
+ * a cut cannot be combined, so optionally a second round cuts the result
+ * half-way through each window and optimises again.
+ *
+ * Windows are only optimised on several threads if SymEngine is built with
+ * thread-safe reference counting.
+ *
+ * @param allow_swaps whether to allow introduction of implicit wire swaps
+ * @param target_2qb_gate target 2-qubit gate (CX or TK2)
+ * @param max_window_size maximum number of gates in each window
+ * @param reoptimise_boundaries whether to run the second round
+ * @param max_threads upper bound on the number of threads, or 0 to use the
+ *    hardware concurrency
+ *
+ * Produces: (CX or TK2) and TK1.
+ */
+Transform full_peephole_optimise_parallel(
+    bool allow_swaps = true, OpType target_2qb_gate = OpType::CX,
+    unsigned max_window_size = 10000, bool reoptimise_boundaries = true,
+    unsigned max_threads = 0);
+
 // kitchen sink optimisation - phase gadget resynthesis, two-qubit Cartan
 // forms, Clifford Expects: Any gates Produces: CX, TK1
 Transform canonical_hyper_clifford_squash();
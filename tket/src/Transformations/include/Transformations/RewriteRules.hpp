@@ -0,0 +1,161 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "Circuit/Circuit.hpp"
+#include "OpType/OpType.hpp"
+#include "Transform.hpp"
+#include "Utils/Expression.hpp"
+
+namespace tket {
+
+namespace Transforms {
+
+/**
+ * A peephole rewrite: a small circuit to look for, and its replacement.
+ *
+ * Parameters of the pattern which are single free symbols are wildcards:
+ * they match any value, but all occurrences of a symbol must match equal
+ * values. Other parameters must match up to the period of the parameter,
+ * after substituting the values of the wildcards. The replacement may use the
+ * wildcards, which are replaced by the matched values.
+ *
+ * Both circuits must be simple, with the same qubits and no bits. The
+ * pattern must consist of gates, act on every qubit, and be closed: every
+ * gate taking one of its input wires must precede (or be) every gate giving
+ * one of its output wires. Any match of a closed pattern can be replaced
+ * without creating cycles, however the surrounding circuit is connected.
+ */
+struct RewriteRule {
+  Circuit pattern;
+  Circuit replacement;
+};
+
+/**
+ * A set of rewrite rules, compiled for matching.
+ *
+ * Each pattern is compiled into a list of nodes and a plan for visiting them
+ * by following edges from the first node. Rules are indexed by the op type of
+ * their first node, so that a sweep over a circuit only tries, at each
+ * vertex, the rules which can start there.
+ */
+class RewriteRuleSet {
+ public:
+  /**
+   * Compile rules. Where matches overlap, earlier rules take precedence.
+   *
+   * @throws std::invalid_argument if a rule does not meet the requirements
+   *    of \ref RewriteRule
+   */
+  explicit RewriteRuleSet(const std::vector<RewriteRule> &rules);
+
+  /**
+   * Find matches in one sweep over the circuit in topological order, and
+   * replace them. Matches are chosen greedily and do not overlap.
+   *
+   * @param circ circuit to rewrite
+   *
+   * @return whether any match was replaced
+   */
+  bool apply(Circuit &circ) const;
+
+  /** The number of rules. */
+  unsigned size() const { return rules_.size(); }
+
+ private:
+  /** Where a wire of a pattern node comes from or goes to. */
+  struct Link {
+    /** Node at the other end, or std::nullopt for the pattern boundary */
+    std::optional<unsigned> node;
+    /** Port on that node, or qubit index on the boundary */
+    port_t port;
+  };
+
+  /** How to test one parameter of a node. */
+  struct ParamTest {
+    Expr value;
+    /** Set if value is a single symbol, to be bound to the matched value */
+    std::optional<Sym> wildcard;
+    /** Whether value has symbols, so must be tested once all are bound */
+    bool deferred;
+    unsigned mod;
+  };
+
+  struct Node {
+    OpType type;
+    unsigned n_qubits;
+    std::vector<ParamTest> params;
+    std::vector<Link> ins;
+    std::vector<Link> outs;
+  };
+
+  /** Find node `node` from the already matched node `from`. */
+  struct Step {
+    unsigned node;
+    unsigned from;
+    /** Whether to follow an out-edge of `from`, rather than an in-edge */
+    bool forward;
+    port_t from_port;
+    port_t node_port;
+  };
+
+  struct CompiledRule {
+    std::vector<Node> nodes;
+    std::vector<Step> plan;
+    Circuit replacement;
+    /** Phase of the pattern, to be removed from the replacement */
+    Expr phase;
+  };
+
+  struct Match {
+    unsigned rule;
+    VertexVec verts;
+    symbol_map_t bindings;
+  };
+
+  std::vector<CompiledRule> rules_;
+  /** Rules by op type of their first node, in order of precedence */
+  std::unordered_map<OpType, std::vector<unsigned>> index_;
+
+  static CompiledRule compile(const RewriteRule &rule);
+
+  static bool node_matches(
+      const Circuit &circ, const Node &node, const Vertex &v,
+      symbol_map_t &bindings);
+
+  std::optional<Match> match_at(
+      const Circuit &circ, unsigned rule, const Vertex &v) const;
+
+  void replace(Circuit &circ, const Match &match) const;
+};
+
+/**
+ * Apply rewrite rules in a single sweep.
+ *
+ * Wrap in Transforms::repeat to rewrite until no rule matches.
+ *
+ * @param rules compiled rules
+ *
+ * @return transform applying \p rules
+ */
+Transform apply_rewrite_rules(const RewriteRuleSet &rules);
+
+}  // namespace Transforms
+
+}  // namespace tket
@@ -117,6 +117,20 @@ class SingleQubitSquash {
    */
   bool squash();
 
+  /**
+   * @brief Squash the chains of single-qubit gates around some vertices.
+   *
+   * Only the chains containing one of the vertices, or ending just before or
+   * starting just after one, are squashed. This is how transforms applied
+   * repeatedly revisit only what has changed.
+   *
+   * @param vertices vertices of the circuit
+   *
+   * @retval true The circuit was changed.
+   * @retval false The circuit was not changed.
+   */
+  bool squash_around(const VertexVec &vertices);
+
   /**
    * @brief Squash everything between in-edge and out-edge
    *
@@ -146,6 +160,13 @@ class SingleQubitSquash {
   void insert_left_over_gate(
       Op_ptr left_over, const Edge &e, const Condition &condition);
 
+  // whether a vertex lies inside a chain of gates on one qubit
+  bool in_chain(const Vertex &v) const;
+
+  // squash the chain containing the given quantum edge, adding its vertices
+  // to `covered`
+  bool squash_chain(const Edge &e, VertexSet &covered);
+
   // whether a vertex can be squashed with the previous vertices
   bool is_squashable(Vertex v, OpType v_type) const;
 
@@ -0,0 +1,260 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "BinaryMatrix.hpp"
+
+#include <bit>
+#include <tkassert/Assert.hpp>
+#include <unordered_map>
+
+namespace tket {
+
+static constexpr unsigned WORD_BITS = 64;
+
+static unsigned n_words(unsigned n_bits) {
+  return (n_bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+BinaryMatrix::BinaryMatrix() : BinaryMatrix(0, 0) {}
+
+BinaryMatrix::BinaryMatrix(unsigned rows, unsigned cols)
+    : rows_(rows),
+      cols_(cols),
+      words_per_row_(n_words(cols)),
+      data_(rows * n_words(cols), 0) {}
+
+BinaryMatrix::BinaryMatrix(const MatrixXb& m)
+    : BinaryMatrix(m.rows(), m.cols()) {
+  for (unsigned r = 0; r < rows_; ++r) {
+    for (unsigned c = 0; c < cols_; ++c) {
+      if (m(r, c)) set(r, c);
+    }
+  }
+}
+
+BinaryMatrix BinaryMatrix::identity(unsigned n) {
+  BinaryMatrix id(n, n);
+  for (unsigned i = 0; i < n; ++i) id.set(i, i);
+  return id;
+}
+
+MatrixXb BinaryMatrix::to_MatrixXb() const {
+  MatrixXb m = MatrixXb::Zero(rows_, cols_);
+  for (unsigned r = 0; r < rows_; ++r) {
+    for (unsigned c = 0; c < cols_; ++c) {
+      m(r, c) = get(r, c);
+    }
+  }
+  return m;
+}
+
+unsigned BinaryMatrix::rows() const { return rows_; }
+
+unsigned BinaryMatrix::cols() const { return cols_; }
+
+bool BinaryMatrix::get(unsigned r, unsigned c) const {
+  return (row_data(r)[c / WORD_BITS] >> (c % WORD_BITS)) & 1;
+}
+
+void BinaryMatrix::set(unsigned r, unsigned c, bool value) {
+  std::uint64_t mask = std::uint64_t{1} << (c % WORD_BITS);
+  if (value)
+    row_data(r)[c / WORD_BITS] |= mask;
+  else
+    row_data(r)[c / WORD_BITS] &= ~mask;
+}
+
+void BinaryMatrix::flip(unsigned r, unsigned c) {
+  row_data(r)[c / WORD_BITS] ^= std::uint64_t{1} << (c % WORD_BITS);
+}
+
+void BinaryMatrix::row_add(unsigned src, unsigned dst) {
+  const std::uint64_t* s = row_data(src);
+  std::uint64_t* d = row_data(dst);
+  for (unsigned w = 0; w < words_per_row_; ++w) d[w] ^= s[w];
+}
+
+bool BinaryMatrix::row_dot(unsigned r0, unsigned r1) const {
+  const std::uint64_t* a = row_data(r0);
+  const std::uint64_t* b = row_data(r1);
+  unsigned count = 0;
+  for (unsigned w = 0; w < words_per_row_; ++w) {
+    count += std::popcount(a[w] & b[w]);
+  }
+  return count % 2;
+}
+
+bool BinaryMatrix::row_parity(unsigned r) const {
+  const std::uint64_t* a = row_data(r);
+  unsigned count = 0;
+  for (unsigned w = 0; w < words_per_row_; ++w) count += std::popcount(a[w]);
+  return count % 2;
+}
+
+std::uint64_t BinaryMatrix::row_chunk(
+    unsigned r, unsigned c0, unsigned c1) const {
+  TKET_ASSERT(c0 <= c1 && c1 <= cols_ && c1 - c0 <= WORD_BITS);
+  unsigned len = c1 - c0;
+  if (len == 0) return 0;
+  const std::uint64_t* a = row_data(r);
+  unsigned w = c0 / WORD_BITS;
+  unsigned offset = c0 % WORD_BITS;
+  std::uint64_t bits = a[w] >> offset;
+  if (offset != 0 && offset + len > WORD_BITS)
+    bits |= a[w + 1] << (WORD_BITS - offset);
+  if (len < WORD_BITS) bits &= (std::uint64_t{1} << len) - 1;
+  return bits;
+}
+
+std::optional<unsigned> BinaryMatrix::first_in_row(
+    unsigned r, unsigned c0, unsigned c1) const {
+  const std::uint64_t* a = row_data(r);
+  for (unsigned c = c0; c < c1;) {
+    unsigned w = c / WORD_BITS;
+    std::uint64_t bits = a[w] >> (c % WORD_BITS);
+    if (bits != 0) {
+      unsigned found = c + std::countr_zero(bits);
+      if (found < c1) return found;
+      return std::nullopt;
+    }
+    c = (w + 1) * WORD_BITS;
+  }
+  return std::nullopt;
+}
+
+BinaryMatrix BinaryMatrix::transpose() const {
+  BinaryMatrix t(cols_, rows_);
+  for (unsigned r = 0; r < rows_; ++r) {
+    for (unsigned c = 0; c < cols_; ++c) {
+      if (get(r, c)) t.set(c, r);
+    }
+  }
+  return t;
+}
+
+bool BinaryMatrix::operator==(const BinaryMatrix& other) const {
+  return rows_ == other.rows_ && cols_ == other.cols_ && data_ == other.data_;
+}
+
+std::vector<std::pair<unsigned, unsigned>>
+BinaryMatrix::gaussian_elimination_row_ops(
+    std::optional<unsigned> n_pivot_cols, unsigned blocksize) {
+  TKET_ASSERT(0 < blocksize && blocksize <= WORD_BITS);
+  std::vector<std::pair<unsigned, unsigned>> ops;
+  unsigned cols = n_pivot_cols ? *n_pivot_cols : cols_;
+  TKET_ASSERT(cols <= cols_);
+  std::vector<unsigned> pcols;  // we know which columns have non-zero entries
+                                // (to save actually transposing the matrix)
+  unsigned pivot_row = 0;
+  unsigned ceiling =
+      (cols + blocksize - 1) / blocksize;  // ceil(cols/blocksize)
+
+  // Get to upper echelon form
+  for (unsigned sec = 0; sec < ceiling; ++sec) {
+    // determine column range for this section
+    // if it hits cols don't go any higher
+    unsigned i0 = sec * blocksize;
+    unsigned i1 = std::min(cols, (sec + 1) * blocksize);
+
+    /* first, try to eliminate sub-rows (ie chunks), for greater speed than
+     * naively doing gaussian elim. */
+    std::unordered_map<std::uint64_t, unsigned> chunks;
+    for (unsigned r = pivot_row; r < rows_; ++r) {
+      std::uint64_t t = row_chunk(r, i0, i1);
+      if (t == 0) continue;
+      /* if first copy of pattern, save. If duplicate then remove by adding
+       * rows*/
+      auto chunk_it = chunks.find(t);
+      if (chunk_it != chunks.end()) {
+        row_add(chunk_it->second, r);
+        ops.push_back({chunk_it->second, r});
+      } else {
+        chunks.insert({t, r});
+      }
+    }
+    /* do gaussian elim. on remaining entries */
+    for (unsigned col = i0; col < i1; ++col) {
+      // find first 1 element in column after pivot_row
+      unsigned first_1 = pivot_row;
+      while (first_1 < rows_ && !get(first_1, col)) {
+        ++first_1;
+      }
+      if (first_1 == rows_) continue;
+
+      // pull back to pivot
+      if (first_1 != pivot_row) {
+        row_add(first_1, pivot_row);
+        ops.push_back({first_1, pivot_row});
+      }
+
+      // clear all entries below pivot
+      for (unsigned r = std::max(pivot_row + 1, first_1); r < rows_; ++r) {
+        if (get(r, col)) {
+          row_add(pivot_row, r);
+          ops.push_back({pivot_row, r});
+        }
+      }
+
+      // record that we pivoted for this column
+      pcols.push_back(col);
+      ++pivot_row;
+    }
+  }
+
+  /* matrix is now in upper triangular form; matrix is reduced to diagonal */
+
+  --pivot_row;
+
+  for (unsigned sec = ceiling; sec-- > 0;) {
+    unsigned i0 = sec * blocksize;
+    unsigned i1 = std::min(cols, (sec + 1) * blocksize);
+
+    std::unordered_map<std::uint64_t, unsigned> chunks;
+    for (unsigned r = pivot_row + 1; r-- > 0;) {
+      std::uint64_t t = row_chunk(r, i0, i1);
+      if (t == 0) continue;
+
+      auto chunk_it = chunks.find(t);
+      if (chunk_it != chunks.end()) {
+        row_add(chunk_it->second, r);
+        ops.push_back({chunk_it->second, r});
+      } else {
+        chunks.insert({t, r});
+      }
+    }
+    while (!pcols.empty() && i0 <= pcols.back() && pcols.back() < i1) {
+      unsigned pcol = pcols.back();
+      pcols.pop_back();
+      for (unsigned r = 0; r < pivot_row; ++r) {
+        if (get(r, pcol)) {
+          row_add(pivot_row, r);
+          ops.push_back({pivot_row, r});
+        }
+      }
+      --pivot_row;
+    }
+  }
+
+  return ops;
+}
+
+std::uint64_t* BinaryMatrix::row_data(unsigned r) {
+  return data_.data() + r * words_per_row_;
+}
+
+const std::uint64_t* BinaryMatrix::row_data(unsigned r) const {
+  return data_.data() + r * words_per_row_;
+}
+
+}  // namespace tket
@@ -74,7 +74,7 @@ csd_t CS_decomp(const Eigen::MatrixXcd &u) {
   // message and do the adjustment ourselves if that behaviour does change.
 
   if (!S.imag().isZero()) {
-    tket_log()->info(
+    TKET_LOG_INFO(
         "Eigen surprisingly returned a non-real diagonal R in QR "
         "decomposition; adjusting Q and R to make it real.");
     for (unsigned j = 0; j < n; j++) {
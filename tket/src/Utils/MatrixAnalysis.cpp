@@ -20,10 +20,10 @@
 #include <map>
 #include <optional>
 #include <sstream>
-#include <tkassert/Assert.hpp>
 #include <utility>
 #include <vector>
 
+#include "Utils/BinaryMatrix.hpp"
 #include "Utils/EigenConfig.hpp"
 
 namespace tket {
@@ -48,25 +48,21 @@ std::pair<MatrixXb, MatrixXb> binary_LLT_decomposition(const MatrixXb &a) {
    * Given A, returns the pair <L, D>
    */
   unsigned n = a.rows();
-  MatrixXb lo = MatrixXb::Identity(n, n);
+  BinaryMatrix lo = BinaryMatrix::identity(n);
   for (unsigned j = 0; j < n; j++) {
     for (unsigned i = j + 1; i < n; i++) {
-      bool sum = a(i, j);
-      for (unsigned k = 0; k < j; k++) {
-        sum ^= lo(i, k) && lo(j, k);
-      }
-      lo(i, j) = sum;
+      // Only columns k < j of rows i and j are filled in at this point, apart
+      // from the unit diagonal of row j, so the row product is exactly the sum
+      // over k < j of lo(i, k) && lo(j, k)
+      lo.set(i, j, a(i, j) ^ lo.row_dot(i, j));
     }
   }
   MatrixXb d = MatrixXb::Zero(n, n);
   for (unsigned i = 0; i < n; i++) {
-    bool sum = a(i, i);
-    for (unsigned k = 0; k < n; k++) {
-      sum ^= lo(i, k);
-    }  // diagonal element of LL^T is just parity of row of L
-    d(i, i) = sum;
+    // diagonal element of LL^T is just parity of row of L
+    d(i, i) = a(i, i) ^ lo.row_parity(i);
   }
-  return {lo, d};
+  return {lo.to_MatrixXb(), d};
 }
 
 std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_col_ops(
@@ -74,134 +70,10 @@ std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_col_ops(
   return gaussian_elimination_row_ops(a.transpose(), blocksize);
 }
 
-struct MatrixXbBlockCompare {
-  bool operator()(
-      const MatrixXb::BlockXpr &lhs, const MatrixXb::BlockXpr &rhs) const {
-    TKET_ASSERT(lhs.rows() == rhs.rows());
-    TKET_ASSERT(lhs.cols() == rhs.cols());
-    for (unsigned r = 0; r < lhs.rows(); ++r) {
-      for (unsigned c = 0; c < lhs.cols(); ++c) {
-        if (lhs(r, c) < rhs(r, c)) return true;
-        if (lhs(r, c) > rhs(r, c)) return false;
-      }
-    }
-    return false;
-  }
-};
-
-/* see https://web.eecs.umich.edu/~imarkov/pubs/jour/qic08-cnot.pdf for a full
- * explanation of this technique */
-/* K. Patel, I. Markov, J. Hayes. Optimal Synthesis of Linear Reversible
-        Circuits. QIC 2008 */
 std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_row_ops(
     const MatrixXb &a, unsigned blocksize) {
-  std::vector<std::pair<unsigned, unsigned>> ops;
-  MatrixXb m = a;
-  unsigned rows = m.rows();
-  unsigned cols = m.cols();
-  std::vector<unsigned> pcols;  // we know which columns have non-zero entries
-                                // (to save actually transposing the matrix)
-  unsigned pivot_row = 0;
-  unsigned ceiling =
-      (cols + blocksize - 1) / blocksize;  // ceil(cols/blocksize)
-
-  // Get to upper echelon form
-  for (unsigned sec = 0; sec < ceiling; ++sec) {
-    // determine column range for this section
-    // if it hits cols don't go any higher
-    unsigned i0 = sec * blocksize;
-    unsigned i1 = std::min(cols, (sec + 1) * blocksize);
-
-    /* first, try to eliminate sub-rows (ie chunks), for greater speed than
-     * naively doing gaussian elim. */
-    std::map<MatrixXb::BlockXpr, unsigned, MatrixXbBlockCompare> chunks;
-    for (unsigned r = pivot_row; r < rows; ++r) {
-      MatrixXb::BlockXpr t = m.block(r, i0, 1, i1 - i0);
-      if (t == MatrixXb::Zero(1, i1 - i0)) continue;
-      /* if first copy of pattern, save. If duplicate then remove by adding
-       * rows*/
-      auto chunk_it = chunks.find(t);
-      if (chunk_it != chunks.end()) {
-        for (unsigned k = 0; k < cols; ++k) {
-          m(r, k) ^= m(chunk_it->second, k);
-        }
-        ops.push_back({chunk_it->second, r});
-      } else {
-        chunks.insert({t, r});
-      }
-    }
-    /* do gaussian elim. on remaining entries */
-    for (unsigned col = i0; col < i1; ++col) {
-      // find first 1 element in column after pivot_row
-      unsigned first_1 = pivot_row;
-      while (first_1 < rows && !m(first_1, col)) {
-        ++first_1;
-      }
-      if (first_1 == rows) continue;
-
-      // pull back to pivot
-      if (first_1 != pivot_row) {
-        for (unsigned k = 0; k < cols; ++k) {
-          m(pivot_row, k) ^= m(first_1, k);
-        }
-        ops.push_back({first_1, pivot_row});
-      }
-
-      // clear all entries below pivot
-      for (unsigned r = std::max(pivot_row + 1, first_1); r < rows; ++r) {
-        if (m(r, col)) {
-          for (unsigned k = 0; k < cols; ++k) {
-            m(r, k) ^= m(pivot_row, k);
-          }
-          ops.push_back({pivot_row, r});
-        }
-      }
-
-      // record that we pivoted for this column
-      pcols.push_back(col);
-      ++pivot_row;
-    }
-  }
-
-  /* matrix is now in upper triangular form; matrix is reduced to diagonal */
-
-  --pivot_row;
-
-  for (unsigned sec = ceiling; sec-- > 0;) {
-    unsigned i0 = sec * blocksize;
-    unsigned i1 = std::min(cols, (sec + 1) * blocksize);
-
-    std::map<MatrixXb::BlockXpr, unsigned, MatrixXbBlockCompare> chunks;
-    for (unsigned r = pivot_row + 1; r-- > 0;) {
-      MatrixXb::BlockXpr t = m.block(r, i0, 1, i1 - i0);
-      if (t == MatrixXb::Zero(1, i1 - i0)) continue;
-
-      auto chunk_it = chunks.find(t);
-      if (chunk_it != chunks.end()) {
-        for (unsigned k = 0; k < cols; ++k) {
-          m(r, k) ^= m(chunk_it->second, k);
-        }
-        ops.push_back({chunk_it->second, r});
-      } else {
-        chunks.insert({t, r});
-      }
-    }
-    while (!pcols.empty() && i0 <= pcols.back() && pcols.back() < i1) {
-      unsigned pcol = pcols.back();
-      pcols.pop_back();
-      for (unsigned r = 0; r < pivot_row; ++r) {
-        if (m(r, pcol)) {
-          for (unsigned k = 0; k < cols; ++k) {
-            m(r, k) ^= m(pivot_row, k);
-          }
-          ops.push_back({pivot_row, r});
-        }
-      }
-      --pivot_row;
-    }
-  }
-
-  return ops;
+  BinaryMatrix m(a);
+  return m.gaussian_elimination_row_ops(std::nullopt, blocksize);
 }
 
 static Eigen::PermutationMatrix<Eigen::Dynamic> qubit_permutation(
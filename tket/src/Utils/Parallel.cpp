@@ -0,0 +1,57 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace tket {
+
+void parallel_for(
+    std::size_t n_jobs, const std::function<void(std::size_t)>& job,
+    unsigned max_threads) {
+  std::size_t n_threads = std::thread::hardware_concurrency();
+  if (max_threads != 0) {
+    n_threads = std::min<std::size_t>(n_threads, max_threads);
+  }
+  n_threads = std::min(n_threads, n_jobs);
+  if (n_threads <= 1) {
+    for (std::size_t i = 0; i < n_jobs; ++i) job(i);
+    return;
+  }
+  std::atomic<std::size_t> next{0};
+  std::vector<std::exception_ptr> errors(n_threads);
+  std::vector<std::thread> threads;
+  threads.reserve(n_threads);
+  for (std::size_t t = 0; t < n_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      try {
+        for (std::size_t i = next++; i < n_jobs; i = next++) job(i);
+      } catch (...) {
+        errors[t] = std::current_exception();
+        next = n_jobs;
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (const std::exception_ptr& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+}  // namespace tket
@@ -14,6 +14,9 @@
 
 #include "PauliStrings.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <map>
 #include <sstream>
 #include <stdexcept>
@@ -25,45 +28,11 @@
 #include "Utils/Constants.hpp"
 #include "Utils/EigenConfig.hpp"
 #include "Utils/Json.hpp"
+#include "Utils/MatrixAnalysis.hpp"
+#include "Utils/Parallel.hpp"
 
 namespace tket {
 
-static const CmplxSpMat const_2x2_matrix(
-    Complex tl, Complex tr, Complex bl, Complex br) {
-  CmplxSpMat m(2, 2);
-  if (tl != czero) {
-    m.insert(0, 0) = tl;
-  }
-  if (tr != czero) {
-    m.insert(0, 1) = tr;
-  }
-  if (bl != czero) {
-    m.insert(1, 0) = bl;
-  }
-  if (br != czero) {
-    m.insert(1, 1) = br;
-  }
-  return m;
-}
-
-static const CmplxSpMat &pauli_sparse_mat(Pauli p) {
-  static const CmplxSpMat I_mat = const_2x2_matrix(1, 0, 0, 1);
-  static const CmplxSpMat X_mat = const_2x2_matrix(0, 1, 1, 0);
-  static const CmplxSpMat Y_mat = const_2x2_matrix(0, -i_, i_, 0);
-  static const CmplxSpMat Z_mat = const_2x2_matrix(1, 0, 0, -1);
-  switch (p) {
-    case Pauli::X:
-      return X_mat;
-    case Pauli::Y:
-      return Y_mat;
-    case Pauli::Z:
-      return Z_mat;
-    default:
-      TKET_ASSERT(p == Pauli::I);
-      return I_mat;
-  }
-}
-
 class StateNotPowerTwo : public std::logic_error {
  public:
   StateNotPowerTwo()
@@ -85,27 +54,37 @@ unsigned get_n_qb_from_statevector(const Eigen::VectorXcd &state) {
   return count - 1;
 }
 
-CmplxSpMat QubitPauliString::to_sparse_matrix() const {
-  qubit_vector_t qubits(map.size());
-  unsigned i = 0;
-  for (const std::pair<const Qubit, Pauli> &pair : map) {
-    qubits[i] = pair.first;
-    ++i;
+namespace {
+
+/**
+ * The action of a Pauli string on computational basis states, taking the first
+ * qubit as the most significant bit:
+ * \f$ P|b\rangle = i^{n_y} (-1)^{|b \wedge z|} |b \oplus x\rangle \f$.
+ */
+struct PauliMasks {
+  std::uint64_t x = 0;
+  std::uint64_t z = 0;
+  unsigned n_y = 0;
+
+  Complex phase() const {
+    static const Complex phases[4] = {1., i_, -1., -i_};
+    return phases[n_y % 4];
   }
-  return to_sparse_matrix(qubits);
-}
+  bool sign_flipped(std::uint64_t b) const { return std::popcount(b & z) % 2; }
+};
 
-CmplxSpMat QubitPauliString::to_sparse_matrix(const unsigned n_qubits) const {
+}  // namespace
+
+static qubit_vector_t default_qubits(unsigned n_qubits) {
   qubit_vector_t qubits(n_qubits);
   for (unsigned i = 0; i < n_qubits; ++i) {
     qubits[i] = Qubit(i);
   }
-  return to_sparse_matrix(qubits);
+  return qubits;
 }
 
-CmplxSpMat QubitPauliString::to_sparse_matrix(
-    const qubit_vector_t &qubits) const {
-  std::vector<Pauli> paulis(qubits.size(), Pauli::I);
+static std::map<Qubit, unsigned> qubit_indices(
+    const qubit_vector_t &qubits, const std::string &caller) {
   std::map<Qubit, unsigned> index_map;
   unsigned index = 0;
   for (const Qubit &q : qubits) {
@@ -114,92 +93,240 @@ CmplxSpMat QubitPauliString::to_sparse_matrix(
   }
   if (index_map.size() != qubits.size())
     throw std::logic_error(
-        "Qubit list given to to_sparse_matrix contains repeats");
-  for (const std::pair<const Qubit, Pauli> &pair : map) {
-    std::map<Qubit, unsigned>::iterator found = index_map.find(pair.first);
+        "Qubit list given to " + caller + " contains repeats");
+  return index_map;
+}
+
+static PauliMasks pauli_masks(
+    const QubitPauliString &qps, const std::map<Qubit, unsigned> &index_map,
+    const std::string &caller) {
+  const unsigned n_qubits = index_map.size();
+  PauliMasks masks;
+  for (const std::pair<const Qubit, Pauli> &pair : qps.map) {
+    std::map<Qubit, unsigned>::const_iterator found =
+        index_map.find(pair.first);
     if (found == index_map.end())
       throw std::logic_error(
-          "Qubit list given to to_sparse_matrix doesn't contain " +
+          "Qubit list given to " + caller + " doesn't contain " +
           pair.first.repr());
-    paulis.at(found->second) = pair.second;
+    const std::uint64_t bit = std::uint64_t{1}
+                              << (n_qubits - 1 - found->second);
+    switch (pair.second) {
+      case Pauli::X:
+        masks.x |= bit;
+        break;
+      case Pauli::Y:
+        masks.x |= bit;
+        masks.z |= bit;
+        ++masks.n_y;
+        break;
+      case Pauli::Z:
+        masks.z |= bit;
+        break;
+      default:
+        TKET_ASSERT(pair.second == Pauli::I);
+    }
   }
-  CmplxSpMat result(1, 1);
-  result.insert(0, 0) = 1;
-  for (Pauli p : paulis) {
-    const CmplxSpMat pauli_mat = pauli_sparse_mat(p);
-    result = Eigen::KroneckerProductSparse(result, pauli_mat).eval();
+  return masks;
+}
+
+static void check_state_size(
+    const Eigen::VectorXcd &state, const qubit_vector_t &qubits,
+    const std::string &caller) {
+  if (state.size() != 1ll << qubits.size())
+    throw std::logic_error(
+        "Size of statevector does not match number of qubits passed to " +
+        caller);
+}
+
+/**
+ * Add the non-zero entries of a Pauli string's matrix, scaled by `coeff`.
+ * There is exactly one in each column.
+ */
+static void add_triplets(
+    const PauliMasks &masks, Complex coeff, std::uint64_t dim,
+    std::vector<TripletCd> &triplets) {
+  const Complex scaled = coeff * masks.phase();
+  for (std::uint64_t b = 0; b < dim; ++b) {
+    triplets.emplace_back(
+        b ^ masks.x, b, masks.sign_flipped(b) ? -scaled : scaled);
+  }
+}
+
+/**
+ * \f$ \sum_{b \in [begin, end)} \langle b \oplus x | \psi \rangle^*
+ * (-1)^{|b \wedge z|} \langle b | \psi \rangle \f$, so that the expectation
+ * of the string is its phase times the sum over all basis states.
+ */
+static Complex masked_overlap(
+    const Eigen::VectorXcd &state, const PauliMasks &masks, std::uint64_t begin,
+    std::uint64_t end) {
+  Complex sum = 0.;
+  for (std::uint64_t b = begin; b < end; ++b) {
+    const Complex term = std::conj(state[b ^ masks.x]) * state[b];
+    if (masks.sign_flipped(b)) {
+      sum -= term;
+    } else {
+      sum += term;
+    }
+  }
+  return sum;
+}
+
+CmplxSpMat QubitPauliString::to_sparse_matrix() const {
+  qubit_vector_t qubits(map.size());
+  unsigned i = 0;
+  for (const std::pair<const Qubit, Pauli> &pair : map) {
+    qubits[i] = pair.first;
+    ++i;
   }
+  return to_sparse_matrix(qubits);
+}
+
+CmplxSpMat QubitPauliString::to_sparse_matrix(const unsigned n_qubits) const {
+  return to_sparse_matrix(default_qubits(n_qubits));
+}
+
+CmplxSpMat QubitPauliString::to_sparse_matrix(
+    const qubit_vector_t &qubits) const {
+  const PauliMasks masks = pauli_masks(
+      *this, qubit_indices(qubits, "to_sparse_matrix"), "to_sparse_matrix");
+  const std::uint64_t dim = std::uint64_t{1} << qubits.size();
+  std::vector<TripletCd> triplets;
+  triplets.reserve(dim);
+  add_triplets(masks, 1., dim, triplets);
+  CmplxSpMat result(dim, dim);
+  result.setFromTriplets(triplets.begin(), triplets.end());
   return result;
 }
 
 CmplxSpMat operator_tensor(
     const OperatorSum &total_operator, unsigned n_qubits) {
-  qubit_vector_t qubits(n_qubits);
-  for (unsigned i = 0; i < n_qubits; ++i) {
-    qubits[i] = Qubit(i);
-  }
-  return operator_tensor(total_operator, qubits);
+  return operator_tensor(total_operator, default_qubits(n_qubits));
 }
 
 CmplxSpMat operator_tensor(
     const OperatorSum &total_operator, const qubit_vector_t &qubits) {
-  CmplxSpMat sum = total_operator[0].second *
-                   total_operator[0].first.to_sparse_matrix(qubits);
-  for (unsigned j = 1; j < total_operator.size(); j++) {
-    sum += total_operator[j].second *
-           total_operator[j].first.to_sparse_matrix(qubits);
-  }
+  const std::map<Qubit, unsigned> index_map =
+      qubit_indices(qubits, "operator_tensor");
+  const std::uint64_t dim = std::uint64_t{1} << qubits.size();
+  std::vector<TripletCd> triplets;
+  triplets.reserve(dim * total_operator.size());
+  for (const std::pair<QubitPauliString, Complex> &term : total_operator) {
+    add_triplets(
+        pauli_masks(term.first, index_map, "operator_tensor"), term.second,
+        dim, triplets);
+  }
+  // Entries at the same position are summed
+  CmplxSpMat sum(dim, dim);
+  sum.setFromTriplets(triplets.begin(), triplets.end());
   return sum;
 }
 
 Eigen::VectorXcd QubitPauliString::dot_state(
     const Eigen::VectorXcd &state) const {
   const unsigned n_qubits = get_n_qb_from_statevector(state);
-  return (to_sparse_matrix(n_qubits) * state);
+  return dot_state(state, default_qubits(n_qubits));
 }
 
 Eigen::VectorXcd QubitPauliString::dot_state(
     const Eigen::VectorXcd &state, const qubit_vector_t &qubits) const {
-  if (state.size() != 1 << qubits.size())
-    throw std::logic_error(
-        "Size of statevector does not match number of qubits passed to "
-        "dot_state");
-  return (to_sparse_matrix(qubits) * state);
+  check_state_size(state, qubits, "dot_state");
+  const PauliMasks masks =
+      pauli_masks(*this, qubit_indices(qubits, "dot_state"), "dot_state");
+  const Complex phase = masks.phase();
+  Eigen::VectorXcd result(state.size());
+  for (std::uint64_t b = 0; b < std::uint64_t(state.size()); ++b) {
+    result[b ^ masks.x] = masks.sign_flipped(b) ? -phase * state[b]
+                                                : phase * state[b];
+  }
+  return result;
 }
 
 Complex QubitPauliString::state_expectation(
     const Eigen::VectorXcd &state) const {
-  return state.dot(dot_state(state));
+  const unsigned n_qubits = get_n_qb_from_statevector(state);
+  return state_expectation(state, default_qubits(n_qubits));
 }
 
 Complex QubitPauliString::state_expectation(
     const Eigen::VectorXcd &state, const qubit_vector_t &qubits) const {
-  return state.dot(dot_state(state, qubits));
+  check_state_size(state, qubits, "state_expectation");
+  const PauliMasks masks = pauli_masks(
+      *this, qubit_indices(qubits, "state_expectation"), "state_expectation");
+  return masks.phase() * masked_overlap(state, masks, 0, state.size());
 }
 
-Complex operator_expectation(
+std::vector<Complex> operator_term_expectations(
     const OperatorSum &total_operator, const Eigen::VectorXcd &state) {
-  Complex exp(0, 0);
+  const unsigned n_qubits = get_n_qb_from_statevector(state);
+  return operator_term_expectations(
+      total_operator, state, default_qubits(n_qubits));
+}
 
-  for (unsigned j = 0; j < total_operator.size(); j++) {
-    exp += total_operator[j].second *
-           total_operator[j].first.state_expectation(state);
+std::vector<Complex> operator_term_expectations(
+    const OperatorSum &total_operator, const Eigen::VectorXcd &state,
+    const qubit_vector_t &qubits) {
+  check_state_size(state, qubits, "operator_term_expectations");
+  const std::map<Qubit, unsigned> index_map =
+      qubit_indices(qubits, "operator_term_expectations");
+  std::vector<PauliMasks> masks;
+  masks.reserve(total_operator.size());
+  for (const std::pair<QubitPauliString, Complex> &term : total_operator) {
+    masks.push_back(
+        pauli_masks(term.first, index_map, "operator_term_expectations"));
+  }
+
+  // Each job sums one block of amplitudes for one term, so that large states
+  // are shared between threads even when there are few terms.
+  constexpr std::uint64_t block_size = 1 << 16;
+  const std::uint64_t dim = state.size();
+  const std::uint64_t n_blocks = (dim + block_size - 1) / block_size;
+  std::vector<Complex> partial_sums(masks.size() * n_blocks);
+  parallel_for(
+      partial_sums.size(),
+      [&](std::size_t job) {
+        const std::uint64_t begin = (job % n_blocks) * block_size;
+        partial_sums[job] = masked_overlap(
+            state, masks[job / n_blocks], begin,
+            std::min(begin + block_size, dim));
+      },
+      // Not worth starting threads for less than a block of work in total
+      masks.size() * dim < block_size ? 1 : 0);
+
+  std::vector<Complex> expectations(masks.size());
+  for (unsigned j = 0; j < masks.size(); ++j) {
+    Complex sum = 0.;
+    for (std::uint64_t k = 0; k < n_blocks; ++k) {
+      sum += partial_sums[j * n_blocks + k];
+    }
+    expectations[j] = masks[j].phase() * sum;
   }
+  return expectations;
+}
 
+static Complex weighted_sum(
+    const OperatorSum &total_operator,
+    const std::vector<Complex> &expectations) {
+  Complex exp(0, 0);
+  for (unsigned j = 0; j < total_operator.size(); j++) {
+    exp += total_operator[j].second * expectations[j];
+  }
   return exp;
 }
 
+Complex operator_expectation(
+    const OperatorSum &total_operator, const Eigen::VectorXcd &state) {
+  return weighted_sum(
+      total_operator, operator_term_expectations(total_operator, state));
+}
+
 Complex operator_expectation(
     const OperatorSum &total_operator, const Eigen::VectorXcd &state,
     const qubit_vector_t &qubits) {
-  Complex exp(0, 0);
-
-  for (unsigned j = 0; j < total_operator.size(); j++) {
-    exp += total_operator[j].second *
-           total_operator[j].first.state_expectation(state, qubits);
-  }
-
-  return exp;
+  return weighted_sum(
+      total_operator,
+      operator_term_expectations(total_operator, state, qubits));
 }
 
 QubitPauliString::QubitPauliString(const std::list<Pauli> &_paulis) {
@@ -0,0 +1,100 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Utils/MatrixAnalysis.hpp"
+
+namespace tket {
+
+/**
+ * Dense matrix over GF(2) with each row packed into 64-bit words.
+ *
+ * Row additions, parities and dot products work a word at a time, rather than
+ * a byte per entry as with `MatrixXb`. This is the common kernel for the
+ * Gaussian elimination used in CX-circuit synthesis, tableau synthesis and
+ * flow identification.
+ */
+class BinaryMatrix {
+ public:
+  BinaryMatrix();
+  // Zero matrix of the given size
+  BinaryMatrix(unsigned rows, unsigned cols);
+  explicit BinaryMatrix(const MatrixXb& m);
+
+  static BinaryMatrix identity(unsigned n);
+
+  MatrixXb to_MatrixXb() const;
+
+  unsigned rows() const;
+  unsigned cols() const;
+
+  bool get(unsigned r, unsigned c) const;
+  void set(unsigned r, unsigned c, bool value = true);
+  void flip(unsigned r, unsigned c);
+
+  // Adds row `src` to row `dst`
+  void row_add(unsigned src, unsigned dst);
+  // Parity of the entrywise product of rows `r0` and `r1`
+  bool row_dot(unsigned r0, unsigned r1) const;
+  // Parity of row `r`
+  bool row_parity(unsigned r) const;
+  /**
+   * Entries `[c0, c1)` of row `r` packed into a word, with column `c0` as the
+   * least significant bit. Requires `c1 - c0 <= 64`.
+   */
+  std::uint64_t row_chunk(unsigned r, unsigned c0, unsigned c1) const;
+  // First column in `[c0, c1)` with a 1 in row `r`, if any
+  std::optional<unsigned> first_in_row(
+      unsigned r, unsigned c0, unsigned c1) const;
+
+  BinaryMatrix transpose() const;
+
+  bool operator==(const BinaryMatrix& other) const;
+
+  /**
+   * Reduces the matrix in place to reduced row echelon form and returns the
+   * row operations performed, as (control, target) pairs meaning row
+   * `control` was added to row `target`.
+   *
+   * Pivots are only searched for in the first `n_pivot_cols` columns
+   * (default: all of them); the row operations are still applied to whole
+   * rows, so any further columns are treated as an augmented right-hand side.
+   *
+   * Uses the sectioned elimination of Patel, Markov & Hayes, "Optimal
+   * Synthesis of Linear Reversible Circuits" (QIC 2008): within each section
+   * of `blocksize` columns, duplicate row patterns are cancelled first before
+   * eliminating column by column. Requires `0 < blocksize <= 64`.
+   */
+  std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_row_ops(
+      std::optional<unsigned> n_pivot_cols = std::nullopt,
+      unsigned blocksize = 6);
+
+ private:
+  unsigned rows_;
+  unsigned cols_;
+  unsigned words_per_row_;
+  // Row-major words; padding bits beyond `cols_` in each row are always zero
+  std::vector<std::uint64_t> data_;
+
+  std::uint64_t* row_data(unsigned r);
+  const std::uint64_t* row_data(unsigned r) const;
+};
+
+}  // namespace tket
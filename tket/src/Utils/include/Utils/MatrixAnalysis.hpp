@@ -72,6 +72,7 @@ Eigen::VectorXcd apply_qubit_permutation(
     const Eigen::VectorXcd &v, const qubit_map_t &perm);
 
 std::pair<MatrixXb, MatrixXb> binary_LLT_decomposition(const MatrixXb &a);
+// See `BinaryMatrix::gaussian_elimination_row_ops`
 std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_col_ops(
     const MatrixXb &a, unsigned blocksize = 6);
 std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_row_ops(
@@ -0,0 +1,42 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace tket {
+
+/**
+ * Run `job(i)` for every `i` in `[0, n_jobs)`, sharing the jobs between
+ * threads.
+ *
+ * Jobs are claimed one at a time, so uneven job costs balance out. If a job
+ * throws, no further jobs are started and the first exception is rethrown on
+ * the calling thread once all threads have stopped. With a single thread (or
+ * a single job) everything runs on the calling thread.
+ *
+ * Jobs must only write to state that no other job touches.
+ *
+ * @param n_jobs number of jobs
+ * @param job function to run for each job index
+ * @param max_threads upper bound on the number of threads, or 0 to use the
+ *    hardware concurrency
+ */
+void parallel_for(
+    std::size_t n_jobs, const std::function<void(std::size_t)>& job,
+    unsigned max_threads = 0);
+
+}  // namespace tket
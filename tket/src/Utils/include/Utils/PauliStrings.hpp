@@ -329,6 +329,23 @@ Complex operator_expectation(
 Complex operator_expectation(
     const OperatorSum &total_operator, const Eigen::VectorXcd &state,
     const qubit_vector_t &qubits);
+/**
+ * Calculate the expectation value of each term of an operator with respect to
+ * a state, ignoring the coefficients.
+ *
+ * Each string is applied to the state through bit masks rather than as a
+ * matrix, and the work is shared between threads for large problems.
+ *
+ * @param total_operator Operator specified by sum of pauli strings
+ * @param state state, encoded by a complex vector
+ *
+ * @return Expectation value of each string, in the order of the terms
+ */
+std::vector<Complex> operator_term_expectations(
+    const OperatorSum &total_operator, const Eigen::VectorXcd &state);
+std::vector<Complex> operator_term_expectations(
+    const OperatorSum &total_operator, const Eigen::VectorXcd &state,
+    const qubit_vector_t &qubits);
 
 /**
  * A tensor of Pauli terms
@@ -125,10 +125,9 @@ class UnitID {
       static const std::string id_regex_str = "[a-z][A-Za-z0-9_]*";
       static const std::regex id_regex(id_regex_str);
       if (!name.empty() && !std::regex_match(name, id_regex)) {
-        std::stringstream msg;
-        msg << "UnitID name '" << name << "' does not match '" << id_regex_str
-            << "', as required for QASM conversion.";
-        tket_log()->warn(msg.str());
+        TKET_LOG_WARN(
+            "UnitID name '" + name + "' does not match '" + id_regex_str +
+            "', as required for QASM conversion.");
       }
     }
   };
@@ -14,8 +14,8 @@
 
 #include "ZX/Flow.hpp"
 
+#include "Utils/BinaryMatrix.hpp"
 #include "Utils/GraphHeaders.hpp"
-#include "Utils/MatrixAnalysis.hpp"
 
 namespace tket {
 
@@ -291,7 +291,7 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
   unsigned n_preserve = preserve.size();
   unsigned n_to_solve = to_solve.size();
   unsigned n_ys = ys.size();
-  MatrixXb mat = MatrixXb::Zero(n_preserve + n_ys, n_correctors + n_to_solve);
+  BinaryMatrix mat(n_preserve + n_ys, n_correctors + n_to_solve);
   // Build adjacency matrix
   for (boost::bimap<ZXVert, unsigned>::const_iterator it = correctors.begin(),
                                                       end = correctors.end();
@@ -299,11 +299,11 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
     for (const ZXVert& n : diag.neighbours(it->left)) {
       auto in_past = preserve.left.find(n);
       if (in_past != preserve.left.end()) {
-        mat(in_past->second, it->right) = true;
+        mat.set(in_past->second, it->right);
       } else {
         auto in_ys = ys.left.find(n);
         if (in_ys != ys.left.end()) {
-          mat(n_preserve + in_ys->second, it->right) = true;
+          mat.set(n_preserve + in_ys->second, it->right);
         }
       }
     }
@@ -313,7 +313,7 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
        it != end; ++it) {
     auto found = correctors.left.find(it->left);
     if (found != correctors.left.end())
-      mat(n_preserve + it->right, found->second) = true;
+      mat.set(n_preserve + it->right, found->second);
   }
   // Add rhs
   for (unsigned i = 0; i < n_to_solve; ++i) {
@@ -321,11 +321,11 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
     switch (diag.get_zxtype(v)) {
       case ZXType::XY:
       case ZXType::PX: {
-        mat(preserve.left.at(v), n_correctors + i) = true;
+        mat.set(preserve.left.at(v), n_correctors + i);
         break;
       }
       case ZXType::XZ: {
-        mat(preserve.left.at(v), n_correctors + i) = true;
+        mat.set(preserve.left.at(v), n_correctors + i);
       }
       // fall through
       case ZXType::YZ:
@@ -333,17 +333,17 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
         for (const ZXVert& n : diag.neighbours(v)) {
           auto found = preserve.left.find(n);
           if (found != preserve.left.end())
-            mat(found->second, n_correctors + i) = true;
+            mat.set(found->second, n_correctors + i);
           else {
             found = ys.left.find(n);
             if (found != ys.left.end())
-              mat(n_preserve + found->second, n_correctors + i) = true;
+              mat.set(n_preserve + found->second, n_correctors + i);
           }
         }
         break;
       }
       case ZXType::PY: {
-        mat(n_preserve + ys.left.at(v), n_correctors + i) = true;
+        mat.set(n_preserve + ys.left.at(v), n_correctors + i);
         break;
       }
       default: {
@@ -353,27 +353,16 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
     }
   }
 
-  // Gaussian elimination
-  std::vector<std::pair<unsigned, unsigned>> row_ops =
-      gaussian_elimination_row_ops(
-          mat.block(0, 0, n_preserve + n_ys, n_correctors));
-  for (const std::pair<unsigned, unsigned>& op : row_ops) {
-    for (unsigned j = 0; j < n_correctors + n_to_solve; ++j) {
-      mat(op.second, j) ^= mat(op.first, j);
-    }
-  }
+  // Gaussian elimination, carrying the rhs columns along
+  mat.gaussian_elimination_row_ops(n_correctors);
 
   // Back substitution
   // For each row i, pick a corrector j for which mat(i,j) == true, else
   // determine that row i has zero lhs
   std::map<unsigned, ZXVert> row_corrector;
   for (unsigned i = 0; i < n_preserve + n_ys; ++i) {
-    for (unsigned j = 0; j < n_correctors; ++j) {
-      if (mat(i, j)) {
-        row_corrector.insert({i, correctors.right.at(j)});
-        break;
-      }
-    }
+    std::optional<unsigned> j = mat.first_in_row(i, 0, n_correctors);
+    if (j) row_corrector.insert({i, correctors.right.at(*j)});
   }
   // For each past i, scan down column of rhs and for each mat(j,CI+i) == true,
   // add corrector from row j or try next i if row j has zero lhs
@@ -382,7 +371,7 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
     bool fail = false;
     ZXVertSeqSet c_i;
     for (unsigned j = 0; j < n_preserve + n_ys; ++j) {
-      if (mat(j, n_correctors + i)) {
+      if (mat.get(j, n_correctors + i)) {
         auto found = row_corrector.find(j);
         if (found == row_corrector.end()) {
           fail = true;
@@ -571,7 +560,7 @@ std::set<ZXVertSeqSet> Flow::identify_focussed_sets(const ZXDiagram& diag) {
     }
   }
 
-  MatrixXb mat = MatrixXb::Zero(n_preserve + n_ys, n_correctors);
+  BinaryMatrix mat(n_preserve + n_ys, n_correctors);
 
   // Build adjacency matrix
   for (boost::bimap<ZXVert, unsigned>::const_iterator it = correctors.begin(),
@@ -580,11 +569,11 @@ std::set<ZXVertSeqSet> Flow::identify_focussed_sets(const ZXDiagram& diag) {
     for (const ZXVert& n : diag.neighbours(it->left)) {
       auto in_preserve = preserve.left.find(n);
       if (in_preserve != preserve.left.end()) {
-        mat(in_preserve->second, it->right) = true;
+        mat.set(in_preserve->second, it->right);
       } else {
         auto in_ys = ys.left.find(n);
         if (in_ys != ys.left.end()) {
-          mat(n_preserve + in_ys->second, it->right) = true;
+          mat.set(n_preserve + in_ys->second, it->right);
         }
       }
     }
@@ -594,17 +583,11 @@ std::set<ZXVertSeqSet> Flow::identify_focussed_sets(const ZXDiagram& diag) {
        it != end; ++it) {
     auto found = correctors.left.find(it->left);
     if (found != correctors.left.end())
-      mat(n_preserve + it->right, found->second) = true;
+      mat.set(n_preserve + it->right, found->second);
   }
 
   // Gaussian elimination
-  std::vector<std::pair<unsigned, unsigned>> row_ops =
-      gaussian_elimination_row_ops(mat);
-  for (const std::pair<unsigned, unsigned>& op : row_ops) {
-    for (unsigned j = 0; j < n_correctors; ++j) {
-      mat(op.second, j) ^= mat(op.first, j);
-    }
-  }
+  mat.gaussian_elimination_row_ops();
 
   // Back substitution
   // For each column j, it either a leading column (the first column for which
@@ -619,7 +602,7 @@ std::set<ZXVertSeqSet> Flow::identify_focussed_sets(const ZXDiagram& diag) {
     ZXVertSeqSet fset{it->left};
     bool new_row_corrector = false;
     for (unsigned i = 0; i < n_preserve + n_ys; ++i) {
-      if (mat(i, it->right)) {
+      if (mat.get(i, it->right)) {
         auto inserted = row_corrector.insert({i, it->left});
         if (inserted.second) {
           // New row_corrector, so move to next column
@@ -0,0 +1,298 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ZX/GraphLikeDiagram.hpp"
+
+#include "Utils/GraphHeaders.hpp"
+
+namespace tket {
+
+namespace zx {
+
+static std::vector<unsigned> members(const GraphLikeDiagram::Neighbourhood& s) {
+  std::vector<unsigned> result;
+  result.reserve(s.count());
+  for (std::size_t i = s.find_first(); i != s.npos; i = s.find_next(i)) {
+    result.push_back(i);
+  }
+  return result;
+}
+
+GraphLikeDiagram::GraphLikeDiagram(const ZXDiagram& diag)
+    : scalar_(diag.get_scalar()) {
+  if (!diag.is_graphlike())
+    throw ZXError("GraphLikeDiagram requires a graphlike ZXDiagram");
+  std::map<ZXVert, unsigned> index;
+  BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
+    if (*diag.get_qtype(v) != QuantumType::Quantum)
+      throw ZXError("GraphLikeDiagram does not support Classical vertices");
+    if (diag.get_zxtype(v) != ZXType::ZSpider) continue;
+    index.insert({v, (unsigned)phases_.size()});
+    phases_.push_back(diag.get_vertex_ZXGen<PhasedGen>(v).get_param());
+  }
+  unsigned n = phases_.size();
+  spiders_ = Neighbourhood(n);
+  spiders_.set();
+  boundary_spiders_ = Neighbourhood(n);
+  adj_.assign(n, Neighbourhood(n));
+  BGL_FORALL_EDGES(w, *diag.graph, ZXGraph) {
+    if (diag.get_qtype(w) != QuantumType::Quantum)
+      throw ZXError("GraphLikeDiagram does not support Classical wires");
+    auto s = index.find(diag.source(w));
+    auto t = index.find(diag.target(w));
+    // Boundary wires are handled below
+    if (s == index.end() || t == index.end()) continue;
+    if (s->second == t->second)
+      throw ZXError("GraphLikeDiagram does not support self loops");
+    if (connected(s->second, t->second))
+      throw ZXError("GraphLikeDiagram does not support parallel wires");
+    add_edge(s->second, t->second);
+  }
+  for (const ZXVert& b : diag.get_boundary()) {
+    WireVec bws = diag.adj_wires(b);
+    if (bws.size() != 1)
+      throw ZXError("Boundary vertex does not have a unique wire");
+    auto s = index.find(diag.other_end(bws.front(), b));
+    if (s == index.end())
+      throw ZXError(
+          "GraphLikeDiagram requires every boundary to be adjacent to a "
+          "spider");
+    boundary_.push_back({diag.get_zxtype(b), s->second});
+    boundary_spiders_.set(s->second);
+  }
+}
+
+ZXDiagram GraphLikeDiagram::to_diagram() const {
+  ZXDiagram diag;
+  std::vector<ZXVert> verts(phases_.size());
+  std::vector<unsigned> sps = spiders();
+  for (unsigned v : sps) {
+    verts[v] = diag.add_vertex(ZXType::ZSpider, phases_[v]);
+  }
+  for (unsigned v : sps) {
+    for (unsigned n : neighbours(v)) {
+      if (v < n) diag.add_wire(verts[v], verts[n], ZXWireType::H);
+    }
+  }
+  for (const BoundaryInfo& b : boundary_) {
+    ZXVert bv = diag.add_vertex(b.type);
+    diag.add_boundary(bv);
+    if (b.type == ZXType::Output)
+      diag.add_wire(verts[b.spider], bv);
+    else
+      diag.add_wire(bv, verts[b.spider]);
+  }
+  diag.multiply_scalar(scalar_);
+  return diag;
+}
+
+std::vector<unsigned> GraphLikeDiagram::spiders() const {
+  return members(spiders_);
+}
+
+unsigned GraphLikeDiagram::n_spiders() const { return spiders_.count(); }
+
+unsigned GraphLikeDiagram::n_edges() const {
+  unsigned total = 0;
+  for (const Neighbourhood& row : adj_) total += row.count();
+  return total / 2;
+}
+
+const GraphLikeDiagram::Neighbourhood& GraphLikeDiagram::neighbourhood(
+    unsigned v) const {
+  check_spider(v);
+  return adj_[v];
+}
+
+std::vector<unsigned> GraphLikeDiagram::neighbours(unsigned v) const {
+  return members(neighbourhood(v));
+}
+
+unsigned GraphLikeDiagram::degree(unsigned v) const {
+  return neighbourhood(v).count();
+}
+
+bool GraphLikeDiagram::connected(unsigned u, unsigned v) const {
+  check_spider(u);
+  check_spider(v);
+  return adj_[u].test(v);
+}
+
+bool GraphLikeDiagram::is_boundary_spider(unsigned v) const {
+  check_spider(v);
+  return boundary_spiders_.test(v);
+}
+
+const Expr& GraphLikeDiagram::get_phase(unsigned v) const {
+  check_spider(v);
+  return phases_[v];
+}
+
+void GraphLikeDiagram::set_phase(unsigned v, const Expr& phase) {
+  check_spider(v);
+  phases_[v] = phase;
+}
+
+const Expr& GraphLikeDiagram::get_scalar() const { return scalar_; }
+
+unsigned GraphLikeDiagram::add_spider(const Expr& phase) {
+  unsigned v = phases_.size();
+  for (Neighbourhood& row : adj_) row.push_back(false);
+  adj_.push_back(Neighbourhood(v + 1));
+  spiders_.push_back(true);
+  boundary_spiders_.push_back(false);
+  phases_.push_back(phase);
+  return v;
+}
+
+void GraphLikeDiagram::add_edge(unsigned u, unsigned v) {
+  check_spider(u);
+  check_spider(v);
+  if (u == v) throw ZXError("GraphLikeDiagram does not support self loops");
+  adj_[u].set(v);
+  adj_[v].set(u);
+}
+
+void GraphLikeDiagram::remove_edge(unsigned u, unsigned v) {
+  check_spider(u);
+  check_spider(v);
+  adj_[u].reset(v);
+  adj_[v].reset(u);
+}
+
+void GraphLikeDiagram::toggle_edge(unsigned u, unsigned v) {
+  if (connected(u, v))
+    remove_edge(u, v);
+  else
+    add_edge(u, v);
+}
+
+void GraphLikeDiagram::remove_spider(unsigned v) {
+  check_spider(v);
+  if (boundary_spiders_.test(v))
+    throw ZXError("Cannot remove a spider adjacent to a boundary");
+  for (unsigned n : neighbours(v)) adj_[n].reset(v);
+  adj_[v].reset();
+  spiders_.reset(v);
+}
+
+void GraphLikeDiagram::complement_neighbourhood(unsigned v) {
+  check_spider(v);
+  const Neighbourhood ns = adj_[v];
+  for (std::size_t n = ns.find_first(); n != ns.npos; n = ns.find_next(n)) {
+    adj_[n] ^= ns;
+    // `n` is in its own row of the neighbourhood, which is not a loop
+    adj_[n].reset(n);
+  }
+}
+
+void GraphLikeDiagram::complement_pivot(unsigned u, unsigned v) {
+  check_spider(u);
+  check_spider(v);
+  const Neighbourhood& nu = adj_[u];
+  const Neighbourhood& nv = adj_[v];
+  Neighbourhood joint = nu & nv;
+  Neighbourhood excl_u = nu - nv;
+  excl_u.reset(v);
+  Neighbourhood excl_v = nv - nu;
+  excl_v.reset(u);
+  toggle_between(joint, excl_u);
+  toggle_between(joint, excl_v);
+  toggle_between(excl_u, excl_v);
+}
+
+void GraphLikeDiagram::toggle_between(
+    const Neighbourhood& a, const Neighbourhood& b) {
+  for (std::size_t i = a.find_first(); i != a.npos; i = a.find_next(i)) {
+    adj_[i] ^= b;
+  }
+  for (std::size_t i = b.find_first(); i != b.npos; i = b.find_next(i)) {
+    adj_[i] ^= a;
+  }
+}
+
+static bool is_pauli_phase(const Expr& phase) {
+  std::optional<unsigned> pi2_mult = equiv_Clifford(phase);
+  return (pi2_mult && ((*pi2_mult % 2) == 0));
+}
+
+static bool is_proper_clifford_phase(const Expr& phase) {
+  std::optional<unsigned> pi2_mult = equiv_Clifford(phase);
+  return (pi2_mult && ((*pi2_mult % 2) == 1));
+}
+
+bool GraphLikeDiagram::remove_interior_clifford(
+    unsigned v, Neighbourhood& dirty) {
+  if (boundary_spiders_.test(v) || !is_proper_clifford_phase(phases_[v]))
+    return false;
+  complement_neighbourhood(v);
+  for (unsigned n : neighbours(v)) phases_[n] = phases_[n] - phases_[v];
+  dirty |= adj_[v];
+  remove_spider(v);
+  return true;
+}
+
+bool GraphLikeDiagram::remove_interior_pauli(unsigned v, Neighbourhood& dirty) {
+  if (boundary_spiders_.test(v) || !is_pauli_phase(phases_[v])) return false;
+  std::optional<unsigned> u;
+  for (unsigned n : neighbours(v)) {
+    if (!boundary_spiders_.test(n) && is_pauli_phase(phases_[n])) {
+      u = n;
+      break;
+    }
+  }
+  if (!u) return false;
+  const Neighbourhood& nu = adj_[*u];
+  const Neighbourhood& nv = adj_[v];
+  Neighbourhood joint = nu & nv;
+  Neighbourhood excl_u = nu - nv;
+  excl_u.reset(v);
+  Neighbourhood excl_v = nv - nu;
+  excl_v.reset(*u);
+  for (unsigned n : members(joint))
+    phases_[n] = phases_[n] + phases_[v] + phases_[*u] + 1.;
+  for (unsigned n : members(excl_u)) phases_[n] = phases_[n] + phases_[v];
+  for (unsigned n : members(excl_v)) phases_[n] = phases_[n] + phases_[*u];
+  toggle_between(joint, excl_u);
+  toggle_between(joint, excl_v);
+  toggle_between(excl_u, excl_v);
+  dirty |= joint;
+  dirty |= excl_u;
+  dirty |= excl_v;
+  remove_spider(*u);
+  remove_spider(v);
+  dirty.reset(*u);
+  return true;
+}
+
+bool GraphLikeDiagram::simplify() {
+  bool success = false;
+  Neighbourhood dirty = spiders_;
+  for (std::size_t v = dirty.find_first(); v != dirty.npos;
+       v = dirty.find_first()) {
+    dirty.reset(v);
+    if (remove_interior_clifford(v, dirty) || remove_interior_pauli(v, dirty))
+      success = true;
+  }
+  return success;
+}
+
+void GraphLikeDiagram::check_spider(unsigned v) const {
+  if (v >= phases_.size() || !spiders_.test(v))
+    throw ZXError("No spider with index " + std::to_string(v));
+}
+
+}  // namespace zx
+
+}  // namespace tket
@@ -43,68 +43,83 @@ bool Rewrite::red_to_green_fun(ZXDiagram& diag) {
 
 Rewrite Rewrite::red_to_green() { return Rewrite(red_to_green_fun); }
 
+/**
+ * Checks whether the spiders `v` and `u` can be fused along the wire `w`.
+ * A merge candidate is either of the same colour and connected by a normal
+ * edge or of different colour and connected by a Hadamard edge.
+ */
+static bool can_fuse_along(
+    const ZXDiagram& diag, const ZXVert& v, const ZXVert& u, const Wire& w) {
+  ZXType vtype = diag.get_zxtype(v);
+  ZXType utype = diag.get_zxtype(u);
+  bool same_colour = vtype == utype;
+  return is_spider_type(vtype) && is_spider_type(utype) && u != v &&
+         (diag.get_wire_type(w) == ZXWireType::Basic) == same_colour;
+}
+
+/**
+ * Merges the phase and wires of spider `u` into its neighbour `v`.
+ * The new wires on `v` are returned; `u` is left in place (with its old wires)
+ * for the caller to remove.
+ */
+static WireVec fuse_spiders(ZXDiagram& diag, const ZXVert& v, const ZXVert& u) {
+  ZXType vtype = diag.get_zxtype(v);
+  bool same_colour = vtype == diag.get_zxtype(u);
+  const PhasedGen& vspid = diag.get_vertex_ZXGen<PhasedGen>(v);
+  const PhasedGen& uspid = diag.get_vertex_ZXGen<PhasedGen>(u);
+  ZXGen_ptr new_spid = std::make_shared<const PhasedGen>(
+      vtype, vspid.get_param() + uspid.get_param(),
+      (vspid.get_qtype() == QuantumType::Classical ||
+       uspid.get_qtype() == QuantumType::Classical)
+          ? QuantumType::Classical
+          : QuantumType::Quantum);
+  diag.set_vertex_ZXGen_ptr(v, new_spid);
+  WireVec new_wires;
+  for (const Wire& uw : diag.adj_wires(u)) {
+    WireEnd u_end = diag.end_of(uw, u);
+    ZXVert other = diag.other_end(uw, u);
+    WireProperties uwp = diag.get_wire_info(uw);
+    // Wires may need flipping type to match colours
+    if (!same_colour)
+      uwp.type = (uwp.type == ZXWireType::Basic) ? ZXWireType::H
+                                                 : ZXWireType::Basic;
+    /**
+     * Basic edges between `(u, v)` will be ignored (these will be
+     * contracted); H edges will become self loops on `v`
+     **/
+    if (other == v && uwp.type == ZXWireType::Basic) continue;
+    // Self loops on `u` needs to become self loops on `v`
+    if (other == u) other = v;
+    // Connect edge to `v` instead with the same properties.
+    if (u_end == WireEnd::Source)
+      new_wires.push_back(diag.add_wire(v, other, uwp));
+    else
+      new_wires.push_back(diag.add_wire(other, v, uwp));
+  }
+  return new_wires;
+}
+
 bool Rewrite::spider_fusion_fun(ZXDiagram& diag) {
   bool success = false;
   std::set<ZXVert> bin;
   BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
     if (bin.contains(v)) continue;
-    ZXType vtype = diag.get_zxtype(v);
-    if (!is_spider_type(vtype)) continue;
-    /**
-     * Go through neighbours and find candidates for merging.
-     * A merge candidate is either of the same colour and connected by
-     * a normal edge or of different colour and connected by a Hadamard
-     * edge
-     **/
+    if (!is_spider_type(diag.get_zxtype(v))) continue;
+    // Go through neighbours and find candidates for merging.
     WireVec adj_vec = diag.adj_wires(v);
     std::list<Wire> adj_list{adj_vec.begin(), adj_vec.end()};
     while (!adj_list.empty()) {
       Wire w = adj_list.front();
       adj_list.pop_front();
-      ZXWireType wtype = diag.get_wire_type(w);
       ZXVert u = diag.other_end(w, v);
       if (bin.contains(u)) continue;
-      ZXType utype = diag.get_zxtype(u);
-      bool same_colour = vtype == utype;
-      if (!is_spider_type(utype) || u == v ||
-          (wtype == ZXWireType::Basic) != same_colour)
-        continue;
+      if (!can_fuse_along(diag, v, u, w)) continue;
       // The spiders `u` and `v` can be fused together
       // We merge into `v` and remove `u` so that we can efficiently continue to
       // search the neighbours
-      const PhasedGen& vspid = diag.get_vertex_ZXGen<PhasedGen>(v);
-      const PhasedGen& uspid = diag.get_vertex_ZXGen<PhasedGen>(u);
-      ZXGen_ptr new_spid = std::make_shared<const PhasedGen>(
-          vtype, vspid.get_param() + uspid.get_param(),
-          (vspid.get_qtype() == QuantumType::Classical ||
-           uspid.get_qtype() == QuantumType::Classical)
-              ? QuantumType::Classical
-              : QuantumType::Quantum);
-      diag.set_vertex_ZXGen_ptr(v, new_spid);
-      for (const Wire& uw : diag.adj_wires(u)) {
-        WireEnd u_end = diag.end_of(uw, u);
-        ZXVert other = diag.other_end(uw, u);
-        WireProperties uwp = diag.get_wire_info(uw);
-        // Wires may need flipping type to match colours
-        if (!same_colour)
-          uwp.type = (uwp.type == ZXWireType::Basic) ? ZXWireType::H
-                                                     : ZXWireType::Basic;
-        /**
-         * Basic edges between `(u, v)` will be ignored (these will be
-         * contracted); H edges will become self loops on `v`
-         **/
-        if (other == v && uwp.type == ZXWireType::Basic) continue;
-        // Self loops on `u` needs to become self loops on `v`
-        if (other == u) other = v;
-        // Connect edge to `v` instead with the same properties.
-        Wire new_w;
-        if (u_end == WireEnd::Source)
-          new_w = diag.add_wire(v, other, uwp);
-        else
-          new_w = diag.add_wire(other, v, uwp);
-        // Iteratively fuse along new wire if possible
-        adj_list.push_back(new_w);
-      }
+      WireVec new_wires = fuse_spiders(diag, v, u);
+      // Iteratively fuse along new wires if possible
+      adj_list.insert(adj_list.end(), new_wires.begin(), new_wires.end());
       // Remove `u`
       bin.insert(u);
       success = true;
@@ -116,85 +131,142 @@ bool Rewrite::spider_fusion_fun(ZXDiagram& diag) {
   return success;
 }
 
+bool Rewrite::spider_fusion_at(
+    ZXDiagram& diag, const ZXVert& v, Worklist& worklist) {
+  if (!is_spider_type(diag.get_zxtype(v))) return false;
+  bool success = false;
+  bool fused = true;
+  while (fused) {
+    fused = false;
+    for (const Wire& w : diag.adj_wires(v)) {
+      ZXVert u = diag.other_end(w, v);
+      if (!can_fuse_along(diag, v, u, w)) continue;
+      fuse_spiders(diag, v, u);
+      worklist.remove_vertex(diag, u);
+      fused = true;
+      success = true;
+      break;
+    }
+  }
+  if (success) worklist.mark_neighbourhood_dirty(diag, v);
+  return success;
+}
+
 Rewrite Rewrite::spider_fusion() { return Rewrite(spider_fusion_fun); }
 
+/**
+ * Removes all self loops on the spider `v`, returning true iff any were found.
+ */
+static bool remove_self_loops(ZXDiagram& diag, const ZXVert& v) {
+  ZXType vtype = diag.get_zxtype(v);
+  if (!is_spider_type(vtype)) return false;
+  bool success = false;
+  unsigned n_pis = 0;
+  QuantumType vqtype = *diag.get_qtype(v);
+  for (const Wire& w : diag.adj_wires(v)) {
+    if (diag.other_end(w, v) != v) continue;
+    // Found a self-loop
+    ZXWireType wtype = diag.get_wire_type(w);
+    QuantumType wqtype = diag.get_qtype(w);
+    /**
+     * Consider each case of quantumness:
+     * - vqtype is Quantum
+     *  + wqtype must be Quantum so Hadamards add phase
+     * - vqtype is Classical
+     *  + wqtype is Classical so each loop is 1 Hadamard
+     *  + wqtype is Quantum so each loop is 2 Hadamards, cancelling out
+     **/
+    if ((vqtype == QuantumType::Quantum || wqtype == QuantumType::Classical) &&
+        wtype == ZXWireType::H)
+      ++n_pis;
+    diag.remove_wire(w);
+    success = true;
+  }
+  if ((n_pis % 2) == 1) {
+    const PhasedGen& spid = diag.get_vertex_ZXGen<PhasedGen>(v);
+    ZXGen_ptr new_spid = std::make_shared<const PhasedGen>(
+        vtype, spid.get_param() + 1., vqtype);
+    diag.set_vertex_ZXGen_ptr(v, new_spid);
+  }
+  return success;
+}
+
 bool Rewrite::self_loop_removal_fun(ZXDiagram& diag) {
   bool success = false;
   BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
-    ZXType vtype = diag.get_zxtype(v);
-    if (!is_spider_type(vtype)) continue;
-    unsigned n_pis = 0;
-    QuantumType vqtype = *diag.get_qtype(v);
-    for (const Wire& w : diag.adj_wires(v)) {
-      if (diag.other_end(w, v) != v) continue;
-      // Found a self-loop
-      ZXWireType wtype = diag.get_wire_type(w);
-      QuantumType wqtype = diag.get_qtype(w);
-      /**
-       * Consider each case of quantumness:
-       * - vqtype is Quantum
-       *  + wqtype must be Quantum so Hadamards add phase
-       * - vqtype is Classical
-       *  + wqtype is Classical so each loop is 1 Hadamard
-       *  + wqtype is Quantum so each loop is 2 Hadamards, cancelling out
-       **/
-      if ((vqtype == QuantumType::Quantum ||
-           wqtype == QuantumType::Classical) &&
-          wtype == ZXWireType::H)
-        ++n_pis;
+    success = remove_self_loops(diag, v) || success;
+  }
+  return success;
+}
+
+bool Rewrite::self_loop_removal_at(
+    ZXDiagram& diag, const ZXVert& v, Worklist& worklist) {
+  if (!remove_self_loops(diag, v)) return false;
+  // Only the phase of `v` may have changed
+  worklist.mark_dirty(v);
+  return true;
+}
+
+Rewrite Rewrite::self_loop_removal() { return Rewrite(self_loop_removal_fun); }
+
+/**
+ * Removes pairs of (effectively) Hadamard wires between the spider `v` and its
+ * neighbours, returning true iff any were found.
+ */
+static bool remove_parallel_h_wires(ZXDiagram& diag, const ZXVert& v) {
+  ZXType vtype = diag.get_zxtype(v);
+  if (!is_spider_type(vtype)) return false;
+  bool success = false;
+  QuantumType vqtype = *diag.get_qtype(v);
+  std::map<ZXVert, Wire> h_wires;
+  for (const Wire& w : diag.adj_wires(v)) {
+    ZXWireType wtype = diag.get_wire_type(w);
+    ZXVert u = diag.other_end(w, v);
+    ZXType utype = diag.get_zxtype(u);
+    if (!is_spider_type(utype)) continue;
+    if ((wtype == ZXWireType::H) != (utype == vtype)) continue;
+    // This is (effectively) a Hadamard edge
+    QuantumType uqtype = *diag.get_qtype(u);
+    QuantumType wqtype = diag.get_qtype(w);
+    if (vqtype == QuantumType::Classical && uqtype == QuantumType::Classical &&
+        wqtype == QuantumType::Quantum) {
+      // Doubled wire forms a pair
       diag.remove_wire(w);
       success = true;
+      continue;
     }
-    if ((n_pis % 2) == 1) {
-      const PhasedGen& spid = diag.get_vertex_ZXGen<PhasedGen>(v);
-      ZXGen_ptr new_spid = std::make_shared<const PhasedGen>(
-          vtype, spid.get_param() + 1., vqtype);
-      diag.set_vertex_ZXGen_ptr(v, new_spid);
+    // Look for another wire to pair it with
+    auto added = h_wires.insert({u, w});
+    if (!added.second) {
+      // Already found the other of the pair, so remove both
+      Wire other_w = added.first->second;
+      h_wires.erase(added.first);
+      diag.remove_wire(w);
+      diag.remove_wire(other_w);
+      success = true;
     }
   }
   return success;
 }
 
-Rewrite Rewrite::self_loop_removal() { return Rewrite(self_loop_removal_fun); }
-
 bool Rewrite::parallel_h_removal_fun(ZXDiagram& diag) {
   bool success = false;
   BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
-    ZXType vtype = diag.get_zxtype(v);
-    if (!is_spider_type(vtype)) continue;
-    QuantumType vqtype = *diag.get_qtype(v);
-    std::map<ZXVert, Wire> h_wires;
-    for (const Wire& w : diag.adj_wires(v)) {
-      ZXWireType wtype = diag.get_wire_type(w);
-      ZXVert u = diag.other_end(w, v);
-      ZXType utype = diag.get_zxtype(u);
-      if (!is_spider_type(utype)) continue;
-      if ((wtype == ZXWireType::H) != (utype == vtype)) continue;
-      // This is (effectively) a Hadamard edge
-      QuantumType uqtype = *diag.get_qtype(u);
-      QuantumType wqtype = diag.get_qtype(w);
-      if (vqtype == QuantumType::Classical &&
-          uqtype == QuantumType::Classical && wqtype == QuantumType::Quantum) {
-        // Doubled wire forms a pair
-        diag.remove_wire(w);
-        success = true;
-        continue;
-      }
-      // Look for another wire to pair it with
-      auto added = h_wires.insert({u, w});
-      if (!added.second) {
-        // Already found the other of the pair, so remove both
-        Wire other_w = added.first->second;
-        h_wires.erase(added.first);
-        diag.remove_wire(w);
-        diag.remove_wire(other_w);
-        success = true;
-      }
-    }
+    success = remove_parallel_h_wires(diag, v) || success;
   }
   return success;
 }
 
+bool Rewrite::parallel_h_removal_at(
+    ZXDiagram& diag, const ZXVert& v, Worklist& worklist) {
+  // Neighbours losing wires to `v` must be revisited, so collect them first
+  ZXVertVec neighbours = diag.neighbours(v);
+  if (!remove_parallel_h_wires(diag, v)) return false;
+  worklist.mark_dirty(v);
+  for (const ZXVert& n : neighbours) worklist.mark_dirty(n);
+  return true;
+}
+
 Rewrite Rewrite::parallel_h_removal() {
   return Rewrite(parallel_h_removal_fun);
 }
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "Utils/GraphHeaders.hpp"
 #include "ZX/Rewrite.hpp"
 
 namespace tket {
@@ -71,6 +72,56 @@ Rewrite Rewrite::repeat_while(const Rewrite &cond, const Rewrite &body) {
   });
 }
 
+Rewrite Rewrite::repeat_local(const std::vector<LocalRewriteFun> &rules) {
+  return Rewrite([=](ZXDiagram &diag) {
+    Worklist worklist(rules.size());
+    BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) { worklist.mark_dirty(v); }
+    bool success = false;
+    unsigned r = 0;
+    while (r < rules.size()) {
+      std::optional<ZXVert> v = worklist.next(r);
+      if (!v) {
+        ++r;
+        continue;
+      }
+      if (rules[r](diag, *v, worklist)) {
+        success = true;
+        r = 0;
+      }
+    }
+    return success;
+  });
+}
+
+Rewrite::Worklist::Worklist(unsigned n_rules) : queues_(n_rules) {}
+
+void Rewrite::Worklist::mark_dirty(const ZXVert &v) {
+  for (ZXVertSeqSet &queue : queues_) queue.insert(v);
+}
+
+void Rewrite::Worklist::mark_neighbourhood_dirty(
+    const ZXDiagram &diag, const ZXVert &v) {
+  mark_dirty(v);
+  for (const ZXVert &n : diag.neighbours(v)) mark_dirty(n);
+}
+
+void Rewrite::Worklist::remove_vertex(ZXDiagram &diag, const ZXVert &v) {
+  for (const ZXVert &n : diag.neighbours(v)) {
+    if (n != v) mark_dirty(n);
+  }
+  for (ZXVertSeqSet &queue : queues_) queue.erase(v);
+  diag.remove_vertex(v);
+}
+
+std::optional<ZXVert> Rewrite::Worklist::next(unsigned rule) {
+  auto &view = queues_.at(rule).get<TagSeq>();
+  if (view.empty()) return std::nullopt;
+  auto it = view.begin();
+  ZXVert v = *it;
+  view.erase(it);
+  return v;
+}
+
 }  // namespace zx
 
 }  // namespace tket
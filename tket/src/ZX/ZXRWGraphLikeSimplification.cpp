@@ -35,6 +35,53 @@ static bool can_complement_neighbourhood(
   return true;
 }
 
+/**
+ * If `v` is an interior proper Clifford spider, performs local complementation
+ * about it and returns its neighbours. `v` is left for the caller to remove.
+ */
+static std::optional<ZXVertVec> complement_interior_clifford(
+    ZXDiagram& diag, const ZXVert& v) {
+  if (!diag.is_proper_clifford_spider(v)) return std::nullopt;
+  const PhasedGen& spid = diag.get_vertex_ZXGen<PhasedGen>(v);
+  QuantumType vqtype = *spid.get_qtype();
+  ZXVertVec neighbours = diag.neighbours(v);
+  if (!can_complement_neighbourhood(diag, vqtype, neighbours))
+    return std::nullopt;
+  // Found an internal proper clifford spider on which we can perform local
+  // complementation
+  /**
+   * Complement the neighbourhoods' edges and modify the phase information
+   * on the neighbours.
+   **/
+  auto xi = neighbours.begin(), x_end = neighbours.end();
+  for (; xi != x_end; ++xi) {
+    for (auto yi = xi + 1; yi != x_end; ++yi) {
+      // Don't add a doubled edge between classicals to preserve graph-like
+      if (!(vqtype == QuantumType::Quantum &&
+            *diag.get_qtype(*xi) == QuantumType::Classical &&
+            *diag.get_qtype(*yi) == QuantumType::Classical)) {
+        std::optional<Wire> wire = diag.wire_between(*xi, *yi);
+        if (wire)
+          diag.remove_wire(*wire);
+        else
+          diag.add_wire(*xi, *yi, ZXWireType::H, vqtype);
+      }
+    }
+    const PhasedGen& xi_op = diag.get_vertex_ZXGen<PhasedGen>(*xi);
+    // If `v` is Quantum, Classical neighbours will pick up both the +theta
+    // and -theta phases, cancelling out
+    if (vqtype == QuantumType::Quantum &&
+        *xi_op.get_qtype() == QuantumType::Classical)
+      continue;
+    // Update phase information
+    ZXGen_ptr xi_new_op = std::make_shared<const PhasedGen>(
+        ZXType::ZSpider, xi_op.get_param() - spid.get_param(),
+        *xi_op.get_qtype());
+    diag.set_vertex_ZXGen_ptr(*xi, xi_new_op);
+  }
+  return neighbours;
+}
+
 bool Rewrite::remove_interior_cliffords_fun(ZXDiagram& diag) {
   if (!diag.is_graphlike()) return false;
   bool success = false;
@@ -45,51 +92,24 @@ bool Rewrite::remove_interior_cliffords_fun(ZXDiagram& diag) {
     auto it = view.begin();
     ZXVert v = *it;
     view.erase(it);
-    if (!diag.is_proper_clifford_spider(v)) continue;
-    const PhasedGen& spid = diag.get_vertex_ZXGen<PhasedGen>(v);
-    QuantumType vqtype = *spid.get_qtype();
-    ZXVertVec neighbours = diag.neighbours(v);
-    if (!can_complement_neighbourhood(diag, vqtype, neighbours)) continue;
-    // Found an internal proper clifford spider on which we can perform local
-    // complementation
-    /**
-     * Complement the neighbourhoods' edges and modify the phase information
-     * on the neighbours.
-     **/
-    auto xi = neighbours.begin(), x_end = neighbours.end();
-    for (; xi != x_end; ++xi) {
-      for (auto yi = xi + 1; yi != x_end; ++yi) {
-        // Don't add a doubled edge between classicals to preserve graph-like
-        if (!(vqtype == QuantumType::Quantum &&
-              *diag.get_qtype(*xi) == QuantumType::Classical &&
-              *diag.get_qtype(*yi) == QuantumType::Classical)) {
-          std::optional<Wire> wire = diag.wire_between(*xi, *yi);
-          if (wire)
-            diag.remove_wire(*wire);
-          else
-            diag.add_wire(*xi, *yi, ZXWireType::H, vqtype);
-        }
-      }
-      const PhasedGen& xi_op = diag.get_vertex_ZXGen<PhasedGen>(*xi);
-      // If `v` is Quantum, Classical neighbours will pick up both the +theta
-      // and -theta phases, cancelling out
-      if (vqtype == QuantumType::Quantum &&
-          *xi_op.get_qtype() == QuantumType::Classical)
-        continue;
-      // Update phase information
-      ZXGen_ptr xi_new_op = std::make_shared<const PhasedGen>(
-          ZXType::ZSpider, xi_op.get_param() - spid.get_param(),
-          *xi_op.get_qtype());
-      diag.set_vertex_ZXGen_ptr(*xi, xi_new_op);
-      candidates.insert(
-          *xi);  // Changing the phase could introduce a new proper Clifford
-    }
+    std::optional<ZXVertVec> neighbours = complement_interior_clifford(diag, v);
+    if (!neighbours) continue;
+    // Changing the phases could introduce new proper Cliffords
+    for (const ZXVert& n : *neighbours) candidates.insert(n);
     diag.remove_vertex(v);
     success = true;
   }
   return success;
 }
 
+bool Rewrite::remove_interior_clifford_at(
+    ZXDiagram& diag, const ZXVert& v, Worklist& worklist) {
+  if (!complement_interior_clifford(diag, v)) return false;
+  // Marks all former neighbours as dirty
+  worklist.remove_vertex(diag, v);
+  return true;
+}
+
 Rewrite Rewrite::remove_interior_cliffords() {
   return Rewrite(remove_interior_cliffords_fun);
 }
@@ -123,6 +143,65 @@ static void bipartite_complementation(
   }
 }
 
+/**
+ * If `v` is an interior Pauli spider with an interior Pauli neighbour `u`,
+ * pivots about the edge between them and returns `u`.
+ * Both `u` and `v` are left for the caller to remove; every vertex whose phase
+ * or edges were changed is still adjacent to one of them.
+ */
+static std::optional<ZXVert> pivot_interior_paulis(
+    ZXDiagram& diag, const ZXVert& v) {
+  // Check `v` is an interior Pauli
+  if (!diag.is_pauli_spider(v)) return std::nullopt;
+  ZXVertVec v_ns = diag.neighbours(v);
+  QuantumType vqtype = *diag.get_qtype(v);
+  if (!can_complement_neighbourhood(diag, vqtype, v_ns)) return std::nullopt;
+  // Look for an interior Pauli neighbour
+  bool pair_found = false;
+  ZXVert u;
+  ZXVertVec u_ns;
+  for (const ZXVert& n : v_ns) {
+    if (!diag.is_pauli_spider(n)) continue;
+    ZXVertVec n_ns = diag.neighbours(n);
+    QuantumType nqtype = *diag.get_qtype(n);
+    if (can_complement_neighbourhood(diag, nqtype, n_ns)) {
+      pair_found = true;
+      u = n;
+      u_ns = n_ns;
+      break;
+    }
+  }
+  if (!pair_found) return std::nullopt;
+  // Found a valid pair
+  // Identify the three sets from the neighbourhoods of `u` and `v`
+  ZXVertSeqSet excl_v{v_ns.begin(), v_ns.end()};
+  excl_v.erase(u);
+  ZXVertSeqSet excl_u, joint;
+  auto& lookup_v = excl_v.get<TagKey>();
+  for (const ZXVert& nu : u_ns) {
+    if (lookup_v.find(nu) != lookup_v.end())
+      joint.insert(nu);
+    else
+      excl_u.insert(nu);
+  }
+  excl_u.erase(v);
+  excl_v.erase(joint.begin(), joint.end());
+  const PhasedGen& v_spid = diag.get_vertex_ZXGen<PhasedGen>(v);
+  const PhasedGen& u_spid = diag.get_vertex_ZXGen<PhasedGen>(u);
+
+  add_phase_to_vertices(
+      diag, joint, v_spid.get_param() + u_spid.get_param() + 1.);
+  add_phase_to_vertices(diag, excl_u, v_spid.get_param());
+  add_phase_to_vertices(diag, excl_v, u_spid.get_param());
+
+  // Because `can_complement_neighbourhood` checks all neighbours,
+  // v and u have the same QuantumType
+  bipartite_complementation(diag, joint, excl_u, vqtype);
+  bipartite_complementation(diag, joint, excl_v, vqtype);
+  bipartite_complementation(diag, excl_u, excl_v, vqtype);
+  return u;
+}
+
 bool Rewrite::remove_interior_paulis_fun(ZXDiagram& diag) {
   if (!diag.is_graphlike()) return false;
   bool success = false;
@@ -134,63 +213,26 @@ bool Rewrite::remove_interior_paulis_fun(ZXDiagram& diag) {
     auto it = view.begin();
     ZXVert v = *it;
     view.erase(it);
-    // Check `v` is an interior Pauli
-    if (!diag.is_pauli_spider(v)) continue;
-    ZXVertVec v_ns = diag.neighbours(v);
-    QuantumType vqtype = *diag.get_qtype(v);
-    if (!can_complement_neighbourhood(diag, vqtype, v_ns)) continue;
-    // Look for an interior Pauli neighbour
-    bool pair_found = false;
-    ZXVert u;
-    ZXVertVec u_ns;
-    for (const ZXVert& n : v_ns) {
-      if (!diag.is_pauli_spider(n)) continue;
-      ZXVertVec n_ns = diag.neighbours(n);
-      QuantumType nqtype = *diag.get_qtype(n);
-      if (can_complement_neighbourhood(diag, nqtype, n_ns)) {
-        pair_found = true;
-        u = n;
-        u_ns = n_ns;
-        break;
-      }
-    }
-    if (!pair_found) continue;
-    // Found a valid pair
-    // Identify the three sets from the neighbourhoods of `u` and `v`
-    ZXVertSeqSet excl_v{v_ns.begin(), v_ns.end()};
-    excl_v.erase(u);
-    ZXVertSeqSet excl_u, joint;
-    auto& lookup_v = excl_v.get<TagKey>();
-    for (const ZXVert& nu : u_ns) {
-      if (lookup_v.find(nu) != lookup_v.end())
-        joint.insert(nu);
-      else
-        excl_u.insert(nu);
-    }
-    excl_u.erase(v);
-    excl_v.erase(joint.begin(), joint.end());
-    const PhasedGen& v_spid = diag.get_vertex_ZXGen<PhasedGen>(v);
-    const PhasedGen& u_spid = diag.get_vertex_ZXGen<PhasedGen>(u);
-
-    add_phase_to_vertices(
-        diag, joint, v_spid.get_param() + u_spid.get_param() + 1.);
-    add_phase_to_vertices(diag, excl_u, v_spid.get_param());
-    add_phase_to_vertices(diag, excl_v, u_spid.get_param());
-
-    // Because `can_complement_neighbourhood` checks all neighbours,
-    // v and u have the same QuantumType
-    bipartite_complementation(diag, joint, excl_u, vqtype);
-    bipartite_complementation(diag, joint, excl_v, vqtype);
-    bipartite_complementation(diag, excl_u, excl_v, vqtype);
-
-    diag.remove_vertex(u);
+    std::optional<ZXVert> u = pivot_interior_paulis(diag, v);
+    if (!u) continue;
+    diag.remove_vertex(*u);
     diag.remove_vertex(v);
-    candidates.erase(u);
+    candidates.erase(*u);
     success = true;
   }
   return success;
 }
 
+bool Rewrite::remove_interior_pauli_at(
+    ZXDiagram& diag, const ZXVert& v, Worklist& worklist) {
+  std::optional<ZXVert> u = pivot_interior_paulis(diag, v);
+  if (!u) return false;
+  // Marks the joint neighbourhood of the pivot as dirty
+  worklist.remove_vertex(diag, *u);
+  worklist.remove_vertex(diag, v);
+  return true;
+}
+
 Rewrite Rewrite::remove_interior_paulis() {
   return Rewrite(remove_interior_paulis_fun);
 }
@@ -241,6 +283,15 @@ Rewrite Rewrite::extend_at_boundary_paulis() {
   return Rewrite(extend_at_boundary_paulis_fun);
 }
 
+Rewrite Rewrite::graphlike_reduction() {
+  Rewrite reduction =
+      repeat_local({remove_interior_clifford_at, remove_interior_pauli_at});
+  return Rewrite([=](ZXDiagram& diag) {
+    if (!diag.is_graphlike()) return false;
+    return reduction.apply(diag);
+  });
+}
+
 }  // namespace zx
 
 }  // namespace tket
@@ -0,0 +1,127 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "ZX/ZXDiagram.hpp"
+
+namespace tket {
+
+namespace zx {
+
+/**
+ * Compact store for quantum graph-like ZX diagrams.
+ *
+ * Spiders are identified by dense indices and each neighbourhood is held as a
+ * bitset over all spider indices. This makes the edge toggling of local
+ * complementation and pivoting a word-level XOR of neighbourhood rows, rather
+ * than O(d^2) individual wire searches and insertions in the `ZXGraph`.
+ *
+ * All spiders are ZSpiders, all edges between spiders are Hadamard edges and
+ * each boundary is connected by a Basic edge to a single spider. Removed
+ * spiders keep their index (so indices remain stable) but are no longer
+ * reported by `spiders()`.
+ */
+class GraphLikeDiagram {
+ public:
+  typedef boost::dynamic_bitset<> Neighbourhood;
+
+  /**
+   * Converts a `ZXDiagram` into compact form.
+   * Throws a `ZXError` if the diagram is not graphlike, contains Classical
+   * vertices or wires, parallel edges or self loops between spiders, or wires
+   * connecting two boundaries directly (see `Rewrite::separate_boundaries`).
+   */
+  explicit GraphLikeDiagram(const ZXDiagram& diag);
+
+  // Converts back to a `ZXDiagram`, preserving the order of the boundary
+  ZXDiagram to_diagram() const;
+
+  // Indices of the spiders currently in the diagram, in increasing order
+  std::vector<unsigned> spiders() const;
+  unsigned n_spiders() const;
+  unsigned n_edges() const;
+
+  const Neighbourhood& neighbourhood(unsigned v) const;
+  std::vector<unsigned> neighbours(unsigned v) const;
+  unsigned degree(unsigned v) const;
+  bool connected(unsigned u, unsigned v) const;
+  // Whether `v` is adjacent to some boundary vertex
+  bool is_boundary_spider(unsigned v) const;
+
+  const Expr& get_phase(unsigned v) const;
+  void set_phase(unsigned v, const Expr& phase);
+
+  const Expr& get_scalar() const;
+
+  // Adds an isolated spider, returning its index
+  unsigned add_spider(const Expr& phase = 0.);
+  void add_edge(unsigned u, unsigned v);
+  void remove_edge(unsigned u, unsigned v);
+  void toggle_edge(unsigned u, unsigned v);
+  // Removes an interior spider along with all of its edges
+  void remove_spider(unsigned v);
+
+  /**
+   * Toggles every edge between distinct neighbours of `v`.
+   * Phases are unchanged.
+   */
+  void complement_neighbourhood(unsigned v);
+
+  /**
+   * Toggles every edge between the three disjoint sets: common neighbours of
+   * `u` and `v`, exclusive neighbours of `u`, and exclusive neighbours of `v`
+   * (`u` and `v` themselves excluded). Phases are unchanged.
+   */
+  void complement_pivot(unsigned u, unsigned v);
+
+  /**
+   * Removes all interior proper Clifford spiders (by local complementation)
+   * and adjacent pairs of interior Pauli spiders (by pivoting) until neither
+   * applies, revisiting only neighbourhoods changed by previous rewrites.
+   * This is the compact equivalent of `Rewrite::graphlike_reduction`.
+   * Returns true iff any change was made.
+   */
+  bool simplify();
+
+ private:
+  struct BoundaryInfo {
+    ZXType type;
+    unsigned spider;
+  };
+
+  // Spiders currently in the diagram
+  Neighbourhood spiders_;
+  // Spiders adjacent to some boundary vertex
+  Neighbourhood boundary_spiders_;
+  // One row per spider index, sized to the number of spider indices
+  std::vector<Neighbourhood> adj_;
+  std::vector<Expr> phases_;
+  // Boundary vertices in the order of the original diagram's boundary
+  std::vector<BoundaryInfo> boundary_;
+  Expr scalar_;
+
+  void check_spider(unsigned v) const;
+  // Toggles every edge between the disjoint sets `a` and `b`
+  void toggle_between(const Neighbourhood& a, const Neighbourhood& b);
+  // Single-vertex rules for `simplify`, adding changed vertices to `dirty`
+  bool remove_interior_clifford(unsigned v, Neighbourhood& dirty);
+  bool remove_interior_pauli(unsigned v, Neighbourhood& dirty);
+};
+
+}  // namespace zx
+
+}  // namespace tket
@@ -40,8 +40,19 @@ namespace zx {
  */
 class Rewrite {
  public:
+  class Worklist;
+
   typedef std::function<bool(ZXDiagram&)> RewriteFun;
   typedef std::function<unsigned(const ZXDiagram&)> Metric;
+  /**
+   * A rule matched and applied about a single vertex.
+   * Returns true iff the rule matched at the given vertex and was applied.
+   * Any vertex whose neighbourhood is changed by the rewrite must be marked as
+   * dirty on the worklist, and removed vertices must be removed via the
+   * worklist so that they are purged from every queue.
+   */
+  typedef std::function<bool(ZXDiagram&, const ZXVert&, Worklist&)>
+      LocalRewriteFun;
 
   /**
    * The actual rewrite to be applied.
@@ -59,6 +70,19 @@ class Rewrite {
   static Rewrite repeat_with_metric(const Rewrite& rw, const Metric& eval);
   static Rewrite repeat_while(const Rewrite& cond, const Rewrite& body);
 
+  /**
+   * Applies a list of local rules until none of them match.
+   * Every vertex starts as a candidate for every rule; afterwards a rule only
+   * revisits vertices marked as dirty by a preceding rewrite. Earlier rules in
+   * the list take priority: after any successful rewrite, the search resumes
+   * from the first rule with a pending candidate.
+   *
+   * This reaches the same kind of fixed point as
+   * `repeat(sequence(...))` over the corresponding exhaustive rewrites, but
+   * avoids rescanning the whole diagram after each pass.
+   */
+  static Rewrite repeat_local(const std::vector<LocalRewriteFun>& rules);
+
   //////////////////
   // Decompositions//
   //////////////////
@@ -161,6 +185,32 @@ class Rewrite {
    */
   static Rewrite extend_at_boundary_paulis();
 
+  /**
+   * Worklist-driven combination of `remove_interior_cliffords` and
+   * `remove_interior_paulis`, applied until neither matches.
+   * Graph-likeness is checked once upfront and preserved by both rules.
+   */
+  static Rewrite graphlike_reduction();
+
+  ////////////////
+  // Local rules//
+  ////////////////
+
+  /**
+   * Single-vertex forms of the rewrites above, for use with `repeat_local`.
+   * The interior Clifford and Pauli rules assume the diagram is graphlike.
+   */
+  static bool spider_fusion_at(
+      ZXDiagram& diag, const ZXVert& v, Worklist& worklist);
+  static bool self_loop_removal_at(
+      ZXDiagram& diag, const ZXVert& v, Worklist& worklist);
+  static bool parallel_h_removal_at(
+      ZXDiagram& diag, const ZXVert& v, Worklist& worklist);
+  static bool remove_interior_clifford_at(
+      ZXDiagram& diag, const ZXVert& v, Worklist& worklist);
+  static bool remove_interior_pauli_at(
+      ZXDiagram& diag, const ZXVert& v, Worklist& worklist);
+
  private:
   Rewrite(const RewriteFun& fun);
 
@@ -179,6 +229,32 @@ class Rewrite {
   static bool extend_at_boundary_paulis_fun(ZXDiagram& diag);
 };
 
+/**
+ * Candidate vertices for a set of local rules.
+ * Each rule has its own queue, so that a vertex rejected by one rule is still
+ * considered by the others. Marking a vertex as dirty adds it to every queue.
+ */
+class Rewrite::Worklist {
+ public:
+  explicit Worklist(unsigned n_rules);
+
+  void mark_dirty(const ZXVert& v);
+  // Marks `v` and all of its neighbours as dirty
+  void mark_neighbourhood_dirty(const ZXDiagram& diag, const ZXVert& v);
+
+  /**
+   * Removes `v` from the diagram, purging it from every queue and marking its
+   * former neighbours as dirty.
+   */
+  void remove_vertex(ZXDiagram& diag, const ZXVert& v);
+
+  // Pops the next candidate for the given rule, if any
+  std::optional<ZXVert> next(unsigned rule);
+
+ private:
+  std::vector<ZXVertSeqSet> queues_;
+};
+
 }  // namespace zx
 
 }  // namespace tket
@@ -20,10 +20,12 @@ namespace tket {
 
 namespace zx {
 
-// Forward declare Rewrite, ZXDiagramPybind, Flow for friend access
+// Forward declare Rewrite, ZXDiagramPybind, Flow, GraphLikeDiagram for friend
+// access
 class Rewrite;
 class ZXDiagramPybind;
 class Flow;
+class GraphLikeDiagram;
 
 class ZXDiagram {
  private:
@@ -321,6 +323,7 @@ class ZXDiagram {
   friend Rewrite;
   friend ZXDiagramPybind;
   friend Flow;
+  friend GraphLikeDiagram;
 
  private:
   /**
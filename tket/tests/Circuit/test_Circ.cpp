@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <boost/graph/graph_traits.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <memory>
@@ -2997,5 +2998,68 @@ SCENARIO("Test replacing wire swaps") {
   REQUIRE(u.isApprox(w, ERR_EPS));
 }
 
+SCENARIO("Recording changes to a circuit") {
+  Circuit circ(2);
+  Vertex h = circ.add_op<unsigned>(OpType::H, {0});
+  Vertex cx = circ.add_op<unsigned>(OpType::CX, {0, 1});
+  Vertex x = circ.add_op<unsigned>(OpType::X, {1});
+  auto contains = [](const VertexVec &vs, const Vertex &v) {
+    return std::find(vs.begin(), vs.end(), v) != vs.end();
+  };
+  GIVEN("No active journal") {
+    REQUIRE_FALSE(circ.change_journal_active());
+    Circuit::JournalCheckpoint cp{0, 0};
+    REQUIRE_FALSE(circ.changed_vertices_since(cp));
+  }
+  GIVEN("Changes made through the circuit") {
+    ChangeJournalScope journal(circ);
+    const Circuit::JournalCheckpoint cp = circ.change_checkpoint();
+    REQUIRE(circ.changed_vertices_since(cp)->empty());
+    circ.set_vertex_Op_ptr(h, get_op_ptr(OpType::Z));
+    Vertex y = circ.add_op<unsigned>(OpType::Y, {0});
+    circ.remove_vertex(
+        x, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::Yes);
+    const VertexVec changed = *circ.changed_vertices_since(cp);
+    // Listed once each, in order of first change.
+    REQUIRE(changed.front() == h);
+    REQUIRE(std::count(changed.begin(), changed.end(), h) == 1);
+    REQUIRE(contains(changed, y));
+    REQUIRE(contains(changed, cx));
+    REQUIRE_FALSE(contains(changed, x));
+    // Only changes after a later checkpoint are reported.
+    const Circuit::JournalCheckpoint cp2 = circ.change_checkpoint();
+    REQUIRE(circ.changed_vertices_since(cp2)->empty());
+    circ.set_vertex_Op_ptr(y, get_op_ptr(OpType::S));
+    REQUIRE(*circ.changed_vertices_since(cp2) == VertexVec{y});
+  }
+  GIVEN("Nested journals") {
+    circ.begin_change_journal();
+    const Circuit::JournalCheckpoint cp = circ.change_checkpoint();
+    circ.begin_change_journal();
+    circ.set_vertex_Op_ptr(h, get_op_ptr(OpType::Z));
+    circ.end_change_journal();
+    REQUIRE(circ.change_journal_active());
+    REQUIRE(*circ.changed_vertices_since(cp) == VertexVec{h});
+    circ.end_change_journal();
+    REQUIRE_FALSE(circ.change_journal_active());
+    REQUIRE_FALSE(circ.changed_vertices_since(cp));
+  }
+  GIVEN("Checkpoints which are no longer meaningful") {
+    ChangeJournalScope journal(circ);
+    const Circuit::JournalCheckpoint cp = circ.change_checkpoint();
+    Circuit other(2);
+    ChangeJournalScope other_journal(other);
+    REQUIRE_FALSE(other.changed_vertices_since(cp));
+    circ = Circuit(2);
+    REQUIRE(circ.change_journal_active());
+    REQUIRE_FALSE(circ.changed_vertices_since(cp));
+  }
+  GIVEN("A copy of a circuit with an active journal") {
+    ChangeJournalScope journal(circ);
+    Circuit copy = circ;
+    REQUIRE_FALSE(copy.change_journal_active());
+  }
+}
+
 }  // namespace test_Circ
 }  // namespace tket
@@ -18,8 +18,10 @@
 
 #include "../Simulation/ComparisonFunctions.hpp"
 #include "Circuit/Boxes.hpp"
+#include "Circuit/CircUtils.hpp"
 #include "Circuit/Circuit.hpp"
 #include "Circuit/Command.hpp"
+#include "Circuit/SynthesisCache.hpp"
 #include "Circuit/ThreeQubitConversion.hpp"
 #include "OpType/OpType.hpp"
 #include "Simulation/CircuitSimulator.hpp"
@@ -277,6 +279,56 @@ SCENARIO("Unitary from circuits") {
     c.add_op<unsigned>(OpType::TK2, {0.4, 0.5, 0.6}, {2, 1});
     check_3q_unitary(c);
   }
+  GIVEN("A region of a larger circuit") {
+    Circuit c(5);
+    c.add_op<unsigned>(OpType::H, {0});
+    c.add_op<unsigned>(OpType::CX, {0, 4});
+    VertexSet verts;
+    verts.insert(c.add_op<unsigned>(OpType::T, {3}));
+    verts.insert(c.add_op<unsigned>(OpType::CZ, {1, 3}));
+    verts.insert(c.add_op<unsigned>(OpType::Ry, 0.3, {2}));
+    verts.insert(c.add_op<unsigned>(OpType::SWAP, {2, 1}));
+    verts.insert(c.add_op<unsigned>(OpType::XXPhase, 0.7, {3, 2}));
+    verts.insert(c.add_op<unsigned>(OpType::CX, {3, 1}));
+    verts.insert(c.add_op<unsigned>(OpType::TK2, {0.1, 0.2, 0.3}, {1, 2}));
+    c.add_phase(0.25);
+    Subcircuit sub;
+    // Wires in a different order from the circuit's qubits
+    for (unsigned q : {3, 1, 2}) {
+      sub.q_in_hole.push_back(c.get_nth_out_edge(c.get_in(Qubit(q)), 0));
+      sub.q_out_hole.push_back(c.get_nth_in_edge(c.get_out(Qubit(q)), 0));
+    }
+    sub.verts = verts;
+    // The region written out on its own, with qubits 3, 1, 2 renumbered
+    // 0, 1, 2, and simulated independently
+    Circuit region(3);
+    region.add_op<unsigned>(OpType::T, {0});
+    region.add_op<unsigned>(OpType::CZ, {1, 0});
+    region.add_op<unsigned>(OpType::Ry, 0.3, {2});
+    region.add_op<unsigned>(OpType::SWAP, {2, 1});
+    region.add_op<unsigned>(OpType::XXPhase, 0.7, {0, 2});
+    region.add_op<unsigned>(OpType::CX, {0, 1});
+    region.add_op<unsigned>(OpType::TK2, {0.1, 0.2, 0.3}, {1, 2});
+    Eigen::MatrixXcd U = tket_sim::get_unitary(region);
+    Matrix8cd U1 = get_matrix_from_3qb_subcircuit(c, sub);
+    CHECK(U.isApprox(U1));
+    // A two-qubit region
+    Circuit c2(3);
+    c2.add_op<unsigned>(OpType::H, {2});
+    Vertex u = c2.add_op<unsigned>(OpType::CZ, {0, 1});
+    Vertex v = c2.add_op<unsigned>(OpType::TK2, {0.1, 0.2, 0.3}, {1, 0});
+    c2.add_op<unsigned>(OpType::CX, {1, 2});
+    Subcircuit sub2;
+    for (unsigned q : {0, 1}) {
+      sub2.q_in_hole.push_back(c2.get_nth_out_edge(c2.get_in(Qubit(q)), 0));
+    }
+    sub2.verts = {u, v};
+    Circuit region2(2);
+    region2.add_op<unsigned>(OpType::CZ, {0, 1});
+    region2.add_op<unsigned>(OpType::TK2, {0.1, 0.2, 0.3}, {1, 0});
+    Eigen::MatrixXcd U2 = tket_sim::get_unitary(region2);
+    CHECK(U2.isApprox(get_matrix_from_2qb_subcircuit(c2, sub2)));
+  }
 }
 
 static bool check_3q_squash(
@@ -517,6 +569,27 @@ SCENARIO("Three-qubit squash") {
   }
 }
 
+SCENARIO("Three-qubit squash with the shared synthesis cache") {
+  GIVEN("A circuit with two identical blocks on different qubits") {
+    SynthesisCache &cache = synthesis_cache();
+    cache.set_capacity(default_synthesis_cache_capacity);
+    cache.clear();
+    Circuit c(6);
+    for (unsigned offset : {0, 3}) {
+      for (unsigned i = 0; i < 22; i++) {
+        c.add_op<unsigned>(OpType::H, {offset + i % 3});
+        c.add_op<unsigned>(OpType::CX, {offset + i % 3, offset + (i + 1) % 3});
+        c.add_op<unsigned>(OpType::Rz, 0.25, {offset + (i + 1) % 3});
+      }
+    }
+    CHECK(check_3q_squash(c));
+    CHECK(cache.get_misses() > 0);
+    CHECK(cache.get_hits() > 0);
+    cache.set_capacity(0);
+    cache.clear();
+  }
+}
+
 SCENARIO("Special cases") {
   GIVEN("A 3-qubit CX circuit with no interaction between qb 0 and qbs 1,2") {
     Circuit c(3);
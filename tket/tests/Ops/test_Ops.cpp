@@ -297,6 +297,58 @@ SCENARIO("Check op retrieval overloads are working correctly.", "[ops]") {
   }
 }
 
+SCENARIO("Common operations are shared", "[ops]") {
+  GIVEN("Parameter-free gates") {
+    REQUIRE(get_op_ptr(OpType::CX) == get_op_ptr(OpType::CX));
+    REQUIRE(get_op_ptr(OpType::H) != get_op_ptr(OpType::S));
+    REQUIRE(get_op_ptr(OpType::Barrier) == get_op_ptr(OpType::Barrier));
+  }
+  GIVEN("Rotations by multiples of a quarter turn") {
+    const Op_ptr rz = get_op_ptr(OpType::Rz, 0.25);
+    REQUIRE(rz == get_op_ptr(OpType::Rz, 0.25));
+    REQUIRE(rz->get_params() == std::vector<Expr>{0.25});
+    REQUIRE(get_op_ptr(OpType::Rz, 0.5) != rz);
+    REQUIRE(get_op_ptr(OpType::Rx, 0.25) != rz);
+  }
+  GIVEN("Rotations by exact multiples of a quarter turn") {
+    const Expr quarter = Expr(1) / 4;
+    const Op_ptr rz = get_op_ptr(OpType::Rz, quarter);
+    REQUIRE(rz == get_op_ptr(OpType::Rz, quarter));
+    REQUIRE(SymEngine::is_a<SymEngine::Rational>(
+        *rz->get_params()[0].get_basic()));
+    // kept apart from the rotation by the double 0.25
+    REQUIRE(rz != get_op_ptr(OpType::Rz, 0.25));
+    const Op_ptr rx = get_op_ptr(OpType::Rx, Expr(3));
+    REQUIRE(rx == get_op_ptr(OpType::Rx, Expr(3)));
+    REQUIRE(SymEngine::is_a<SymEngine::Integer>(
+        *rx->get_params()[0].get_basic()));
+    REQUIRE(
+        get_op_ptr(OpType::Rz, Expr(6) / 4) ==
+        get_op_ptr(OpType::Rz, Expr(3) / 2));
+  }
+  GIVEN("Other operations") {
+    REQUIRE(get_op_ptr(OpType::Rz, 0.3) != get_op_ptr(OpType::Rz, 0.3));
+    REQUIRE(get_op_ptr(OpType::Rz, 4.25) != get_op_ptr(OpType::Rz, 4.25));
+    REQUIRE(get_op_ptr(OpType::Rz, -0.25) != get_op_ptr(OpType::Rz, -0.25));
+    REQUIRE(get_op_ptr(OpType::Rz, Expr(4)) != get_op_ptr(OpType::Rz, Expr(4)));
+    const Expr third = Expr(1) / 3;
+    REQUIRE(get_op_ptr(OpType::Rz, third) != get_op_ptr(OpType::Rz, third));
+    // rounds to 0.25 as a double, but is not exactly 1/4
+    const Expr big = SymEngine::pow(Expr(10), Expr(20));
+    const Expr near_quarter = (big + 1) / (4 * big);
+    REQUIRE(
+        get_op_ptr(OpType::Rz, near_quarter) !=
+        get_op_ptr(OpType::Rz, near_quarter));
+    Sym a = SymEngine::symbol("a");
+    const Op_ptr rz = get_op_ptr(OpType::Rz, Expr(a));
+    REQUIRE(rz != get_op_ptr(OpType::Rz, Expr(a)));
+    REQUIRE(rz->free_symbols() == SymSet{a});
+    const Op_ptr cnx = get_op_ptr(OpType::CnX, std::vector<Expr>{}, 3);
+    REQUIRE(cnx->n_qubits() == 3);
+    clear_symbol_table();
+  }
+}
+
 SCENARIO("Examples for is_singleq_unitary") {
   GIVEN("Some true positives") {
     REQUIRE((get_op_ptr(OpType::Z))->get_desc().is_singleq_unitary());
@@ -14,6 +14,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <random>
+#include <thread>
 
 #include "../testutil.hpp"
 #include "Placement/Placement.hpp"
@@ -309,6 +310,44 @@ SCENARIO("Base GraphPlacement class") {
         {Qubit(0), Node(2)}, {Qubit(1), Node(1)}, {Qubit(2), Node(0)}};
     REQUIRE(placement_map == comparison_map);
   }
+  GIVEN("One GraphPlacement reused for several circuits, concurrently.") {
+    SquareGrid architecture(3, 4);
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<unsigned> qubit_dist(0, 7);
+    std::vector<Circuit> circuits;
+    for (unsigned i = 0; i < 6; i++) {
+      Circuit circuit(8);
+      for (unsigned j = 0; j < 4 + 2 * i; j++) {
+        unsigned q0 = qubit_dist(rng), q1 = qubit_dist(rng);
+        if (q0 != q1) circuit.add_op<unsigned>(OpType::CX, {q0, q1});
+      }
+      circuits.push_back(circuit);
+    }
+    // the cached target graphs must not change any results
+    std::vector<std::vector<std::map<Qubit, Node>>> expected_maps;
+    for (const Circuit& circuit : circuits) {
+      GraphPlacement placement(architecture, 100, 10000);
+      expected_maps.push_back(placement.get_all_placement_maps(circuit, 100));
+    }
+    GraphPlacement placement(architecture, 100, 10000);
+    std::vector<std::vector<std::map<Qubit, Node>>> all_maps(circuits.size());
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < circuits.size(); i++) {
+      threads.emplace_back([&, i]() {
+        all_maps[i] = placement.get_all_placement_maps(circuits[i], 100);
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    REQUIRE(all_maps == expected_maps);
+    // and again, now that every target graph is cached
+    for (unsigned i = 0; i < circuits.size(); i++) {
+      REQUIRE(
+          placement.get_all_placement_maps(circuits[i], 100) ==
+          expected_maps[i]);
+    }
+  }
 }
 
 }  // namespace tket
@@ -408,5 +408,46 @@ SCENARIO("Base NoiseAwarePlacement class") {
     REQUIRE(map[Qubit(4)] == Node(1));
     REQUIRE(map[Qubit(5)] == Node(2));
   }
+  GIVEN(
+      "Two qubit connected circuit, three qubit triangle Architecture, "
+      "a single match, NoiseAwarePlacement::set_local_search.") {
+    std::vector<std::pair<unsigned, unsigned>> edges = {{0, 1}, {1, 2}, {2, 0}};
+    Architecture architecture(edges);
+    Circuit circuit(2);
+    circuit.add_op<unsigned>(OpType::CX, {0, 1});
+    // the single WSM match does not depend on the errors, so it is on the
+    // good edge for at most one of the three choices of good edge; in the
+    // others it is worse, and a single move along the triangle improves it
+    unsigned n_improved = 0;
+    for (unsigned i = 0; i < 3; i++) {
+      const Node good0(i), good1((i + 1) % 3), other((i + 2) % 3);
+      avg_link_errors_t link_errors;
+      link_errors[{good0, good1}] = 0.01;
+      link_errors[{good1, other}] = 0.5;
+      link_errors[{other, good0}] = 0.5;
+      NoiseAwarePlacement placement(architecture, {}, link_errors, {}, 1);
+      REQUIRE(!placement.get_local_search());
+      std::map<Qubit, Node> first = placement.get_placement_map(circuit);
+      REQUIRE(first.size() == 2);
+      placement.set_local_search(true);
+      std::map<Qubit, Node> map = placement.get_placement_map(circuit);
+      REQUIRE(map.size() == 2);
+      REQUIRE(map[Qubit(0)] != other);
+      REQUIRE(map[Qubit(1)] != other);
+      if (first[Qubit(0)] == other || first[Qubit(1)] == other) {
+        n_improved++;
+      }
+    }
+    REQUIRE(n_improved >= 2);
+
+    NoiseAwarePlacement placement(architecture);
+    placement.set_local_search(true);
+    Placement::Ptr placement_ptr =
+        std::make_shared<NoiseAwarePlacement>(placement);
+    nlohmann::json j_placement = placement_ptr;
+    Placement::Ptr loaded = j_placement.get<Placement::Ptr>();
+    REQUIRE(std::dynamic_pointer_cast<NoiseAwarePlacement>(loaded)
+                ->get_local_search());
+  }
 }
 }  // namespace tket
\ No newline at end of file
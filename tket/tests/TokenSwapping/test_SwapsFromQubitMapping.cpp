@@ -17,6 +17,7 @@
 #include <tkrng/RNG.hpp>
 
 #include "Architecture/BestTsaWithArch.hpp"
+#include "Architecture/TsaSolutionCache.hpp"
 
 using std::vector;
 
@@ -117,5 +118,79 @@ SCENARIO("get_swaps : swaps returned directly from architecture") {
   REQUIRE(nodes_copy == node_final_positions);
 }
 
+// Checks that the swaps are on edges, and perform the node mapping.
+static void check_swaps(
+    const Architecture& arch, const BestTsaWithArch::NodeMapping& node_mapping,
+    const std::vector<std::pair<Node, Node>>& node_swaps) {
+  // Key: a node. Value: the target of the token currently on it.
+  std::map<Node, Node> targets;
+  for (const Node& node : arch.get_all_nodes_vec()) {
+    targets[node] = node;
+  }
+  for (const auto& entry : node_mapping) {
+    targets[entry.first] = entry.second;
+  }
+  for (const auto& [node1, node2] : node_swaps) {
+    REQUIRE((arch.edge_exists(node1, node2) || arch.edge_exists(node2, node1)));
+    std::swap(targets[node1], targets[node2]);
+  }
+  for (const auto& entry : node_mapping) {
+    REQUIRE(targets.at(entry.second) == entry.second);
+  }
+}
+
+SCENARIO("get_swaps : several strategies, and cached solutions") {
+  const SquareGrid arch(3, 4, 2);
+  const auto nodes = arch.get_all_nodes_vec();
+  const auto strategies = BestTsaWithArch::get_default_strategies();
+  REQUIRE(strategies.size() > 1);
+  REQUIRE(strategies[0].seed == BestTsaWithArch::Strategy().seed);
+
+  RNG rng;
+  TsaSolutionCache cache(3);
+  std::vector<BestTsaWithArch::NodeMapping> node_mappings;
+  for (unsigned ii = 0; ii < 5; ++ii) {
+    auto nodes_copy = nodes;
+    rng.do_shuffle(nodes_copy);
+    BestTsaWithArch::NodeMapping node_mapping;
+    for (size_t jj = 0; jj < nodes.size(); ++jj) {
+      node_mapping[nodes_copy[jj]] = nodes[jj];
+    }
+    const auto single_swaps = BestTsaWithArch::get_swaps(arch, node_mapping);
+    const auto best_swaps =
+        BestTsaWithArch::get_swaps(arch, node_mapping, strategies, 2);
+    check_swaps(arch, node_mapping, best_swaps);
+    CHECK(best_swaps.size() <= single_swaps.size());
+    // With only the default strategy, nothing changes.
+    CHECK(
+        BestTsaWithArch::get_swaps(arch, node_mapping, {strategies[0]}) ==
+        single_swaps);
+
+    CHECK(cache.get_swaps(arch, node_mapping) == single_swaps);
+    node_mappings.push_back(node_mapping);
+  }
+  CHECK(cache.size() == 3);
+  CHECK(cache.get_hits() == 0);
+
+  // The most recent problems are answered from the cache,
+  // also for an equal but separately constructed architecture.
+  const SquareGrid arch_copy(3, 4, 2);
+  const auto swaps = cache.get_swaps(arch_copy, node_mappings.back());
+  CHECK(cache.get_hits() == 1);
+  check_swaps(arch_copy, node_mappings.back(), swaps);
+  // The oldest was evicted, so is solved again.
+  check_swaps(
+      arch, node_mappings.front(),
+      cache.get_swaps(arch, node_mappings.front()));
+  CHECK(cache.get_hits() == 1);
+  CHECK(cache.size() == 3);
+
+  // Trivial mappings need no swaps, and are not stored.
+  BestTsaWithArch::NodeMapping trivial_mapping;
+  trivial_mapping[nodes[0]] = nodes[0];
+  CHECK(cache.get_swaps(arch, trivial_mapping).empty());
+  CHECK(cache.size() == 3);
+}
+
 }  // namespace tests
 }  // namespace tket
@@ -0,0 +1,136 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+#include "Utils/BinaryMatrix.hpp"
+
+namespace tket {
+namespace test_BinaryMatrix {
+
+static MatrixXb random_matrix(unsigned rows, unsigned cols, unsigned seed) {
+  std::mt19937 rng(seed);
+  MatrixXb m(rows, cols);
+  for (unsigned r = 0; r < rows; ++r) {
+    for (unsigned c = 0; c < cols; ++c) {
+      m(r, c) = rng() % 2;
+    }
+  }
+  return m;
+}
+
+SCENARIO("Word-packed binary matrices") {
+  GIVEN("A matrix spanning several words per row") {
+    MatrixXb m = random_matrix(5, 150, 1);
+    BinaryMatrix b(m);
+    CHECK(b.rows() == 5);
+    CHECK(b.cols() == 150);
+    CHECK(b.to_MatrixXb() == m);
+    CHECK(BinaryMatrix(MatrixXb(m.transpose())) == b.transpose());
+    for (unsigned r = 0; r < 5; ++r) {
+      // Chunks straddling a word boundary
+      std::uint64_t chunk = b.row_chunk(r, 60, 70);
+      for (unsigned c = 60; c < 70; ++c) {
+        CHECK(((chunk >> (c - 60)) & 1) == m(r, c));
+      }
+      std::optional<unsigned> first = b.first_in_row(r, 64, 150);
+      for (unsigned c = 64; c < 150; ++c) {
+        if (m(r, c)) {
+          REQUIRE(first);
+          CHECK(*first == c);
+          break;
+        }
+      }
+    }
+    b.row_add(0, 1);
+    for (unsigned c = 0; c < 150; ++c) {
+      CHECK(b.get(1, c) == (m(0, c) != m(1, c)));
+    }
+    bool dot = false;
+    for (unsigned c = 0; c < 150; ++c) dot ^= m(2, c) && m(3, c);
+    CHECK(b.row_dot(2, 3) == dot);
+  }
+  GIVEN("An invertible matrix") {
+    // Scramble the identity by random row operations
+    unsigned n = 100;
+    std::mt19937 rng(2);
+    BinaryMatrix b = BinaryMatrix::identity(n);
+    for (unsigned i = 0; i < 1000; ++i) {
+      unsigned r0 = rng() % n, r1 = rng() % n;
+      if (r0 != r1) b.row_add(r0, r1);
+    }
+    MatrixXb m = b.to_MatrixXb();
+    std::vector<std::pair<unsigned, unsigned>> ops =
+        b.gaussian_elimination_row_ops();
+    CHECK(b == BinaryMatrix::identity(n));
+    // The free function reports the same operations
+    CHECK(gaussian_elimination_row_ops(m) == ops);
+    // Replaying the operations reduces the original matrix
+    for (const std::pair<unsigned, unsigned>& op : ops) {
+      for (unsigned c = 0; c < n; ++c) m(op.second, c) ^= m(op.first, c);
+    }
+    CHECK(m == MatrixXb::Identity(n, n));
+  }
+  GIVEN("An augmented system") {
+    // Solve a x = y by eliminating on the first n columns only
+    unsigned n = 70;
+    std::mt19937 rng(3);
+    BinaryMatrix a = BinaryMatrix::identity(n);
+    for (unsigned i = 0; i < 500; ++i) {
+      unsigned r0 = rng() % n, r1 = rng() % n;
+      if (r0 != r1) a.row_add(r0, r1);
+    }
+    std::vector<bool> x(n);
+    for (unsigned i = 0; i < n; ++i) x[i] = rng() % 2;
+    BinaryMatrix aug(n, n + 1);
+    for (unsigned r = 0; r < n; ++r) {
+      bool y = false;
+      for (unsigned c = 0; c < n; ++c) {
+        aug.set(r, c, a.get(r, c));
+        y ^= a.get(r, c) && x[c];
+      }
+      aug.set(r, n, y);
+    }
+    aug.gaussian_elimination_row_ops(n);
+    for (unsigned r = 0; r < n; ++r) {
+      CHECK(aug.first_in_row(r, 0, n) == r);
+      CHECK(aug.get(r, n) == x[r]);
+    }
+  }
+  GIVEN("A symmetric matrix") {
+    unsigned n = 80;
+    MatrixXb m = random_matrix(n, n, 4);
+    MatrixXb a = MatrixXb::Zero(n, n);
+    for (unsigned r = 0; r < n; ++r) {
+      for (unsigned c = 0; c <= r; ++c) {
+        a(r, c) = m(r, c);
+        a(c, r) = m(r, c);
+      }
+    }
+    std::pair<MatrixXb, MatrixXb> ld = binary_LLT_decomposition(a);
+    BinaryMatrix lo(ld.first);
+    for (unsigned r = 0; r < n; ++r) {
+      CHECK(lo.get(r, r));
+      for (unsigned c = 0; c < n; ++c) {
+        // (L L^T)(r, c) is the dot product of rows r and c of L
+        CHECK(lo.row_dot(r, c) == (a(r, c) != ld.second(r, c)));
+        if (c > r) CHECK_FALSE(lo.get(r, c));
+      }
+    }
+  }
+}
+
+}  // namespace test_BinaryMatrix
+}  // namespace tket
@@ -0,0 +1,131 @@
+// Copyright 2019-2022 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "ZX/GraphLikeDiagram.hpp"
+#include "ZX/Rewrite.hpp"
+
+namespace tket {
+namespace zx {
+namespace test_ZXGraphLikeDiagram {
+
+SCENARIO("Compact graph-like diagrams") {
+  GIVEN("A graph-like diagram") {
+    /**
+     * Two inputs and outputs, each attached to its own spider, with an
+     * interior proper Clifford and a pair of interior Paulis
+     */
+    ZXDiagram diag(2, 2, 0, 0);
+    ZXVertVec ins = diag.get_boundary(ZXType::Input);
+    ZXVertVec outs = diag.get_boundary(ZXType::Output);
+    ZXVert i0 = diag.add_vertex(ZXType::ZSpider, 0.25);
+    ZXVert i1 = diag.add_vertex(ZXType::ZSpider, 0.75);
+    ZXVert o0 = diag.add_vertex(ZXType::ZSpider);
+    ZXVert o1 = diag.add_vertex(ZXType::ZSpider, 0.3);
+    ZXVert c = diag.add_vertex(ZXType::ZSpider, 0.5);
+    ZXVert p0 = diag.add_vertex(ZXType::ZSpider, 1.);
+    ZXVert p1 = diag.add_vertex(ZXType::ZSpider);
+    diag.add_wire(ins[0], i0);
+    diag.add_wire(ins[1], i1);
+    diag.add_wire(o0, outs[0]);
+    diag.add_wire(o1, outs[1]);
+    diag.add_wire(i0, c, ZXWireType::H);
+    diag.add_wire(i1, c, ZXWireType::H);
+    diag.add_wire(c, p0, ZXWireType::H);
+    diag.add_wire(p0, p1, ZXWireType::H);
+    diag.add_wire(p0, o0, ZXWireType::H);
+    diag.add_wire(p1, o1, ZXWireType::H);
+    diag.add_wire(i0, o1, ZXWireType::H);
+    REQUIRE_NOTHROW(diag.check_validity());
+    REQUIRE(diag.is_graphlike());
+
+    GraphLikeDiagram compact(diag);
+    REQUIRE(compact.n_spiders() == 7);
+    REQUIRE(compact.n_edges() == 7);
+
+    WHEN("Converting back") {
+      ZXDiagram round_trip = compact.to_diagram();
+      REQUIRE_NOTHROW(round_trip.check_validity());
+      CHECK(round_trip.is_graphlike());
+      CHECK(round_trip.count_vertices(ZXType::ZSpider) == 7);
+      CHECK(round_trip.count_vertices(ZXType::Input) == 2);
+      CHECK(round_trip.count_vertices(ZXType::Output) == 2);
+      CHECK(round_trip.count_wires(ZXWireType::H) == 7);
+      CHECK(round_trip.count_wires(ZXWireType::Basic) == 4);
+    }
+    WHEN("Complementing a neighbourhood twice") {
+      std::vector<std::vector<unsigned>> before;
+      for (unsigned v : compact.spiders())
+        before.push_back(compact.neighbours(v));
+      for (unsigned v : compact.spiders()) {
+        if (compact.degree(v) < 3) continue;
+        compact.complement_neighbourhood(v);
+        // Local complementation never changes the neighbourhood of `v`
+        CHECK(compact.degree(v) >= 3);
+        compact.complement_neighbourhood(v);
+      }
+      std::vector<std::vector<unsigned>> after;
+      for (unsigned v : compact.spiders())
+        after.push_back(compact.neighbours(v));
+      CHECK(before == after);
+    }
+    WHEN("Simplifying") {
+      REQUIRE(compact.simplify());
+      CHECK_FALSE(compact.simplify());
+      // Only the boundary spiders remain
+      CHECK(compact.n_spiders() == 4);
+      for (unsigned v : compact.spiders()) {
+        CHECK(compact.is_boundary_spider(v));
+      }
+      ZXDiagram simplified = compact.to_diagram();
+      REQUIRE_NOTHROW(simplified.check_validity());
+      CHECK_FALSE(Rewrite::remove_interior_cliffords().apply(simplified));
+      CHECK_FALSE(Rewrite::remove_interior_paulis().apply(simplified));
+      // Matches the result of rewriting the original diagram
+      Rewrite::graphlike_reduction().apply(diag);
+      CHECK(
+          diag.count_vertices(ZXType::ZSpider) ==
+          simplified.count_vertices(ZXType::ZSpider));
+    }
+  }
+  GIVEN("Diagrams which are not supported") {
+    ZXDiagram diag(1, 1, 0, 0);
+    ZXVertVec ins = diag.get_boundary(ZXType::Input);
+    ZXVertVec outs = diag.get_boundary(ZXType::Output);
+    WHEN("Boundaries are directly connected") {
+      diag.add_wire(ins[0], outs[0]);
+      REQUIRE_THROWS_AS(GraphLikeDiagram(diag), ZXError);
+    }
+    WHEN("The diagram has parallel Hadamard wires") {
+      ZXVert z0 = diag.add_vertex(ZXType::ZSpider);
+      ZXVert z1 = diag.add_vertex(ZXType::ZSpider);
+      diag.add_wire(ins[0], z0);
+      diag.add_wire(z0, z1, ZXWireType::H);
+      diag.add_wire(z0, z1, ZXWireType::H);
+      diag.add_wire(z1, outs[0]);
+      REQUIRE_THROWS_AS(GraphLikeDiagram(diag), ZXError);
+    }
+    WHEN("The diagram is not graph-like") {
+      ZXVert x = diag.add_vertex(ZXType::XSpider);
+      diag.add_wire(ins[0], x);
+      diag.add_wire(x, outs[0]);
+      REQUIRE_THROWS_AS(GraphLikeDiagram(diag), ZXError);
+    }
+  }
+}
+
+}  // namespace test_ZXGraphLikeDiagram
+}  // namespace zx
+}  // namespace tket
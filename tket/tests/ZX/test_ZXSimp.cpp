@@ -87,6 +87,7 @@ SCENARIO("Testing graph state simplification") {
   diag1.add_wire(c46, d1_out[3], ZXWireType::Basic);
 
   REQUIRE_NOTHROW(diag1.check_validity());
+  ZXDiagram diag2(diag1);
 
   /** Apply rewrites to diagram 1 to turn into a graph-like form **/
 
@@ -109,6 +110,25 @@ SCENARIO("Testing graph state simplification") {
   CHECK(Rewrite::remove_interior_paulis().apply(diag1));
 
   CHECK_FALSE(Rewrite::parallel_h_removal().apply(diag1));
+
+  /** Repeat the simplification with the worklist-driven rewrites **/
+
+  Rewrite::red_to_green().apply(diag2);
+  CHECK(Rewrite::repeat_local(
+            {Rewrite::spider_fusion_at, Rewrite::self_loop_removal_at,
+             Rewrite::parallel_h_removal_at})
+            .apply(diag2));
+  Rewrite::io_extension().apply(diag2);
+  Rewrite::separate_boundaries().apply(diag2);
+  REQUIRE(diag2.is_graphlike());
+
+  CHECK(Rewrite::graphlike_reduction().apply(diag2));
+  REQUIRE_NOTHROW(diag2.check_validity());
+  CHECK(diag2.is_graphlike());
+  // The worklist driver runs both rules to a joint fixed point
+  CHECK_FALSE(Rewrite::remove_interior_cliffords().apply(diag2));
+  CHECK_FALSE(Rewrite::remove_interior_paulis().apply(diag2));
+  CHECK_FALSE(Rewrite::graphlike_reduction().apply(diag2));
 }
 
 }  // namespace test_ZXSimp
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "Architecture/Architecture.hpp"
+#include "Architecture/CompiledArchitecture.hpp"
 #include "Graphs/ArticulationPoints.hpp"
 
 namespace tket {
@@ -176,6 +177,151 @@ SCENARIO("Test Architecture utility methods.") {
     REQUIRE(subarc.get_all_edges_vec().size() == 1);
   }
 }
+SCENARIO("Test CompiledArchitecture agrees with Architecture") {
+  GIVEN("A ring with a tail, so there are articulation points") {
+    Architecture arc(
+        {{Node(0), Node(1)},
+         {Node(1), Node(2)},
+         {Node(2), Node(3)},
+         {Node(3), Node(0)},
+         {Node(3), Node(4)},
+         {Node(5), Node(4)}});
+    const auto compiled = arc.get_compiled();
+    REQUIRE(compiled->n_nodes() == 6);
+    REQUIRE(arc.get_compiled() == compiled);
+    const node_vector_t nodes = arc.get_all_nodes_vec();
+    for (const Node& n1 : nodes) {
+      const unsigned i1 = compiled->get_index(n1);
+      REQUIRE(compiled->get_node(i1) == n1);
+      REQUIRE(
+          compiled->get_distances(i1).size() == arc.get_distances(n1).size());
+      for (const Node& n2 : nodes) {
+        const unsigned i2 = compiled->get_index(n2);
+        REQUIRE(compiled->get_distance(i1, i2) == arc.get_distance(n1, n2));
+        REQUIRE(
+            compiled->edge_exists(i1, i2) ==
+            (arc.edge_exists(n1, n2) || arc.edge_exists(n2, n1)));
+      }
+      REQUIRE(
+          compiled->get_degree(i1) == arc.get_neighbour_nodes(n1).size());
+    }
+    REQUIRE(compiled->get_diameter() == 4);
+    REQUIRE(arc.get_diameter() == 4);
+    const node_set_t aps{Node(3), Node(4)};
+    REQUIRE(compiled->get_articulation_points() == aps);
+    REQUIRE(arc.get_articulation_points() == aps);
+    REQUIRE_THROWS_AS(
+        compiled->get_index(Node(6)), graphs::NodeDoesNotExistError);
+
+    WHEN("The architecture is modified") {
+      const Architecture copy(arc);
+      arc.add_node(Node(6));
+      // the copy keeps the compiled form of the unmodified architecture
+      REQUIRE(copy.get_compiled() == compiled);
+      const auto recompiled = arc.get_compiled();
+      REQUIRE(recompiled != compiled);
+      REQUIRE(compiled->n_nodes() == 6);
+      REQUIRE(recompiled->n_nodes() == 7);
+      const unsigned i6 = recompiled->get_index(Node(6));
+      REQUIRE(
+          recompiled->get_distance(0, i6) == CompiledArchitecture::unreachable);
+      REQUIRE_THROWS_AS(
+          recompiled->get_distance(Node(0), Node(6)),
+          graphs::NodesNotConnected);
+      REQUIRE_THROWS_AS(arc.get_diameter(), graphs::NodesNotConnected);
+    }
+  }
+}
+SCENARIO("Test CompiledArchitecture shortest paths") {
+  // A 4x4 grid has many shortest paths between most pairs.
+  const SquareGrid arc(4, 4);
+  const node_vector_t nodes = arc.get_all_nodes_vec();
+  const auto compiled = arc.get_compiled();
+  REQUIRE(compiled->has_next_hop_table());
+  // With no memory to spare, rows are computed one at a time.
+  const CompiledArchitecture bounded(arc, 0);
+  REQUIRE(!bounded.has_distance_table());
+  REQUIRE(!bounded.has_next_hop_table());
+  REQUIRE(bounded.get_diameter() == compiled->get_diameter());
+
+  for (const Node& root : nodes) {
+    for (const Node& target : nodes) {
+      const auto expected_path =
+          arc.DirectedGraph<Node>::get_path(root, target);
+      REQUIRE(arc.get_path(root, target) == expected_path);
+
+      const unsigned i_root = compiled->get_index(root);
+      const unsigned i_target = compiled->get_index(target);
+      const std::vector<unsigned> path =
+          compiled->get_path(i_target, i_root);
+      REQUIRE(bounded.get_path(i_target, i_root) == path);
+      REQUIRE(
+          bounded.get_distance(i_root, i_target) ==
+          compiled->get_distance(i_root, i_target));
+      REQUIRE(path.size() == compiled->get_distance(i_root, i_target) + 1);
+      REQUIRE(path.size() == expected_path.size());
+      for (unsigned ii = 0; ii < path.size(); ++ii) {
+        REQUIRE(compiled->get_node(path[ii]) == expected_path[ii]);
+      }
+      if (path.size() > 1) {
+        REQUIRE(compiled->get_next_hop(i_target, i_root) == path[1]);
+        REQUIRE(bounded.get_next_hop(i_target, i_root) == path[1]);
+      }
+    }
+  }
+  GIVEN("A disconnected architecture") {
+    Architecture disconnected({{Node(0), Node(1)}, {Node(2), Node(3)}});
+    REQUIRE(disconnected.get_path(Node(0), Node(3)).empty());
+    const auto compiled_disconnected = disconnected.get_compiled();
+    REQUIRE(
+        compiled_disconnected->get_next_hop(
+            compiled_disconnected->get_index(Node(0)),
+            compiled_disconnected->get_index(Node(3))) ==
+        CompiledArchitecture::unreachable);
+    const CompiledArchitecture bounded_disconnected(disconnected, 0);
+    REQUIRE(
+        bounded_disconnected.get_distance(
+            bounded_disconnected.get_index(Node(0)),
+            bounded_disconnected.get_index(Node(3))) ==
+        CompiledArchitecture::unreachable);
+    REQUIRE_THROWS_AS(
+        bounded_disconnected.get_diameter(), graphs::NodesNotConnected);
+  }
+}
+SCENARIO("Test CompiledArchitecture memory use on a large device") {
+  // Full 32-bit distance and next-hop tables would need 200MB.
+  const unsigned n_nodes = 5000;
+  const RingArch arc(n_nodes);
+  const CompiledArchitecture compiled(arc);
+  REQUIRE(!compiled.has_distance_table());
+  REQUIRE(!compiled.has_next_hop_table());
+  REQUIRE(
+      compiled.get_max_table_bytes() <=
+      CompiledArchitecture::default_max_table_bytes);
+  REQUIRE(compiled.get_diameter() == n_nodes / 2);
+
+  const unsigned i0 = compiled.get_index(Node("ringNode", 0));
+  const unsigned i1 = compiled.get_index(Node("ringNode", 1));
+  const unsigned i_far = compiled.get_index(Node("ringNode", n_nodes / 2));
+  REQUIRE(compiled.get_distance(i0, i1) == 1);
+  REQUIRE(compiled.get_distance(i0, i_far) == n_nodes / 2);
+  REQUIRE(compiled.get_path(i0, i_far).size() == n_nodes / 2 + 1);
+
+  GIVEN("A budget with room for the distance table only") {
+    const std::size_t table_bytes =
+        std::size_t(n_nodes) * n_nodes * sizeof(std::uint16_t);
+    const CompiledArchitecture distances_only(arc, table_bytes);
+    REQUIRE(distances_only.has_distance_table());
+    REQUIRE(!distances_only.has_next_hop_table());
+    // With no room left over, a single row is cached.
+    REQUIRE(
+        distances_only.get_max_table_bytes() ==
+        table_bytes + 2 * n_nodes * sizeof(unsigned));
+    REQUIRE(distances_only.get_distance(i0, i_far) == n_nodes / 2);
+    REQUIRE(
+        distances_only.get_path(i0, i_far) == compiled.get_path(i0, i_far));
+  }
+}
 }  // namespace test_Architectures
 }  // namespace graphs
 }  // namespace tket
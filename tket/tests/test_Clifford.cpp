@@ -208,6 +208,42 @@ SCENARIO("valid_insertion_point returns space-like interaction points") {
   REQUIRE((ips->second).e == e2);
 }
 
+SCENARIO("Causal order from the reachability index matches the DAG") {
+  Circuit circ(4);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::S, {2});
+  circ.add_op<unsigned>(OpType::CZ, {2, 3});
+  circ.add_op<unsigned>(OpType::V, {1});
+  circ.add_op<unsigned>(OpType::CX, {1, 2});
+  circ.add_op<unsigned>(OpType::H, {3});
+  circ.add_op<unsigned>(OpType::CX, {3, 0});
+  circ.add_op<unsigned>(OpType::S, {1});
+  CliffordReductionPassTester clifford_pass(circ);
+
+  std::vector<Vertex> verts;
+  for (const Vertex &v : circ.all_vertices()) {
+    if (!is_final_q_type(circ.get_OpType_from_Vertex(v))) verts.push_back(v);
+  }
+  for (const Vertex &from : verts) {
+    // Everything reachable from `from`, including itself.
+    VertexSet future{from};
+    std::vector<Vertex> to_visit{from};
+    while (!to_visit.empty()) {
+      const Vertex v = to_visit.back();
+      to_visit.pop_back();
+      for (const Vertex &succ : circ.get_successors(v)) {
+        if (future.insert(succ).second) to_visit.push_back(succ);
+      }
+    }
+    for (const Vertex &to : verts) {
+      REQUIRE(
+          clifford_pass.in_causal_order(from, to) ==
+          (future.find(to) != future.end()));
+    }
+  }
+}
+
 SCENARIO("ham3tc.qasm file was breaking for canonical clifford transform") {
   Circuit circ(5);
   circ.add_op<unsigned>(OpType::H, {1});
@@ -55,5 +55,67 @@ SCENARIO("Does Device correctly hold and return error information") {
   }
 }
 
+SCENARIO("DenseDeviceCharacterisation matches DeviceCharacterisation") {
+  Node n0{0}, n1{1}, n2{2}, n3{3};
+  GIVEN("Default errors") {
+    avg_node_errors_t ne{{n0, 0.1}, {n1, 0.2}, {n3, 0.4}};
+    avg_link_errors_t le{{{n0, n1}, 0.3}, {{n1, n2}, 0.5}, {{n2, n3}, 0.6}};
+    avg_readout_errors_t re{{n2, 0.05}};
+    DeviceCharacterisation characterisation(ne, le, re);
+    // n3 is not indexed, so its errors are dropped
+    DenseDeviceCharacterisation dense(characterisation, {n2, n0, n1});
+    REQUIRE(dense.n_nodes() == 3);
+    REQUIRE(dense.get_index(n2) == 0);
+    REQUIRE(dense.get_index(n1) == 2);
+    REQUIRE(!dense.get_index(n3));
+    const std::vector<Node>& nodes = dense.get_nodes();
+    for (unsigned i = 0; i < 3; i++) {
+      REQUIRE(dense.get_error(i) == characterisation.get_error(nodes[i]));
+      REQUIRE(
+          dense.get_error(i, OpType::X) ==
+          characterisation.get_error(nodes[i], OpType::X));
+      REQUIRE(
+          dense.get_readout_error(i) ==
+          characterisation.get_readout_error(nodes[i]));
+      for (unsigned j = 0; j < 3; j++) {
+        REQUIRE(
+            dense.get_error(i, j) ==
+            characterisation.get_error({nodes[i], nodes[j]}));
+      }
+    }
+    REQUIRE(dense.get_error(2, 0) == 0.5);
+    REQUIRE(dense.get_error(0, 2) == 0.);
+  }
+  GIVEN("OpType-specific errors") {
+    op_node_errors_t ne{
+        {n0, {{OpType::X, 0.1}, {OpType::H, 0.2}}}, {n1, {{OpType::X, 0.3}}}};
+    op_link_errors_t le{{{n0, n1}, {{OpType::CX, 0.4}}}};
+    DeviceCharacterisation characterisation(ne, le);
+    DenseDeviceCharacterisation dense(characterisation, {n0, n1, n2});
+    const std::vector<Node>& nodes = dense.get_nodes();
+    for (unsigned i = 0; i < 3; i++) {
+      for (OpType op : {OpType::X, OpType::H, OpType::Z}) {
+        REQUIRE(
+            dense.get_error(i, op) ==
+            characterisation.get_error(nodes[i], op));
+      }
+      for (unsigned j = 0; j < 3; j++) {
+        for (OpType op : {OpType::CX, OpType::CZ}) {
+          REQUIRE(
+              dense.get_error(i, j, op) ==
+              characterisation.get_error({nodes[i], nodes[j]}, op));
+        }
+      }
+    }
+    REQUIRE(dense.get_error(1, OpType::H) == 0.);
+    REQUIRE(dense.get_error(0, 1, OpType::CX) == 0.4);
+  }
+  GIVEN("Repeated Nodes") {
+    REQUIRE_THROWS_AS(
+        DenseDeviceCharacterisation(DeviceCharacterisation(), {n0, n1, n0}),
+        std::invalid_argument);
+  }
+}
+
 }  // namespace test_DeviceCharacterisation
 }  // namespace tket
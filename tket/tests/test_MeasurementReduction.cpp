@@ -98,5 +98,56 @@ SCENARIO("Some QubitOperators") {
   }
 }
 
+SCENARIO("Incremental measurement reduction") {
+  QubitPauliString zzzz({Pauli::Z, Pauli::Z, Pauli::Z, Pauli::Z});
+  QubitPauliString xxyy({Pauli::X, Pauli::X, Pauli::Y, Pauli::Y});
+  QubitPauliString yyxx({Pauli::Y, Pauli::Y, Pauli::X, Pauli::X});
+  QubitPauliString z0(Qubit(0), Pauli::Z);
+  QubitPauliString x0(Qubit(0), Pauli::X);
+  QubitPauliString z5(Qubit(5), Pauli::Z);
+  MeasurementReducer reducer(PauliPartitionStrat::CommutingSets);
+  reducer.add_terms({zzzz, xxyy, yyxx, z0});
+  REQUIRE(reducer.n_terms() == 4);
+  REQUIRE(reducer.n_partitions() == 2);
+  REQUIRE(reducer.get_setup().verify());
+  GIVEN("Terms already present") {
+    reducer.add_terms({zzzz, z0, z0});
+    REQUIRE(reducer.n_terms() == 4);
+    REQUIRE(reducer.n_partitions() == 2);
+  }
+  GIVEN("Removed terms") {
+    reducer.remove_terms({xxyy, z0});
+    REQUIRE(reducer.n_terms() == 2);
+    MeasurementSetup ms = reducer.get_setup();
+    REQUIRE(ms.get_result_map().size() == 2);
+    REQUIRE(ms.get_result_map().count(xxyy) == 0);
+    REQUIRE(ms.verify());
+    WHEN("All terms of a partition are removed") {
+      reducer.remove_terms({zzzz, yyxx});
+      REQUIRE(reducer.n_terms() == 0);
+      REQUIRE(reducer.n_partitions() == 0);
+      REQUIRE(reducer.get_setup().get_circs().empty());
+    }
+  }
+  GIVEN("Added terms on new qubits") {
+    reducer.add_terms({x0, z5});
+    REQUIRE(reducer.n_terms() == 6);
+    MeasurementSetup ms = reducer.get_setup();
+    for (const Circuit& circ : ms.get_circs()) {
+      REQUIRE(circ.n_qubits() == 5);
+      REQUIRE(circ.n_bits() == 5);
+    }
+    REQUIRE(ms.verify());
+    WHEN("Repartitioning") {
+      reducer.repartition();
+      REQUIRE(reducer.n_terms() == 6);
+      MeasurementSetup fresh = measurement_reduction(
+          {zzzz, xxyy, yyxx, z0, x0, z5}, PauliPartitionStrat::CommutingSets);
+      REQUIRE(reducer.n_partitions() == fresh.get_circs().size());
+      REQUIRE(reducer.get_setup().verify());
+    }
+  }
+}
+
 }  // namespace test_MeasurementReduction
 }  // namespace tket
@@ -271,6 +271,71 @@ SCENARIO("Test matrix product utilities") {
     const QubitPauliString op({{Qubit(0), Pauli::X}, {Qubit(1), Pauli::Y}});
     REQUIRE_THROWS(op.to_sparse_matrix({Qubit(0), Qubit(2)}));
   }
+  GIVEN("A sum of strings and a random state") {
+    const unsigned n_qubits = 4;
+    const std::vector<Pauli> paulis{Pauli::I, Pauli::X, Pauli::Y, Pauli::Z};
+    OperatorSum total_operator;
+    std::vector<Eigen::MatrixXcd> dense_terms;
+    for (unsigned j = 0; j < 20; ++j) {
+      QubitPauliString qps;
+      Eigen::MatrixXcd dense = Eigen::MatrixXcd::Identity(1, 1);
+      for (unsigned q = 0; q < n_qubits; ++q) {
+        Pauli p = paulis[(7 * j + 3 * q + j * q) % 4];
+        qps.map[Qubit(q)] = p;
+        Eigen::Matrix2cd single;
+        switch (p) {
+          case Pauli::X:
+            single << 0, 1, 1, 0;
+            break;
+          case Pauli::Y:
+            single << 0, -i_, i_, 0;
+            break;
+          case Pauli::Z:
+            single << 1, 0, 0, -1;
+            break;
+          default:
+            single << 1, 0, 0, 1;
+        }
+        dense = Eigen::kroneckerProduct(dense, single).eval();
+      }
+      total_operator.push_back({qps, Complex(j, 1)});
+      dense_terms.push_back(dense);
+    }
+    const Eigen::VectorXcd state = random_unitary(1 << n_qubits, 1).col(0);
+    std::vector<Complex> expectations =
+        operator_term_expectations(total_operator, state);
+    Eigen::MatrixXcd dense_sum = Eigen::MatrixXcd::Zero(16, 16);
+    Complex total = 0.;
+    for (unsigned j = 0; j < total_operator.size(); ++j) {
+      const Complex expected = state.dot(dense_terms[j] * state);
+      CHECK(std::abs(expectations[j] - expected) < ERR_EPS);
+      CHECK(total_operator[j].first.dot_state(state).isApprox(
+          dense_terms[j] * state));
+      dense_sum += total_operator[j].second * dense_terms[j];
+      total += total_operator[j].second * expected;
+    }
+    CHECK(operator_tensor(total_operator, n_qubits).toDense().isApprox(
+        dense_sum));
+    CHECK(std::abs(operator_expectation(total_operator, state) - total) <
+          ERR_EPS);
+  }
+  GIVEN("A state spanning several blocks of amplitudes") {
+    const unsigned n_qubits = 18;
+    Eigen::VectorXcd state(1 << n_qubits);
+    for (unsigned b = 0; b < state.size(); ++b) {
+      state[b] = Complex(std::cos(b), std::sin(3 * b));
+    }
+    state.normalize();
+    const QubitPauliString op(
+        {{Qubit(0), Pauli::Y}, {Qubit(9), Pauli::X}, {Qubit(17), Pauli::Z}});
+    std::vector<Complex> expectations =
+        operator_term_expectations({{op, 1.}, {op, 2.}}, state);
+    const Complex expected = state.dot(op.dot_state(state));
+    REQUIRE(expectations.size() == 2);
+    CHECK(std::abs(expectations[0] - expected) < ERR_EPS);
+    CHECK(expectations[0] == expectations[1]);
+    CHECK(std::abs(op.state_expectation(state) - expected) < ERR_EPS);
+  }
 }
 
 }  // namespace test_PauliString
@@ -299,6 +299,46 @@ SCENARIO("Building rebases with rebase_factory") {
     correct.add_phase(0.125);
     REQUIRE(circ == correct);
   }
+  GIVEN("A circuit with repeated gates") {
+    Circuit circ(3);
+    for (unsigned i = 0; i < 10; ++i) {
+      circ.add_op<unsigned>(OpType::Rx, 0.3, {i % 3});
+      circ.add_op<unsigned>(OpType::H, {(i + 1) % 3});
+      circ.add_op<unsigned>(OpType::CZ, {i % 3, (i + 1) % 3});
+    }
+    const auto u0 = tket_sim::get_unitary(circ);
+    unsigned n_calls = 0;
+    auto tk1_counter = [&n_calls](
+                           const Expr& alpha, const Expr& beta,
+                           const Expr& gamma) {
+      ++n_calls;
+      Circuit c(1);
+      c.add_op<unsigned>(OpType::TK1, {alpha, beta, gamma}, {0});
+      return c;
+    };
+    Transform t = Transforms::rebase_factory(
+        {OpType::CX, OpType::TK1}, CircPool::CX(), tk1_counter);
+    REQUIRE(t.apply(circ));
+    THEN("Each distinct gate is only rebased once") {
+      // Rx(0.3), and H (including those from decomposing CZ)
+      REQUIRE(n_calls == 2);
+      REQUIRE(circ.count_gates(OpType::CX) == 10);
+      REQUIRE(circ.count_gates(OpType::TK1) == 40);
+      const auto u1 = tket_sim::get_unitary(circ);
+      REQUIRE(tket_sim::compare_statevectors_or_unitaries(u0, u1));
+    }
+  }
+  GIVEN("A circuit with opgroups") {
+    // H is replaced by a single TK1, and CZ by several gates; the opgroups
+    // are dropped either way.
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::H, {0}, "single");
+    circ.add_op<unsigned>(OpType::CZ, {0, 1}, "multi");
+    REQUIRE(circ.get_opgroups().size() == 2);
+    REQUIRE(Transforms::rebase_tket().apply(circ));
+    REQUIRE(circ.count_gates(OpType::TK1) > 0);
+    REQUIRE(circ.get_opgroups().empty());
+  }
 }
 
 SCENARIO("Decompose all boxes") {
@@ -16,6 +16,7 @@
 #include <numeric>
 #include <optional>
 #include <stdexcept>
+#include <tkrng/RNG.hpp>
 
 #include "Circuit/CircPool.hpp"
 #include "Circuit/CircUtils.hpp"
@@ -38,6 +39,7 @@
 #include "Transformations/PauliOptimisation.hpp"
 #include "Transformations/Rebase.hpp"
 #include "Transformations/Replacement.hpp"
+#include "Transformations/RewriteRules.hpp"
 #include "Transformations/RzPhasedXSquash.hpp"
 #include "Transformations/Transform.hpp"
 #include "Utils/Expression.hpp"
@@ -2624,5 +2626,174 @@ SCENARIO("Test decompose_ZYZ_to_TK1") {
   REQUIRE(u1.isApprox(u1));
 }
 
+SCENARIO("Full peephole optimisation over windows") {
+  GIVEN("A 'random' circuit larger than the windows") {
+    Circuit circ(4);
+    RNG rng;
+    for (unsigned i = 0; i < 60; i++) {
+      unsigned a = rng.get_size_t(3);
+      unsigned b = rng.get_size_t(3);
+      unsigned c = rng.get_size_t(3);
+      unsigned d = rng.get_size_t(3);
+      circ.add_op<unsigned>(OpType::H, {a});
+      circ.add_op<unsigned>(OpType::Rz, 0.1 * (i % 7), {b});
+      if (c != d) {
+        circ.add_op<unsigned>(OpType::CX, {c, d});
+      }
+    }
+    const auto u = tket_sim::get_unitary(circ);
+    for (OpType target : {OpType::CX, OpType::TK2}) {
+      for (bool allow_swaps : {false, true}) {
+        Circuit windowed = circ;
+        REQUIRE(full_peephole_optimise_parallel(
+                    allow_swaps, target, 20, true, 4)
+                    .apply(windowed));
+        CHECK(
+            windowed.n_gates() ==
+            windowed.count_gates(target) + windowed.count_gates(OpType::TK1));
+        CHECK(windowed.n_gates() < circ.n_gates());
+        CHECK(tket_sim::compare_statevectors_or_unitaries(
+            u, tket_sim::get_unitary(windowed)));
+      }
+    }
+  }
+  GIVEN("A circuit within a single window") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    Circuit windowed = circ;
+    REQUIRE(full_peephole_optimise_parallel().apply(windowed));
+    Circuit serial = circ;
+    full_peephole_optimise().apply(serial);
+    CHECK(windowed == serial);
+  }
+  GIVEN("An empty window size") {
+    REQUIRE_THROWS_AS(
+        full_peephole_optimise_parallel(true, OpType::CX, 0),
+        std::invalid_argument);
+  }
+}
+
+SCENARIO("Repeated transforms revisit only what changed") {
+  GIVEN("A 'random' circuit") {
+    Circuit circ(4);
+    RNG rng;
+    for (unsigned i = 0; i < 60; i++) {
+      unsigned a = rng.get_size_t(3);
+      unsigned b = rng.get_size_t(3);
+      unsigned c = rng.get_size_t(3);
+      unsigned d = rng.get_size_t(3);
+      circ.add_op<unsigned>(OpType::Z, {a});
+      circ.add_op<unsigned>(OpType::Rx, 0.25 * (i % 5), {b});
+      if (c != d) {
+        circ.add_op<unsigned>(OpType::CX, {c, d});
+      }
+    }
+    const auto u = tket_sim::get_unitary(circ);
+    WHEN("Commuting and removing redundancies") {
+      Transform seq = Transforms::commute_through_multis() >>
+                      Transforms::remove_redundancies();
+      REQUIRE(Transforms::repeat(seq).apply(circ));
+      THEN("A full scan finds nothing more to do") {
+        Transform fresh = Transforms::commute_through_multis() >>
+                          Transforms::remove_redundancies();
+        REQUIRE_FALSE(fresh.apply(circ));
+        REQUIRE(tket_sim::compare_statevectors_or_unitaries(
+            u, tket_sim::get_unitary(circ)));
+      }
+    }
+    WHEN("Squashing single-qubit gates between commutations") {
+      Transform seq = Transforms::commute_through_multis() >>
+                      Transforms::squash_1qb_to_pqp(OpType::Rx, OpType::Rz) >>
+                      Transforms::remove_redundancies();
+      Transforms::repeat(seq).apply(circ);
+      THEN("A full scan finds nothing more to do") {
+        Transform fresh =
+            Transforms::commute_through_multis() >>
+            Transforms::squash_1qb_to_pqp(OpType::Rx, OpType::Rz) >>
+            Transforms::remove_redundancies();
+        REQUIRE_FALSE(fresh.apply(circ));
+        REQUIRE(tket_sim::compare_statevectors_or_unitaries(
+            u, tket_sim::get_unitary(circ)));
+      }
+    }
+  }
+}
+
+SCENARIO("Rewriting with compiled rules") {
+  Sym a = SymEngine::symbol("a");
+  Sym b = SymEngine::symbol("b");
+  Circuit merge_pattern(1);
+  merge_pattern.add_op<unsigned>(OpType::Rz, {Expr(a)}, {0});
+  merge_pattern.add_op<unsigned>(OpType::Rz, {Expr(b)}, {0});
+  Circuit merge_replacement(1);
+  merge_replacement.add_op<unsigned>(OpType::Rz, {Expr(a) + Expr(b)}, {0});
+  Circuit cx_pattern(2);
+  cx_pattern.add_op<unsigned>(OpType::CX, {0, 1});
+  cx_pattern.add_op<unsigned>(OpType::CX, {0, 1});
+  const Transforms::RewriteRuleSet rules(
+      {{merge_pattern, merge_replacement}, {cx_pattern, Circuit(2)}});
+  REQUIRE(rules.size() == 2);
+  GIVEN("A circuit with mergeable rotations and cancelling CXs") {
+    Circuit circ(3);
+    circ.add_op<unsigned>(OpType::Rz, 0.3, {0});
+    circ.add_op<unsigned>(OpType::Rz, 0.4, {0});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    circ.add_op<unsigned>(OpType::CX, {2, 1});
+    circ.add_op<unsigned>(OpType::Rz, 0.5, {1});
+    circ.add_op<unsigned>(OpType::Rz, 0.6, {1});
+    circ.add_op<unsigned>(OpType::Rz, 0.7, {1});
+    const auto u = tket_sim::get_unitary(circ);
+    REQUIRE(Transforms::repeat(Transforms::apply_rewrite_rules(rules))
+                .apply(circ));
+    THEN("All matches are rewritten") {
+      REQUIRE(circ.n_gates() == 3);
+      REQUIRE(circ.count_gates(OpType::CX) == 1);
+      REQUIRE(tket_sim::compare_statevectors_or_unitaries(
+          u, tket_sim::get_unitary(circ)));
+      REQUIRE_FALSE(Transforms::apply_rewrite_rules(rules).apply(circ));
+    }
+  }
+  GIVEN("CXs on the wrong ports") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::CX, {1, 0});
+    REQUIRE_FALSE(Transforms::apply_rewrite_rules(rules).apply(circ));
+  }
+  GIVEN("A pattern with a fixed parameter") {
+    Circuit pattern(1);
+    pattern.add_op<unsigned>(OpType::Rx, {Expr(a)}, {0});
+    pattern.add_op<unsigned>(OpType::Rx, {-Expr(a)}, {0});
+    const Transforms::RewriteRuleSet inverse({{pattern, Circuit(1)}});
+    Circuit circ(1);
+    circ.add_op<unsigned>(OpType::Rx, 0.25, {0});
+    circ.add_op<unsigned>(OpType::Rx, 3.75, {0});
+    circ.add_op<unsigned>(OpType::Rx, 0.25, {0});
+    circ.add_op<unsigned>(OpType::Rx, 0.5, {0});
+    REQUIRE(Transforms::apply_rewrite_rules(inverse).apply(circ));
+    REQUIRE(circ.n_gates() == 2);
+  }
+  GIVEN("Invalid rules") {
+    Circuit open_pattern(2);
+    open_pattern.add_op<unsigned>(OpType::H, {0});
+    open_pattern.add_op<unsigned>(OpType::H, {1});
+    REQUIRE_THROWS_AS(
+        Transforms::RewriteRuleSet({{open_pattern, Circuit(2)}}),
+        std::invalid_argument);
+    Circuit idle_pattern(2);
+    idle_pattern.add_op<unsigned>(OpType::H, {0});
+    REQUIRE_THROWS_AS(
+        Transforms::RewriteRuleSet({{idle_pattern, Circuit(2)}}),
+        std::invalid_argument);
+    Circuit unbound(1);
+    unbound.add_op<unsigned>(OpType::Rz, {Expr(b)}, {0});
+    Circuit h(1);
+    h.add_op<unsigned>(OpType::H, {0});
+    REQUIRE_THROWS_AS(
+        Transforms::RewriteRuleSet({{h, unbound}}), std::invalid_argument);
+  }
+}
+
 }  // namespace test_Synthesis
 }  // namespace tket
@@ -16,6 +16,7 @@
 
 #include "Circuit/CircUtils.hpp"
 #include "Circuit/Command.hpp"
+#include "Circuit/SynthesisCache.hpp"
 #include "Gate/Rotation.hpp"
 #include "Ops/ClassicalOps.hpp"
 #include "Predicates/CompilationUnit.hpp"
@@ -983,5 +984,97 @@ SCENARIO("Test decompose Clifford circuit") {
   }
 }
 
+SCENARIO("Synthesis cache") {
+  SynthesisCache cache(2);
+  unsigned n_calls = 0;
+  const SynthesisCache::Synthesiser synthesise =
+      [&n_calls](const Eigen::MatrixXcd &U) {
+        ++n_calls;
+        return two_qubit_canonical(U);
+      };
+  const Eigen::MatrixXcd U = random_unitary(4, 1);
+  GIVEN("A repeated unitary") {
+    Circuit c0 = cache.get_circuit("test", U, synthesise);
+    Circuit c1 = cache.get_circuit("test", U, synthesise);
+    CHECK(n_calls == 1);
+    CHECK(cache.get_hits() == 1);
+    CHECK(cache.get_misses() == 1);
+    CHECK(tket_sim::compare_statevectors_or_unitaries(
+        tket_sim::get_unitary(c1), U));
+    CHECK(c0 == c1);
+  }
+  GIVEN("A unitary differing by a global phase") {
+    cache.get_circuit("test", U, synthesise);
+    const Eigen::MatrixXcd V = std::exp(0.3 * i_) * U;
+    Circuit c = cache.get_circuit("test", V, synthesise);
+    CHECK(n_calls == 1);
+    CHECK(tket_sim::compare_statevectors_or_unitaries(
+        tket_sim::get_unitary(c), V));
+  }
+  GIVEN("Different tags") {
+    cache.get_circuit("test", U, synthesise);
+    cache.get_circuit("other", U, synthesise);
+    CHECK(n_calls == 2);
+    CHECK(cache.size() == 2);
+  }
+  GIVEN("More unitaries than the capacity") {
+    for (int seed = 0; seed < 4; ++seed) {
+      cache.get_circuit("test", random_unitary(4, seed), synthesise);
+    }
+    CHECK(cache.size() == 2);
+    // The most recently used are kept.
+    cache.get_circuit("test", random_unitary(4, 3), synthesise);
+    CHECK(n_calls == 4);
+    cache.get_circuit("test", random_unitary(4, 0), synthesise);
+    CHECK(n_calls == 5);
+  }
+  GIVEN("Zero capacity") {
+    cache.set_capacity(0);
+    cache.get_circuit("test", U, synthesise);
+    cache.get_circuit("test", U, synthesise);
+    CHECK(n_calls == 2);
+    CHECK(cache.size() == 0);
+  }
+}
+
+// Four CX gates on qubits a and b, which KAK reduces to at most three
+static void add_squashable_block(Circuit &circ, unsigned a, unsigned b) {
+  circ.add_op<unsigned>(OpType::CX, {a, b});
+  circ.add_op<unsigned>(OpType::Rx, 0.7, {b});
+  circ.add_op<unsigned>(OpType::CX, {b, a});
+  circ.add_op<unsigned>(OpType::Ry, 0.2, {a});
+  circ.add_op<unsigned>(OpType::CX, {a, b});
+  circ.add_op<unsigned>(OpType::Rz, 0.4, {b});
+  circ.add_op<unsigned>(OpType::CX, {b, a});
+}
+
+SCENARIO("Two-qubit squash with the shared synthesis cache") {
+  SynthesisCache &cache = synthesis_cache();
+  GIVEN("The default, disabled cache") {
+    Circuit circ(2);
+    add_squashable_block(circ, 0, 1);
+    REQUIRE(Transforms::two_qubit_squash().apply(circ));
+    CHECK(cache.size() == 0);
+    CHECK(cache.get_hits() == 0);
+  }
+  GIVEN("A circuit with two identical blocks on different qubits") {
+    cache.set_capacity(default_synthesis_cache_capacity);
+    cache.clear();
+    Circuit circ(4);
+    add_squashable_block(circ, 0, 1);
+    add_squashable_block(circ, 2, 3);
+    const Eigen::MatrixXcd U = tket_sim::get_unitary(circ);
+    CHECK(Transforms::two_qubit_squash().apply(circ));
+    CHECK(circ.count_gates(OpType::CX) <= 6);
+    CHECK(cache.get_misses() == 1);
+    CHECK(cache.get_hits() == 1);
+    CHECK(cache.size() == 1);
+    CHECK(tket_sim::compare_statevectors_or_unitaries(
+        tket_sim::get_unitary(circ), U));
+    cache.set_capacity(0);
+    cache.clear();
+  }
+}
+
 }  // namespace test_TwoQubitCanonical
 }  // namespace tket
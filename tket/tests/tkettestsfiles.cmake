@@ -23,6 +23,7 @@ set(TEST_SOURCES
     ${TKET_TESTS_DIR}/Utils/test_CosSinDecomposition.cpp
     ${TKET_TESTS_DIR}/Utils/test_HelperFunctions.cpp
     ${TKET_TESTS_DIR}/Utils/test_MatrixAnalysis.cpp
+    ${TKET_TESTS_DIR}/Utils/test_BinaryMatrix.cpp
     ${TKET_TESTS_DIR}/Graphs/test_GraphColouring.cpp
     ${TKET_TESTS_DIR}/Graphs/test_GraphFindComponents.cpp
     ${TKET_TESTS_DIR}/Graphs/test_GraphFindMaxClique.cpp
@@ -100,6 +101,7 @@ set(TEST_SOURCES
     ${TKET_TESTS_DIR}/ZX/test_ZXDiagram.cpp
     ${TKET_TESTS_DIR}/ZX/test_ZXAxioms.cpp
     ${TKET_TESTS_DIR}/ZX/test_ZXSimp.cpp
+    ${TKET_TESTS_DIR}/ZX/test_ZXGraphLikeDiagram.cpp
     ${TKET_TESTS_DIR}/ZX/test_ZXRebase.cpp
     ${TKET_TESTS_DIR}/ZX/test_Flow.cpp
     ${TKET_TESTS_DIR}/ZX/test_ZXConverters.cpp